@@ -0,0 +1,23 @@
+[localbench]
+# Path to the search binary (relative to this file), it can be overridden
+# by --bin option so that two builds can be compared with the same config.
+search-bin = search
+# Space separated list of globs (relative to this file)
+problems = ../testsuites/proto/depot-pfile*.proto
+           ../testsuites/proto/rovers-p0*.proto
+           ../testsuites/proto/driverlog-pfile?.proto
+search = astar-opt lazy-sat
+max-time = 300
+max-mem = 2048
+repeat = 5
+# Number of parallel runs, 0 means number of CPUs
+workers = 0
+
+[localbench-search-astar-opt]
+search = astar
+heur = lm-cut max
+
+[localbench-search-lazy-sat]
+search = lazy ehc
+heur = ff
+opts = --progress-freq 1000000
@@ -0,0 +1,421 @@
+#!/usr/bin/env python2
+#
+# Local benchmarking driver.
+#
+# Runs a matrix of search configurations over a set of problems on the
+# local machine and stores time, memory, number of expanded states and
+# plan cost of each run. Results of two builds can be compared with the
+# diff command that flags statistically significant changes.
+#
+# Usage:
+#   localbench.py run localbench.cfg results.json [--bin path/to/search]
+#                                                 [--workers N]
+#   localbench.py diff base.json new.json [--alpha 0.05] [--threshold 0.05]
+#
+# See localbench.cfg.tpl for the format of the configuration file.
+#
+
+from __future__ import print_function
+import sys
+import os
+import re
+import glob
+import json
+import math
+import time
+import resource
+import subprocess
+import multiprocessing
+try:
+    import ConfigParser as cfgparser
+except ImportError:
+    import configparser as cfgparser
+
+
+def err(msg):
+    print('Error: ' + msg, file = sys.stderr)
+    sys.exit(-1)
+
+
+class Config(object):
+    def __init__(self, fn):
+        if not os.path.isfile(fn):
+            err('Could not open config file `{0}\''.format(fn))
+
+        self.fn = fn
+        self.topdir = os.path.dirname(os.path.abspath(fn))
+        self.cfg = cfgparser.ConfigParser()
+        self.cfg.read(fn)
+
+        self.search_bin = self._get('localbench', 'search-bin', 'search')
+        self.max_time = int(self._get('localbench', 'max-time', '300'))
+        self.max_mem = int(self._get('localbench', 'max-mem', '2048'))
+        self.repeat = int(self._get('localbench', 'repeat', '5'))
+        self.workers = int(self._get('localbench', 'workers', '0'))
+
+        self.problems = []
+        for pattern in self._get('localbench', 'problems', '').split():
+            pattern = os.path.join(self.topdir, pattern)
+            self.problems += sorted(glob.glob(pattern))
+        if len(self.problems) == 0:
+            err('No problems found.')
+
+        self.search = []
+        for name in self._get('localbench', 'search', '').split():
+            self.search += self._parseSearch(name)
+        if len(self.search) == 0:
+            err('No search configurations defined.')
+
+    def _get(self, section, option, default):
+        if self.cfg.has_option(section, option):
+            return self.cfg.get(section, option)
+        return default
+
+    def _parseSearch(self, name):
+        section = 'localbench-search-' + name
+        if not self.cfg.has_section(section):
+            err('Missing section [{0}]'.format(section))
+
+        search = self._get(section, 'search', 'astar').split()
+        heur = self._get(section, 'heur', 'lm-cut').split()
+        opts = self._get(section, 'opts', '').split()
+
+        # Cartesian product of all search algorithms and heuristics
+        out = []
+        for s in search:
+            for h in heur:
+                cname = name
+                if len(search) > 1 or len(heur) > 1:
+                    cname = '{0}-{1}-{2}'.format(name, s, h).replace(':', '-')
+                args = ['-s', s, '-H', h] + opts
+                out += [{ 'name' : cname, 'args' : args }]
+        return out
+
+
+_re_stat = {
+    'search_time' : re.compile(r'^\s*Search Time: ([0-9.]+)'),
+    'expanded' : re.compile(r'^\s*Expanded States: ([0-9]+)'),
+    'evaluated' : re.compile(r'^\s*Evaluated States: ([0-9]+)'),
+    'generated' : re.compile(r'^\s*Generated States: ([0-9]+)'),
+    'plan_cost' : re.compile(r'^Plan Cost: ([0-9]+)'),
+    'overall_time' : re.compile(r'^Overall Time: ([0-9.]+)'),
+}
+
+def parseOutput(out):
+    res = { 'found' : False }
+    for line in out.split('\n'):
+        if line.startswith('Solution found.'):
+            res['found'] = True
+        for key, r in _re_stat.items():
+            m = r.match(line)
+            if m is None:
+                continue
+            val = m.group(1)
+            val = float(val) if '.' in val else int(val)
+
+            # Statistics of all agents are summed up
+            if key in res and key not in ['plan_cost', 'overall_time']:
+                res[key] += val
+            else:
+                res[key] = val
+    return res
+
+def runOne(job):
+    cmd = [job['bin'], '-p', job['problem'],
+           '--max-time', str(job['max_time']),
+           '--max-mem', str(job['max_mem'])] + job['args']
+
+    start = time.time()
+    proc = subprocess.Popen(cmd, stdout = subprocess.PIPE,
+                            stderr = subprocess.PIPE)
+    out, _ = proc.communicate()
+    wall = time.time() - start
+
+    # Peak memory of the finished child (in kb on Linux). Each worker
+    # process runs exactly one job (see maxtasksperchild) so this is the
+    # peak memory of this run only.
+    maxrss = resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss
+
+    if not isinstance(out, str):
+        out = out.decode('utf-8', 'replace')
+    res = parseOutput(out)
+    res['config'] = job['config']
+    res['problem'] = os.path.basename(job['problem'])
+    res['rep'] = job['rep']
+    res['wall_time'] = wall
+    res['peak_mem_kb'] = maxrss
+    res['returncode'] = proc.returncode
+    return res
+
+def cmdRun(args):
+    if len(args) < 2:
+        usage()
+
+    cfg = Config(args[0])
+    outfn = args[1]
+    search_bin = cfg.search_bin
+    workers = cfg.workers
+    i = 2
+    while i < len(args):
+        if args[i] == '--bin' and i + 1 < len(args):
+            search_bin = args[i + 1]
+            i += 2
+        elif args[i] == '--workers' and i + 1 < len(args):
+            workers = int(args[i + 1])
+            i += 2
+        else:
+            usage()
+
+    if not os.path.isabs(search_bin) and not os.path.isfile(search_bin):
+        search_bin = os.path.join(cfg.topdir, search_bin)
+    if not os.path.isfile(search_bin):
+        err('Could not find search binary `{0}\''.format(search_bin))
+    if workers <= 0:
+        workers = multiprocessing.cpu_count()
+
+    jobs = []
+    for rep in range(cfg.repeat):
+        for s in cfg.search:
+            for prob in cfg.problems:
+                jobs += [{ 'bin' : search_bin,
+                           'problem' : prob,
+                           'config' : s['name'],
+                           'args' : s['args'],
+                           'rep' : rep,
+                           'max_time' : cfg.max_time,
+                           'max_mem' : cfg.max_mem }]
+
+    print('Running {0} jobs on {1} workers...'.format(len(jobs), workers),
+          file = sys.stderr)
+    pool = multiprocessing.Pool(workers, maxtasksperchild = 1)
+    results = []
+    for i, res in enumerate(pool.imap_unordered(runOne, jobs)):
+        results += [res]
+        print('[{0}/{1}] {2} {3} #{4}: {5:.3f} s'
+                .format(i + 1, len(jobs), res['config'], res['problem'],
+                        res['rep'], res['wall_time']),
+              file = sys.stderr)
+    pool.close()
+    pool.join()
+
+    results.sort(key = lambda x: (x['config'], x['problem'], x['rep']))
+    data = { 'search_bin' : os.path.abspath(search_bin),
+             'config' : os.path.abspath(cfg.fn),
+             'results' : results }
+    with open(outfn, 'w') as fout:
+        json.dump(data, fout, indent = 1, sort_keys = True)
+
+
+def median(vals):
+    vals = sorted(vals)
+    n = len(vals)
+    if n == 0:
+        return None
+    if n % 2 == 1:
+        return vals[n // 2]
+    return (vals[n // 2 - 1] + vals[n // 2]) / 2.
+
+def binom(n, k):
+    out = 1
+    for i in range(min(k, n - k)):
+        out = out * (n - i) // (i + 1)
+    return out
+
+def minPValue(n1, n2):
+    """ Returns the smallest p-value the two-sided Mann-Whitney U test can
+        reach with samples of sizes n1 and n2. """
+    if n1 == 0 or n2 == 0:
+        return 1.
+    return min(1., 2. / binom(n1 + n2, n1))
+
+def exactUDist(n1, n2):
+    """ Returns the list of numbers of orderings of the samples for each
+        value of U (without ties). """
+    # cnt[j][u] is the number of orderings of n1' = i and n2' = j samples
+    # with the statistic u, i is increased in the outer loop
+    cnt = [[1] for j in range(n2 + 1)]
+    for i in range(1, n1 + 1):
+        nxt = []
+        for j in range(n2 + 1):
+            size = i * j + 1
+            row = [0] * size
+            # The largest value is from the first sample, it is greater
+            # than all j values from the second sample
+            for u, c in enumerate(cnt[j]):
+                row[u + j] += c
+            # The largest value is from the second sample
+            if j > 0:
+                for u, c in enumerate(nxt[j - 1]):
+                    row[u] += c
+            nxt += [row]
+        cnt = nxt
+    return cnt[n2]
+
+def mannWhitneyU(a, b):
+    """ Two-sided Mann-Whitney U test. The exact distribution of U is used
+        for small samples without ties, otherwise the normal approximation
+        with tie correction is used. Returns the p-value. """
+    n1, n2 = len(a), len(b)
+    if n1 == 0 or n2 == 0:
+        return 1.
+
+    vals = sorted([(x, 0) for x in a] + [(x, 1) for x in b])
+    ranks = [0.] * len(vals)
+    ties = 0.
+    i = 0
+    while i < len(vals):
+        j = i
+        while j + 1 < len(vals) and vals[j + 1][0] == vals[i][0]:
+            j += 1
+        rank = (i + j) / 2. + 1.
+        for k in range(i, j + 1):
+            ranks[k] = rank
+        t = j - i + 1
+        ties += t ** 3 - t
+        i = j + 1
+
+    r1 = sum(r for r, v in zip(ranks, vals) if v[1] == 0)
+    u1 = r1 - n1 * (n1 + 1) / 2.
+    mu = n1 * n2 / 2.
+    n = n1 + n2
+
+    if ties == 0. and n1 <= 20 and n2 <= 20:
+        dist = exactUDist(n1, n2)
+        u = int(round(min(u1, n1 * n2 - u1)))
+        p = 2. * sum(dist[:u + 1]) / binom(n, n1)
+        return min(1., p)
+
+    sigma2 = n1 * n2 / 12. * ((n + 1) - ties / (n * (n - 1)))
+    if sigma2 <= 0.:
+        return 1.
+    z = (abs(u1 - mu) - 0.5) / math.sqrt(sigma2)
+    if z < 0.:
+        z = 0.
+    return math.erfc(z / math.sqrt(2.))
+
+def groupResults(data):
+    out = {}
+    for r in data['results']:
+        key = (r['config'], r['problem'])
+        out.setdefault(key, []).append(r)
+    return out
+
+def cmdDiff(args):
+    if len(args) < 2:
+        usage()
+
+    alpha = 0.05
+    threshold = 0.05
+    i = 2
+    while i < len(args):
+        if args[i] == '--alpha' and i + 1 < len(args):
+            alpha = float(args[i + 1])
+            i += 2
+        elif args[i] == '--threshold' and i + 1 < len(args):
+            threshold = float(args[i + 1])
+            i += 2
+        else:
+            usage()
+
+    base = groupResults(json.load(open(args[0])))
+    new = groupResults(json.load(open(args[1])))
+
+    regressions = 0
+    improvements = 0
+    warned = set()
+    print('{0:30s} {1:30s} {2:>10s} {3:>10s} {4:>8s} {5:>8s}  {6}'
+            .format('config', 'problem', 'metric', 'base', 'new',
+                    'change', 'flag'))
+    for key in sorted(set(base.keys()) | set(new.keys())):
+        if key not in base or key not in new:
+            print('{0:30s} {1:30s} missing in {2}'
+                    .format(key[0], key[1],
+                            'base' if key not in base else 'new'))
+            continue
+
+        b, n = base[key], new[key]
+        bfound = all(r['found'] for r in b)
+        nfound = all(r['found'] for r in n)
+        if bfound != nfound:
+            print('{0:30s} {1:30s} {2:>10s} {3:>10s} {4:>10s}'
+                    .format(key[0], key[1], 'solved', str(bfound),
+                            str(nfound)))
+            if bfound:
+                regressions += 1
+            else:
+                improvements += 1
+            continue
+
+        for metric in ['search_time', 'peak_mem_kb', 'expanded',
+                       'plan_cost']:
+            bv = [r[metric] for r in b if metric in r]
+            nv = [r[metric] for r in n if metric in r]
+            if len(bv) == 0 or len(nv) == 0:
+                continue
+
+            bm, nm = median(bv), median(nv)
+            change = 0.
+            if bm != 0:
+                change = (nm - bm) / float(bm)
+            elif nm != 0:
+                change = 1.
+
+            flag = ''
+            if metric in ['expanded', 'plan_cost']:
+                # Deterministic metrics: any change is significant
+                if nm != bm:
+                    flag = 'CHANGED'
+            elif abs(change) >= threshold:
+                sizes = (len(bv), len(nv))
+                if minPValue(*sizes) >= alpha and sizes not in warned:
+                    print('Warning: {0} vs {1} runs can never reach'
+                          ' alpha = {2} (min p = {3:.3f}), increase repeat'
+                          ' in the config file.'
+                            .format(sizes[0], sizes[1], alpha,
+                                    minPValue(*sizes)),
+                          file = sys.stderr)
+                    warned.add(sizes)
+                p = mannWhitneyU(bv, nv)
+                if p < alpha:
+                    flag = 'SLOWER' if change > 0. else 'FASTER'
+                    if metric == 'peak_mem_kb':
+                        flag = 'MORE-MEM' if change > 0. else 'LESS-MEM'
+                    flag += ' (p={0:.3f})'.format(p)
+
+            if flag.startswith('SLOWER') or flag.startswith('MORE-MEM'):
+                regressions += 1
+            elif flag.startswith('FASTER') or flag.startswith('LESS-MEM'):
+                improvements += 1
+            elif flag.startswith('CHANGED') and metric == 'plan_cost' \
+                    and nm > bm:
+                regressions += 1
+
+            if flag != '' or metric == 'search_time':
+                print('{0:30s} {1:30s} {2:>10s} {3:>10.3f} {4:>10.3f}'
+                      ' {5:>+7.1f}%  {6}'
+                        .format(key[0], key[1], metric, bm, nm,
+                                100. * change, flag))
+
+    print('')
+    print('Significant regressions: {0}'.format(regressions))
+    print('Significant improvements: {0}'.format(improvements))
+    if regressions > 0:
+        sys.exit(1)
+
+
+def usage():
+    print('Usage: {0} run config.cfg results.json [--bin search]'
+          ' [--workers N]'.format(sys.argv[0]), file = sys.stderr)
+    print('       {0} diff base.json new.json [--alpha 0.05]'
+          ' [--threshold 0.05]'.format(sys.argv[0]), file = sys.stderr)
+    sys.exit(-1)
+
+if __name__ == '__main__':
+    if len(sys.argv) < 2:
+        usage()
+    if sys.argv[1] == 'run':
+        cmdRun(sys.argv[2:])
+    elif sys.argv[1] == 'diff':
+        cmdDiff(sys.argv[2:])
+    else:
+        usage()
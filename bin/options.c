@@ -36,14 +36,20 @@ static char default_heur[] = "lm-cut";
 static char default_search[] = "astar";
 
 static const char *opt_search_ehc[] = {
-    "pref", "pref_only", NULL
+    "pref", "pref_only", "par", "sss", "sym", "de", NULL
 };
 static const char *opt_search_lazy[] = {
     "pref", "pref_only", "list-bucket", "list-heap", "list-rb",
-    "list-splay", NULL
+    "list-splay", "sss", "sym", "de", NULL
 };
 static const char *opt_search_astar[] = {
-    "pathmax", NULL
+    "pathmax", "sss", "sym", "de", NULL
+};
+static const char *opt_search_all[] = {
+    "sss", "sym", "de", NULL
+};
+static const char *opt_search_bfs[] = {
+    "count", "par", NULL
 };
 static const char *opt_empty[] = { NULL };
 static const char *opt_heur_all[] = {
@@ -72,6 +78,9 @@ static optdef_t opt_search[] = {
     { "ehc", opt_search_ehc },
     { "lazy", opt_search_lazy },
     { "astar", opt_search_astar },
+    { "rwastar", opt_search_all },
+    { "smastar", opt_search_all },
+    { "bfs", opt_search_bfs },
 };
 static int opt_search_size = sizeof(opt_search) / sizeof(optdef_t);
 
@@ -82,6 +91,7 @@ static optdef_t opt_heur[] = {
     { "max", opt_heur_all },
     { "relax-max", opt_heur_all },
     { "ff", opt_heur_all },
+    { "add-max-ff", opt_heur_all },
     { "dtg", opt_heur_all },
     { "max2", opt_heur_all },
     { "lm-cut", opt_heur_all },
@@ -148,14 +158,51 @@ static int readOpts(int argc, char *argv[])
     optsAddDesc("print-heur-init", 0x0, OPTS_NONE, &o->print_heur_init, NULL,
                 "Prints heuristic value for the initial state to stdout."
                 " (default: Off)");
+    optsAddDesc("prune-h2", 0x0, OPTS_NONE, &o->prune_h2, NULL,
+                "Prunes unreachable facts and useless operators using"
+                " forward and backward h^2 mutexes before the search starts."
+                " Works only in the single-agent mode. (default: Off)");
+    optsAddDesc("heur-cache", 0x0, OPTS_INT, &o->heur_cache, NULL,
+                "Caches heuristic values of up to the specified number of"
+                " states projected onto the variables relevant to the goal."
+                " Works only in the single-agent mode. Set to 0 to disable."
+                " (default: 0)");
+    optsAddDesc("pot-ensemble", 0x0, OPTS_INT, &o->pot_ensemble, NULL,
+                "Number of potential functions computed by the pot"
+                " heuristic. The heuristic value is the maximum over the"
+                " functions optimized for the initial state and for states"
+                " sampled by random walks. (default: 1)");
+    optsAddDesc("pot-threads", 0x0, OPTS_INT, &o->pot_threads, NULL,
+                "Number of threads solving the LPs of --pot-ensemble."
+                " (default: 1)");
+    optsAddDesc("ldm-cache-mem", 0x0, OPTS_INT, &o->ldm_cache_mem, NULL,
+                "Memory budget in MB of the landmark cache of the"
+                " lm-cut-inc-cache heuristics. The least recently used"
+                " landmark sets are evicted when the budget is exceeded."
+                " Set to 0 for unlimited cache. (default: 0)");
     optsAddDesc("max-time", 0x0, OPTS_INT, &o->max_time, NULL,
                 "Maximal time the search can spent on finding solution in"
                 " seconds. (default: 30 minutes).");
     optsAddDesc("max-mem", 0x0, OPTS_INT, &o->max_mem, NULL,
                 "Maximal memory (peak memory) in MB. (default: 1GB)");
+    optsAddDesc("mem-pressure", 0x0, OPTS_INT, &o->mem_pressure, NULL,
+                "Percentage of --max-mem at which the search is asked to"
+                " release its caches (e.g., landmarks cached by the"
+                " heuristic). Halfway between this limit and --max-mem"
+                " the caches are dropped completely. Requires the hard"
+                " limit monitor. Set to 0 to disable. (default: 80)");
     optsAddDesc("progress-freq", 0x0, OPTS_INT, &o->progress_freq, NULL,
                 "Frequency in which progress bar is called."
                 " (default: 10000)");
+    optsAddDesc("metrics-fd", 0x0, OPTS_INT, &o->metrics_fd, NULL,
+                "Writes search metrics as JSON lines to the specified"
+                " file descriptor each time the progress bar is called"
+                " and once more when the search ends. (default: -1, i.e.,"
+                " disabled)");
+    optsAddDesc("trace", 0x0, OPTS_STR, &o->trace, NULL,
+                "Records search steps, heuristic evaluations and"
+                " multi-agent communication and writes them in Chrome"
+                " trace format to the specified file. (default: None)");
     optsAddDesc("dot-graph", 0x0, OPTS_STR, &o->dot_graph, NULL,
                 "Prints problem definition as graph in DOT format in"
                 " specified file. (default: None)");
@@ -200,11 +247,15 @@ static void usage(const char *progname)
 "    Search option should be a string consisting of one or more options\n"
 "    delimited by a semicolon. The first part must be name of the search\n"
 "    followed by a list of options.\n"
-"    The available search methods are: ehc, lazy, astar\n"
+"    The available search methods are: ehc, lazy, astar, rwastar,\n"
+"    smastar, bfs\n"
 "\n"
 "    Options allowed for *ehc*:\n"
 "           pref      -- preferred operators are used\n"
 "           pref_only -- only the preferred operators are used\n"
+"           par       -- the improvement search proceeds layer by layer\n"
+"                        and states of each layer are evaluated using\n"
+"                        all available CPUs\n"
 "\n"
 "    Options allowed for *lazy*:\n"
 "           pref        -- preferred operators are used\n"
@@ -217,6 +268,33 @@ static void usage(const char *progname)
 "    Options allowed for *astar*:\n"
 "           pathmax -- pathmax variant of A*\n"
 "\n"
+"    *rwastar* is an anytime restarting weighted A* with weights 5, 3, 2, 1.\n"
+"    Each improved plan is reported (and written to --output) as soon as\n"
+"    it is found.\n"
+"\n"
+"    *smastar* is a memory-bounded A* that keeps the number of stored\n"
+"    states within 3/4 of --max-mem by evicting the worst leaves.\n"
+"    It cannot be used in multi-agent search and the lm-cut-inc-*\n"
+"    heuristics cannot be used with *smastar*.\n"
+"\n"
+"    *bfs* is a blind breadth-first search storing layers of states as\n"
+"    compressed sorted arrays instead of the state pool (the heuristic\n"
+"    is not used). The plan is optimal only for unit-cost problems.\n"
+"    Options allowed for *bfs*:\n"
+"           count -- explore the whole reachable state space and print\n"
+"                    the number of reachable states\n"
+"           par   -- expand each layer using all available CPUs\n"
+"\n"
+"    Options allowed for all search methods except bfs:\n"
+"           sss -- prune applicable operators using strong stubborn\n"
+"                  sets (it is switched off automatically if it does\n"
+"                  not prune enough)\n"
+"           sym -- map states to canonical representatives of their\n"
+"                  symmetry classes (orbit search)\n"
+"           de  -- learn generalized dead ends from the states the\n"
+"                  heuristic marks as dead ends and prune states\n"
+"                  matching them without calling the heuristic\n"
+"\n"
 "    EXAMPLES:\n"
 "           ehc:pref -- EHC algorithm with preferred operators\n"
 "           lazy:pref:list-bucket -- Lazy algorithm with preferred\n"
@@ -227,8 +305,8 @@ static void usage(const char *progname)
     fprintf(stderr,
 "  HEUR OPTIONS:\n"
 "    The available heur algorithms are:\n"
-"        goalcount, add, max, ff, dtg, max2, lm-cut, lm-cut-inc-local, lm-cut2,\n"
-"        lm-cut-inc-cache, flow, potential.\n"
+"        goalcount, add, max, ff, add-max-ff, dtg, max2, lm-cut,\n"
+"        lm-cut-inc-local, lm-cut2, lm-cut-inc-cache, flow, potential.\n"
 "    Additionally for the multi-agent mode: ma-max, ma-ff, ma-lm-cut, ma-dtg, ma-pot\n"
 "\n"
 "    Options allowed for flow heuristic:\n"
@@ -237,6 +315,9 @@ static void usage(const char *progname)
 "\n"
 "    Options allowed for lm-cut-inc-cache heuristic:\n"
 "           prune -- Pruning of cache is enabled\n"
+"\n""    Options allowed for dtg and ma-dtg heuristics:\n"
+"           all-pairs -- Distances between all pairs of values are\n"
+"                        precomputed\n"
 "\n"
 "    Options allowed for all (non ma-) heuristics in multi-agent mode:\n"
 "           proj -- heur is computed on projected operators\n"
@@ -344,8 +425,16 @@ static void printOpts(void)
     printf("Output: %s\n", o->output);
     printf("Max time: %d s\n", o->max_time);
     printf("Max mem: %d MB\n", o->max_mem);
+    printf("Mem pressure: %d %%\n", o->mem_pressure);
     printf("Progress freq: %d\n", o->progress_freq);
+    printf("Metrics fd: %d\n", o->metrics_fd);
+    printf("Trace: %s\n", o->trace);
     printf("Print heur init: %d\n", o->print_heur_init);
+    printf("Prune h2: %d\n", o->prune_h2);
+    printf("Heur cache: %d\n", o->heur_cache);
+    printf("Pot ensemble: %d\n", o->pot_ensemble);
+    printf("Pot threads: %d\n", o->pot_threads);
+    printf("Ldm cache mem: %d MB\n", o->ldm_cache_mem);
     printf("Dot graph: %s\n", o->dot_graph);
     printf("Heur: %s [", o->heur);
     for (i = 0; i < o->heur_opts_len; ++i){
@@ -372,7 +461,11 @@ options_t *options(int argc, char *argv[])
     o->tcp_id = -1;
     o->max_time = 30 * 60;
     o->max_mem = 1024;
+    o->mem_pressure = 80;
+    o->pot_ensemble = 1;
+    o->pot_threads = 1;
     o->progress_freq = 10000;
+    o->metrics_fd = -1;
     o->heur = default_heur;
     o->heur_opts = NULL;
     o->heur_opts_len = 0;
@@ -398,6 +491,24 @@ options_t *options(int argc, char *argv[])
         return NULL;
     }
 
+    // Agents refer to each other's states by state IDs which are reused
+    // by smastar
+    if (strcmp(o->search, "smastar") == 0
+            && (o->ma_unfactor || o->ma_factor || o->ma_factor_dir)){
+        fprintf(stderr, "Error: smastar cannot be used in multi-agent"
+                        " search.\n\n");
+        usage(argv[0]);
+        return NULL;
+    }
+
+    if (strcmp(o->search, "smastar") == 0
+            && strstr(o->heur, "lm-cut-inc-") != NULL){
+        fprintf(stderr, "Error: Heuristic `%s' keeps data by state IDs"
+                        " which are reused by smastar.\n\n", o->heur);
+        usage(argv[0]);
+        return NULL;
+    }
+
     printOpts();
     return o;
 }
@@ -33,8 +33,16 @@ struct _options_t {
     int tcp_id;
     int max_time;
     int max_mem;
+    int mem_pressure;
     int progress_freq;
+    int metrics_fd;
+    char *trace;
     int print_heur_init;
+    int prune_h2;
+    int heur_cache;
+    int pot_ensemble;
+    int pot_threads;
+    int ldm_cache_mem;
     char *dot_graph;
     int hard_limit_sleeptime;
 
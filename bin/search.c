@@ -22,12 +22,14 @@
 #include <errno.h>
 #include <dirent.h>
 #include <signal.h>
+#include <time.h>
 #include <boruvka/tasks.h>
 #include <boruvka/alloc.h>
 #include <plan/ma_msg.h>
 #include <plan/problem.h>
 #include <plan/search.h>
 #include <plan/ma_search.h>
+#include <plan/trace.h>
 
 #include "options.h"
 
@@ -42,6 +44,13 @@ struct _progress_t {
     int max_time;
     int max_mem;
     int agent_id;
+
+    int metrics_fd;             /*!< File descriptor of the metrics stream
+                                     or -1 */
+    const plan_search_t *search;
+    const plan_ma_comm_t *comm; /*!< Set only in multi-agent mode */
+    double metrics_last_time;   /*!< Elapsed time of the last record */
+    long metrics_last_expanded; /*!< Expanded states of the last record */
 };
 typedef struct _progress_t progress_t;
 
@@ -63,6 +72,11 @@ static struct {
     int sleeptime;
     int max_time;
     int max_mem;
+    int soft_mem;       /*!< Memory (MB) triggering soft memory pressure
+                             or 0 if disabled */
+    int high_mem;       /*!< Memory (MB) triggering high memory pressure */
+    int pressure_level; /*!< Last requested memory pressure level */
+    int pressure_mem;   /*!< Memory at the time of the last request */
 
     bor_timer_t timer;
     plan_search_t *search;
@@ -89,6 +103,71 @@ static void limitMonitorAbort(void)
         exit(-1);
 }
 
+static void limitMonitorMemPressure(int level)
+{
+    int i;
+
+    pthread_mutex_lock(&limit_monitor.lock);
+    if (limit_monitor.search)
+        planSearchMemPressure(limit_monitor.search, level);
+    for (i = 0; i < limit_monitor.ma_search_size; ++i)
+        planMASearchMemPressure(limit_monitor.ma_search[i], level);
+    pthread_mutex_unlock(&limit_monitor.lock);
+}
+
+/** Returns current resident memory in MB or -1 if it is not known */
+static int limitMonitorCurMem(void)
+{
+    FILE *fin;
+    long size, resident;
+
+    fin = fopen("/proc/self/statm", "r");
+    if (fin == NULL)
+        return -1;
+    if (fscanf(fin, "%ld %ld", &size, &resident) != 2)
+        resident = -1L;
+    fclose(fin);
+
+    if (resident < 0L)
+        return -1;
+    return (resident * sysconf(_SC_PAGESIZE)) / (1024L * 1024L);
+}
+
+static void limitMonitorCheckMemPressure(void)
+{
+    int level, cur_mem;
+
+    if (limit_monitor.soft_mem <= 0
+            || (cur_mem = limitMonitorCurMem()) < 0)
+        return;
+
+    level = PLAN_MEM_PRESSURE_NONE;
+    if (cur_mem >= limit_monitor.high_mem){
+        level = PLAN_MEM_PRESSURE_HIGH;
+    }else if (cur_mem >= limit_monitor.soft_mem){
+        level = PLAN_MEM_PRESSURE_SOFT;
+    }
+
+    if (level == PLAN_MEM_PRESSURE_NONE){
+        limit_monitor.pressure_level = PLAN_MEM_PRESSURE_NONE;
+        return;
+    }
+
+    // Repeat the request only if the pressure got higher or the memory
+    // is still growing
+    if (level <= limit_monitor.pressure_level
+            && cur_mem <= limit_monitor.pressure_mem)
+        return;
+
+    fprintf(stderr, "Memory pressure level %d (mem: %d, soft limit: %d,"
+                    " limit: %d).\n",
+            level, cur_mem, limit_monitor.soft_mem, limit_monitor.max_mem);
+    fflush(stderr);
+    limit_monitor.pressure_level = level;
+    limit_monitor.pressure_mem = cur_mem;
+    limitMonitorMemPressure(level);
+}
+
 static void *limitMonitorTh(void *_)
 {
     struct rusage usg;
@@ -123,6 +202,7 @@ static void *limitMonitorTh(void *_)
             }
         }
 
+        limitMonitorCheckMemPressure();
         sleep(limit_monitor.sleeptime);
     }
     return NULL;
@@ -135,7 +215,8 @@ static void limitMonitorSignalKill(int signum)
     limitMonitorAbort();
 }
 
-static void limitMonitorStart(int sleeptime, int max_time, int max_mem)
+static void limitMonitorStart(int sleeptime, int max_time, int max_mem,
+                              int mem_pressure)
 {
     struct sigaction s;
 
@@ -146,6 +227,13 @@ static void limitMonitorStart(int sleeptime, int max_time, int max_mem)
     // Give the hard limit monitor 2 minutes more
     limit_monitor.max_time = max_time + (2 * 60);
     limit_monitor.max_mem = max_mem;
+    limit_monitor.soft_mem = 0;
+    if (mem_pressure > 0 && mem_pressure < 100){
+        limit_monitor.soft_mem = (max_mem * mem_pressure) / 100;
+        limit_monitor.high_mem = (limit_monitor.soft_mem + max_mem) / 2;
+    }
+    limit_monitor.pressure_level = PLAN_MEM_PRESSURE_NONE;
+    limit_monitor.pressure_mem = 0;
     borTimerStart(&limit_monitor.timer);
 
     limit_monitor.search = NULL;
@@ -186,10 +274,109 @@ static void limitMonitorAddMASearch(plan_ma_search_t *ma_search)
     pthread_mutex_unlock(&limit_monitor.lock);
 }
 
+static void progressInit(progress_t *p, const options_t *o, int agent_id)
+{
+    p->max_time = o->max_time;
+    p->max_mem = o->max_mem;
+    p->agent_id = agent_id;
+    p->metrics_fd = o->metrics_fd;
+    p->search = NULL;
+    p->comm = NULL;
+    p->metrics_last_time = 0.;
+    p->metrics_last_expanded = 0L;
+}
+
+/**
+ * Writes one JSON record to the metrics stream.
+ * The whole record is written by a single write() so that records of
+ * agents running in separate threads are not interleaved.
+ */
+static void metricsWrite(progress_t *p, const plan_search_stat_t *stat,
+                         const char *event)
+{
+    char buf[1024];
+    struct timespec ts;
+    double dt, exp_per_sec;
+    size_t pool_states = 0, pool_bytes = 0, mem_bytes = 0;
+    plan_search_mem_t mem;
+    int size;
+
+    if (p->metrics_fd < 0)
+        return;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    dt = stat->elapsed_time - p->metrics_last_time;
+    exp_per_sec = 0.;
+    if (dt > 0.){
+        exp_per_sec = (stat->expanded_states - p->metrics_last_expanded) / dt;
+    }else if (stat->elapsed_time > 0.){
+        // Nothing changed since the last record (e.g., the final record
+        // right after the last progress call): report the overall rate
+        exp_per_sec = stat->expanded_states / stat->elapsed_time;
+    }
+    p->metrics_last_time = stat->elapsed_time;
+    p->metrics_last_expanded = stat->expanded_states;
+
+    if (p->search != NULL && p->search->state_pool != NULL){
+        pool_states = planStatePoolSize(p->search->state_pool);
+        pool_bytes = pool_states
+                * planStatePackerBufSize(p->search->state_pool->packer);
+        planSearchMemUsage(p->search, &mem);
+        mem_bytes = planSearchMemTotal(&mem);
+    }
+    if (p->comm != NULL)
+        mem_bytes += planMACommMemUsage(p->comm);
+
+    size = snprintf(buf, sizeof(buf),
+                    "{\"event\":\"%s\",\"agent\":%d,"
+                    "\"time\":%ld.%09ld,\"elapsed\":%.6f,"
+                    "\"steps\":%ld,\"evaluated\":%ld,\"expanded\":%ld,"
+                    "\"generated\":%ld,\"expanded_per_sec\":%.2f,"
+                    "\"open_size\":%ld,\"state_pool_states\":%lu,"
+                    "\"state_pool_bytes\":%lu,\"mem_bytes\":%lu,"
+                    "\"peak_memory_mb\":%ld,",
+                    event, p->agent_id,
+                    (long)ts.tv_sec, (long)ts.tv_nsec, stat->elapsed_time,
+                    stat->steps, stat->evaluated_states,
+                    stat->expanded_states, stat->generated_states,
+                    exp_per_sec, stat->open_size,
+                    (unsigned long)pool_states, (unsigned long)pool_bytes,
+                    (unsigned long)mem_bytes, stat->peak_memory);
+
+    if (stat->heur_count > 0){
+        size += snprintf(buf + size, sizeof(buf) - size,
+                         "\"heur_min\":%d,\"heur_avg\":%.3f,",
+                         (int)stat->heur_min, planSearchStatHeurAvg(stat));
+    }else{
+        size += snprintf(buf + size, sizeof(buf) - size,
+                         "\"heur_min\":null,\"heur_avg\":null,");
+    }
+
+    if (p->comm != NULL){
+        size += snprintf(buf + size, sizeof(buf) - size,
+                         "\"sent_msgs\":%ld,\"recv_msgs\":%ld,",
+                         p->comm->sent_msgs, p->comm->recv_msgs);
+    }
+
+    size += snprintf(buf + size, sizeof(buf) - size,
+                     "\"found\":%d}\n", stat->found);
+
+    if (write(p->metrics_fd, buf, size) != size){
+        fprintf(stderr, "%02d:: Warning: Cannot write metrics to fd %d: %s\n",
+                p->agent_id, p->metrics_fd, strerror(errno));
+        fprintf(stderr, "%02d:: Warning: Metrics stream disabled.\n",
+                p->agent_id);
+        p->metrics_fd = -1;
+    }
+}
+
 static int progress(const plan_search_stat_t *stat, void *data)
 {
     progress_t *p = (progress_t *)data;
 
+    metricsWrite(p, stat, "progress");
+
     fprintf(stderr, "%02d:: [%.3f s, %ld MB] %ld steps, %ld evaluated,"
                     " %ld expanded, %ld generated, found: %d\n",
             p->agent_id,
@@ -224,6 +411,9 @@ static void printProblem(const plan_problem_t *prob)
            planStatePackerBufSize(prob->state_pool->packer));
     printf("Size of state id: %d\n", (int)sizeof(plan_state_id_t));
     printf("Duplicate operators removed: %d\n", prob->duplicate_ops_removed);
+    printf("H^2 removed operators: %d\n", prob->h2_ops_removed);
+    printf("H^2 removed facts: %d\n", prob->h2_facts_removed);
+    printf("H^2 removed variables: %d\n", prob->h2_vars_removed);
     if (prob->agent_name != NULL){
         printf("Agent name: %s\n", prob->agent_name);
         printf("Agent ID: %d\n", prob->agent_id);
@@ -250,6 +440,20 @@ static void printProblemMA(const plan_problem_agents_t *prob)
     fflush(stdout);
 }
 
+#ifdef PLAN_TIMERS
+static void printPhaseStat(const plan_search_stat_t *stat, const char *prefix)
+{
+    int i;
+
+    for (i = 0; i < PLAN_SEARCH_PHASE_SIZE; ++i){
+        printf("%sPhase %s: %f s, %ld calls\n", prefix,
+               planSearchStatPhaseName(i),
+               planSearchStatPhaseTime(stat, i),
+               stat->phase[i].calls);
+    }
+}
+#endif /* PLAN_TIMERS */
+
 static void printStat(const plan_search_stat_t *stat, const char *prefix)
 {
     printf("%sSearch Time: %f\n", prefix, stat->elapsed_time);
@@ -258,32 +462,76 @@ static void printStat(const plan_search_stat_t *stat, const char *prefix)
     printf("%sExpanded States: %ld\n", prefix, stat->expanded_states);
     printf("%sGenerated States: %ld\n", prefix, stat->generated_states);
     printf("%sPeak Memory: %ld kb\n", prefix, stat->peak_memory);
+#ifdef PLAN_TIMERS
+    printPhaseStat(stat, prefix);
+#endif /* PLAN_TIMERS */
     fflush(stdout);
 }
 
-static void printResults(const options_t *o, int res, plan_path_t *path)
+#define MEM_KB(bytes) ((unsigned long)(((bytes) + 1023) / 1024))
+static void printMem(const plan_search_t *search, const plan_ma_comm_t *comm,
+                     const char *prefix)
+{
+    const plan_state_pool_t *pool = search->state_pool;
+    plan_search_mem_t mem;
+    size_t total, comm_mem = 0;
+    int i;
+
+    planSearchMemUsage(search, &mem);
+    total = planSearchMemTotal(&mem);
+
+    printf("%sMemory State Pool States: %lu kb\n", prefix,
+           MEM_KB(mem.state_pool));
+    printf("%sMemory State Pool Index: %lu kb\n", prefix,
+           MEM_KB(mem.state_pool_index));
+    for (i = 1; i < pool->data_size; ++i){
+        printf("%sMemory State Pool Data[%d]: %lu kb\n", prefix, i,
+               MEM_KB(planStatePoolDataMemUsage(pool, i)));
+    }
+    printf("%sMemory Open List: %lu kb\n", prefix, MEM_KB(mem.open_list));
+    printf("%sMemory Heuristic: %lu kb\n", prefix, MEM_KB(mem.heur));
+    if (comm != NULL){
+        comm_mem = planMACommMemUsage(comm);
+        total += comm_mem;
+        printf("%sMemory Comm Buffers: %lu kb\n", prefix, MEM_KB(comm_mem));
+    }
+    printf("%sMemory Accounted Total: %lu kb\n", prefix, MEM_KB(total));
+    if (search->mem_shed_count > 0){
+        printf("%sMemory Pressure Requests: %ld\n", prefix,
+               search->mem_shed_count);
+        printf("%sMemory Released: %lu kb\n", prefix,
+               MEM_KB(search->mem_shed_bytes));
+    }
+    fflush(stdout);
+}
+
+static void writePlan(const options_t *o, const plan_path_t *path)
 {
     FILE *fout;
 
+    if (strcmp(o->output, "-") == 0){
+        planPathPrint(path, stdout);
+        printf("Plan written to stdout\n");
+    }else{
+        fout = fopen(o->output, "w");
+        if (fout != NULL){
+            planPathPrint(path, fout);
+            fclose(fout);
+            printf("Plan written to `%s'\n", o->output);
+        }else{
+            fprintf(stderr, "Error: Could not plan write to `%s'\n",
+                    o->output);
+        }
+    }
+}
+
+static void printResults(const options_t *o, int res, plan_path_t *path)
+{
     if (res == PLAN_SEARCH_FOUND){
         printf("Solution found.\n");
 
-        if (o->output != NULL){
-            if (strcmp(o->output, "-") == 0){
-                planPathPrint(path, stdout);
-                printf("Plan written to stdout\n");
-            }else{
-                fout = fopen(o->output, "w");
-                if (fout != NULL){
-                    planPathPrint(path, fout);
-                    fclose(fout);
-                    printf("Plan written to `%s'\n", o->output);
-                }else{
-                    fprintf(stderr, "Error: Could not plan write to `%s'\n",
-                            o->output);
-                }
-            }
-        }
+        if (o->output != NULL)
+            writePlan(o, path);
 
         printf("Plan Cost: %d\n", (int)planPathCost(path));
         printf("Plan Length: %d\n", planPathLen(path));
@@ -420,6 +668,8 @@ static int loadProblemSeq(const options_t *o)
     int flags;
 
     flags = PLAN_PROBLEM_USE_CG;
+    if (o->prune_h2)
+        flags |= PLAN_PROBLEM_PRUNE_H2;
     problem = NULL;
     if (o->proto != NULL){
         problem = planProblemFromProto(o->proto, flags);
@@ -428,7 +678,7 @@ static int loadProblemSeq(const options_t *o)
             return -1;
         }
     }else if (o->fd != NULL){
-        problem = planProblemFromFD(o->fd);
+        problem = planProblemFromFD(o->fd, flags);
         if (problem == NULL){
             fprintf(stderr, "Error: Could not load file `%s'\n", o->fd);
             return -1;
@@ -572,10 +822,14 @@ static plan_heur_t *_heurNew(const options_t *o,
         heur = planHeurRelaxMaxNew(prob, flags);
     }else if (strcmp(name, "ff") == 0){
         heur = planHeurRelaxFFNew(prob, flags);
+    }else if (strcmp(name, "add-max-ff") == 0){
+        heur = planHeurAddMaxFFNew(prob, flags);
     }else if (strcmp(name, "dtg") == 0){
-        heur = planHeurDTGNew(prob, 0);
+        if (optionsHeurOpt(o, "all-pairs"))
+            flags |= PLAN_HEUR_DTG_ALL_PAIRS;
+        heur = planHeurDTGNew(prob, flags);
     }else if (strcmp(name, "max2") == 0){
-        heur = planHeurH2MaxNew(prob, flags);
+        heur = planHeurMax2New(prob, flags);
     }else if (strcmp(name, "lm-cut") == 0){
         heur = planHeurLMCutNew(prob, flags);
     }else if (strcmp(name, "relax-lm-cut") == 0){
@@ -588,10 +842,14 @@ static plan_heur_t *_heurNew(const options_t *o,
         if (optionsHeurOpt(o, "prune"))
             flags2 |= PLAN_LANDMARK_CACHE_PRUNE;
         heur = planHeurLMCutIncCacheNew(prob, flags, flags2);
+        planHeurLMCutIncCacheSetMaxMem(heur,
+                                       (size_t)o->ldm_cache_mem << 20);
     }else if (strcmp(name, "relax-lm-cut-inc-cache") == 0){
         if (optionsHeurOpt(o, "prune"))
             flags2 |= PLAN_LANDMARK_CACHE_PRUNE;
         heur = planHeurRelaxLMCutIncCacheNew(prob, flags, flags2);
+        planHeurRelaxLMCutIncCacheSetMaxMem(heur,
+                                            (size_t)o->ldm_cache_mem << 20);
     }else if (strcmp(name, "lm-cut2") == 0){
         heur = planHeurLMCut2New(prob, flags);
     }else if (strcmp(name, "flow") == 0){
@@ -605,7 +863,8 @@ static plan_heur_t *_heurNew(const options_t *o,
             flags |= PLAN_HEUR_POT_ALL_SYNTACTIC_STATES;
         state = planStateNew(prob->state_pool->num_vars);
         planStatePoolGetState(prob->state_pool, prob->initial_state, state);
-        heur = planHeurPotentialNew(prob, state, flags);
+        heur = planHeurPotentialEnsembleNew(prob, state, o->pot_ensemble,
+                                            o->pot_threads, flags);
         planStateDel(state);
     }else if (strcmp(name, "ma-max") == 0){
         heur = planHeurMARelaxMaxNew(prob, flags);
@@ -614,7 +873,9 @@ static plan_heur_t *_heurNew(const options_t *o,
     }else if (strcmp(name, "ma-lm-cut") == 0){
         heur = planHeurMALMCutNew(prob);
     }else if (strcmp(name, "ma-dtg") == 0){
-        heur = planHeurMADTGNew(prob);
+        if (optionsHeurOpt(o, "all-pairs"))
+            flags |= PLAN_HEUR_DTG_ALL_PAIRS;
+        heur = planHeurMADTGNew(prob, flags);
     }else if (strcmp(name, "ma-pot") == 0){
         if (optionsHeurOpt(o, "all-synt-states"))
             flags |= PLAN_HEUR_POT_ALL_SYNTACTIC_STATES;
@@ -640,6 +901,8 @@ static plan_heur_t *heurNew(const options_t *o,
     plan_heur_t *heur;
 
     heur = _heurNew(o, o->heur, prob);
+    if (heur != NULL && o->heur_cache > 0)
+        heur = planHeurCacheNew(heur, prob, o->heur_cache);
     return heur;
 }
 
@@ -669,18 +932,40 @@ static plan_heur_t *heurNewMA(const options_t *o,
     return heur;
 }
 
+static void improvedPlan(plan_search_t *search, const plan_path_t *path,
+                         plan_cost_t cost, void *data)
+{
+    const options_t *o = (const options_t *)data;
+
+    planSearchStatUpdate(&search->stat);
+    printf("Improved Plan Cost: %d (length: %d, time: %f s)\n",
+           (int)cost, planPathLen(path), search->stat.elapsed_time);
+    if (o->output != NULL)
+        writePlan(o, path);
+    fflush(stdout);
+}
+
+/**
+ * Creates the search algorithm. ma is true in the multi-agent mode.
+ */
 static plan_search_t *searchNew(const options_t *o,
                                 plan_problem_t *prob,
                                 plan_heur_t *heur,
-                                void *progress_data)
+                                void *progress_data,
+                                int ma)
 {
     plan_search_t *search = NULL;
     plan_search_params_t *params;
     plan_search_ehc_params_t ehc_params;
     plan_search_lazy_params_t lazy_params;
     plan_search_astar_params_t astar_params;
+    plan_search_rwastar_params_t rwastar_params;
+    plan_search_smastar_params_t smastar_params;
+    plan_search_bfs_params_t bfs_params;
+    size_t state_bytes;
     int use_preferred_ops = PLAN_SEARCH_PREFERRED_NONE;
     int use_pathmax = 0;
+    int i, num_threads;
 
     if (optionsSearchOpt(o, "pref")){
         use_preferred_ops = PLAN_SEARCH_PREFERRED_PREF;
@@ -695,6 +980,13 @@ static plan_search_t *searchNew(const options_t *o,
     if (strcmp(o->search, "ehc") == 0){
         planSearchEHCParamsInit(&ehc_params);
         ehc_params.use_preferred_ops = use_preferred_ops;
+        if (optionsSearchOpt(o, "par") && !heur->ma){
+            num_threads = BOR_MAX(sysconf(_SC_NPROCESSORS_ONLN), 1);
+            ehc_params.thread_heur = BOR_ALLOC_ARR(plan_heur_t *, num_threads);
+            ehc_params.thread_heur_size = num_threads;
+            for (i = 0; i < num_threads; ++i)
+                ehc_params.thread_heur[i] = heurNew(o, prob);
+        }
         params = &ehc_params.search;
 
     }else if (strcmp(o->search, "lazy") == 0){
@@ -709,6 +1001,30 @@ static plan_search_t *searchNew(const options_t *o,
         astar_params.pathmax = use_pathmax;
         params = &astar_params.search;
 
+    }else if (strcmp(o->search, "rwastar") == 0){
+        planSearchRWAStarParamsInit(&rwastar_params);
+        rwastar_params.improved_fn = improvedPlan;
+        rwastar_params.improved_data = (void *)o;
+        params = &rwastar_params.search;
+
+    }else if (strcmp(o->search, "smastar") == 0){
+        planSearchSMAStarParamsInit(&smastar_params);
+        // Rough estimate of the memory per state: the packed state, the
+        // state space node and ~64 bytes for the hash table and the
+        // SMA* per-state data.
+        state_bytes  = planStatePackerBufSize(prob->state_pool->packer);
+        state_bytes += sizeof(plan_state_space_node_t) + 64;
+        smastar_params.max_states = (o->max_mem * 1024UL * 768UL)
+                                        / state_bytes;
+        params = &smastar_params.search;
+
+    }else if (strcmp(o->search, "bfs") == 0){
+        planSearchBFSParamsInit(&bfs_params);
+        bfs_params.count_reachable = optionsSearchOpt(o, "count");
+        if (optionsSearchOpt(o, "par"))
+            bfs_params.num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+        params = &bfs_params.search;
+
     }else{
         return NULL;
     }
@@ -719,13 +1035,40 @@ static plan_search_t *searchNew(const options_t *o,
     params->progress.freq = o->progress_freq;
     params->progress.data = progress_data;
     params->prob = prob;
+    params->stubborn = optionsSearchOpt(o, "sss");
+    if (params->stubborn && ma){
+        // Other agents' public operators can interfere with the stubborn
+        // set computed only from the agent's own operators
+        fprintf(stderr, "Search Warning: Strong stubborn sets cannot be"
+                        " used in multi-agent search. Pruning is"
+                        " disabled.\n");
+        params->stubborn = 0;
+    }
+    params->symmetry = optionsSearchOpt(o, "sym");
+    if (params->symmetry && ma){
+        // Symmetries are detected on the agent's projection only and
+        // canonical states would differ among agents
+        fprintf(stderr, "Search Warning: Symmetries cannot be used in"
+                        " multi-agent search. Symmetry reduction is"
+                        " disabled.\n");
+        params->symmetry = 0;
+    }
+    params->dead_end = optionsSearchOpt(o, "de");
 
     if (strcmp(o->search, "ehc") == 0){
         search = planSearchEHCNew(&ehc_params);
+        if (ehc_params.thread_heur)
+            BOR_FREE(ehc_params.thread_heur);
     }else if (strcmp(o->search, "lazy") == 0){
         search = planSearchLazyNew(&lazy_params);
     }else if (strcmp(o->search, "astar") == 0){
         search = planSearchAStarNew(&astar_params);
+    }else if (strcmp(o->search, "rwastar") == 0){
+        search = planSearchRWAStarNew(&rwastar_params);
+    }else if (strcmp(o->search, "smastar") == 0){
+        search = planSearchSMAStarNew(&smastar_params);
+    }else if (strcmp(o->search, "bfs") == 0){
+        search = planSearchBFSNew(&bfs_params);
     }
 
     return search;
@@ -743,21 +1086,39 @@ static int singleThread(const options_t *o)
     heur = heurNew(o, problem);
 
     // Create search algorithm
-    progress_data.max_time = o->max_time;
-    progress_data.max_mem = o->max_mem;
-    progress_data.agent_id = 0;
-    search = searchNew(o, problem, heur, &progress_data);
+    progressInit(&progress_data, o, 0);
+    search = searchNew(o, problem, heur, &progress_data, 0);
+    progress_data.search = search;
     limitMonitorSetSearch(search);
 
     // Run search
+    planTraceThreadName("search");
     planPathInit(&path);
     res = planSearchRun(search, &path);
+    metricsWrite(&progress_data, &search->stat, "end");
 
     printf("\n");
     printResults(o, res, &path);
     printInitHeur(o, search);
     printf("\n");
     printStat(&search->stat, "");
+    printMem(search, NULL, "");
+    if (o->heur_cache > 0){
+        long hits, misses;
+        planHeurCacheStat(heur, &hits, &misses);
+        printf("Heur Cache Hits: %ld\n", hits);
+        printf("Heur Cache Misses: %ld\n", misses);
+    }
+    if (strcmp(o->search, "bfs") == 0){
+        printf("Reachable States: %ld\n", planSearchBFSReachable(search));
+        printf("BFS Layers: %d\n", planSearchBFSLayers(search));
+    }
+    if (optionsSearchOpt(o, "de")){
+        printf("Dead-End Conflicts: %ld\n",
+               planSearchDeadEndConflicts(search));
+        printf("Dead-End Pruned States: %ld\n",
+               planSearchDeadEndPruned(search));
+    }
     fflush(stdout);
 
     planPathFree(&path);
@@ -772,6 +1133,10 @@ static void maRun(int agent_id, ma_t *ma)
 {
     plan_ma_search_params_t params;
     plan_ma_search_t *ma_search;
+    char name[32];
+
+    sprintf(name, "agent %d", agent_id);
+    planTraceThreadName(name);
 
     planMASearchParamsInit(&params);
     params.comm = ma->comm;
@@ -785,6 +1150,7 @@ static void maRun(int agent_id, ma_t *ma)
     ma_search = planMASearchNew(&params);
     limitMonitorAddMASearch(ma_search);
     ma->res = planMASearchRun(ma_search, &ma->path);
+    metricsWrite(&ma->progress_data, &ma->search->stat, "end");
     planMASearchDel(ma_search);
 }
 
@@ -802,15 +1168,14 @@ static int maInit(ma_t *ma, int agent_id, const options_t *o,
 
     ma->agent_id = agent_id;
     ma->opts = o;
-    ma->progress_data.max_time = o->max_time;
-    ma->progress_data.max_mem = o->max_mem;
-    ma->progress_data.agent_id = agent_id;
+    progressInit(&ma->progress_data, o, agent_id);
 
     heur = heurNewMA(o, prob, globprob);
     if (heur == NULL)
         return -1;
 
-    ma->search = searchNew(o, prob, heur, &ma->progress_data);
+    ma->search = searchNew(o, prob, heur, &ma->progress_data, 1);
+    ma->progress_data.search = ma->search;
 
     planPathInit(&ma->path);
 
@@ -830,6 +1195,7 @@ static int maInit(ma_t *ma, int agent_id, const options_t *o,
         fprintf(stderr, "Error: Cannot create a communication channel.\n");
         return -1;
     }
+    ma->progress_data.comm = ma->comm;
 
     return 0;
 }
@@ -877,6 +1243,7 @@ static void maPrintResults(ma_t *ma, int size, const options_t *o)
     for (i = 0; i < size; ++i){
         printf("Agent[%d] stats:\n", ma[i].agent_id);
         printStat(&ma[i].search->stat, "    ");
+        printMem(ma[i].search, ma[i].comm, "    ");
     }
 }
 
@@ -994,13 +1361,16 @@ int main(int argc, char *argv[])
 
     if (opts->hard_limit_sleeptime > 0){
         limitMonitorStart(opts->hard_limit_sleeptime,
-                          opts->max_time, opts->max_mem);
+                          opts->max_time, opts->max_mem,
+                          opts->mem_pressure);
     }
 
     if (loadProblem(opts) != 0)
         return -1;
     if (dotGraph(opts) != 0)
         return -1;
+    if (opts->trace != NULL && planTraceStart(opts->trace) != 0)
+        return -1;
 
     if (opts->ma_unfactor){
         if (maUnfactored(opts) != 0)
@@ -1018,6 +1388,7 @@ int main(int argc, char *argv[])
 
     if (opts->hard_limit_sleeptime > 0)
         limitMonitorJoin();
+    planTraceStop();
 
     if (comm_pool != NULL)
         planMACommInprocPoolDel(comm_pool);
@@ -28,6 +28,14 @@ extern "C" {
 
 BOR_VARR_DECL(int, plan_arr_int_t, planArrInt)
 
+/**
+ * Returns number of bytes allocated by the array.
+ */
+_bor_inline size_t planArrIntMemUsage(const plan_arr_int_t *arr)
+{
+    return sizeof(int) * arr->alloc;
+}
+
 /**
  * Sorts the array.
  */
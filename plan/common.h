@@ -157,6 +157,24 @@ typedef uint32_t plan_packer_word_t;
  */
 #define PLAN_SEARCH_PREFERRED_ONLY 2
 
+
+/**
+ * No memory pressure.
+ */
+#define PLAN_MEM_PRESSURE_NONE 0
+
+/**
+ * Memory consumption reached the soft limit: caches that are cheap to
+ * rebuild should be trimmed.
+ */
+#define PLAN_MEM_PRESSURE_SOFT 1
+
+/**
+ * Memory consumption is close to the hard limit: everything that can be
+ * recomputed later should be released.
+ */
+#define PLAN_MEM_PRESSURE_HIGH 2
+
 #ifdef PLAN_DEBUG
 #include <assert.h>
 # define ASSERT(exp) assert(exp)
@@ -29,9 +29,27 @@ extern "C" {
 
 #define PLAN_FA_MUTEX_ONLY_GOAL 0x1u
 
+/**
+ * Finds all maximal fa-mutexes with respect to the given state that are
+ * not subsets of any mutex group already stored in ms and adds them to
+ * ms. If PLAN_FA_MUTEX_ONLY_GOAL is set only fa-mutexes containing a goal
+ * fact are inferred.
+ * The ILP formulation is used if an LP solver is available, otherwise
+ * it falls back to planFAMutexFindNative().
+ */
 void planFAMutexFind(const plan_problem_t *p, const plan_state_t *state,
                      plan_mutex_group_set_t *ms, unsigned flags);
 
+/**
+ * Same as planFAMutexFind() but always uses the native combinatorial
+ * search that does not depend on any LP solver. The search is split
+ * between num_threads threads.
+ */
+void planFAMutexFindNative(const plan_problem_t *p,
+                           const plan_state_t *state,
+                           plan_mutex_group_set_t *ms,
+                           unsigned flags, int num_threads);
+
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -0,0 +1,162 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+#ifndef __PLAN_H2_H__
+#define __PLAN_H2_H__
+
+#include <stdint.h>
+#include <plan/problem.h>
+#include <plan/fact_id.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * h^2 over Fact-Pair Bitsets
+ * ===========================
+ *
+ * Reachable pairs of facts are stored as a symmetric bit matrix with one
+ * row per fact (the diagonal holds reachable facts). An operator is
+ * applied to all pairs at once: the set of facts that can be added to its
+ * effect is the bitwise AND of the rows of its preconditions minus the
+ * facts of the variables it changes, so the propagation works on whole
+ * machine words instead of single fact pairs.
+ *
+ * Operator costs are handled by processing the pairs in layers of
+ * increasing cost: the pairs reached by an operator are postponed to the
+ * layer of the current cost plus the cost of the operator and the layers
+ * are merged to the matrix in increasing order. The first layer in which
+ * all goal pairs are reachable is the h^2 value.
+ *
+ * Operators with conditional effects are relaxed to a single operator
+ * adding all conditional effects and deleting only the unconditional
+ * effects, i.e., h^2 computed here is still admissible and the mutexes
+ * are still sound.
+ *
+ * The same propagation can be run backwards (see planH2InitBackward()):
+ * the operators are reversed (effects become preconditions and
+ * preconditions become effects; a variable changed by an operator without
+ * precondition on it can have any value before) and the propagation
+ * starts from all pairs consistent with the goal. The pairs not reached
+ * this way cannot be part of any state from which the goal is reachable.
+ */
+
+struct _plan_h2_op_t {
+    int *pre;        /*!< Precondition facts */
+    int pre_size;
+    int *eff;        /*!< Effect facts */
+    int eff_size;
+    int del_size;    /*!< The first .del_size effects delete all other
+                          values of their variables */
+    plan_cost_t cost;
+    int stamp;       /*!< Propagation step of the last check */
+};
+typedef struct _plan_h2_op_t plan_h2_op_t;
+
+struct _plan_h2_layer_t {
+    plan_cost_t value; /*!< Cost of the pairs in the layer */
+    uint64_t *pair;    /*!< Pairs reached in this layer */
+    char *row_dirty;   /*!< True for rows with some pair set */
+    int active;
+};
+typedef struct _plan_h2_layer_t plan_h2_layer_t;
+
+struct _plan_h2_t {
+    plan_fact_id_t fact_id;
+    int fact_size;
+    int words;           /*!< Number of words per row */
+
+    uint64_t *pair;      /*!< Bit matrix of reachable pairs */
+    uint64_t *fact;      /*!< Reachable facts (the diagonal of .pair) */
+    int *row_stamp;      /*!< Step in which the row was changed */
+    int fact_stamp;      /*!< Step in which .fact was changed */
+    int stamp;           /*!< Current propagation step */
+    int *var_beg;        /*!< First fact of the variable of each fact */
+    int *var_end;        /*!< One after the last fact of the variable */
+
+    plan_h2_op_t *op;
+    int op_size;
+    int *op_fact;        /*!< Storage for .pre and .eff of operators */
+
+    plan_h2_layer_t *layer;
+    int layer_size;
+    uint64_t *mask;      /*!< Pre-allocated row */
+};
+typedef struct _plan_h2_t plan_h2_t;
+
+/**
+ * Initializes h^2 structure for the given problem.
+ */
+void planH2Init(plan_h2_t *h2, const plan_problem_t *p);
+
+/**
+ * Initializes h^2 structure for the backward direction, i.e., with
+ * reversed operators. Only planH2MutexBackward() can be used on such
+ * structure.
+ */
+void planH2InitBackward(plan_h2_t *h2, const plan_problem_t *p);
+
+/**
+ * Frees allocated resources.
+ */
+void planH2Free(plan_h2_t *h2);
+
+/**
+ * Computes h^2 value of the goal from the state.
+ * Returns PLAN_HEUR_DEAD_END if the goal is not reachable.
+ */
+plan_cost_t planH2(plan_h2_t *h2, const plan_state_t *state,
+                   const plan_part_state_t *goal);
+
+/**
+ * Computes all pairs reachable from the state ignoring operator costs.
+ * The pairs that are not reachable are mutexes, see planH2IsMutex().
+ */
+void planH2Mutex(plan_h2_t *h2, const plan_state_t *state);
+
+/**
+ * Computes all pairs from which the goal is reachable (regardless of
+ * the operator costs). The structure must be initialized with
+ * planH2InitBackward(). The pairs that are not reached are mutexes in the
+ * sense that no state containing them can reach the goal.
+ */
+void planH2MutexBackward(plan_h2_t *h2, const plan_part_state_t *goal);
+
+/**
+ * Returns true if the pair of facts was not reached in the last call of
+ * planH2Mutex() (or planH2(), planH2MutexBackward()). A single
+ * unreachable fact is mutex with itself, two values of the same variable
+ * are always mutex.
+ */
+int planH2IsMutex(const plan_h2_t *h2,
+                  plan_var_id_t var1, plan_val_t val1,
+                  plan_var_id_t var2, plan_val_t val2);
+
+/**
+ * Returns true if the fact was reached in the last run.
+ */
+int planH2IsReachable(const plan_h2_t *h2, plan_var_id_t var, plan_val_t val);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* __PLAN_H2_H__ */
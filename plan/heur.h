@@ -87,6 +87,12 @@ struct _plan_search_t;
  */
 #define PLAN_HEUR_POT_PRINT_INIT_TIME 0x100u
 
+/**
+ * Precompute distances between all pairs of values in domain transition
+ * graphs of variables (up to some size) for dtg and ma-dtg heuristics.
+ */
+#define PLAN_HEUR_DTG_ALL_PAIRS 0x200u
+
 #define PLAN_HEUR_H2 0x1000u
 
 /** Forward declaration */
@@ -121,6 +127,12 @@ struct _plan_heur_res_t {
                              member. */
     plan_landmark_set_t landmarks; /*!< Struct containing landmarks */
 
+    /** Heuristic values filled only by heuristics computing more
+     *  estimates at once (see planHeurAddMaxFFNew()). */
+    plan_cost_t heur_add; /*!< h^add value */
+    plan_cost_t heur_max; /*!< h^max value */
+    plan_cost_t heur_ff;  /*!< Cost of the relaxed plan */
+
 };
 typedef struct _plan_heur_res_t plan_heur_res_t;
 
@@ -186,6 +198,17 @@ typedef void (*plan_heur_ma_request_fn)(plan_heur_t *heur,
                                         plan_ma_comm_t *comm,
                                         const plan_ma_msg_t *msg);
 
+/**
+ * Returns number of bytes allocated by the heuristic.
+ */
+typedef size_t (*plan_heur_mem_usage_fn)(const plan_heur_t *heur);
+
+/**
+ * Releases memory the heuristic can live without (caches) according to
+ * the given level of memory pressure (PLAN_MEM_PRESSURE_*).
+ */
+typedef void (*plan_heur_shed_mem_fn)(plan_heur_t *heur, int level);
+
 struct _plan_heur_t {
     plan_heur_del_fn del_fn;
     plan_heur_state_fn heur_state_fn;
@@ -194,6 +217,8 @@ struct _plan_heur_t {
     plan_heur_ma_node_fn heur_ma_node_fn;
     plan_heur_ma_update_fn heur_ma_update_fn;
     plan_heur_ma_request_fn heur_ma_request_fn;
+    plan_heur_mem_usage_fn mem_usage_fn;
+    plan_heur_shed_mem_fn shed_mem_fn;
 
     int ma; /*!< Set to true if planHeurMA*() functions should be used
                  instead of planHeur() */
@@ -232,6 +257,15 @@ plan_heur_t *planHeurMaxNew(const plan_problem_t *p, unsigned flags);
  */
 plan_heur_t *planHeurRelaxFFNew(const plan_problem_t *p, unsigned flags);
 
+/**
+ * Creates a relaxation heuristic computing h^add, h^max and cost of the
+ * relaxed plan (h^FF) in a single pass over the relaxed problem.
+ * All three values are stored in .heur_add, .heur_max and .heur_ff
+ * members of plan_heur_res_t, .heur is set to the h^FF value and
+ * preferred operators are the operators from the relaxed plan.
+ */
+plan_heur_t *planHeurAddMaxFFNew(const plan_problem_t *p, unsigned flags);
+
 /**
  * Creates an LM-Cut heuristics.
  */
@@ -256,6 +290,15 @@ plan_heur_t *planHeurRelaxLMCutIncCacheNew(const plan_problem_t *p,
 plan_heur_t *planHeurLMCutIncCacheNew(const plan_problem_t *p,
                                       unsigned flags, unsigned cache_flags);
 
+/**
+ * Limits the memory of the landmark cache of the incremental LM-Cut
+ * heuristic created by planHeur[Relax]LMCutIncCacheNew() to max_mem
+ * bytes (0 means unlimited). The least recently used landmark sets are
+ * evicted first. The call is ignored for any other heuristic.
+ */
+void planHeurRelaxLMCutIncCacheSetMaxMem(plan_heur_t *heur, size_t max_mem);
+void planHeurLMCutIncCacheSetMaxMem(plan_heur_t *heur, size_t max_mem);
+
 /**
  * h^2 heuristic
  */
@@ -271,6 +314,7 @@ plan_heur_t *planHeurLMCut2New(const plan_problem_t *p, unsigned flags);
 
 /**
  * Domain transition graph based heuristic.
+ * See PLAN_HEUR_DTG_ALL_PAIRS flag.
  */
 plan_heur_t *planHeurDTGNew(const plan_problem_t *p, unsigned flags);
 
@@ -287,6 +331,19 @@ plan_heur_t *planHeurPotentialNew(const plan_problem_t *p,
                                   const plan_state_t *init_state,
                                   unsigned flags);
 
+/**
+ * Potential heuristic computed as the maximum over an ensemble of
+ * {ensemble_size} potential functions. The first function is the same as
+ * in planHeurPotentialNew(), the others are optimized for states sampled
+ * by random walks from {init_state}. The LPs are solved in {num_threads}
+ * parallel threads. If {ensemble_size} is at most one, it is equivalent
+ * to planHeurPotentialNew().
+ */
+plan_heur_t *planHeurPotentialEnsembleNew(const plan_problem_t *p,
+                                          const plan_state_t *init_state,
+                                          int ensemble_size, int num_threads,
+                                          unsigned flags);
+
 /**
  * Creates an multi-agent version of max heuristic.
  */
@@ -305,8 +362,10 @@ plan_heur_t *planHeurMALMCutNew(const plan_problem_t *agent_def);
 
 /**
  * Multi-agent DTG heuristic.
+ * See PLAN_HEUR_DTG_ALL_PAIRS flag.
  */
-plan_heur_t *planHeurMADTGNew(const plan_problem_t *agent_def);
+plan_heur_t *planHeurMADTGNew(const plan_problem_t *agent_def,
+                              unsigned flags);
 
 /**
  * Multi-agent potential heuristic.
@@ -318,6 +377,25 @@ plan_heur_t *planHeurMAPotNew(const plan_problem_t *p, unsigned flags);
  */
 plan_heur_t *planHeurMAPotProjNew(const plan_problem_t *p, unsigned flags);
 
+/**
+ * Creates a caching wrapper around the heuristic {heur}.
+ * States are projected onto the variables connected with the goal in the
+ * causal graph of {p} and the heuristic values together with the
+ * preferred operators are cached for each such projection. At most
+ * {capacity} projections are stored, the least recently used ones are
+ * evicted first.
+ * The wrapper takes ownership of {heur}, i.e., {heur} is deleted together
+ * with the wrapper. Multi-agent heuristics cannot be wrapped.
+ */
+plan_heur_t *planHeurCacheNew(plan_heur_t *heur, const plan_problem_t *p,
+                              int capacity);
+
+/**
+ * Returns number of hits and misses of the heuristic created by
+ * planHeurCacheNew(). Zeros are returned for any other heuristic.
+ */
+void planHeurCacheStat(const plan_heur_t *heur, long *hits, long *misses);
+
 /**
  * Deletes heuristics object.
  */
@@ -340,6 +418,19 @@ void planHeurNode(plan_heur_t *heur, plan_state_id_t state_id,
 void planHeurState(plan_heur_t *heur, const plan_state_t *state,
                    plan_heur_res_t *res);
 
+/**
+ * Returns number of bytes allocated by internal structures of the
+ * heuristic or 0 if the heuristic does not account its memory.
+ */
+size_t planHeurMemUsage(const plan_heur_t *heur);
+
+/**
+ * Asks the heuristic to release memory according to the level of memory
+ * pressure (PLAN_MEM_PRESSURE_*).
+ * Returns number of released bytes as accounted by planHeurMemUsage().
+ */
+size_t planHeurShedMem(plan_heur_t *heur, int level);
+
 /**
  * Initialization of heuristic in ma mode.
  * This is called from within ma-search object before first call of
@@ -409,6 +500,22 @@ void _planHeurMAInit(plan_heur_t *heur,
                      plan_heur_ma_update_fn heur_ma_update_fn,
                      plan_heur_ma_request_fn heur_ma_request_fn);
 
+/**
+ * Sets callback returning memory allocated by the heuristic.
+ * This function must be called _after_ _planHeurInit().
+ * For internal use.
+ */
+void _planHeurMemUsageInit(plan_heur_t *heur,
+                           plan_heur_mem_usage_fn mem_usage_fn);
+
+/**
+ * Sets callback releasing memory under memory pressure.
+ * This function must be called _after_ _planHeurInit().
+ * For internal use.
+ */
+void _planHeurShedMemInit(plan_heur_t *heur,
+                          plan_heur_shed_mem_fn shed_mem_fn);
+
 /**
  * Frees allocated resources.
  * For internal use.
@@ -21,7 +21,6 @@
 #define __PLAN_LANDMARK_H__
 
 #include <boruvka/htable.h>
-#include <boruvka/splaytree_int.h>
 #include <plan/common.h>
 
 #ifdef __cplusplus
@@ -73,6 +72,11 @@ void planLandmarkSetInit(plan_landmark_set_t *ldms);
  */
 void planLandmarkSetFree(plan_landmark_set_t *ldms);
 
+/**
+ * Returns number of bytes allocated by the landmarks in the set.
+ */
+size_t planLandmarkSetMemUsage(const plan_landmark_set_t *ldms);
+
 /**
  * Adds one landmark to the set.
  */
@@ -80,15 +84,29 @@ void planLandmarkSetAdd(plan_landmark_set_t *ldms, int size, int *op_id);
 
 /**
  * Cache for landmark sets.
+ *
+ * Landmark sets are indexed by an open-addressing hash table keyed by
+ * the ID of the set. Each landmark is stored only once and shared
+ * (reference counted) among all sets that contain it. Records of sets
+ * and landmarks are allocated from an internal arena. If the memory
+ * budget is set (see planLandmarkCacheSetMaxMem()), the least recently
+ * used sets are evicted whenever the budget is exceeded.
  */
 struct _plan_landmark_cache_t {
     bor_htable_t *ldm_table; /*!< Hash table of landmarks */
-    bor_splaytree_int_t *ldms; /*!< Landmark sets */
+    struct _plan_landmark_cache_slot_t *index; /*!< Index of landmark sets */
+    int index_size; /*!< Number of slots in .index[], a power of two */
+    int num_sets; /*!< Number of stored landmark sets */
+    bor_list_t lru; /*!< Landmark sets, the most recently used first */
     bor_list_t prune; /*!< List of landmarks ready to be pruned */
     int prune_enable; /*!< True if cache should be pruned */
+    size_t max_mem; /*!< Memory budget in bytes, 0 means unlimited */
+
+    struct _plan_landmark_arena_t *arena; /*!< Storage of records */
 
     plan_landmark_set_t ldms_out; /*!< Set used for *Get() method */
     int ldms_alloc; /*!< Size of allocated space in .ldms_out */
+    size_t mem; /*!< Bytes taken by the stored landmarks and sets */
 };
 typedef struct _plan_landmark_cache_t plan_landmark_cache_t;
 
@@ -107,6 +125,18 @@ plan_landmark_cache_t *planLandmarkCacheNew(unsigned flags);
  */
 void planLandmarkCacheDel(plan_landmark_cache_t *);
 
+/**
+ * Sets the memory budget of the cache in bytes (0 means unlimited).
+ * Whenever the landmarks and sets stored in the cache take more memory
+ * than the budget, the least recently added or retrieved sets are
+ * evicted.
+ * The budget counts only bytes of the stored records (.mem). Memory of
+ * evicted records is not returned to the system, it is reused by new
+ * records of any size, so the memory allocated by the cache exceeds the
+ * budget only by fragmentation and by the index structures.
+ */
+void planLandmarkCacheSetMaxMem(plan_landmark_cache_t *ldmc, size_t max_mem);
+
 /**
  * Adds a landmark set to the cache under the specified ID.
  * The cache "consumes" the content of the given landmark set, so the
@@ -127,14 +157,27 @@ const plan_landmark_set_t *planLandmarkCacheGet(plan_landmark_cache_t *ldmc,
                                                 int ldmid);
 
 /**
- * Prune old used landmarks from cache.
- * Returns number of deleted landmarks.
- * Note 1: Pruning must be enabled (see PLAN_LANDMARK_CACHE_PRUNE).
- * Note 2: Landmarks are automatically pruned whenever a new landmark is
- * added, so usualy there is no need to call this function directly.
+ * Prune old used landmarks from cache, i.e., landmark sets that were
+ * already retrieved by planLandmarkCacheGet().
+ * Returns number of deleted landmark sets.
+ * Note: If pruning is enabled (see PLAN_LANDMARK_CACHE_PRUNE), landmarks
+ * are automatically pruned whenever a new landmark is added, so usualy
+ * there is no need to call this function directly.
  */
 int planLandmarkPrune(plan_landmark_cache_t *ldmc);
 
+/**
+ * Deletes all landmark sets from the cache.
+ */
+void planLandmarkCacheClear(plan_landmark_cache_t *ldmc);
+
+/**
+ * Returns number of bytes allocated by the cache, including the free
+ * space in the allocated blocks. The memory is returned to the system
+ * only by planLandmarkCacheClear().
+ */
+size_t planLandmarkCacheMemUsage(const plan_landmark_cache_t *ldmc);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif /* __cplusplus */
@@ -68,12 +68,18 @@ typedef int (*plan_list_top_fn)(plan_list_t *list,
  */
 typedef void (*plan_list_clear_fn)(plan_list_t *list);
 
+/**
+ * Returns number of bytes allocated by the list.
+ */
+typedef size_t (*plan_list_mem_usage_fn)(const plan_list_t *list);
+
 struct _plan_list_t {
     plan_list_del_fn del_fn;
     plan_list_push_fn push_fn;
     plan_list_pop_fn pop_fn;
     plan_list_top_fn top_fn;
     plan_list_clear_fn clear_fn;
+    plan_list_mem_usage_fn mem_usage_fn;
 };
 
 /**
@@ -115,6 +121,12 @@ _bor_inline int planListTop(plan_list_t *list,
  */
 _bor_inline void planListClear(plan_list_t *list);
 
+/**
+ * Returns number of bytes allocated by the list, i.e., the list structure
+ * itself and all stored elements.
+ */
+_bor_inline size_t planListMemUsage(const plan_list_t *list);
+
 /**** INLINES ****/
 _bor_inline void planListDel(plan_list_t *l)
 {
@@ -147,6 +159,11 @@ _bor_inline void planListClear(plan_list_t *l)
     l->clear_fn(l);
 }
 
+_bor_inline size_t planListMemUsage(const plan_list_t *l)
+{
+    return l->mem_usage_fn(l);
+}
+
 
 /**
  * Initializes parent object.
@@ -156,7 +173,8 @@ void _planListInit(plan_list_t *l,
                    plan_list_push_fn push_fn,
                    plan_list_pop_fn pop_fn,
                    plan_list_top_fn top_fn,
-                   plan_list_clear_fn clear_fn);
+                   plan_list_clear_fn clear_fn,
+                   plan_list_mem_usage_fn mem_usage_fn);
 
 /**
  * Frees resources of parent object.
@@ -37,12 +37,14 @@ typedef int (*plan_list_lazy_pop_fn)(plan_list_lazy_t *,
                                      plan_state_id_t *parent_state_id,
                                      plan_op_t **op);
 typedef void (*plan_list_lazy_clear_fn)(plan_list_lazy_t *);
+typedef size_t (*plan_list_lazy_mem_usage_fn)(const plan_list_lazy_t *);
 
 struct _plan_list_lazy_t {
     plan_list_lazy_del_fn del_fn;
     plan_list_lazy_push_fn push_fn;
     plan_list_lazy_pop_fn pop_fn;
     plan_list_lazy_clear_fn clear_fn;
+    plan_list_lazy_mem_usage_fn mem_usage_fn;
 };
 
 /**
@@ -97,6 +99,12 @@ _bor_inline int planListLazyPop(plan_list_lazy_t *l,
  */
 _bor_inline void planListLazyClear(plan_list_lazy_t *l);
 
+/**
+ * Returns number of bytes allocated by the list, i.e., the list structure
+ * itself and all stored elements.
+ */
+_bor_inline size_t planListLazyMemUsage(const plan_list_lazy_t *l);
+
 /**** INLINES ****/
 _bor_inline void planListLazyDel(plan_list_lazy_t *l)
 {
@@ -123,6 +131,11 @@ _bor_inline void planListLazyClear(plan_list_lazy_t *l)
     l->clear_fn(l);
 }
 
+_bor_inline size_t planListLazyMemUsage(const plan_list_lazy_t *l)
+{
+    return l->mem_usage_fn(l);
+}
+
 
 /**
  * Initializes lazy list.
@@ -131,7 +144,8 @@ void planListLazyInit(plan_list_lazy_t *l,
                       plan_list_lazy_del_fn del_fn,
                       plan_list_lazy_push_fn push_fn,
                       plan_list_lazy_pop_fn pop_fn,
-                      plan_list_lazy_clear_fn clear_fn);
+                      plan_list_lazy_clear_fn clear_fn,
+                      plan_list_lazy_mem_usage_fn mem_usage_fn);
 
 /**
  * Frees resources.
@@ -21,6 +21,7 @@
 #define __PLAN_MA_COMM_H__
 
 #include <plan/ma_msg.h>
+#include <plan/trace.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -41,6 +42,7 @@ typedef int (*plan_ma_comm_send_to_node_fn)(plan_ma_comm_t *comm, int node_id,
 typedef plan_ma_msg_t *(*plan_ma_comm_recv_fn)(plan_ma_comm_t *comm);
 typedef plan_ma_msg_t *(*plan_ma_comm_recv_block_fn)(plan_ma_comm_t *comm,
                                                      int timeout_in_ms);
+typedef size_t (*plan_ma_comm_mem_usage_fn)(const plan_ma_comm_t *comm);
 struct _plan_ma_comm_t {
     int node_id;
     int node_size;
@@ -49,6 +51,10 @@ struct _plan_ma_comm_t {
     plan_ma_comm_send_to_node_fn send_to_node_fn;
     plan_ma_comm_recv_fn recv_fn;
     plan_ma_comm_recv_block_fn recv_block_fn;
+    plan_ma_comm_mem_usage_fn mem_usage_fn;
+
+    long sent_msgs; /*!< Number of successfully sent messages */
+    long recv_msgs; /*!< Number of received messages */
 };
 
 
@@ -132,14 +138,26 @@ _bor_inline plan_ma_msg_t *planMACommRecv(plan_ma_comm_t *comm);
 _bor_inline plan_ma_msg_t *planMACommRecvBlock(plan_ma_comm_t *comm,
                                                int timeout_in_ms);
 
+/**
+ * Returns number of bytes allocated by the communication channel for
+ * buffering messages.
+ */
+_bor_inline size_t planMACommMemUsage(const plan_ma_comm_t *comm);
+
 
 void _planMACommInit(plan_ma_comm_t *comm, int agent_id, int agent_size,
                      plan_ma_comm_del_fn del_fn,
                      plan_ma_comm_send_to_node_fn send_to_node_fn,
                      plan_ma_comm_recv_fn recv_fn,
-                     plan_ma_comm_recv_block_fn recv_block_fn);
+                     plan_ma_comm_recv_block_fn recv_block_fn,
+                     plan_ma_comm_mem_usage_fn mem_usage_fn);
 
 /**** INLINES: ****/
+_bor_inline size_t planMACommMemUsage(const plan_ma_comm_t *comm)
+{
+    return comm->mem_usage_fn(comm);
+}
+
 _bor_inline void planMACommDel(plan_ma_comm_t *comm)
 {
     comm->del_fn(comm);
@@ -172,7 +190,16 @@ _bor_inline int planMACommSendToAll(plan_ma_comm_t *comm,
 _bor_inline int planMACommSendToNode(plan_ma_comm_t *comm, int node_id,
                                      const plan_ma_msg_t *msg)
 {
-    return comm->send_to_node_fn(comm, node_id, msg);
+    if (comm->send_to_node_fn(comm, node_id, msg) != 0)
+        return -1;
+    ++comm->sent_msgs;
+    if (plan_trace_enabled){
+        planTraceInstant("ma-msg", "send", "to", node_id,
+                         "type", planMAMsgType(msg),
+                         "subtype", planMAMsgSubType(msg),
+                         "size", planMAMsgPackedSize(msg));
+    }
+    return 0;
 }
 
 _bor_inline int planMACommSendInRing(plan_ma_comm_t *comm,
@@ -183,17 +210,47 @@ _bor_inline int planMACommSendInRing(plan_ma_comm_t *comm,
     return planMACommSendToNode(comm, node_id, msg);
 }
 
+/**
+ * Bookkeeping of a received message.
+ */
+_bor_inline void _planMACommRecvd(plan_ma_comm_t *comm,
+                                  const plan_ma_msg_t *msg)
+{
+    ++comm->recv_msgs;
+    if (plan_trace_enabled){
+        planTraceInstant("ma-msg", "recv", "from", planMAMsgAgent(msg),
+                         "type", planMAMsgType(msg),
+                         "subtype", planMAMsgSubType(msg),
+                         "size", planMAMsgPackedSize(msg));
+    }
+}
+
 _bor_inline plan_ma_msg_t *planMACommRecv(plan_ma_comm_t *comm)
 {
-    if (comm->recv_fn)
-        return comm->recv_fn(comm);
-    return comm->recv_block_fn(comm, 0);
+    plan_ma_msg_t *msg;
+
+    if (comm->recv_fn){
+        msg = comm->recv_fn(comm);
+    }else{
+        msg = comm->recv_block_fn(comm, 0);
+    }
+    if (msg != NULL)
+        _planMACommRecvd(comm, msg);
+    return msg;
 }
 
 _bor_inline plan_ma_msg_t *planMACommRecvBlock(plan_ma_comm_t *comm,
                                                int timeout_in_ms)
 {
-    return comm->recv_block_fn(comm, timeout_in_ms);
+    plan_ma_msg_t *msg;
+
+    planTraceBeginArgs("ma-msg", "recv-wait", "timeout", timeout_in_ms,
+                       NULL, 0);
+    msg = comm->recv_block_fn(comm, timeout_in_ms);
+    planTraceEnd("ma-msg", "recv-wait");
+    if (msg != NULL)
+        _planMACommRecvd(comm, msg);
+    return msg;
 }
 
 #ifdef __cplusplus
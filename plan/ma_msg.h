@@ -305,6 +305,11 @@ void *planMAMsgPacked(const plan_ma_msg_t *msg, int *size);
  */
 int planMAMsgPackToBuf(const plan_ma_msg_t *msg, void *buf, int *size);
 
+/**
+ * Returns size of the packed message in bytes (without packing it).
+ */
+int planMAMsgPackedSize(const plan_ma_msg_t *msg);
+
 /**
  * Returns a new message unpacked from the given buffer.
  */
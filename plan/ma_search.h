@@ -68,6 +68,12 @@ int planMASearchRun(plan_ma_search_t *search, plan_path_t *path);
  */
 void planMASearchAbort(plan_ma_search_t *search);
 
+/**
+ * Requests release of memory by the underlying search (can be called from
+ * other thread). See planSearchMemPressure().
+ */
+void planMASearchMemPressure(plan_ma_search_t *search, int level);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -149,6 +149,43 @@ _bor_inline double planPotStatePot(const plan_pot_t *pot,
                                    const plan_state_t *state);
 
 
+/**
+ * Ensemble of potential functions evaluated as the maximum over them.
+ * The potentials are stored as a table with one row per LP variable so
+ * that the values of all functions for a single fact are stored
+ * contiguously.
+ */
+struct _plan_pot_ensemble_t {
+    int size;    /*!< Number of potential functions */
+    double *pot; /*!< pot->lp_var_size x size table of potentials */
+    double *sum; /*!< Pre-allocated accumulator of length size */
+};
+typedef struct _plan_pot_ensemble_t plan_pot_ensemble_t;
+
+/**
+ * Computes an ensemble of states_size potential functions, i'th function
+ * is optimized for states[i], or for the objective pot was initialized
+ * with (pot->prob.state_coef) if states[i] is NULL.
+ * The LPs are distributed among num_threads threads, each thread keeps
+ * its own LP and changes only its objective between the solves.
+ */
+void planPotEnsembleInit(plan_pot_ensemble_t *ens, const plan_pot_t *pot,
+                         plan_state_t * const *states, int states_size,
+                         int num_threads);
+
+/**
+ * Frees allocated resources.
+ */
+void planPotEnsembleFree(plan_pot_ensemble_t *ens);
+
+/**
+ * Returns the maximal potential of the state over all functions.
+ */
+_bor_inline double planPotEnsembleStatePot(const plan_pot_ensemble_t *ens,
+                                           const plan_pot_t *pot,
+                                           const plan_state_t *state);
+
+
 /**
  * Initializes agent potential structure.
  */
@@ -184,6 +221,32 @@ _bor_inline double planPotStatePot(const plan_pot_t *pot,
     return p;
 }
 
+_bor_inline double planPotEnsembleStatePot(const plan_pot_ensemble_t *ens,
+                                           const plan_pot_t *pot,
+                                           const plan_state_t *state)
+{
+    const double *row;
+    double *sum = ens->sum;
+    double p;
+    int i, j, id;
+
+    for (j = 0; j < ens->size; ++j)
+        sum[j] = 0.;
+    for (i = 0; i < pot->var_size; ++i){
+        if (i == pot->ma_privacy_var)
+            continue;
+        id = pot->var[i].lp_var_id[planStateGet(state, i)];
+        row = ens->pot + (size_t)id * ens->size;
+        for (j = 0; j < ens->size; ++j)
+            sum[j] += row[j];
+    }
+
+    p = sum[0];
+    for (j = 1; j < ens->size; ++j)
+        p = BOR_MAX(p, sum[j]);
+    return p;
+}
+
 #else /* PLAN_LP */
 
 void planNOPot(void);
@@ -55,6 +55,13 @@ extern "C" {
 #define PLAN_PROBLEM_NUM_AGENTS(num) \
     ((unsigned)(((unsigned char)(num)) << 4))
 
+/**
+ * Prunes unreachable facts and useless operators using forward and
+ * backward h^2 mutexes, see planProblemPruneH2().
+ * The flag is ignored for agents' problem definitions.
+ */
+#define PLAN_PROBLEM_PRUNE_H2 0x1000u
+
 struct _plan_problem_private_val_t {
     int var;
     int val;
@@ -75,6 +82,12 @@ struct _plan_problem_t {
     plan_succ_gen_t *succ_gen;     /*!< Successor generator */
     int duplicate_ops_removed;     /*!< Number of duplicate operators that
                                         were removed */
+    int h2_ops_removed;            /*!< Number of operators removed by
+                                        h^2 pruning */
+    int h2_facts_removed;          /*!< Number of facts removed by h^2
+                                        pruning */
+    int h2_vars_removed;           /*!< Number of variables removed by h^2
+                                        pruning */
 
     /** Fllowing data are available only in case of agent problem defintion: */
     char *agent_name;   /*!< Name of the corresponding agent */
@@ -102,8 +115,9 @@ plan_problem_t *planProblemFromPDDL(const char *domain_pddl,
                                     unsigned flags);
 /**
  * Loads planning problem from the fast-downward file.
+ * Only PLAN_PROBLEM_PRUNE_H2 flag is considered.
  */
-plan_problem_t *planProblemFromFD(const char *fn);
+plan_problem_t *planProblemFromFD(const char *fn, unsigned flags);
 
 /**
  * Loads problem definition from protbuf format.
@@ -171,6 +185,25 @@ void planProblemAgentsDotGraph(const plan_problem_agents_t *agents,
 _bor_inline int planProblemCheckGoal(plan_problem_t *p,
                                      plan_state_id_t state_id);
 
+/**
+ * Prunes the problem using h^2 mutexes:
+ *   1. operators with mutex preconditions (forward h^2 from the initial
+ *      state) are removed and so are conditional effects whose
+ *      conditions are mutex with the precondition of the operator,
+ *   2. operators whose application leads to a pair of facts from which
+ *      the goal is not reachable (backward h^2) are removed,
+ *   3. both steps are repeated until no operator is removed,
+ *   4. unreachable values are removed from the domains of variables and
+ *      variables with only one value left are removed completely.
+ * Values and variables are renumbered, the state pool is re-created and
+ * the successor generator (if already built) too. If var_order is
+ * non-NULL it is updated to the new variable IDs.
+ * Agents' problems (with projected operators or a privacy variable) are
+ * left untouched.
+ * The problem must not be packed yet (see planProblemPack()).
+ */
+void planProblemPruneH2(plan_problem_t *p, plan_var_id_t *var_order);
+
 /**
  * Pack part-states and operators.
  */
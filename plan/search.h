@@ -31,6 +31,7 @@
 #include <plan/ma_comm.h>
 #include <plan/search_stat.h>
 #include <plan/search_applicable_ops.h>
+#include <plan/symmetry.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -72,6 +73,22 @@ struct _plan_search_params_t {
                             planSearchDel() */
 
     plan_problem_t *prob; /*!< Problem definition */
+
+    int stubborn; /*!< True if applicable operators should be pruned using
+                       strong stubborn sets (partial-order reduction). The
+                       pruning preserves optimality and it is
+                       automatically switched off if it does not prune
+                       enough operators. It must not be used in
+                       multi-agent search. */
+    int symmetry; /*!< True if states should be mapped to canonical
+                       representatives of their symmetry classes (orbit
+                       search). Plans are reconstructed in the original
+                       state space. It must not be used in multi-agent
+                       search. */
+    int dead_end; /*!< True if dead ends reported by the heuristic should
+                       be generalized to partial states (conflicts) and
+                       states containing a learned conflict should be
+                       pruned without calling the heuristic. */
 };
 typedef struct _plan_search_params_t plan_search_params_t;
 
@@ -83,6 +100,27 @@ typedef struct _plan_search_params_t plan_search_params_t;
 struct _plan_search_ehc_params_t {
     plan_search_params_t search; /*!< Common parameters */
     int use_preferred_ops; /*!< One of PLAN_SEARCH_PREFERRED_* constants */
+
+    plan_heur_t **thread_heur; /*!< If set, the breadth-first improvement
+                                    search proceeds layer by layer and the
+                                    heuristic values of each layer are
+                                    computed in parallel, one thread per
+                                    heuristic in this array. The first
+                                    improving state in the order of
+                                    generation is always chosen so the
+                                    result does not depend on the number
+                                    of threads. The heuristics must be
+                                    distinct from .search.heur and they
+                                    are deleted with the search if
+                                    .search.heur_del is set.
+                                    Heuristics computed from the search
+                                    state space (e.g., the incremental
+                                    LM-Cut or goal-count) or multi-agent
+                                    heuristics must be called from the
+                                    search thread, so with them the
+                                    layers are evaluated sequentially
+                                    (and a warning is printed). */
+    int thread_heur_size;      /*!< Number of elements in .thread_heur */
 };
 typedef struct _plan_search_ehc_params_t plan_search_ehc_params_t;
 
@@ -144,6 +182,145 @@ void planSearchAStarParamsInit(plan_search_astar_params_t *p);
 plan_search_t *planSearchAStarNew(const plan_search_astar_params_t *params);
 
 
+/**
+ * Anytime Restarting Weighted A* Search Algorithm
+ * ------------------------------------------------
+ *
+ * Runs weighted A* with a decreasing sequence of weights. Each time a
+ * plan is found, the search is restarted from the initial state with the
+ * next weight and the cost of the plan is used as an upper bound for all
+ * subsequent iterations. The state space (g-values and heuristic values)
+ * is shared between iterations so the heuristic is computed at most once
+ * per state. Once the last weight is reached, the search continues
+ * without restarts until the open-list is exhausted which means that the
+ * last plan found is optimal.
+ */
+
+/**
+ * Callback called whenever a plan cheaper than the previous one is found.
+ */
+typedef void (*plan_search_improved_plan_fn)(plan_search_t *search,
+                                             const plan_path_t *path,
+                                             plan_cost_t cost,
+                                             void *userdata);
+
+struct _plan_search_rwastar_params_t {
+    plan_search_params_t search; /*!< Common parameters */
+
+    const int *weight; /*!< Sequence of weights, if set to NULL the
+                            default sequence 5, 3, 2, 1 is used. */
+    int weight_size;   /*!< Number of elements in .weight */
+
+    plan_search_improved_plan_fn improved_fn; /*!< Improved plan callback */
+    void *improved_data; /*!< User data for .improved_fn */
+};
+typedef struct _plan_search_rwastar_params_t plan_search_rwastar_params_t;
+
+/**
+ * Initializes parameters of RWA* algorithm.
+ */
+void planSearchRWAStarParamsInit(plan_search_rwastar_params_t *p);
+
+/**
+ * Creates a new instance of the restarting weighted A* search algorithm.
+ */
+plan_search_t *planSearchRWAStarNew(const plan_search_rwastar_params_t *params);
+
+
+/**
+ * Memory-Bounded A* Search Algorithm (SMA*)
+ * ------------------------------------------
+ *
+ * A* that keeps number of states stored in the state pool within the
+ * given budget. Whenever the budget is exceeded, the leaves with the
+ * highest f-value are evicted from the open-list (and removed from the
+ * state pool) and their f-values are backed up into their parents which
+ * are re-inserted into the open-list so that the forgotten subtrees can
+ * be regenerated later. The budget can be temporarily exceeded by the
+ * successors of one expanded state or if there is no leaf that could be
+ * evicted.
+ * IDs of the removed states are reused by the state pool, therefore
+ * heuristics that keep data by state IDs (the incremental LM-Cut
+ * heuristics) cannot be used with this algorithm. For the same reason it
+ * cannot be used in multi-agent search where agents refer to states of
+ * each other by their IDs.
+ */
+struct _plan_search_smastar_params_t {
+    plan_search_params_t search; /*!< Common parameters */
+
+    size_t max_states; /*!< Maximal number of states kept in the state
+                            pool, 0 means no limit */
+};
+typedef struct _plan_search_smastar_params_t plan_search_smastar_params_t;
+
+/**
+ * Initializes parameters of SMA* algorithm.
+ */
+void planSearchSMAStarParamsInit(plan_search_smastar_params_t *p);
+
+/**
+ * Creates a new instance of the memory-bounded A* search algorithm.
+ */
+plan_search_t *planSearchSMAStarNew(const plan_search_smastar_params_t *params);
+
+/**
+ * Returns number of states evicted from memory so far.
+ */
+long planSearchSMAStarEvicted(const plan_search_t *search);
+
+
+/**
+ * Breadth-First Search
+ * ---------------------
+ *
+ * Blind layered breadth-first search with eager duplicate detection.
+ * Instead of the state pool, each layer is stored as a sorted array of
+ * packed states compressed by the prefix shared with the previous state.
+ * Successors of a layer are sorted and duplicates are removed by a
+ * sorted merge with previous layers that seeks over blocks of the layers
+ * using their index, so only the parts of the layers overlapping with the
+ * successors are decoded. The expansion, sorting and duplicate detection
+ * of a layer can be split between several threads.
+ *
+ * The found plan is the shortest one in the number of operators, i.e., it
+ * is optimal only for unit-cost problems. The plan is reconstructed by
+ * searching for predecessors in the stored layers, only the states on the
+ * plan are inserted into the state pool.
+ */
+struct _plan_search_bfs_params_t {
+    plan_search_params_t search; /*!< Common parameters */
+
+    int count_reachable; /*!< If true, the whole reachable state space is
+                              explored even if a goal is found earlier.
+                              The shortest plan is still returned if any
+                              goal state is reachable. */
+    int num_threads;     /*!< Number of threads expanding each layer
+                              (default: 1) */
+};
+typedef struct _plan_search_bfs_params_t plan_search_bfs_params_t;
+
+/**
+ * Initializes parameters of BFS algorithm.
+ */
+void planSearchBFSParamsInit(plan_search_bfs_params_t *p);
+
+/**
+ * Creates a new instance of the breadth-first search algorithm.
+ */
+plan_search_t *planSearchBFSNew(const plan_search_bfs_params_t *params);
+
+/**
+ * Returns number of distinct reachable states found so far.
+ */
+long planSearchBFSReachable(const plan_search_t *search);
+
+/**
+ * Returns number of layers stored so far (including the layer with the
+ * initial state).
+ */
+int planSearchBFSLayers(const plan_search_t *search);
+
+
 
 /**
  * Common Functions
@@ -270,6 +447,61 @@ const plan_state_t *planSearchLoadState(plan_search_t *search,
 plan_state_space_node_t *planSearchLoadNode(plan_search_t *search,
                                             plan_state_id_t state_id);
 
+/**
+ * Returns number of dead-end conflicts learned so far (see
+ * plan_search_params_t.dead_end).
+ */
+long planSearchDeadEndConflicts(const plan_search_t *search);
+
+/**
+ * Returns number of states that were pruned by the learned dead-end
+ * conflicts.
+ */
+long planSearchDeadEndPruned(const plan_search_t *search);
+
+/**
+ * Memory used by the search split by subsystems (in bytes).
+ */
+struct _plan_search_mem_t {
+    size_t state_pool;       /*!< Packed states */
+    size_t state_pool_index; /*!< Hash table over the packed states */
+    size_t state_pool_data;  /*!< All other per-state data arrays reserved
+                                  in the state pool (state space nodes,
+                                  algorithm-specific data, ...) */
+    size_t open_list;        /*!< Open-list and other structures of the
+                                  search algorithm */
+    size_t heur;             /*!< Internals of the heuristic function */
+};
+typedef struct _plan_search_mem_t plan_search_mem_t;
+
+/**
+ * Fills mem with the current memory usage of the search.
+ * The heuristic is accounted only if it reports its memory usage (see
+ * planHeurMemUsage()).
+ */
+void planSearchMemUsage(const plan_search_t *search, plan_search_mem_t *mem);
+
+/**
+ * Returns sum of all items of mem.
+ */
+size_t planSearchMemTotal(const plan_search_mem_t *mem);
+
+/**
+ * Requests release of memory according to the level of memory pressure
+ * (PLAN_MEM_PRESSURE_*). The request is handled by planSearchRun()
+ * between two steps, so this function can be called from other thread
+ * (similarly to planSearchAbort()).
+ */
+void planSearchMemPressure(plan_search_t *search, int level);
+
+/**
+ * Immediately releases memory according to the level of memory pressure.
+ * Currently, the heuristic is asked to shed its caches.
+ * Must not be called from other thread than the one running the search.
+ * Returns number of released bytes.
+ */
+size_t planSearchShedMem(plan_search_t *search, int level);
+
 /**
  * Internals
  * ----------
@@ -311,6 +543,13 @@ typedef void (*plan_search_insert_node_fn)(plan_search_t *,
  */
 typedef plan_cost_t (*plan_search_top_node_cost_fn)(const plan_search_t *s);
 
+/**
+ * Returns number of bytes allocated by the algorithm itself, i.e., by the
+ * open-list and other internal structures that are not stored in the
+ * state pool.
+ */
+typedef size_t (*plan_search_mem_usage_fn)(const plan_search_t *s);
+
 struct _plan_search_block_t {
     pthread_mutex_t lock;
     pthread_cond_t cond;
@@ -318,11 +557,20 @@ struct _plan_search_block_t {
 };
 typedef struct _plan_search_block_t plan_search_block_t;
 
+/** Forward declaration of strong stubborn sets pruning */
+typedef struct _plan_search_stubborn_t plan_search_stubborn_t;
+
+/** Forward declaration of dead-end learning */
+typedef struct _plan_search_dead_end_t plan_search_dead_end_t;
+
 /**
  * Common base struct for all search algorithms.
  */
 struct _plan_search_t {
     int abort;
+    int mem_pressure;       /*!< Pending PLAN_MEM_PRESSURE_* request */
+    long mem_shed_count;    /*!< Number of handled memory pressure requests */
+    size_t mem_shed_bytes;  /*!< Bytes released under memory pressure */
     plan_heur_t *heur;      /*!< Heuristic function */
     int heur_del;           /*!< True if .heur should be deleted */
     plan_state_id_t initial_state;
@@ -337,6 +585,7 @@ struct _plan_search_t {
     plan_search_step_fn step_fn;
     plan_search_insert_node_fn insert_node_fn;
     plan_search_top_node_cost_fn top_node_cost_fn;
+    plan_search_mem_usage_fn mem_usage_fn;
     plan_search_poststep_fn poststep_fn;
     void *poststep_data;
     plan_search_expanded_node_fn expanded_node_fn;
@@ -350,6 +599,12 @@ struct _plan_search_t {
     plan_state_id_t state_id;        /*!< ID of .state -- used for caching*/
     plan_search_stat_t stat;
     plan_search_applicable_ops_t app_ops;
+    plan_search_stubborn_t *stubborn; /*!< Pruning of .app_ops or NULL */
+    plan_search_dead_end_t *dead_end; /*!< Learned dead ends or NULL */
+    plan_symmetry_t *symmetry;  /*!< Symmetries of the problem or NULL */
+    plan_state_t *sym_state;    /*!< Preallocated state for symmetries */
+    plan_state_id_t sym_initial_state; /*!< Original (non-canonical)
+                                            initial state */
 
     plan_state_id_t goal_state; /*!< The found state satisfying the goal */
 };
@@ -365,7 +620,8 @@ void _planSearchInit(plan_search_t *search,
                      plan_search_init_step_fn init_step_fn,
                      plan_search_step_fn step_fn,
                      plan_search_insert_node_fn insert_node_fn,
-                     plan_search_top_node_cost_fn top_node_cost_fn);
+                     plan_search_top_node_cost_fn top_node_cost_fn,
+                     plan_search_mem_usage_fn mem_usage_fn);
 
 /**
  * Frees allocated resources.
@@ -381,6 +637,15 @@ void _planSearchFree(plan_search_t *search);
 int _planSearchFindApplicableOps(plan_search_t *search,
                                  plan_state_id_t state_id);
 
+/**
+ * Applies operator to the state and returns ID of the resulting state.
+ * If symmetries are used, the canonical representative of the resulting
+ * state is returned instead.
+ */
+plan_state_id_t _planSearchNextState(plan_search_t *search,
+                                     plan_op_t *op,
+                                     plan_state_id_t state_id);
+
 /**
  * Returns PLAN_SEARCH_CONT if the heuristic value was computed.
  * Any other status should lead to immediate exit from the search algorithm
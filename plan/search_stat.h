@@ -21,11 +21,38 @@
 #define __PLAN_SEARCH_STAT_H__
 
 #include <boruvka/timer.h>
+#include <plan/common.h>
+
+#ifdef PLAN_TIMERS
+# include <time.h>
+#endif /* PLAN_TIMERS */
 
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
+/**
+ * Phases of the search that are timed if the library is compiled with
+ * TIMERS=yes (i.e., PLAN_TIMERS is defined in plan/config.h). Otherwise,
+ * the timing functions below are empty and the counters stay zero.
+ */
+#define PLAN_SEARCH_PHASE_SUCC_GEN   0 /*!< Finding applicable operators */
+#define PLAN_SEARCH_PHASE_STATE_POOL 1 /*!< Creating and inserting states */
+#define PLAN_SEARCH_PHASE_HEUR       2 /*!< Heuristic evaluation */
+#define PLAN_SEARCH_PHASE_LIST       3 /*!< Pushing to and popping from
+                                            open-list */
+#define PLAN_SEARCH_PHASE_SIZE       4
+
+/**
+ * Time and calls accumulated in one phase.
+ */
+struct _plan_search_stat_phase_t {
+    long calls;   /*!< Number of finished calls */
+    long time_ns; /*!< Overall time in nanoseconds */
+    long start_ns; /*!< Start of the current call */
+};
+typedef struct _plan_search_stat_phase_t plan_search_stat_phase_t;
+
 /**
  * Struct for statistics from search.
  */
@@ -39,6 +66,12 @@ struct _plan_search_stat_t {
     long generated_states;
     long peak_memory;
     int found;
+    long open_size;       /*!< Current number of entries in the open-list */
+    plan_cost_t heur_min; /*!< The lowest heuristic value (dead ends are
+                               not counted) */
+    double heur_sum;      /*!< Sum of heuristic values (without dead ends) */
+    long heur_count;      /*!< Number of values summed in .heur_sum */
+    plan_search_stat_phase_t phase[PLAN_SEARCH_PHASE_SIZE];
 };
 typedef struct _plan_search_stat_t plan_search_stat_t;
 
@@ -89,6 +122,56 @@ _bor_inline void planSearchStatSetFound(plan_search_stat_t *stat);
  */
 _bor_inline void planSearchStatSetNotFound(plan_search_stat_t *stat);
 
+/**
+ * Records a heuristic value of an evaluated state. Dead ends should not be
+ * recorded.
+ */
+_bor_inline void planSearchStatAddHeur(plan_search_stat_t *stat,
+                                       plan_cost_t heur);
+
+/**
+ * Returns average of the recorded heuristic values or 0 if no value was
+ * recorded.
+ */
+_bor_inline double planSearchStatHeurAvg(const plan_search_stat_t *stat);
+
+/**
+ * Increments number of entries in the open-list by one.
+ */
+_bor_inline void planSearchStatIncOpen(plan_search_stat_t *stat);
+
+/**
+ * Decrements number of entries in the open-list by one.
+ */
+_bor_inline void planSearchStatDecOpen(plan_search_stat_t *stat);
+
+/**
+ * Sets number of entries in the open-list.
+ */
+_bor_inline void planSearchStatSetOpen(plan_search_stat_t *stat, long size);
+
+/**
+ * Returns a short name of the phase.
+ */
+const char *planSearchStatPhaseName(int phase);
+
+/**
+ * Returns time in seconds spent in the phase.
+ */
+_bor_inline double planSearchStatPhaseTime(const plan_search_stat_t *stat,
+                                           int phase);
+
+/**
+ * Marks the beginning of the phase. Every call must be paired with
+ * planSearchStatPhaseStop() and a phase must not be nested in itself.
+ */
+_bor_inline void planSearchStatPhaseStart(plan_search_stat_t *stat, int phase);
+
+/**
+ * Marks the end of the phase.
+ */
+_bor_inline void planSearchStatPhaseStop(plan_search_stat_t *stat, int phase);
+
 /**** INLINES ****/
 _bor_inline void planSearchStatIncEvaluatedStates(plan_search_stat_t *stat)
 {
@@ -115,6 +198,72 @@ _bor_inline void planSearchStatSetNotFound(plan_search_stat_t *stat)
     stat->found = 0;
 }
 
+_bor_inline void planSearchStatAddHeur(plan_search_stat_t *stat,
+                                       plan_cost_t heur)
+{
+    stat->heur_min = BOR_MIN(stat->heur_min, heur);
+    stat->heur_sum += heur;
+    ++stat->heur_count;
+}
+
+_bor_inline double planSearchStatHeurAvg(const plan_search_stat_t *stat)
+{
+    if (stat->heur_count == 0)
+        return 0.;
+    return stat->heur_sum / stat->heur_count;
+}
+
+_bor_inline void planSearchStatIncOpen(plan_search_stat_t *stat)
+{
+    ++stat->open_size;
+}
+
+_bor_inline void planSearchStatDecOpen(plan_search_stat_t *stat)
+{
+    --stat->open_size;
+}
+
+_bor_inline void planSearchStatSetOpen(plan_search_stat_t *stat, long size)
+{
+    stat->open_size = size;
+}
+
+_bor_inline double planSearchStatPhaseTime(const plan_search_stat_t *stat,
+                                           int phase)
+{
+    return stat->phase[phase].time_ns / 1E9;
+}
+
+#ifdef PLAN_TIMERS
+_bor_inline long _planSearchStatNow(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000000L + t.tv_nsec;
+}
+
+_bor_inline void planSearchStatPhaseStart(plan_search_stat_t *stat, int phase)
+{
+    stat->phase[phase].start_ns = _planSearchStatNow();
+}
+
+_bor_inline void planSearchStatPhaseStop(plan_search_stat_t *stat, int phase)
+{
+    plan_search_stat_phase_t *p = stat->phase + phase;
+    p->time_ns += _planSearchStatNow() - p->start_ns;
+    ++p->calls;
+}
+
+#else /* PLAN_TIMERS */
+_bor_inline void planSearchStatPhaseStart(plan_search_stat_t *stat, int phase)
+{
+}
+
+_bor_inline void planSearchStatPhaseStop(plan_search_stat_t *stat, int phase)
+{
+}
+#endif /* PLAN_TIMERS */
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -97,6 +97,15 @@ void planStatePackerUnpack(const plan_state_packer_t *p,
 void planStatePackerPackPartState(const plan_state_packer_t *p,
                                   plan_part_state_t *part_state);
 
+/**
+ * Returns the position of the word of the packed buffer where the value of
+ * the variable is stored (pos) and the mask of bits the value occupies
+ * within the word (mask).
+ */
+void planStatePackerVarField(const plan_state_packer_t *p,
+                             plan_var_id_t var,
+                             int *pos, plan_packer_word_t *mask);
+
 /**
  * Just alternative call of planStatePackerPackPartState().
  */
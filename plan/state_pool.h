@@ -34,6 +34,19 @@
 extern "C" {
 #endif /* __cplusplus */
 
+/**
+ * Initial value of an element of a data array, needed for resetting the
+ * data of removed states.
+ */
+struct _plan_state_pool_data_init_t {
+    size_t el_size;             /*!< Size of an element */
+    bor_extarr_el_init_fn fn;   /*!< Init function (may be NULL) */
+    const void *data;           /*!< User data for .fn */
+    void *el;                   /*!< Copy of the initial element if .fn is
+                                     NULL */
+};
+typedef struct _plan_state_pool_data_init_t plan_state_pool_data_init_t;
+
 /**
  * Main struct managing all states and its corresponding informations.
  */
@@ -42,9 +55,16 @@ struct _plan_state_pool_t {
 
     plan_state_packer_t *packer;
     bor_extarr_t **data;    /*!< Data arrays */
+    plan_state_pool_data_init_t *data_init; /*!< Initial values of data
+                                                 arrays */
     int data_size;          /*!< Number of data arrays */
     bor_htable_t *htable;   /*!< Hash table for uniqueness of states. */
-    size_t num_states;
+    size_t num_states;      /*!< Number of allocated state IDs, i.e., all
+                                 IDs are lower than this number */
+    plan_state_id_t *free_id; /*!< IDs of removed states that are reused
+                                   by the following insertions */
+    size_t free_id_size;
+    size_t free_id_alloc;
 };
 typedef struct _plan_state_pool_t plan_state_pool_t;
 
@@ -96,6 +116,32 @@ plan_state_id_t planStatePoolInsert(plan_state_pool_t *pool,
 plan_state_id_t planStatePoolInsertPacked(plan_state_pool_t *pool,
                                           const void *packed_state);
 
+/**
+ * Removes the state from the pool, i.e., the state cannot be found
+ * anymore, all data corresponding to the state are reset to their initial
+ * values and the state ID will be reused by some later insertion.
+ * Returns 0 on success, -1 if the state is not in the pool.
+ */
+int planStatePoolRemove(plan_state_pool_t *pool, plan_state_id_t sid);
+
+/**
+ * Returns number of states that are currently stored in the pool, i.e.,
+ * number of allocated IDs minus number of removed states.
+ */
+_bor_inline size_t planStatePoolSize(const plan_state_pool_t *pool);
+
+/**
+ * Returns number of bytes allocated by the data array.
+ * The data array with ID 0 always holds the packed states.
+ */
+size_t planStatePoolDataMemUsage(const plan_state_pool_t *pool, int data_id);
+
+/**
+ * Returns number of bytes allocated by the index over the packed states,
+ * i.e., the hash table and the list of reusable IDs.
+ */
+size_t planStatePoolIndexMemUsage(const plan_state_pool_t *pool);
+
 /**
  * Returns state ID corresponding to the given state.
  */
@@ -143,6 +189,12 @@ plan_state_id_t planStatePoolApplyPartStates(plan_state_pool_t *pool,
                                              int part_states_len,
                                              plan_state_id_t sid);
 
+/**** INLINES ****/
+_bor_inline size_t planStatePoolSize(const plan_state_pool_t *pool)
+{
+    return pool->num_states - pool->free_id_size;
+}
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif /* __cplusplus */
@@ -0,0 +1,129 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#ifndef __PLAN_SYMMETRY_H__
+#define __PLAN_SYMMETRY_H__
+
+#include <plan/problem.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Structural Symmetries
+ * ======================
+ *
+ * Symmetries are automorphisms of the problem description graph, i.e.,
+ * a colored directed graph with a vertex for each variable, each fact
+ * (variable-value pair) and each operator. Facts are connected with their
+ * variables, preconditions point to operators and operators point to
+ * their effects. Goal facts and operators with different costs are
+ * colored differently so each automorphism maps the problem onto itself
+ * while keeping goals and costs intact.
+ *
+ * Generators of the automorphism group are found by a partition
+ * refinement search with individualization (in the spirit of nauty).
+ * The search follows only the first path below each candidate so it may
+ * miss some generators, but every reported generator is verified to be
+ * an automorphism.
+ */
+
+/**
+ * Maximal number of branches of the search tree that are tried while
+ * looking for generators.
+ */
+#define PLAN_SYMMETRY_MAX_BRANCHES 1000
+
+/**
+ * Permutation of facts and operators, i.e., a generator of the symmetry
+ * group or a composition of generators.
+ */
+struct _plan_symmetry_gen_t {
+    plan_var_id_t *var; /*!< var[v] is the image of variable v */
+    plan_val_t **val;   /*!< val[v][x] is the image of value x of var v */
+    int *op;            /*!< op[o] is the image of operator o */
+};
+typedef struct _plan_symmetry_gen_t plan_symmetry_gen_t;
+
+struct _plan_symmetry_t {
+    int var_size;             /*!< Number of variables */
+    plan_val_t *var_range;    /*!< Ranges of variables */
+    const plan_op_t *op;      /*!< Operators of the problem */
+    int op_size;              /*!< Number of operators */
+    plan_symmetry_gen_t *gen; /*!< List of generators */
+    int gen_size;             /*!< Number of generators */
+    plan_state_t *state;      /*!< Preallocated state */
+    int *trace;       /*!< Generators applied in the last canonicalization */
+    int trace_size;
+    int trace_alloc;
+};
+typedef struct _plan_symmetry_t plan_symmetry_t;
+
+/**
+ * Finds generators of the symmetry group of the problem.
+ * Returns 0 on success and -1 if the problem is not supported (i.e., it
+ * has conditional effects).
+ */
+int planSymmetryInit(plan_symmetry_t *sym, const plan_problem_t *prob);
+
+/**
+ * Frees allocated resources.
+ */
+void planSymmetryFree(plan_symmetry_t *sym);
+
+/**
+ * Applies generator to the state src and writes result to dst.
+ */
+void planSymmetryGenApply(const plan_symmetry_gen_t *gen, int var_size,
+                          const plan_state_t *src, plan_state_t *dst);
+
+/**
+ * Rewrites the state to its canonical representative, i.e., generators
+ * are greedily applied as long as they produce lexicographically smaller
+ * state. The sequence of applied generators is remembered so that it can
+ * be undone by planSymmetryGenUncanon().
+ * Note that the canonical representative is not necessarily unique for
+ * the whole orbit of the state.
+ */
+void planSymmetryCanonState(plan_symmetry_t *sym, plan_state_t *state);
+
+/**
+ * Initializes gen as the identity permutation.
+ */
+void planSymmetryGenInit(plan_symmetry_gen_t *gen, const plan_symmetry_t *sym);
+
+/**
+ * Frees resources allocated by planSymmetryGenInit().
+ */
+void planSymmetryGenFree(plan_symmetry_gen_t *gen, const plan_symmetry_t *sym);
+
+/**
+ * Composes gen with the inverse of the last canonicalization, i.e., if
+ * the last call of planSymmetryCanonState() mapped state s to c and gen
+ * maps s to r, then gen is changed so that it maps c to r.
+ */
+void planSymmetryGenUncanon(plan_symmetry_gen_t *gen,
+                            const plan_symmetry_t *sym);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* __PLAN_SYMMETRY_H__ */
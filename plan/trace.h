@@ -0,0 +1,155 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+#ifndef __PLAN_TRACE_H__
+#define __PLAN_TRACE_H__
+
+#include <boruvka/core.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Tracing
+ * ========
+ *
+ * Records begin/end and instant events from the search algorithms and
+ * from the multi-agent layer (messages, heuristic round trips,
+ * termination and snapshots) and writes them in the Chrome trace event
+ * format (chrome://tracing, Perfetto).
+ *
+ * Events are buffered per thread without any locking and the whole trace
+ * is written by planTraceStop(). All names and argument names passed to
+ * the functions below must be string literals (or otherwise live until
+ * planTraceStop() is called) because only pointers are stored.
+ *
+ * If the tracing is not started, each call costs one test of a global
+ * flag.
+ */
+
+/**
+ * Maximal number of events recorded by one thread. Further events are
+ * dropped (and counted).
+ */
+#define PLAN_TRACE_MAX_EVENTS (1 << 20)
+
+/**
+ * Non-zero if the tracing is enabled. Do not set it directly.
+ */
+extern int plan_trace_enabled;
+
+/**
+ * Starts recording of events. The trace is written to the file fn once
+ * planTraceStop() is called.
+ * Returns 0 on success, -1 if the file cannot be opened or the tracing
+ * is already running.
+ */
+int planTraceStart(const char *fn);
+
+/**
+ * Stops recording, writes all buffered events to the file given to
+ * planTraceStart() and frees all buffers.
+ * This must be called when no other thread records events.
+ */
+void planTraceStop(void);
+
+/**
+ * Sets the name of the calling thread shown in the trace viewer
+ * (e.g., "agent 0"). The name is copied.
+ */
+void planTraceThreadName(const char *name);
+
+/**
+ * Begin of a duration event.
+ */
+_bor_inline void planTraceBegin(const char *cat, const char *name);
+
+/**
+ * Same as planTraceBegin() but with two integer arguments (either
+ * argument name can be NULL).
+ */
+_bor_inline void planTraceBeginArgs(const char *cat, const char *name,
+                                    const char *arg1, long val1,
+                                    const char *arg2, long val2);
+
+/**
+ * End of the duration event started by planTraceBegin*().
+ */
+_bor_inline void planTraceEnd(const char *cat, const char *name);
+
+/**
+ * Instant event with up to four integer arguments (unused argument names
+ * are NULL).
+ */
+_bor_inline void planTraceInstant(const char *cat, const char *name,
+                                  const char *arg1, long val1,
+                                  const char *arg2, long val2,
+                                  const char *arg3, long val3,
+                                  const char *arg4, long val4);
+
+
+/**
+ * Records one event. For internal use.
+ */
+void _planTraceEvent(char ph, const char *cat, const char *name,
+                     const char *arg1, long val1,
+                     const char *arg2, long val2,
+                     const char *arg3, long val3,
+                     const char *arg4, long val4);
+
+/**** INLINES: ****/
+_bor_inline void planTraceBegin(const char *cat, const char *name)
+{
+    if (plan_trace_enabled)
+        _planTraceEvent('B', cat, name, NULL, 0, NULL, 0, NULL, 0, NULL, 0);
+}
+
+_bor_inline void planTraceBeginArgs(const char *cat, const char *name,
+                                    const char *arg1, long val1,
+                                    const char *arg2, long val2)
+{
+    if (plan_trace_enabled)
+        _planTraceEvent('B', cat, name, arg1, val1, arg2, val2,
+                        NULL, 0, NULL, 0);
+}
+
+_bor_inline void planTraceEnd(const char *cat, const char *name)
+{
+    if (plan_trace_enabled)
+        _planTraceEvent('E', cat, name, NULL, 0, NULL, 0, NULL, 0, NULL, 0);
+}
+
+_bor_inline void planTraceInstant(const char *cat, const char *name,
+                                  const char *arg1, long val1,
+                                  const char *arg2, long val2,
+                                  const char *arg3, long val3,
+                                  const char *arg4, long val4)
+{
+    if (plan_trace_enabled)
+        _planTraceEvent('i', cat, name, arg1, val1, arg2, val2,
+                        arg3, val3, arg4, val4);
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* __PLAN_TRACE_H__ */
@@ -42,6 +42,8 @@ struct _plan_list_lazy_map_t {
     plan_list_lazy_t list;    /*!< Parent class */
     TREE_T tree; /*!< Instance of a tree */
     keynode_t *pre_keynode;   /*!< Preinitialized key-node */
+    long keynode_size;        /*!< Number of key-nodes in the tree */
+    long node_size;           /*!< Number of stored values */
 };
 typedef struct _plan_list_lazy_map_t plan_list_lazy_map_t;
 
@@ -57,6 +59,7 @@ static int planListLazyMapPop(plan_list_lazy_t *,
                               plan_state_id_t *parent_state_id,
                               plan_op_t **op);
 static void planListLazyMapClear(plan_list_lazy_t *);
+static size_t planListLazyMapMemUsage(const plan_list_lazy_t *);
 
 
 plan_list_lazy_t *NEW_FN(void)
@@ -68,12 +71,15 @@ plan_list_lazy_t *NEW_FN(void)
 
     l->pre_keynode = BOR_ALLOC(keynode_t);
     borFifoInit(&l->pre_keynode->fifo, sizeof(node_t));
+    l->keynode_size = 0;
+    l->node_size = 0;
 
     planListLazyInit(&l->list,
                      planListLazyMapDel,
                      planListLazyMapPush,
                      planListLazyMapPop,
-                     planListLazyMapClear);
+                     planListLazyMapClear,
+                     planListLazyMapMemUsage);
 
     return &l->list;
 }
@@ -109,6 +115,7 @@ static void planListLazyMapPush(plan_list_lazy_t *_l,
         keynode = l->pre_keynode;
         l->pre_keynode = BOR_ALLOC(keynode_t);
         borFifoInit(&l->pre_keynode->fifo, sizeof(node_t));
+        ++l->keynode_size;
 
     }else{
         // Key already in tree
@@ -119,6 +126,7 @@ static void planListLazyMapPush(plan_list_lazy_t *_l,
     n.parent_state_id = parent_state_id;
     n.op = op;
     borFifoPush(&keynode->fifo, &n);
+    ++l->node_size;
 }
 
 static int planListLazyMapPop(plan_list_lazy_t *_l,
@@ -144,12 +152,14 @@ static int planListLazyMapPop(plan_list_lazy_t *_l,
     *parent_state_id = n->parent_state_id;
     *op              = n->op;
     borFifoPop(&keynode->fifo);
+    --l->node_size;
 
     // If the key-node is empty, remove it from the tree
     if (borFifoEmpty(&keynode->fifo)){
         TREE_REMOVE(&l->tree, &keynode->tree);
         borFifoFree(&keynode->fifo);
         BOR_FREE(keynode);
+        --l->keynode_size;
     }
 
     return 0;
@@ -167,4 +177,18 @@ static void planListLazyMapClear(plan_list_lazy_t *_l)
         borFifoFree(&keynode->fifo);
         BOR_FREE(keynode);
     }
+    l->keynode_size = 0;
+    l->node_size = 0;
+}
+
+static size_t planListLazyMapMemUsage(const plan_list_lazy_t *_l)
+{
+    const plan_list_lazy_map_t *l;
+    size_t size;
+
+    l = bor_container_of(_l, const plan_list_lazy_map_t, list);
+    size  = sizeof(*l);
+    size += (l->keynode_size + 1) * sizeof(keynode_t);
+    size += l->node_size * sizeof(node_t);
+    return size;
 }
@@ -18,11 +18,689 @@
  */
 
 #include <boruvka/alloc.h>
+#include <boruvka/tasks.h>
 #include "plan/fa_mutex.h"
 #include "plan/fact_id.h"
 #include "plan/lp.h"
 
-#ifdef PLAN_LP
+static void setGoalFlag(plan_mutex_group_t *m,
+                        const plan_part_state_t *goal)
+{
+    plan_var_id_t var;
+    plan_val_t val;
+    int i, tmpi;
+
+    for (i = 0; i < m->fact_size; ++i){
+        PLAN_PART_STATE_FOR_EACH(goal, tmpi, var, val){
+            if (m->fact[i].var == var && m->fact[i].val == val){
+                m->is_goal = 1;
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * Native (LP-free) inference of fa-mutexes.
+ *
+ * A set of facts M is a fa-mutex if at most one fact from M holds in the
+ * state and for every operator o it holds that |M \cap add(o)| <= |M \cap
+ * del(o)|, where del(o) are the precondition facts on the variables
+ * changed by o. These are the same constraints as in the ILP formulation
+ * below and the ILP loop enumerates exactly all inclusion-maximal sets
+ * satisfying them. Here the same sets are enumerated by a backtracking
+ * search with constraint propagation. The search is split by seeds (the
+ * fact with the lowest ID in the fa-mutex) which are distributed between
+ * threads. The sets maximal only within their seed are filtered out at
+ * the end.
+ */
+
+/** Constraint "at least one fact outside the group" */
+struct _fam_row_t {
+    const char *in_group;
+    int in_out;   /*!< Number of facts outside group set to 1 */
+    int free_out; /*!< Number of unassigned facts outside group */
+};
+typedef struct _fam_row_t fam_row_t;
+
+/** Constraint system shared by all threads */
+struct _fam_t {
+    int fact_size;
+    int op_size;
+    int *op_fact_beg;  /*!< Facts of operator constraints */
+    int *op_fact;
+    int *op_coef;      /*!< +1 for add facts, -1 for delete facts */
+    int *fact_op_beg;  /*!< Operator constraints of each fact */
+    int *fact_op;
+    int *fact_op_coef;
+    char *is_init;
+    char **row;        /*!< Input mutexes and the goal constraint */
+    int row_size;
+};
+typedef struct _fam_t fam_t;
+
+/** Search state of a thread */
+struct _fam_th_t {
+    const fam_t *fam;
+    int seed_from;
+    int seed_step;
+
+    char *val;         /*!< -1 unassigned, 0 out, 1 in */
+    int *pos_in;
+    int *pos_free;
+    int *neg_in;
+    int *neg_free;
+    int init_in;
+    int init_free;
+    fam_row_t *row;
+    int row_size;
+    int row_alloc;
+    int row_own_from;  /*!< Rows from this index are owned by the thread */
+    int *trail;
+    int trail_size;
+    char *cur;
+    char *next;
+
+    plan_arr_int_t cand; /*!< Stack of candidate facts for branching */
+    plan_arr_int_t res; /*!< Found sets, each terminated by -1 */
+};
+typedef struct _fam_th_t fam_th_t;
+
+static void famInit(fam_t *fam, const plan_fact_id_t *fact_id,
+                    const plan_problem_t *p, const plan_state_t *state,
+                    const plan_mutex_group_set_t *ms, unsigned flags)
+{
+    const plan_op_t *op;
+    const plan_part_state_t *pre, *eff;
+    plan_var_id_t var;
+    plan_val_t val;
+    int *coef, *touched, touched_size;
+    int i, j, fid, prei, effi, size;
+    char *row;
+
+    bzero(fam, sizeof(*fam));
+    fam->fact_size = fact_id->fact_size;
+    fam->op_size = p->op_size;
+
+    // Operator constraints with the coefficients overwritten in the same
+    // order as in the ILP formulation
+    coef = BOR_CALLOC_ARR(int, fam->fact_size);
+    touched = BOR_ALLOC_ARR(int, fam->fact_size);
+    fam->op_fact_beg = BOR_ALLOC_ARR(int, fam->op_size + 1);
+    fam->fact_op_beg = BOR_CALLOC_ARR(int, fam->fact_size + 1);
+    size = 0;
+    for (i = 0; i < p->op_size; ++i)
+        size += p->op[i].pre->vals_size + p->op[i].eff->vals_size;
+    fam->op_fact = BOR_ALLOC_ARR(int, size);
+    fam->op_coef = BOR_ALLOC_ARR(int, size);
+
+    size = 0;
+    for (i = 0; i < p->op_size; ++i){
+        op = p->op + i;
+        pre = op->pre;
+        eff = op->eff;
+        touched_size = 0;
+        for (prei = effi = 0; effi < eff->vals_size;){
+            if (prei < pre->vals_size
+                    && pre->vals[prei].var < eff->vals[effi].var){
+                ++prei;
+                continue;
+            }
+
+            if (prei < pre->vals_size
+                    && pre->vals[prei].var == eff->vals[effi].var){
+                fid = planFactIdVar(fact_id, pre->vals[prei].var,
+                                             pre->vals[prei].val);
+                if (coef[fid] == 0)
+                    touched[touched_size++] = fid;
+                coef[fid] = -1;
+                ++prei;
+            }
+
+            fid = planFactIdVar(fact_id, eff->vals[effi].var,
+                                         eff->vals[effi].val);
+            if (coef[fid] == 0)
+                touched[touched_size++] = fid;
+            coef[fid] = 1;
+            ++effi;
+        }
+
+        fam->op_fact_beg[i] = size;
+        for (j = 0; j < touched_size; ++j){
+            fid = touched[j];
+            fam->op_fact[size] = fid;
+            fam->op_coef[size++] = coef[fid];
+            fam->fact_op_beg[fid + 1] += 1;
+            coef[fid] = 0;
+        }
+    }
+    fam->op_fact_beg[p->op_size] = size;
+
+    for (i = 0; i < fam->fact_size; ++i)
+        fam->fact_op_beg[i + 1] += fam->fact_op_beg[i];
+    fam->fact_op = BOR_ALLOC_ARR(int, size);
+    fam->fact_op_coef = BOR_ALLOC_ARR(int, size);
+    for (i = 0; i < fam->fact_size; ++i)
+        coef[i] = fam->fact_op_beg[i];
+    for (i = 0; i < p->op_size; ++i){
+        for (j = fam->op_fact_beg[i]; j < fam->op_fact_beg[i + 1]; ++j){
+            fid = fam->op_fact[j];
+            fam->fact_op[coef[fid]] = i;
+            fam->fact_op_coef[coef[fid]++] = fam->op_coef[j];
+        }
+    }
+    BOR_FREE(coef);
+    BOR_FREE(touched);
+
+    // State constraint
+    fam->is_init = BOR_CALLOC_ARR(char, fam->fact_size);
+    for (i = 0; i < p->var_size; ++i){
+        if (i == p->ma_privacy_var)
+            continue;
+        fid = planFactIdVar(fact_id, i, planStateGet(state, i));
+        fam->is_init[fid] = 1;
+    }
+
+    // Input mutexes and the goal are both expressed as "at least one fact
+    // outside the group"
+    fam->row = BOR_ALLOC_ARR(char *, ms->group_size + 1);
+    for (i = 0; i < ms->group_size; ++i){
+        if (ms->group[i].fact_size == 0)
+            continue;
+        row = BOR_CALLOC_ARR(char, fam->fact_size);
+        for (j = 0; j < ms->group[i].fact_size; ++j){
+            fid = planFactIdVar(fact_id, ms->group[i].fact[j].var,
+                                         ms->group[i].fact[j].val);
+            row[fid] = 1;
+        }
+        fam->row[fam->row_size++] = row;
+    }
+
+    if (flags & PLAN_FA_MUTEX_ONLY_GOAL){
+        row = BOR_ALLOC_ARR(char, fam->fact_size);
+        memset(row, 1, fam->fact_size);
+        PLAN_PART_STATE_FOR_EACH(p->goal, i, var, val)
+            row[planFactIdVar(fact_id, var, val)] = 0;
+        fam->row[fam->row_size++] = row;
+    }
+}
+
+static void famFree(fam_t *fam)
+{
+    int i;
+
+    BOR_FREE(fam->op_fact_beg);
+    BOR_FREE(fam->op_fact);
+    BOR_FREE(fam->op_coef);
+    BOR_FREE(fam->fact_op_beg);
+    BOR_FREE(fam->fact_op);
+    BOR_FREE(fam->fact_op_coef);
+    BOR_FREE(fam->is_init);
+    for (i = 0; i < fam->row_size; ++i)
+        BOR_FREE(fam->row[i]);
+    BOR_FREE(fam->row);
+}
+
+static void famThPushRow(fam_th_t *th, const char *in_group)
+{
+    fam_row_t *row;
+    int i;
+
+    if (th->row_size == th->row_alloc){
+        th->row_alloc = 2 * th->row_alloc + 4;
+        th->row = BOR_REALLOC_ARR(th->row, fam_row_t, th->row_alloc);
+    }
+    row = th->row + th->row_size++;
+    row->in_group = in_group;
+    row->in_out = 0;
+    row->free_out = 0;
+    for (i = 0; i < th->fam->fact_size; ++i)
+        row->free_out += !in_group[i];
+}
+
+static void famThInit(fam_th_t *th, const fam_t *fam, int from, int step)
+{
+    int i, j;
+
+    bzero(th, sizeof(*th));
+    th->fam = fam;
+    th->seed_from = from;
+    th->seed_step = step;
+
+    th->val = BOR_ALLOC_ARR(char, fam->fact_size);
+    memset(th->val, -1, fam->fact_size);
+    th->pos_in = BOR_CALLOC_ARR(int, fam->op_size);
+    th->neg_in = BOR_CALLOC_ARR(int, fam->op_size);
+    th->pos_free = BOR_CALLOC_ARR(int, fam->op_size);
+    th->neg_free = BOR_CALLOC_ARR(int, fam->op_size);
+    for (i = 0; i < fam->op_size; ++i){
+        for (j = fam->op_fact_beg[i]; j < fam->op_fact_beg[i + 1]; ++j){
+            if (fam->op_coef[j] > 0){
+                ++th->pos_free[i];
+            }else{
+                ++th->neg_free[i];
+            }
+        }
+    }
+    for (i = 0; i < fam->fact_size; ++i)
+        th->init_free += fam->is_init[i];
+
+    for (i = 0; i < fam->row_size; ++i)
+        famThPushRow(th, fam->row[i]);
+    th->row_own_from = th->row_size;
+
+    th->trail = BOR_ALLOC_ARR(int, fam->fact_size);
+    th->cur = BOR_ALLOC_ARR(char, fam->fact_size);
+    th->next = BOR_ALLOC_ARR(char, fam->fact_size);
+    planArrIntInit(&th->cand, 64);
+    planArrIntInit(&th->res, 64);
+}
+
+static void famThFree(fam_th_t *th)
+{
+    int i;
+
+    BOR_FREE(th->val);
+    BOR_FREE(th->pos_in);
+    BOR_FREE(th->neg_in);
+    BOR_FREE(th->pos_free);
+    BOR_FREE(th->neg_free);
+    for (i = th->row_own_from; i < th->row_size; ++i)
+        BOR_FREE((char *)th->row[i].in_group);
+    if (th->row != NULL)
+        BOR_FREE(th->row);
+    BOR_FREE(th->trail);
+    BOR_FREE(th->cur);
+    BOR_FREE(th->next);
+    planArrIntFree(&th->cand);
+    planArrIntFree(&th->res);
+}
+
+static void famThSet(fam_th_t *th, int fact, int v)
+{
+    const fam_t *fam = th->fam;
+    int i, op;
+
+    th->val[fact] = v;
+    th->trail[th->trail_size++] = fact;
+    for (i = fam->fact_op_beg[fact]; i < fam->fact_op_beg[fact + 1]; ++i){
+        op = fam->fact_op[i];
+        if (fam->fact_op_coef[i] > 0){
+            --th->pos_free[op];
+            th->pos_in[op] += v;
+        }else{
+            --th->neg_free[op];
+            th->neg_in[op] += v;
+        }
+    }
+    if (fam->is_init[fact]){
+        --th->init_free;
+        th->init_in += v;
+    }
+    for (i = 0; i < th->row_size; ++i){
+        if (!th->row[i].in_group[fact]){
+            --th->row[i].free_out;
+            th->row[i].in_out += v;
+        }
+    }
+}
+
+static void famThUndo(fam_th_t *th, int mark)
+{
+    const fam_t *fam = th->fam;
+    int i, op, fact, v;
+
+    while (th->trail_size > mark){
+        fact = th->trail[--th->trail_size];
+        v = th->val[fact];
+        th->val[fact] = -1;
+        for (i = fam->fact_op_beg[fact]; i < fam->fact_op_beg[fact + 1]; ++i){
+            op = fam->fact_op[i];
+            if (fam->fact_op_coef[i] > 0){
+                ++th->pos_free[op];
+                th->pos_in[op] -= v;
+            }else{
+                ++th->neg_free[op];
+                th->neg_in[op] -= v;
+            }
+        }
+        if (fam->is_init[fact]){
+            ++th->init_free;
+            th->init_in -= v;
+        }
+        for (i = 0; i < th->row_size; ++i){
+            if (!th->row[i].in_group[fact]){
+                ++th->row[i].free_out;
+                th->row[i].in_out -= v;
+            }
+        }
+    }
+}
+
+/** Propagates all assignments from the trail starting at qhead.
+ *  Returns -1 on conflict. */
+static int famThPropagate(fam_th_t *th, int qhead)
+{
+    const fam_t *fam = th->fam;
+    fam_row_t *row;
+    int i, j, op, fact, f, slack;
+
+    while (qhead < th->trail_size){
+        fact = th->trail[qhead++];
+
+        for (i = fam->fact_op_beg[fact]; i < fam->fact_op_beg[fact + 1]; ++i){
+            op = fam->fact_op[i];
+            slack = th->neg_in[op] + th->neg_free[op] - th->pos_in[op];
+            if (slack < 0)
+                return -1;
+            if (slack > 0 || th->pos_free[op] + th->neg_free[op] == 0)
+                continue;
+
+            // No slack left: no other add fact can be in the set and all
+            // delete facts must be in the set
+            for (j = fam->op_fact_beg[op]; j < fam->op_fact_beg[op + 1]; ++j){
+                f = fam->op_fact[j];
+                if (th->val[f] == -1)
+                    famThSet(th, f, fam->op_coef[j] < 0);
+            }
+        }
+
+        if (fam->is_init[fact] && th->val[fact] == 1){
+            if (th->init_in > 1)
+                return -1;
+            for (f = 0; th->init_free > 0 && f < fam->fact_size; ++f){
+                if (fam->is_init[f] && th->val[f] == -1)
+                    famThSet(th, f, 0);
+            }
+        }
+
+        for (i = 0; i < th->row_size; ++i){
+            row = th->row + i;
+            if (row->in_group[fact] || row->in_out > 0 || row->free_out > 1)
+                continue;
+            if (row->free_out == 0)
+                return -1;
+            for (f = 0; f < fam->fact_size; ++f){
+                if (!row->in_group[f] && th->val[f] == -1){
+                    famThSet(th, f, 1);
+                    break;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int famThAssign(fam_th_t *th, int fact, int v)
+{
+    int qhead = th->trail_size;
+    famThSet(th, fact, v);
+    return famThPropagate(th, qhead);
+}
+
+/** Assigns all facts before seed to 0, seed to 1 and all facts from
+ *  force (if non-NULL) to 1. */
+static int famThSeed(fam_th_t *th, int seed, const char *force)
+{
+    int i;
+
+    for (i = 0; i < seed; ++i)
+        famThSet(th, i, 0);
+    famThSet(th, seed, 1);
+    if (famThPropagate(th, 0) != 0)
+        return -1;
+
+    for (i = seed + 1; force != NULL && i < th->fam->fact_size; ++i){
+        if (!force[i])
+            continue;
+        if (th->val[i] == 0)
+            return -1;
+        if (th->val[i] == -1 && famThAssign(th, i, 1) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+/** Branches over the candidate facts stored in th->cand from index
+ *  cand_from: in the i-th branch the i-th fact is set to 1 and all
+ *  previous facts are set to 0. */
+static int famThDFS(fam_th_t *th);
+static int famThBranch(fam_th_t *th, int cand_from)
+{
+    int i, fact, mark, mark2, ret;
+
+    ret = 0;
+    mark = th->trail_size;
+    for (i = cand_from; i < th->cand.size; ++i){
+        fact = th->cand.arr[i];
+        if (th->val[fact] == 1){
+            // Forced by the previous branches, so no other branch is
+            // possible
+            ret = famThDFS(th);
+            break;
+
+        }else if (th->val[fact] == -1){
+            mark2 = th->trail_size;
+            if (famThAssign(th, fact, 1) == 0 && famThDFS(th)){
+                ret = 1;
+                break;
+            }
+            famThUndo(th, mark2);
+            if (famThAssign(th, fact, 0) != 0)
+                break;
+        }
+    }
+    th->cand.size = cand_from;
+    if (!ret)
+        famThUndo(th, mark);
+    return ret;
+}
+
+/** Depth-first search for a consistent assignment. Only the constraints
+ *  that are not yet satisfied by the facts set to 1 are branched on, so
+ *  the unassigned facts are considered to be 0 in the found solution. */
+static int famThDFS(fam_th_t *th)
+{
+    const fam_t *fam = th->fam;
+    const fam_row_t *row;
+    int i, j, op, best_op, cand_from;
+
+    cand_from = th->cand.size;
+
+    // Operators with more add facts than delete facts in the set
+    best_op = -1;
+    for (op = 0; op < fam->op_size; ++op){
+        if (th->pos_in[op] > th->neg_in[op]
+                && (best_op < 0 || th->neg_free[op] < th->neg_free[best_op])){
+            best_op = op;
+        }
+    }
+
+    if (best_op >= 0){
+        for (j = fam->op_fact_beg[best_op];
+                j < fam->op_fact_beg[best_op + 1]; ++j){
+            if (fam->op_coef[j] < 0 && th->val[fam->op_fact[j]] == -1)
+                planArrIntAdd(&th->cand, fam->op_fact[j]);
+        }
+        return famThBranch(th, cand_from);
+    }
+
+    // Groups without any fact outside them set to 1
+    for (i = 0; i < th->row_size; ++i){
+        row = th->row + i;
+        if (row->in_out > 0)
+            continue;
+        for (j = 0; j < fam->fact_size; ++j){
+            if (!row->in_group[j] && th->val[j] == -1)
+                planArrIntAdd(&th->cand, j);
+        }
+        return famThBranch(th, cand_from);
+    }
+
+    return 1;
+}
+
+static void famThSolveSeed(fam_th_t *th, int seed)
+{
+    int fact_size = th->fam->fact_size;
+    int i, found;
+    char *tmp;
+
+    while (1){
+        famThUndo(th, 0);
+        if (famThSeed(th, seed, NULL) != 0 || !famThDFS(th))
+            break;
+        for (i = 0; i < fact_size; ++i)
+            th->cur[i] = (th->val[i] == 1);
+
+        // Grow the set until no superset with the same seed exists
+        do {
+            famThUndo(th, 0);
+            famThPushRow(th, th->cur);
+            found = (famThSeed(th, seed, th->cur) == 0
+                        && famThDFS(th));
+            for (i = 0; found && i < fact_size; ++i)
+                th->next[i] = (th->val[i] == 1);
+            famThUndo(th, 0);
+            --th->row_size;
+
+            if (found){
+                tmp = th->cur;
+                th->cur = th->next;
+                th->next = tmp;
+            }
+        } while (found);
+
+        for (i = 0; i < fact_size; ++i){
+            if (th->cur[i])
+                planArrIntAdd(&th->res, i);
+        }
+        planArrIntAdd(&th->res, -1);
+
+        // Subsets of the found set are not fa-mutexes we are looking for
+        tmp = BOR_ALLOC_ARR(char, fact_size);
+        memcpy(tmp, th->cur, fact_size);
+        famThPushRow(th, tmp);
+    }
+    famThUndo(th, 0);
+}
+
+static void famThRun(fam_th_t *th)
+{
+    int seed;
+
+    for (seed = th->seed_from; seed < th->fam->fact_size;
+            seed += th->seed_step){
+        famThSolveSeed(th, seed);
+    }
+}
+
+static void famThTask(int id, void *data, const bor_tasks_thinfo_t *_)
+{
+    famThRun((fam_th_t *)data);
+}
+
+static int famCmpSet(const void *a, const void *b)
+{
+    const int *s1 = *(const int **)a;
+    const int *s2 = *(const int **)b;
+
+    for (; *s1 >= 0 && *s1 == *s2; ++s1, ++s2);
+    return *s1 - *s2;
+}
+
+/** Returns true if s1 is a subset of s2 */
+static int famIsSubset(const int *s1, const int *s2)
+{
+    for (; *s1 >= 0 && *s2 >= 0; ++s2){
+        if (*s1 == *s2)
+            ++s1;
+    }
+    return *s1 < 0;
+}
+
+void planFAMutexFindNative(const plan_problem_t *p,
+                           const plan_state_t *state,
+                           plan_mutex_group_set_t *ms,
+                           unsigned flags, int num_threads)
+{
+    plan_fact_id_t fact_id;
+    fam_t fam;
+    fam_th_t *th;
+    bor_tasks_t *tasks;
+    plan_mutex_group_t *m;
+    plan_var_id_t var;
+    plan_val_t val;
+    const int **set;
+    const int *s;
+    int i, j, set_size;
+
+    if (num_threads < 1)
+        num_threads = 1;
+
+    planFactIdInit(&fact_id, p->var, p->var_size, PLAN_FACT_ID_REVERSE_MAP);
+    famInit(&fam, &fact_id, p, state, ms, flags);
+
+    th = BOR_ALLOC_ARR(fam_th_t, num_threads);
+    for (i = 0; i < num_threads; ++i)
+        famThInit(th + i, &fam, i, num_threads);
+
+    if (num_threads == 1){
+        famThRun(th);
+    }else{
+        tasks = borTasksNew(num_threads);
+        for (i = 0; i < num_threads; ++i)
+            borTasksAdd(tasks, famThTask, i, th + i);
+        borTasksRun(tasks);
+        borTasksDel(tasks);
+    }
+
+    // Gather the sets from all threads in a deterministic order
+    set_size = 0;
+    for (i = 0; i < num_threads; ++i){
+        for (j = 0; j < th[i].res.size; ++j)
+            set_size += (th[i].res.arr[j] < 0);
+    }
+    set = BOR_ALLOC_ARR(const int *, set_size);
+    set_size = 0;
+    for (i = 0; i < num_threads; ++i){
+        for (j = 0; j < th[i].res.size; ++j){
+            if (j == 0 || th[i].res.arr[j - 1] < 0)
+                set[set_size++] = th[i].res.arr + j;
+        }
+    }
+    qsort(set, set_size, sizeof(const int *), famCmpSet);
+
+    // Keep only sets that are maximal also across seeds
+    for (i = 0; i < set_size; ++i){
+        for (j = 0; j < set_size; ++j){
+            if (i != j && famIsSubset(set[i], set[j]))
+                break;
+        }
+        if (j < set_size)
+            continue;
+
+        m = planMutexGroupSetAdd(ms);
+        m->is_fa = 1;
+        for (s = set[i]; *s >= 0; ++s){
+            planFactIdVarFromFact(&fact_id, *s, &var, &val);
+            planMutexGroupAdd(m, var, val);
+        }
+        setGoalFlag(m, p->goal);
+    }
+
+    BOR_FREE(set);
+    for (i = 0; i < num_threads; ++i)
+        famThFree(th + i);
+    BOR_FREE(th);
+    famFree(&fam);
+    planFactIdFree(&fact_id);
+}
+
+/** The built-in LP solver is not used because the combinatorial search
+ *  above is much faster than its branch and bound */
+#if defined(PLAN_LP) && !defined(PLAN_USE_LP_NATIVE)
 
 static void setStateConstr(plan_lp_t *lp, int row,
                            const plan_fact_id_t *fact_id,
@@ -123,23 +801,6 @@ static void addGoalConstr(plan_lp_t *lp,
     }
 }
 
-static void setGoalFlag(plan_mutex_group_t *m,
-                        const plan_part_state_t *goal)
-{
-    plan_var_id_t var;
-    plan_val_t val;
-    int i, tmpi;
-
-    for (i = 0; i < m->fact_size; ++i){
-        PLAN_PART_STATE_FOR_EACH(goal, tmpi, var, val){
-            if (m->fact[i].var == var && m->fact[i].val == val){
-                m->is_goal = 1;
-                return;
-            }
-        }
-    }
-}
-
 static void addFAMutex(plan_mutex_group_set_t *ms,
                        const plan_fact_id_t *fact_id,
                        const double *obj,
@@ -203,13 +864,11 @@ void planFAMutexFind(const plan_problem_t *p, const plan_state_t *state,
     planFactIdFree(&fact_id);
 }
 
-#else /* PLAN_LP */
+#else /* defined(PLAN_LP) && !defined(PLAN_USE_LP_NATIVE) */
 
 void planFAMutexFind(const plan_problem_t *p, const plan_state_t *state,
                      plan_mutex_group_set_t *ms, unsigned flags)
 {
-    fprintf(stderr, "Error: Cannot compute fa-mutexes because no"
-                    " LP-solver was available during compilation!\n");
-    fflush(stderr);
+    planFAMutexFindNative(p, state, ms, flags, 1);
 }
-#endif /* PLAN_LP */
+#endif /* defined(PLAN_LP) && !defined(PLAN_USE_LP_NATIVE) */
@@ -369,6 +369,26 @@ void planFactOpCrossRefFree(plan_fact_op_cross_ref_t *cr)
     planFactIdFree(&cr->fact_id);
 }
 
+size_t planFactOpCrossRefMemUsage(const plan_fact_op_cross_ref_t *cr)
+{
+    size_t size;
+    int i;
+
+    size  = cr->op_alloc * (2 * sizeof(plan_arr_int_t) + sizeof(int));
+    for (i = 0; i < cr->op_size; ++i){
+        size += planArrIntMemUsage(cr->op_pre + i);
+        size += planArrIntMemUsage(cr->op_eff + i);
+    }
+
+    size += cr->fact_size * 2 * sizeof(plan_arr_int_t);
+    for (i = 0; i < cr->fact_size; ++i){
+        size += planArrIntMemUsage(cr->fact_pre + i);
+        size += planArrIntMemUsage(cr->fact_eff + i);
+    }
+    size += cr->fake_pre_size * sizeof(plan_fake_pre_t);
+    return size;
+}
+
 int planFactOpCrossRefAddFakePre(plan_fact_op_cross_ref_t *cr,
                                  plan_cost_t value)
 {
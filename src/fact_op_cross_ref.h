@@ -76,6 +76,12 @@ void planFactOpCrossRefInit(plan_fact_op_cross_ref_t *cr,
  */
 void planFactOpCrossRefFree(plan_fact_op_cross_ref_t *cr);
 
+/**
+ * Returns number of bytes allocated by the cross reference table (without
+ * the translation table .fact_id).
+ */
+size_t planFactOpCrossRefMemUsage(const plan_fact_op_cross_ref_t *cr);
+
 /**
  * Adds a new fake precondition fact with a specified initial value.
  * Returns ID of the fact.
@@ -0,0 +1,132 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+#include <boruvka/alloc.h>
+
+#include "fact_op_graph.h"
+
+void planFactOpGraphInit(plan_fact_op_graph_t *g, int fact_size, int op_size)
+{
+    bzero(g, sizeof(*g));
+    g->fact_size = fact_size;
+    g->op_size = op_size;
+    planArrIntInit(&g->pre_edge, 64);
+    planArrIntInit(&g->eff_edge, 64);
+}
+
+void planFactOpGraphFree(plan_fact_op_graph_t *g)
+{
+    if (g->op_pre_beg)
+        BOR_FREE(g->op_pre_beg);
+    if (g->op_pre)
+        BOR_FREE(g->op_pre);
+    if (g->op_eff_beg)
+        BOR_FREE(g->op_eff_beg);
+    if (g->op_eff)
+        BOR_FREE(g->op_eff);
+    if (g->fact_pre_beg)
+        BOR_FREE(g->fact_pre_beg);
+    if (g->fact_pre)
+        BOR_FREE(g->fact_pre);
+    if (g->fact_eff_beg)
+        BOR_FREE(g->fact_eff_beg);
+    if (g->fact_eff)
+        BOR_FREE(g->fact_eff);
+    planArrIntFree(&g->pre_edge);
+    planArrIntFree(&g->eff_edge);
+}
+
+_bor_inline void addEdge(plan_fact_op_graph_t *g, plan_arr_int_t *edge,
+                         int op_id, int fact_id)
+{
+    planArrIntAdd(edge, op_id);
+    planArrIntAdd(edge, fact_id);
+    if (op_id >= g->op_size)
+        g->op_size = op_id + 1;
+}
+
+void planFactOpGraphAddPre(plan_fact_op_graph_t *g, int op_id, int fact_id)
+{
+    addEdge(g, &g->pre_edge, op_id, fact_id);
+}
+
+void planFactOpGraphAddEff(plan_fact_op_graph_t *g, int op_id, int fact_id)
+{
+    addEdge(g, &g->eff_edge, op_id, fact_id);
+}
+
+/** Creates rows indexed by edge[from] containing edge[to] using a stable
+ *  counting sort, i.e., the order of the edges is preserved. */
+static void buildRows(const plan_arr_int_t *edge, int from, int to,
+                      int row_size, int **beg_out, int **row_out)
+{
+    int *beg, *row, *pos;
+    int i, size;
+
+    size = edge->size / 2;
+    beg = BOR_CALLOC_ARR(int, row_size + 1);
+    row = BOR_ALLOC_ARR(int, BOR_MAX(size, 1));
+
+    for (i = 0; i < size; ++i)
+        ++beg[edge->arr[2 * i + from] + 1];
+    for (i = 0; i < row_size; ++i)
+        beg[i + 1] += beg[i];
+
+    pos = BOR_ALLOC_ARR(int, row_size + 1);
+    memcpy(pos, beg, sizeof(int) * (row_size + 1));
+    for (i = 0; i < size; ++i)
+        row[pos[edge->arr[2 * i + from]]++] = edge->arr[2 * i + to];
+    BOR_FREE(pos);
+
+    *beg_out = beg;
+    *row_out = row;
+}
+
+void planFactOpGraphFinalize(plan_fact_op_graph_t *g)
+{
+    buildRows(&g->pre_edge, 0, 1, g->op_size, &g->op_pre_beg, &g->op_pre);
+    buildRows(&g->eff_edge, 0, 1, g->op_size, &g->op_eff_beg, &g->op_eff);
+    buildRows(&g->pre_edge, 1, 0, g->fact_size,
+              &g->fact_pre_beg, &g->fact_pre);
+    buildRows(&g->eff_edge, 1, 0, g->fact_size,
+              &g->fact_eff_beg, &g->fact_eff);
+
+    // The edges are not needed anymore
+    planArrIntFree(&g->pre_edge);
+    planArrIntFree(&g->eff_edge);
+    bzero(&g->pre_edge, sizeof(g->pre_edge));
+    bzero(&g->eff_edge, sizeof(g->eff_edge));
+}
+
+size_t planFactOpGraphMemUsage(const plan_fact_op_graph_t *g)
+{
+    size_t size;
+
+    size  = sizeof(*g);
+    size += 2 * sizeof(int) * (g->op_size + 1);
+    size += 2 * sizeof(int) * (g->fact_size + 1);
+    if (g->op_pre_beg){
+        size += 2 * sizeof(int) * g->op_pre_beg[g->op_size];
+        size += 2 * sizeof(int) * g->op_eff_beg[g->op_size];
+    }
+    size += planArrIntMemUsage(&g->pre_edge);
+    size += planArrIntMemUsage(&g->eff_edge);
+    return size;
+}
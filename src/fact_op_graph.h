@@ -0,0 +1,166 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+#ifndef __PLAN_FACT_OP_GRAPH_H__
+#define __PLAN_FACT_OP_GRAPH_H__
+
+#include "plan/arr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Fact/Operator Graph
+ * ====================
+ *
+ * Relaxed planning graph stored in the compressed sparse row format: all
+ * precondition (effect) edges are stored in one contiguous array and each
+ * operator (fact) refers to its range of the array using offsets, so a
+ * traversal of the graph touches only a few contiguous arrays.
+ *
+ * The graph is built by adding edges (op, fact) with
+ * planFactOpGraphAddPre() and planFactOpGraphAddEff() and then calling
+ * planFactOpGraphFinalize(). Both directions, i.e., facts of an operator
+ * and operators of a fact, are created from the same edges and each row
+ * keeps the order in which the edges were added.
+ *
+ * The graph is oblivious to the meaning of facts and operators (fact IDs
+ * can be also IDs of fact pairs, operators can be artificial), the
+ * heuristics store their per-fact and per-operator values in their own
+ * dense arrays indexed by the same IDs.
+ */
+struct _plan_fact_op_graph_t {
+    int fact_size;     /*!< Number of facts */
+    int op_size;       /*!< Number of operators */
+
+    int *op_pre_beg;   /*!< Offsets to .op_pre, size is .op_size + 1 */
+    int *op_pre;       /*!< Precondition facts of operators */
+    int *op_eff_beg;   /*!< Offsets to .op_eff, size is .op_size + 1 */
+    int *op_eff;       /*!< Effect facts of operators */
+    int *fact_pre_beg; /*!< Offsets to .fact_pre, size is .fact_size + 1 */
+    int *fact_pre;     /*!< Operators having the fact as a precondition */
+    int *fact_eff_beg; /*!< Offsets to .fact_eff, size is .fact_size + 1 */
+    int *fact_eff;     /*!< Operators having the fact as an effect */
+
+    plan_arr_int_t pre_edge; /*!< Pairs (op, fact) added so far */
+    plan_arr_int_t eff_edge; /*!< Pairs (op, fact) added so far */
+};
+typedef struct _plan_fact_op_graph_t plan_fact_op_graph_t;
+
+/**
+ * Iterates over VAL in the row ID of the given offsets and edge array.
+ */
+#define PLAN_FACT_OP_GRAPH_FOR_EACH(BEG, EDGE, ID, VAL) \
+    for (int ___gi = (BEG)[(ID)], ___gend = (BEG)[(ID) + 1]; \
+         ___gi < ___gend && ((VAL) = (EDGE)[___gi], 1); ++___gi)
+
+/**
+ * Iterates over precondition facts of the operator.
+ */
+#define PLAN_FACT_OP_GRAPH_OP_PRE_FOR_EACH(G, OP_ID, FACT_ID) \
+    PLAN_FACT_OP_GRAPH_FOR_EACH((G)->op_pre_beg, (G)->op_pre, \
+                                (OP_ID), (FACT_ID))
+
+/**
+ * Iterates over effect facts of the operator.
+ */
+#define PLAN_FACT_OP_GRAPH_OP_EFF_FOR_EACH(G, OP_ID, FACT_ID) \
+    PLAN_FACT_OP_GRAPH_FOR_EACH((G)->op_eff_beg, (G)->op_eff, \
+                                (OP_ID), (FACT_ID))
+
+/**
+ * Iterates over operators having the fact as a precondition.
+ */
+#define PLAN_FACT_OP_GRAPH_FACT_PRE_FOR_EACH(G, FACT_ID, OP_ID) \
+    PLAN_FACT_OP_GRAPH_FOR_EACH((G)->fact_pre_beg, (G)->fact_pre, \
+                                (FACT_ID), (OP_ID))
+
+/**
+ * Iterates over operators having the fact as an effect.
+ */
+#define PLAN_FACT_OP_GRAPH_FACT_EFF_FOR_EACH(G, FACT_ID, OP_ID) \
+    PLAN_FACT_OP_GRAPH_FOR_EACH((G)->fact_eff_beg, (G)->fact_eff, \
+                                (FACT_ID), (OP_ID))
+
+/**
+ * Initializes an empty graph with the given number of facts and
+ * operators. The number of operators grows automatically as edges of
+ * operators with higher IDs are added.
+ */
+void planFactOpGraphInit(plan_fact_op_graph_t *g, int fact_size, int op_size);
+
+/**
+ * Frees allocated resources.
+ */
+void planFactOpGraphFree(plan_fact_op_graph_t *g);
+
+/**
+ * Adds fact as a precondition of the operator.
+ */
+void planFactOpGraphAddPre(plan_fact_op_graph_t *g, int op_id, int fact_id);
+
+/**
+ * Adds fact as an effect of the operator.
+ */
+void planFactOpGraphAddEff(plan_fact_op_graph_t *g, int op_id, int fact_id);
+
+/**
+ * Builds the compressed rows from the added edges. No edges can be added
+ * afterwards.
+ */
+void planFactOpGraphFinalize(plan_fact_op_graph_t *g);
+
+/**
+ * Returns number of bytes allocated by the graph.
+ */
+size_t planFactOpGraphMemUsage(const plan_fact_op_graph_t *g);
+
+/**
+ * Returns number of preconditions of the operator.
+ */
+_bor_inline int planFactOpGraphOpPreSize(const plan_fact_op_graph_t *g,
+                                         int op_id);
+
+/**
+ * Returns number of effects of the operator.
+ */
+_bor_inline int planFactOpGraphOpEffSize(const plan_fact_op_graph_t *g,
+                                         int op_id);
+
+
+/**** INLINES: ****/
+_bor_inline int planFactOpGraphOpPreSize(const plan_fact_op_graph_t *g,
+                                         int op_id)
+{
+    return g->op_pre_beg[op_id + 1] - g->op_pre_beg[op_id];
+}
+
+_bor_inline int planFactOpGraphOpEffSize(const plan_fact_op_graph_t *g,
+                                         int op_id)
+{
+    return g->op_eff_beg[op_id + 1] - g->op_eff_beg[op_id];
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __PLAN_FACT_OP_GRAPH_H__ */
@@ -0,0 +1,585 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+#include <boruvka/alloc.h>
+
+#include "plan/h2.h"
+
+#define WORD_BITS 64
+#define ROW(h2, pair, fact) ((pair) + (size_t)(fact) * (h2)->words)
+#define BIT_IS_SET(row, i) (((row)[(i) / WORD_BITS] >> ((i) % WORD_BITS)) & 1u)
+#define BIT_SET(row, i) ((row)[(i) / WORD_BITS] |= (1ull << ((i) % WORD_BITS)))
+
+static void loadOps(plan_h2_t *h2, const plan_problem_t *p)
+{
+    const plan_op_t *pop;
+    plan_h2_op_t *op;
+    int i, j, fid, size, *buf;
+
+    // Count the facts so that all operators can share one array
+    size = 0;
+    for (i = 0; i < p->op_size; ++i){
+        pop = p->op + i;
+        size += pop->pre->vals_size + pop->eff->vals_size;
+        for (j = 0; j < pop->cond_eff_size; ++j)
+            size += pop->cond_eff[j].eff->vals_size;
+    }
+
+    h2->op_size = p->op_size;
+    h2->op = BOR_CALLOC_ARR(plan_h2_op_t, h2->op_size);
+    h2->op_fact = BOR_ALLOC_ARR(int, BOR_MAX(size, 1));
+    buf = h2->op_fact;
+    for (i = 0; i < p->op_size; ++i){
+        pop = p->op + i;
+        op = h2->op + i;
+        op->cost = pop->cost;
+
+        op->pre = buf;
+        PLAN_FACT_ID_FOR_EACH_PART_STATE(&h2->fact_id, pop->pre, fid)
+            op->pre[op->pre_size++] = fid;
+        buf += op->pre_size;
+
+        op->eff = buf;
+        PLAN_FACT_ID_FOR_EACH_PART_STATE(&h2->fact_id, pop->eff, fid)
+            op->eff[op->eff_size++] = fid;
+        op->del_size = op->eff_size;
+        for (j = 0; j < pop->cond_eff_size; ++j){
+            PLAN_FACT_ID_FOR_EACH_PART_STATE(&h2->fact_id,
+                                             pop->cond_eff[j].eff, fid){
+                op->eff[op->eff_size++] = fid;
+            }
+        }
+        buf += op->eff_size;
+    }
+}
+
+/** Reverses operators for the backward direction */
+static void loadOpsBackward(plan_h2_t *h2, const plan_problem_t *p)
+{
+    const plan_op_t *pop;
+    const plan_part_state_t *ps;
+    plan_h2_op_t *op;
+    plan_var_id_t var;
+    plan_val_t val;
+    int *pre_val, *changed;
+    int i, j, k, fid, size, *buf;
+
+    // Each effect variable can turn into all its values
+    size = 0;
+    for (i = 0; i < p->op_size; ++i){
+        pop = p->op + i;
+        size += pop->pre->vals_size + pop->eff->vals_size;
+        PLAN_PART_STATE_FOR_EACH(pop->eff, k, var, val)
+            size += p->var[var].range;
+        for (j = 0; j < pop->cond_eff_size; ++j){
+            PLAN_PART_STATE_FOR_EACH(pop->cond_eff[j].eff, k, var, val)
+                size += p->var[var].range;
+        }
+    }
+
+    h2->op_size = p->op_size;
+    h2->op = BOR_CALLOC_ARR(plan_h2_op_t, h2->op_size);
+    h2->op_fact = BOR_ALLOC_ARR(int, BOR_MAX(size, 1));
+
+    // changed[var] is 1 for the variables set by the effect, 2 for the
+    // variables set by a conditional effect (their value after the
+    // operator is not known) and 0 otherwise.
+    pre_val = BOR_ALLOC_ARR(int, BOR_MAX(p->var_size, 1));
+    changed = BOR_CALLOC_ARR(int, BOR_MAX(p->var_size, 1));
+    for (i = 0; i < p->var_size; ++i)
+        pre_val[i] = -1;
+
+    buf = h2->op_fact;
+    for (i = 0; i < p->op_size; ++i){
+        pop = p->op + i;
+        op = h2->op + i;
+        op->cost = pop->cost;
+
+        PLAN_PART_STATE_FOR_EACH(pop->pre, k, var, val)
+            pre_val[var] = val;
+        PLAN_PART_STATE_FOR_EACH(pop->eff, k, var, val)
+            changed[var] = 1;
+        for (j = 0; j < pop->cond_eff_size; ++j){
+            PLAN_PART_STATE_FOR_EACH(pop->cond_eff[j].eff, k, var, val)
+                changed[var] = 2;
+        }
+
+        // The effects and prevail conditions hold after the operator
+        op->pre = buf;
+        PLAN_PART_STATE_FOR_EACH(pop->eff, k, var, val){
+            fid = planFactIdVar(&h2->fact_id, var, val);
+            if (changed[var] == 1 && fid >= 0)
+                op->pre[op->pre_size++] = fid;
+        }
+        PLAN_PART_STATE_FOR_EACH(pop->pre, k, var, val){
+            fid = planFactIdVar(&h2->fact_id, var, val);
+            if (changed[var] == 0 && fid >= 0)
+                op->pre[op->pre_size++] = fid;
+        }
+        buf += op->pre_size;
+
+        // The changed variables had the value of the precondition before
+        // or any value if there is no precondition on them
+        op->eff = buf;
+        for (j = -1; j < pop->cond_eff_size; ++j){
+            ps = (j < 0 ? pop->eff : pop->cond_eff[j].eff);
+            PLAN_PART_STATE_FOR_EACH(ps, k, var, val){
+                if (changed[var] < 0)
+                    continue;
+                changed[var] = -1;
+
+                if (pre_val[var] >= 0){
+                    fid = planFactIdVar(&h2->fact_id, var, pre_val[var]);
+                    if (fid >= 0)
+                        op->eff[op->eff_size++] = fid;
+                    continue;
+                }
+
+                for (val = 0; val < p->var[var].range; ++val){
+                    fid = planFactIdVar(&h2->fact_id, var, val);
+                    if (fid >= 0)
+                        op->eff[op->eff_size++] = fid;
+                }
+            }
+        }
+        op->del_size = op->eff_size;
+        buf += op->eff_size;
+
+        PLAN_PART_STATE_FOR_EACH(pop->pre, k, var, val)
+            pre_val[var] = -1;
+        PLAN_PART_STATE_FOR_EACH(pop->eff, k, var, val)
+            changed[var] = 0;
+        for (j = 0; j < pop->cond_eff_size; ++j){
+            PLAN_PART_STATE_FOR_EACH(pop->cond_eff[j].eff, k, var, val)
+                changed[var] = 0;
+        }
+    }
+
+    BOR_FREE(pre_val);
+    BOR_FREE(changed);
+}
+
+static void init(plan_h2_t *h2, const plan_problem_t *p)
+{
+    int var, val, fid;
+
+    bzero(h2, sizeof(*h2));
+    planFactIdInit(&h2->fact_id, p->var, p->var_size, 0);
+    h2->fact_size = h2->fact_id.fact_size;
+    h2->words = (h2->fact_size + WORD_BITS - 1) / WORD_BITS;
+    h2->words = BOR_MAX(h2->words, 1);
+
+    h2->pair = BOR_ALLOC_ARR(uint64_t, (size_t)h2->fact_size * h2->words);
+    h2->fact = BOR_ALLOC_ARR(uint64_t, h2->words);
+    h2->mask = BOR_ALLOC_ARR(uint64_t, h2->words);
+    h2->row_stamp = BOR_ALLOC_ARR(int, h2->fact_size);
+
+    h2->var_beg = BOR_ALLOC_ARR(int, h2->fact_size);
+    h2->var_end = BOR_ALLOC_ARR(int, h2->fact_size);
+    for (var = 0; var < p->var_size; ++var){
+        for (val = 0; val < p->var[var].range; ++val){
+            fid = planFactIdVar(&h2->fact_id, var, val);
+            if (fid < 0)
+                continue;
+            h2->var_beg[fid] = planFactIdVar(&h2->fact_id, var, 0);
+            h2->var_end[fid] = h2->var_beg[fid] + p->var[var].range;
+        }
+    }
+}
+
+void planH2Init(plan_h2_t *h2, const plan_problem_t *p)
+{
+    init(h2, p);
+    loadOps(h2, p);
+}
+
+void planH2InitBackward(plan_h2_t *h2, const plan_problem_t *p)
+{
+    init(h2, p);
+    loadOpsBackward(h2, p);
+}
+
+void planH2Free(plan_h2_t *h2)
+{
+    int i;
+
+    for (i = 0; i < h2->layer_size; ++i){
+        BOR_FREE(h2->layer[i].pair);
+        BOR_FREE(h2->layer[i].row_dirty);
+    }
+    if (h2->layer)
+        BOR_FREE(h2->layer);
+    if (h2->op)
+        BOR_FREE(h2->op);
+    if (h2->op_fact)
+        BOR_FREE(h2->op_fact);
+    BOR_FREE(h2->pair);
+    BOR_FREE(h2->fact);
+    BOR_FREE(h2->mask);
+    BOR_FREE(h2->row_stamp);
+    BOR_FREE(h2->var_beg);
+    BOR_FREE(h2->var_end);
+    planFactIdFree(&h2->fact_id);
+}
+
+/** Returns layer with the given value, a new one is created if needed */
+static plan_h2_layer_t *layerGet(plan_h2_t *h2, plan_cost_t value)
+{
+    plan_h2_layer_t *layer, *free_layer = NULL;
+    int i;
+
+    for (i = 0; i < h2->layer_size; ++i){
+        layer = h2->layer + i;
+        if (layer->active && layer->value == value)
+            return layer;
+        if (!layer->active && free_layer == NULL)
+            free_layer = layer;
+    }
+
+    if (free_layer == NULL){
+        ++h2->layer_size;
+        h2->layer = BOR_REALLOC_ARR(h2->layer, plan_h2_layer_t,
+                                    h2->layer_size);
+        free_layer = h2->layer + h2->layer_size - 1;
+        free_layer->pair = BOR_CALLOC_ARR(uint64_t,
+                                          (size_t)h2->fact_size * h2->words);
+        free_layer->row_dirty = BOR_CALLOC_ARR(char, h2->fact_size);
+    }
+
+    free_layer->value = value;
+    free_layer->active = 1;
+    return free_layer;
+}
+
+/** Returns active layer with the lowest value or NULL */
+static plan_h2_layer_t *layerMin(plan_h2_t *h2)
+{
+    plan_h2_layer_t *layer = NULL;
+    int i;
+
+    for (i = 0; i < h2->layer_size; ++i){
+        if (h2->layer[i].active
+                && (layer == NULL || h2->layer[i].value < layer->value)){
+            layer = h2->layer + i;
+        }
+    }
+    return layer;
+}
+
+/** Adds pair (f1, f2) to the matrix */
+_bor_inline void addPair(plan_h2_t *h2, int f1, int f2)
+{
+    BIT_SET(ROW(h2, h2->pair, f1), f2);
+    BIT_SET(ROW(h2, h2->pair, f2), f1);
+    h2->row_stamp[f1] = h2->row_stamp[f2] = h2->stamp;
+}
+
+/** Merges layer to the matrix of reachable pairs and deactivates it */
+static void layerMerge(plan_h2_t *h2, plan_h2_layer_t *layer)
+{
+    uint64_t *lrow, *row, w;
+    int f, i, b;
+
+    for (f = 0; f < h2->fact_size; ++f){
+        if (!layer->row_dirty[f])
+            continue;
+        layer->row_dirty[f] = 0;
+
+        lrow = ROW(h2, layer->pair, f);
+        row = ROW(h2, h2->pair, f);
+        for (i = 0; i < h2->words; ++i){
+            w = lrow[i] & ~row[i];
+            lrow[i] = 0;
+            while (w != 0){
+                b = i * WORD_BITS + __builtin_ctzll(w);
+                w &= w - 1;
+                addPair(h2, f, b);
+                if (b == f){
+                    BIT_SET(h2->fact, f);
+                    h2->fact_stamp = h2->stamp;
+                }
+            }
+        }
+    }
+    layer->active = 0;
+}
+
+static int isApplicable(const plan_h2_t *h2, const plan_h2_op_t *op)
+{
+    const uint64_t *row;
+    int i, j;
+
+    for (i = 0; i < op->pre_size; ++i){
+        row = ROW(h2, h2->pair, op->pre[i]);
+        for (j = i; j < op->pre_size; ++j){
+            if (!BIT_IS_SET(row, op->pre[j]))
+                return 0;
+        }
+    }
+    return 1;
+}
+
+static int opNeedsUpdate(const plan_h2_t *h2, const plan_h2_op_t *op)
+{
+    int i;
+
+    if (op->pre_size == 0)
+        return h2->fact_stamp > op->stamp;
+    for (i = 0; i < op->pre_size; ++i){
+        if (h2->row_stamp[op->pre[i]] > op->stamp)
+            return 1;
+    }
+    return 0;
+}
+
+/** Clears bits [from, to) of the row */
+static void clearRange(uint64_t *row, int from, int to)
+{
+    int w1 = from / WORD_BITS, w2 = (to - 1) / WORD_BITS;
+    uint64_t m1 = ~0ull << (from % WORD_BITS);
+    uint64_t m2 = ~0ull >> (WORD_BITS - 1 - ((to - 1) % WORD_BITS));
+    int i;
+
+    if (from >= to)
+        return;
+    if (w1 == w2){
+        row[w1] &= ~(m1 & m2);
+        return;
+    }
+    row[w1] &= ~m1;
+    for (i = w1 + 1; i < w2; ++i)
+        row[i] = 0;
+    row[w2] &= ~m2;
+}
+
+/** Applies operator on the current matrix and records the new pairs to
+ *  the layer of the given value */
+static void applyOp(plan_h2_t *h2, const plan_h2_op_t *op, plan_cost_t value)
+{
+    plan_h2_layer_t *layer = NULL;
+    uint64_t *mask = h2->mask, *row, *lrow, w;
+    int i, j, e, words = h2->words;
+
+    // Facts that can be reached together with each effect: those that
+    // are reachable with all preconditions and are not deleted
+    if (op->pre_size == 0){
+        memcpy(mask, h2->fact, sizeof(uint64_t) * words);
+    }else{
+        memcpy(mask, ROW(h2, h2->pair, op->pre[0]), sizeof(uint64_t) * words);
+        for (i = 1; i < op->pre_size; ++i){
+            row = ROW(h2, h2->pair, op->pre[i]);
+            for (j = 0; j < words; ++j)
+                mask[j] &= row[j];
+        }
+    }
+    for (i = 0; i < op->del_size; ++i){
+        e = op->eff[i];
+        clearRange(mask, h2->var_beg[e], h2->var_end[e]);
+    }
+    for (i = 0; i < op->eff_size; ++i)
+        BIT_SET(mask, op->eff[i]);
+
+    for (i = 0; i < op->eff_size; ++i){
+        e = op->eff[i];
+        row = ROW(h2, h2->pair, e);
+        lrow = NULL;
+        for (j = 0; j < words; ++j){
+            w = mask[j] & ~row[j];
+            if (w == 0)
+                continue;
+
+            if (layer == NULL)
+                layer = layerGet(h2, value);
+            if (lrow == NULL){
+                lrow = ROW(h2, layer->pair, e);
+                layer->row_dirty[e] = 1;
+            }
+            lrow[j] |= w;
+        }
+    }
+}
+
+static void addState(plan_h2_t *h2, const plan_state_t *state)
+{
+    const int *facts;
+    int size, i, j;
+
+    facts = planFactIdState(&h2->fact_id, state, &size);
+    for (i = 0; i < size; ++i){
+        if (facts[i] < 0)
+            continue;
+        BIT_SET(h2->fact, facts[i]);
+        for (j = i; j < size; ++j){
+            if (facts[j] >= 0)
+                addPair(h2, facts[i], facts[j]);
+        }
+    }
+    h2->fact_stamp = h2->stamp;
+}
+
+/** Sets all pairs of facts consistent with the goal as reached */
+static void addGoalRegression(plan_h2_t *h2, const plan_part_state_t *goal)
+{
+    uint64_t *row;
+    int f, fid;
+
+    for (f = 0; f < h2->fact_size; ++f)
+        BIT_SET(h2->fact, f);
+    PLAN_FACT_ID_FOR_EACH_PART_STATE(&h2->fact_id, goal, fid){
+        clearRange(h2->fact, h2->var_beg[fid], h2->var_end[fid]);
+        BIT_SET(h2->fact, fid);
+    }
+
+    for (f = 0; f < h2->fact_size; ++f){
+        if (!BIT_IS_SET(h2->fact, f))
+            continue;
+        row = ROW(h2, h2->pair, f);
+        memcpy(row, h2->fact, sizeof(uint64_t) * h2->words);
+        clearRange(row, h2->var_beg[f], h2->var_end[f]);
+        BIT_SET(row, f);
+        h2->row_stamp[f] = h2->stamp;
+    }
+    h2->fact_stamp = h2->stamp;
+}
+
+static int goalReached(const plan_h2_t *h2, const int *goal, int goal_size)
+{
+    const uint64_t *row;
+    int i, j;
+
+    for (i = 0; i < goal_size; ++i){
+        row = ROW(h2, h2->pair, goal[i]);
+        for (j = i; j < goal_size; ++j){
+            if (!BIT_IS_SET(row, goal[j]))
+                return 0;
+        }
+    }
+    return 1;
+}
+
+/** Clears the matrix and all layers */
+static void reset(plan_h2_t *h2)
+{
+    int i;
+
+    bzero(h2->pair, sizeof(uint64_t) * h2->fact_size * h2->words);
+    bzero(h2->fact, sizeof(uint64_t) * h2->words);
+    bzero(h2->row_stamp, sizeof(int) * h2->fact_size);
+    for (i = 0; i < h2->op_size; ++i)
+        h2->op[i].stamp = 0;
+    for (i = 0; i < h2->layer_size; ++i){
+        if (h2->layer[i].active){
+            h2->layer[i].active = 0;
+            bzero(h2->layer[i].pair,
+                  sizeof(uint64_t) * h2->fact_size * h2->words);
+            bzero(h2->layer[i].row_dirty, h2->fact_size);
+        }
+    }
+
+    h2->stamp = 1;
+}
+
+/** Runs propagation from the pairs set in the matrix */
+static plan_cost_t run(plan_h2_t *h2, const int *goal, int goal_size,
+                       int use_cost)
+{
+    plan_h2_layer_t *layer;
+    plan_h2_op_t *op;
+    plan_cost_t value = 0;
+    int i;
+
+    while (1){
+        if (goal != NULL && goalReached(h2, goal, goal_size))
+            return value;
+
+        // Apply all operators whose preconditions were changed since the
+        // last application
+        for (i = 0; i < h2->op_size; ++i){
+            op = h2->op + i;
+            if (!opNeedsUpdate(h2, op))
+                continue;
+            op->stamp = h2->stamp;
+            if (isApplicable(h2, op))
+                applyOp(h2, op, value + (use_cost ? op->cost : 0));
+        }
+        ++h2->stamp;
+
+        if ((layer = layerMin(h2)) == NULL)
+            break;
+        value = layer->value;
+        layerMerge(h2, layer);
+    }
+
+    return PLAN_HEUR_DEAD_END;
+}
+
+plan_cost_t planH2(plan_h2_t *h2, const plan_state_t *state,
+                   const plan_part_state_t *goal)
+{
+    plan_cost_t value;
+    int *gfact, gsize = 0, fid;
+
+    gfact = BOR_ALLOC_ARR(int, BOR_MAX(goal->vals_size, 1));
+    PLAN_FACT_ID_FOR_EACH_PART_STATE(&h2->fact_id, goal, fid)
+        gfact[gsize++] = fid;
+    reset(h2);
+    addState(h2, state);
+    value = run(h2, gfact, gsize, 1);
+    BOR_FREE(gfact);
+    return value;
+}
+
+void planH2Mutex(plan_h2_t *h2, const plan_state_t *state)
+{
+    reset(h2);
+    addState(h2, state);
+    run(h2, NULL, 0, 0);
+}
+
+void planH2MutexBackward(plan_h2_t *h2, const plan_part_state_t *goal)
+{
+    reset(h2);
+    addGoalRegression(h2, goal);
+    run(h2, NULL, 0, 0);
+}
+
+int planH2IsMutex(const plan_h2_t *h2,
+                  plan_var_id_t var1, plan_val_t val1,
+                  plan_var_id_t var2, plan_val_t val2)
+{
+    int f1, f2;
+
+    if (var1 == var2)
+        return val1 != val2 || !planH2IsReachable(h2, var1, val1);
+
+    f1 = planFactIdVar(&h2->fact_id, var1, val1);
+    f2 = planFactIdVar(&h2->fact_id, var2, val2);
+    if (f1 < 0 || f2 < 0)
+        return 0;
+    return !BIT_IS_SET(ROW(h2, h2->pair, f1), f2);
+}
+
+int planH2IsReachable(const plan_h2_t *h2, plan_var_id_t var, plan_val_t val)
+{
+    int f = planFactIdVar(&h2->fact_id, var, val);
+    if (f < 0)
+        return 1;
+    return BIT_IS_SET(h2->fact, f);
+}
@@ -47,6 +47,18 @@ void _planHeurMAInit(plan_heur_t *heur,
     heur->ma = 1;
 }
 
+void _planHeurMemUsageInit(plan_heur_t *heur,
+                           plan_heur_mem_usage_fn mem_usage_fn)
+{
+    heur->mem_usage_fn = mem_usage_fn;
+}
+
+void _planHeurShedMemInit(plan_heur_t *heur,
+                          plan_heur_shed_mem_fn shed_mem_fn)
+{
+    heur->shed_mem_fn = shed_mem_fn;
+}
+
 void _planHeurFree(plan_heur_t *heur)
 {
 }
@@ -74,6 +86,28 @@ void planHeurState(plan_heur_t *heur, const plan_state_t *state,
     heur->heur_state_fn(heur, state, res);
 }
 
+size_t planHeurMemUsage(const plan_heur_t *heur)
+{
+    if (heur->mem_usage_fn)
+        return heur->mem_usage_fn(heur);
+    return 0;
+}
+
+size_t planHeurShedMem(plan_heur_t *heur, int level)
+{
+    size_t before, after;
+
+    if (heur->shed_mem_fn == NULL || level == PLAN_MEM_PRESSURE_NONE)
+        return 0;
+
+    before = planHeurMemUsage(heur);
+    heur->shed_mem_fn(heur, level);
+    after = planHeurMemUsage(heur);
+    if (after >= before)
+        return 0;
+    return before - after;
+}
+
 void planHeurMAInit(plan_heur_t *heur, int agent_size, int agent_id,
                     plan_ma_state_t *ma_state)
 {
@@ -82,6 +82,7 @@ typedef struct _plan_heur_add_max_t plan_heur_add_max_t;
 #define HEUR(parent) bor_container_of((parent), plan_heur_add_max_t, heur)
 
 static void heurDel(plan_heur_t *_heur);
+static size_t heurMemUsage(const plan_heur_t *_heur);
 static void heurVal(plan_heur_t *_heur, const plan_state_t *state,
                     plan_heur_res_t *res);
 
@@ -97,6 +98,7 @@ plan_heur_t *NEW_FN(const plan_problem_t *p, unsigned flags)
     bzero(h, sizeof(*h));
     h->flags = flags;
     _planHeurInit(&h->heur, heurDel, heurVal, NULL);
+    _planHeurMemUsageInit(&h->heur, heurMemUsage);
     planFactIdInit(&h->fact_id, p->var, p->var_size, 0);
     loadOpFact(h, p);
 
@@ -123,6 +125,23 @@ static void heurDel(plan_heur_t *_heur)
     BOR_FREE(h);
 }
 
+static size_t heurMemUsage(const plan_heur_t *_heur)
+{
+    const plan_heur_add_max_t *h;
+    size_t size;
+    int i;
+
+    h = bor_container_of(_heur, const plan_heur_add_max_t, heur);
+    size  = sizeof(*h);
+    size += sizeof(fact_t) * h->fact_size;
+    for (i = 0; i < h->fact_size; ++i)
+        size += planArrIntMemUsage(&h->fact[i].pre_op);
+    size += sizeof(op_t) * h->op_alloc;
+    for (i = 0; i < h->op_size; ++i)
+        size += planArrIntMemUsage(&h->op[i].eff);
+    return size;
+}
+
 static void initFacts(plan_heur_add_max_t *h)
 {
     int i;
@@ -0,0 +1,478 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+#include <boruvka/alloc.h>
+#include "plan/arr.h"
+#include "plan/pq.h"
+#include "plan/fact_id.h"
+#include "plan/heur.h"
+#include "pref_op_selector.h"
+
+/**
+ * Combined h^add, h^max and h^FF
+ * ===============================
+ *
+ * The exploration is a Dijkstra-style search over facts ordered by their
+ * h^max values, so h^max is computed exactly as in heur_add_max.c. An
+ * operator is reached when its last precondition is popped from the
+ * queue and at that time its h^add value is the sum of the current h^add
+ * values of its preconditions. Since h^add values are not ordered by
+ * h^max, a fact can get a lower h^add value after it was already used by
+ * some reached operators -- the difference is then propagated to these
+ * operators and to their effects (label-correcting).
+ *
+ * An operator reached from a fact popped with h^max value v has h^add
+ * value at least v and so has everything that is derived from it. The
+ * exploration can therefore terminate as soon as the goal was popped and
+ * the lowest h^max value in the queue is not lower than the h^add value
+ * of the goal. The relaxed plan is then extracted using the best
+ * supporters w.r.t. h^add.
+ */
+
+struct _op_t {
+    plan_arr_int_t pre; /*!< Facts in its precondition */
+    plan_arr_int_t eff; /*!< Facts in its effect */
+    int cost;           /*!< Cost of the operator */
+    int parent;         /*!< ID of the original operator, -1 for goal */
+    int unsat;          /*!< Number of unsatisfied preconditions */
+    int add;            /*!< h^add value, valid only if .unsat == 0 */
+};
+typedef struct _op_t op_t;
+
+struct _fact_t {
+    plan_arr_int_t pre_op; /*!< Operators having this fact as its
+                                precondition */
+    plan_pq_el_t heap;     /*!< Connection to priority heap, the key is
+                                h^max value of the fact */
+    int add;               /*!< h^add value of the fact */
+    int supp;              /*!< Best supporter w.r.t. h^add */
+};
+typedef struct _fact_t fact_t;
+
+#define FID(heur, f) ((f) - (heur)->fact)
+#define FMAX(fact) (fact)->heap.key
+#define FMAX_SET(fact, val) do { (fact)->heap.key = val; } while(0)
+#define FMAX_INIT(fact) FMAX_SET((fact), INT_MAX)
+#define FMAX_IS_SET(fact) (FMAX(fact) != INT_MAX)
+
+#define FPUSH(pq, value, fact) \
+    do { \
+    if (FMAX_IS_SET(fact)){ \
+        planPQUpdate((pq), (value), &(fact)->heap); \
+    }else{ \
+        planPQPush((pq), (value), &(fact)->heap); \
+    } \
+    } while (0)
+
+struct _plan_heur_add_max_ff_t {
+    plan_heur_t heur;
+    unsigned flags;
+    plan_fact_id_t fact_id;
+    const plan_op_t *base_op;
+
+    fact_t *fact;
+    int fact_size;
+    int fact_goal;
+    int fact_nopre;
+
+    op_t *op;
+    int op_alloc;
+    int op_size;
+    int op_goal;
+    int base_op_size;
+
+    plan_arr_int_t stack; /*!< Pre-allocated stack */
+    char *plan_fact;      /*!< Facts in the relaxed plan */
+    char *plan_op;        /*!< Original operators in the relaxed plan */
+};
+typedef struct _plan_heur_add_max_ff_t plan_heur_add_max_ff_t;
+
+#define HEUR(parent) bor_container_of((parent), plan_heur_add_max_ff_t, heur)
+
+static void heurDel(plan_heur_t *_heur);
+static size_t heurMemUsage(const plan_heur_t *_heur);
+static void heurVal(plan_heur_t *_heur, const plan_state_t *state,
+                    plan_heur_res_t *res);
+
+static void loadOpFact(plan_heur_add_max_ff_t *h, const plan_problem_t *p);
+
+plan_heur_t *planHeurAddMaxFFNew(const plan_problem_t *p, unsigned flags)
+{
+    plan_heur_add_max_ff_t *h;
+
+    h = BOR_ALLOC(plan_heur_add_max_ff_t);
+    bzero(h, sizeof(*h));
+    h->flags = flags;
+    h->base_op = p->op;
+    h->base_op_size = p->op_size;
+    _planHeurInit(&h->heur, heurDel, heurVal, NULL);
+    _planHeurMemUsageInit(&h->heur, heurMemUsage);
+    planFactIdInit(&h->fact_id, p->var, p->var_size, 0);
+    loadOpFact(h, p);
+
+    planArrIntInit(&h->stack, h->op_size);
+    h->plan_fact = BOR_ALLOC_ARR(char, h->fact_size);
+    h->plan_op = BOR_ALLOC_ARR(char, BOR_MAX(h->base_op_size, 1));
+
+    return &h->heur;
+}
+
+static void heurDel(plan_heur_t *_heur)
+{
+    plan_heur_add_max_ff_t *h = HEUR(_heur);
+    int i;
+
+    _planHeurFree(&h->heur);
+    planFactIdFree(&h->fact_id);
+
+    for (i = 0; i < h->fact_size; ++i)
+        planArrIntFree(&h->fact[i].pre_op);
+    if (h->fact)
+        BOR_FREE(h->fact);
+
+    for (i = 0; i < h->op_size; ++i){
+        planArrIntFree(&h->op[i].pre);
+        planArrIntFree(&h->op[i].eff);
+    }
+    if (h->op)
+        BOR_FREE(h->op);
+
+    planArrIntFree(&h->stack);
+    BOR_FREE(h->plan_fact);
+    BOR_FREE(h->plan_op);
+    BOR_FREE(h);
+}
+
+static size_t heurMemUsage(const plan_heur_t *_heur)
+{
+    const plan_heur_add_max_ff_t *h;
+    size_t size;
+    int i;
+
+    h = bor_container_of(_heur, const plan_heur_add_max_ff_t, heur);
+    size  = sizeof(*h);
+    size += sizeof(fact_t) * h->fact_size;
+    for (i = 0; i < h->fact_size; ++i)
+        size += planArrIntMemUsage(&h->fact[i].pre_op);
+    size += sizeof(op_t) * h->op_alloc;
+    for (i = 0; i < h->op_size; ++i){
+        size += planArrIntMemUsage(&h->op[i].pre);
+        size += planArrIntMemUsage(&h->op[i].eff);
+    }
+    size += planArrIntMemUsage(&h->stack);
+    size += h->fact_size + BOR_MAX(h->base_op_size, 1);
+    return size;
+}
+
+static void initFactsOps(plan_heur_add_max_ff_t *h)
+{
+    int i;
+
+    for (i = 0; i < h->fact_size; ++i){
+        FMAX_INIT(h->fact + i);
+        h->fact[i].add = INT_MAX;
+        h->fact[i].supp = -1;
+    }
+
+    for (i = 0; i < h->op_size; ++i)
+        h->op[i].unsat = h->op[i].pre.size;
+}
+
+static void addFact(plan_heur_add_max_ff_t *h, int fact_id, plan_pq_t *pq)
+{
+    FPUSH(pq, 0, h->fact + fact_id);
+    h->fact[fact_id].add = 0;
+}
+
+static void addInitState(plan_heur_add_max_ff_t *h,
+                         const plan_state_t *state,
+                         plan_pq_t *pq)
+{
+    int fact_id;
+
+    PLAN_FACT_ID_FOR_EACH_STATE(&h->fact_id, state, fact_id)
+        addFact(h, fact_id, pq);
+    addFact(h, h->fact_nopre, pq);
+}
+
+/** Sets a lower h^add value of the fact and updates values of the
+ *  already reached operators. The operators are pushed to the stack. */
+static void setAdd(plan_heur_add_max_ff_t *h, fact_t *fact,
+                   int value, int supp)
+{
+    op_t *op;
+    int delta, op_id;
+
+    delta = fact->add - value;
+    fact->add = value;
+    fact->supp = supp;
+
+    // Only operators that were already reached need to be updated, the
+    // others read the value once they are reached
+    PLAN_ARR_INT_FOR_EACH(&fact->pre_op, op_id){
+        op = h->op + op_id;
+        if (op->unsat == 0){
+            op->add -= delta;
+            planArrIntAdd(&h->stack, op_id);
+        }
+    }
+}
+
+/** Propagates h^add values of the operators in the stack */
+static void propagateAdd(plan_heur_add_max_ff_t *h)
+{
+    fact_t *fact;
+    op_t *op;
+    int op_id, fact_id;
+
+    while (h->stack.size > 0){
+        op_id = h->stack.arr[--h->stack.size];
+        op = h->op + op_id;
+        PLAN_ARR_INT_FOR_EACH(&op->eff, fact_id){
+            fact = h->fact + fact_id;
+            if (fact->add > op->add)
+                setAdd(h, fact, op->add, op_id);
+        }
+    }
+}
+
+static void opReached(plan_heur_add_max_ff_t *h, int op_id, int max,
+                      plan_pq_t *pq)
+{
+    op_t *op = h->op + op_id;
+    fact_t *fact;
+    int fact_id;
+
+    op->add = op->cost;
+    PLAN_ARR_INT_FOR_EACH(&op->pre, fact_id)
+        op->add += h->fact[fact_id].add;
+    max += op->cost;
+
+    PLAN_ARR_INT_FOR_EACH(&op->eff, fact_id){
+        fact = h->fact + fact_id;
+        if (FMAX(fact) > max)
+            FPUSH(pq, max, fact);
+        if (fact->add > op->add){
+            setAdd(h, fact, op->add, op_id);
+            propagateAdd(h);
+        }
+    }
+}
+
+/** Marks relaxed plan and returns its cost */
+static int markPlan(plan_heur_add_max_ff_t *h)
+{
+    const op_t *op;
+    int fact_id, value = 0;
+
+    bzero(h->plan_fact, h->fact_size);
+    bzero(h->plan_op, BOR_MAX(h->base_op_size, 1));
+
+    h->stack.size = 0;
+    planArrIntAdd(&h->stack, h->fact_goal);
+    while (h->stack.size > 0){
+        fact_id = h->stack.arr[--h->stack.size];
+        if (h->plan_fact[fact_id])
+            continue;
+        h->plan_fact[fact_id] = 1;
+        if (h->fact[fact_id].supp < 0)
+            continue;
+
+        op = h->op + h->fact[fact_id].supp;
+        PLAN_ARR_INT_FOR_EACH(&op->pre, fact_id){
+            if (!h->plan_fact[fact_id])
+                planArrIntAdd(&h->stack, fact_id);
+        }
+
+        if (op->parent >= 0 && !h->plan_op[op->parent]){
+            h->plan_op[op->parent] = 1;
+            value += op->cost;
+        }
+    }
+
+    return value;
+}
+
+static void prefOps(plan_heur_add_max_ff_t *h, plan_heur_res_t *res)
+{
+    plan_pref_op_selector_t sel;
+    int i;
+
+    // Select preferred operators as those that are in relaxed plan
+    planPrefOpSelectorInit(&sel, res, h->base_op);
+    for (i = 0; i < h->base_op_size; ++i){
+        if (h->plan_op[i])
+            planPrefOpSelectorSelect(&sel, i);
+    }
+    planPrefOpSelectorFinalize(&sel);
+}
+
+static void heurVal(plan_heur_t *_heur, const plan_state_t *state,
+                    plan_heur_res_t *res)
+{
+    plan_heur_add_max_ff_t *h = HEUR(_heur);
+    plan_pq_t pq;
+    plan_pq_el_t *el;
+    fact_t *fact, *goal = h->fact + h->fact_goal;
+    int op_id, value, goal_popped = 0;
+
+    planPQInit(&pq);
+    initFactsOps(h);
+    h->stack.size = 0;
+    addInitState(h, state, &pq);
+    while (!planPQEmpty(&pq)){
+        el = planPQPop(&pq, &value);
+        fact = bor_container_of(el, fact_t, heap);
+
+        // Nothing reached from now on can lower h^add of the goal
+        if (goal_popped && value >= goal->add)
+            break;
+        if (fact == goal){
+            goal_popped = 1;
+            if (value >= goal->add)
+                break;
+            continue;
+        }
+
+        PLAN_ARR_INT_FOR_EACH(&fact->pre_op, op_id){
+            if (--h->op[op_id].unsat == 0)
+                opReached(h, op_id, value, &pq);
+        }
+    }
+    planPQFree(&pq);
+
+    if (!FMAX_IS_SET(goal)){
+        res->heur = res->heur_add = res->heur_max = res->heur_ff
+            = PLAN_HEUR_DEAD_END;
+        return;
+    }
+
+    res->heur_max = FMAX(goal);
+    res->heur_add = goal->add;
+    res->heur_ff = markPlan(h);
+    res->heur = res->heur_ff;
+
+    if (res->pref_op)
+        prefOps(h, res);
+}
+
+static op_t *nextOp(plan_heur_add_max_ff_t *h)
+{
+    if (h->op_size == h->op_alloc){
+        h->op_alloc *= 2;
+        h->op = BOR_REALLOC_ARR(h->op, op_t, h->op_alloc);
+        bzero(h->op + h->op_size, sizeof(op_t) * (h->op_alloc - h->op_size));
+    }
+
+    return h->op + h->op_size++;
+}
+
+static int getCost(const plan_heur_add_max_ff_t *h, const plan_op_t *op)
+{
+    int cost;
+
+    cost = op->cost;
+    if (h->flags & PLAN_HEUR_OP_UNIT_COST)
+        cost = 1;
+    if (h->flags & PLAN_HEUR_OP_COST_PLUS_ONE)
+        cost = cost + 1;
+    return cost;
+}
+
+/** Adds the fact to the precondition of the operator */
+static void addPre(plan_heur_add_max_ff_t *h, int op_id, int fact_id)
+{
+    planArrIntAdd(&h->op[op_id].pre, fact_id);
+    planArrIntAdd(&h->fact[fact_id].pre_op, op_id);
+}
+
+static void addCondEff(plan_heur_add_max_ff_t *h, int parent_op_id,
+                       const plan_op_t *pop,
+                       const plan_op_cond_eff_t *cond_eff)
+{
+    op_t *op = nextOp(h);
+    int op_id = op - h->op;
+    int fid;
+
+    op->cost = getCost(h, pop);
+    op->parent = parent_op_id;
+
+    PLAN_FACT_ID_FOR_EACH_PART_STATE(&h->fact_id, pop->pre, fid)
+        addPre(h, op_id, fid);
+    PLAN_FACT_ID_FOR_EACH_PART_STATE(&h->fact_id, cond_eff->pre, fid)
+        addPre(h, op_id, fid);
+    if (h->op[op_id].pre.size == 0)
+        addPre(h, op_id, h->fact_nopre);
+
+    PLAN_FACT_ID_FOR_EACH_PART_STATE(&h->fact_id, cond_eff->eff, fid)
+        planArrIntAdd(&h->op[op_id].eff, fid);
+    PLAN_ARR_INT_FOR_EACH(&h->op[parent_op_id].eff, fid)
+        planArrIntAdd(&h->op[op_id].eff, fid);
+    planArrIntSort(&h->op[op_id].eff);
+}
+
+static void loadOpFact(plan_heur_add_max_ff_t *h, const plan_problem_t *p)
+{
+    op_t *op;
+    int i, op_id, fid;
+
+    // Allocate facts and add one for empty-precondition fact and one for
+    // goal fact
+    h->fact_size = h->fact_id.fact_size + 2;
+    h->fact = BOR_CALLOC_ARR(fact_t, h->fact_size);
+    h->fact_goal = h->fact_size - 2;
+    h->fact_nopre = h->fact_size - 1;
+
+    // Allocate operators and add one artificial for goal
+    h->op_alloc = h->op_size = p->op_size + 1;
+    h->op = BOR_CALLOC_ARR(op_t, h->op_alloc);
+    h->op_goal = h->op_size - 1;
+
+    for (op_id = 0; op_id < p->op_size; ++op_id){
+        op = h->op + op_id;
+        op->cost = getCost(h, p->op + op_id);
+        op->parent = op_id;
+
+        PLAN_FACT_ID_FOR_EACH_PART_STATE(&h->fact_id, p->op[op_id].eff, fid)
+            planArrIntAdd(&op->eff, fid);
+        PLAN_FACT_ID_FOR_EACH_PART_STATE(&h->fact_id, p->op[op_id].pre, fid)
+            addPre(h, op_id, fid);
+        if (h->op[op_id].pre.size == 0)
+            addPre(h, op_id, h->fact_nopre);
+
+        for (i = 0; i < p->op[op_id].cond_eff_size; ++i)
+            addCondEff(h, op_id, p->op + op_id, p->op[op_id].cond_eff + i);
+    }
+
+    // Set up goal operator
+    op = h->op + h->op_goal;
+    planArrIntAdd(&op->eff, h->fact_goal);
+    op->cost = 0;
+    op->parent = -1;
+    PLAN_FACT_ID_FOR_EACH_PART_STATE(&h->fact_id, p->goal, fid)
+        addPre(h, h->op_goal, fid);
+    if (h->op[h->op_goal].pre.size == 0)
+        addPre(h, h->op_goal, h->fact_nopre);
+
+    if (h->op_alloc != h->op_size){
+        h->op_alloc = h->op_size;
+        h->op = BOR_REALLOC_ARR(h->op, op_t, h->op_alloc);
+    }
+}
@@ -0,0 +1,357 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+#include <boruvka/alloc.h>
+#include <boruvka/htable.h>
+#include <boruvka/hfunc.h>
+#include <boruvka/list.h>
+#include "plan/heur.h"
+#include "plan/search.h"
+#include "plan/causal_graph.h"
+#include "pref_op_selector.h"
+
+/**
+ * Cached heuristic value of one abstract state.
+ */
+struct _entry_t {
+    bor_list_t htable; /*!< Connection to the hash table */
+    bor_list_t lru;    /*!< Connection to the LRU list */
+    bor_htable_key_t hash; /*!< Cached hash of .val[] */
+    plan_cost_t heur;  /*!< Heuristic value */
+    int has_pref;      /*!< True if .pref_op[] was filled */
+    int pref_size;     /*!< Number of preferred operators */
+    int *pref_op;      /*!< Sorted IDs of preferred operators */
+    plan_val_t val[];  /*!< Values of the relevant variables */
+};
+typedef struct _entry_t entry_t;
+
+struct _plan_heur_cache_t {
+    plan_heur_t heur;
+    plan_heur_t *inner;      /*!< Wrapped heuristic */
+    const plan_op_t *base_op;
+
+    int *var;                /*!< Variables the heuristic depends on */
+    int var_size;            /*!< Number of elements in .var[] */
+    int capacity;            /*!< Maximal number of cached states */
+
+    bor_htable_t *table;     /*!< Cached states */
+    bor_list_t lru;          /*!< Cached states, least recently used last */
+    int size;                /*!< Number of cached states */
+    size_t mem;              /*!< Bytes allocated by entries */
+    entry_t *key;            /*!< Pre-allocated entry used for lookup */
+
+    long hits;
+    long misses;
+};
+typedef struct _plan_heur_cache_t plan_heur_cache_t;
+
+#define HEUR(parent) bor_container_of((parent), plan_heur_cache_t, heur)
+
+static void heurDel(plan_heur_t *_heur);
+static void heurVal(plan_heur_t *_heur, const plan_state_t *state,
+                    plan_heur_res_t *res);
+static void heurNode(plan_heur_t *_heur, plan_state_id_t state_id,
+                     plan_search_t *search, plan_heur_res_t *res);
+static size_t heurMemUsage(const plan_heur_t *_heur);
+static void heurShedMem(plan_heur_t *_heur, int level);
+
+static bor_htable_key_t entryHash(const bor_list_t *k, void *ud);
+static int entryEq(const bor_list_t *k1, const bor_list_t *k2, void *ud);
+
+/** Determines variables the heuristic value can depend on */
+static void initVars(plan_heur_cache_t *h, const plan_problem_t *p);
+
+plan_heur_t *planHeurCacheNew(plan_heur_t *heur, const plan_problem_t *p,
+                              int capacity)
+{
+    plan_heur_cache_t *h;
+
+    if (heur->ma){
+        fprintf(stderr, "Heur Error: Cache cannot wrap a multi-agent"
+                        " heuristic.\n");
+        return NULL;
+    }
+
+    h = BOR_ALLOC(plan_heur_cache_t);
+    _planHeurInit(&h->heur, heurDel, heurVal, heurNode);
+    _planHeurMemUsageInit(&h->heur, heurMemUsage);
+    _planHeurShedMemInit(&h->heur, heurShedMem);
+    h->inner = heur;
+    h->base_op = p->op;
+    initVars(h, p);
+    h->capacity = BOR_MAX(capacity, 1);
+
+    h->table = borHTableNew(entryHash, entryEq, h);
+    borListInit(&h->lru);
+    h->size = 0;
+    h->mem = 0;
+    h->key = BOR_MALLOC(sizeof(entry_t) + sizeof(plan_val_t) * h->var_size);
+    h->hits = h->misses = 0;
+
+    return &h->heur;
+}
+
+void planHeurCacheStat(const plan_heur_t *heur, long *hits, long *misses)
+{
+    const plan_heur_cache_t *h;
+
+    *hits = *misses = 0;
+    if (heur->del_fn != heurDel)
+        return;
+
+    h = bor_container_of(heur, const plan_heur_cache_t, heur);
+    *hits = h->hits;
+    *misses = h->misses;
+}
+
+static void entryDel(plan_heur_cache_t *h, entry_t *e)
+{
+    borHTableErase(h->table, &e->htable);
+    borListDel(&e->lru);
+    h->mem -= sizeof(entry_t) + sizeof(plan_val_t) * h->var_size;
+    if (e->pref_op){
+        h->mem -= sizeof(int) * e->pref_size;
+        BOR_FREE(e->pref_op);
+    }
+    BOR_FREE(e);
+    --h->size;
+}
+
+/** Evicts least recently used entries until at most size remains */
+static void evict(plan_heur_cache_t *h, int size)
+{
+    entry_t *e;
+
+    while (h->size > size){
+        e = BOR_LIST_ENTRY(borListPrev(&h->lru), entry_t, lru);
+        entryDel(h, e);
+    }
+}
+
+static void heurDel(plan_heur_t *_heur)
+{
+    plan_heur_cache_t *h = HEUR(_heur);
+
+    evict(h, 0);
+    borHTableDel(h->table);
+    BOR_FREE(h->key);
+    if (h->var)
+        BOR_FREE(h->var);
+    planHeurDel(h->inner);
+    _planHeurFree(&h->heur);
+    BOR_FREE(h);
+}
+
+static size_t heurMemUsage(const plan_heur_t *_heur)
+{
+    const plan_heur_cache_t *h;
+    size_t size;
+
+    h = bor_container_of(_heur, const plan_heur_cache_t, heur);
+    size  = sizeof(*h);
+    size += sizeof(int) * h->var_size;
+    size += sizeof(entry_t) + sizeof(plan_val_t) * h->var_size;
+    size += sizeof(bor_list_t) * borHTableSize(h->table);
+    size += h->mem;
+    size += planHeurMemUsage(h->inner);
+    return size;
+}
+
+static void heurShedMem(plan_heur_t *_heur, int level)
+{
+    plan_heur_cache_t *h = HEUR(_heur);
+
+    // Keep the more recently used half under soft pressure
+    if (level >= PLAN_MEM_PRESSURE_HIGH){
+        evict(h, 0);
+    }else{
+        evict(h, h->size / 2);
+    }
+    planHeurShedMem(h->inner, level);
+}
+
+static bor_htable_key_t entryHash(const bor_list_t *k, void *ud)
+{
+    const entry_t *e = BOR_LIST_ENTRY(k, entry_t, htable);
+    return e->hash;
+}
+
+static int entryEq(const bor_list_t *k1, const bor_list_t *k2, void *ud)
+{
+    const plan_heur_cache_t *h = ud;
+    const entry_t *e1 = BOR_LIST_ENTRY(k1, entry_t, htable);
+    const entry_t *e2 = BOR_LIST_ENTRY(k2, entry_t, htable);
+
+    return e1->hash == e2->hash
+            && memcmp(e1->val, e2->val, sizeof(plan_val_t) * h->var_size) == 0;
+}
+
+/** Projects the state into h->key and returns the corresponding entry if
+ *  cached */
+static entry_t *lookup(plan_heur_cache_t *h, const plan_state_t *state)
+{
+    bor_list_t *item;
+    int i;
+
+    for (i = 0; i < h->var_size; ++i)
+        h->key->val[i] = planStateGet(state, h->var[i]);
+    h->key->hash = borCityHash_64(h->key->val,
+                                  sizeof(plan_val_t) * h->var_size);
+
+    item = borHTableFind(h->table, &h->key->htable);
+    if (item == NULL)
+        return NULL;
+    return BOR_LIST_ENTRY(item, entry_t, htable);
+}
+
+static int cmpInt(const void *a, const void *b)
+{
+    return *(const int *)a - *(const int *)b;
+}
+
+/** Stores the result for the state projected in h->key */
+static void store(plan_heur_cache_t *h, entry_t *e, const plan_heur_res_t *res)
+{
+    size_t size;
+    int i;
+
+    if (e == NULL){
+        evict(h, h->capacity - 1);
+
+        size = sizeof(entry_t) + sizeof(plan_val_t) * h->var_size;
+        e = BOR_MALLOC(size);
+        memcpy(e, h->key, size);
+        e->has_pref = 0;
+        e->pref_size = 0;
+        e->pref_op = NULL;
+        borHTableInsert(h->table, &e->htable);
+        borListPrepend(&h->lru, &e->lru);
+        h->mem += size;
+        ++h->size;
+    }
+
+    e->heur = res->heur;
+    if (res->pref_op != NULL && !e->has_pref){
+        e->has_pref = 1;
+        e->pref_size = res->pref_size;
+        if (e->pref_size > 0){
+            e->pref_op = BOR_ALLOC_ARR(int, e->pref_size);
+            for (i = 0; i < e->pref_size; ++i)
+                e->pref_op[i] = res->pref_op[i] - h->base_op;
+            qsort(e->pref_op, e->pref_size, sizeof(int), cmpInt);
+            h->mem += sizeof(int) * e->pref_size;
+        }
+    }
+}
+
+/** Fills the result from the cached entry */
+static void load(plan_heur_cache_t *h, entry_t *e, plan_heur_res_t *res)
+{
+    plan_pref_op_selector_t sel;
+    int i;
+
+    // Move the entry to the front of the LRU list
+    borListDel(&e->lru);
+    borListPrepend(&h->lru, &e->lru);
+
+    res->heur = e->heur;
+    if (res->pref_op != NULL){
+        planPrefOpSelectorInit(&sel, res, h->base_op);
+        for (i = 0; i < e->pref_size; ++i)
+            planPrefOpSelectorSelect(&sel, e->pref_op[i]);
+        planPrefOpSelectorFinalize(&sel);
+    }
+}
+
+/** Returns true if the result can be taken from the entry */
+static int usable(const entry_t *e, const plan_heur_res_t *res)
+{
+    return e != NULL && (res->pref_op == NULL || e->has_pref);
+}
+
+static void heurVal(plan_heur_t *_heur, const plan_state_t *state,
+                    plan_heur_res_t *res)
+{
+    plan_heur_cache_t *h = HEUR(_heur);
+    entry_t *e;
+
+    // Landmarks are not cached
+    if (res->save_landmarks){
+        planHeurState(h->inner, state, res);
+        return;
+    }
+
+    e = lookup(h, state);
+    if (usable(e, res)){
+        ++h->hits;
+        load(h, e, res);
+        return;
+    }
+
+    ++h->misses;
+    planHeurState(h->inner, state, res);
+    store(h, e, res);
+}
+
+static void heurNode(plan_heur_t *_heur, plan_state_id_t state_id,
+                     plan_search_t *search, plan_heur_res_t *res)
+{
+    plan_heur_cache_t *h = HEUR(_heur);
+    entry_t *e;
+
+    if (res->save_landmarks){
+        planHeurNode(h->inner, state_id, search, res);
+        return;
+    }
+
+    e = lookup(h, planSearchLoadState(search, state_id));
+    if (usable(e, res)){
+        ++h->hits;
+        load(h, e, res);
+        return;
+    }
+
+    ++h->misses;
+    planHeurNode(h->inner, state_id, search, res);
+    store(h, e, res);
+}
+
+static void initVars(plan_heur_cache_t *h, const plan_problem_t *p)
+{
+    plan_causal_graph_t *cg;
+    int i;
+
+    // Only the variables connected with the goal in the causal graph can
+    // change the value of the heuristic (and preferred operators), the
+    // values of the other variables can enable only operators that do
+    // not contribute to reaching the goal.
+    cg = planCausalGraphNew(p->var_size);
+    planCausalGraphBuildFromOps(cg, p->op, p->op_size);
+    planCausalGraph(cg, p->goal);
+
+    h->var = BOR_ALLOC_ARR(int, p->var_size);
+    h->var_size = 0;
+    for (i = 0; i < p->var_size; ++i){
+        if (cg->important_var[i])
+            h->var[h->var_size++] = i;
+    }
+
+    planCausalGraphDel(cg);
+}
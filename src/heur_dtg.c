@@ -49,6 +49,10 @@ plan_heur_t *planHeurDTGNew(const plan_problem_t *p, unsigned flags)
     hdtg = BOR_ALLOC(plan_heur_dtg_t);
     _planHeurInit(&hdtg->heur, heurDTGDel, heurDTG, NULL);
     planHeurDTGDataInit(&hdtg->data, p->var, p->var_size, p->op, p->op_size);
+    if (flags & PLAN_HEUR_DTG_ALL_PAIRS){
+        planHeurDTGDataPrecompute(&hdtg->data,
+                                  PLAN_HEUR_DTG_ALL_PAIRS_MAX_RANGE);
+    }
     planHeurDTGCtxInit(&hdtg->ctx, &hdtg->data);
 
     // Save goal values
@@ -90,6 +94,9 @@ static void heurDTG(plan_heur_t *_heur, const plan_state_t *state,
  *  path argument. */
 static void dtgPathExplore(const plan_dtg_t *dtg, plan_var_id_t var,
                            plan_val_t val, plan_heur_dtg_path_t *path);
+/** Fills pre[] with paths from all values to val */
+static void dtgPathBFS(const plan_dtg_var_t *dtg, plan_val_t val,
+                       plan_heur_dtg_path_pre_t *pre);
 /** Frees allocated memory */
 static void dtgPathFree(plan_heur_dtg_path_t *path);
 
@@ -181,6 +188,46 @@ void planHeurDTGDataInitUnknown(plan_heur_dtg_data_t *dtg_data,
     dtgPathCacheInit(&dtg_data->dtg_path, &dtg_data->dtg);
 }
 
+void planHeurDTGDataPrecompute(plan_heur_dtg_data_t *dtg_data, int max_range)
+{
+    plan_heur_dtg_path_cache_t *pc = &dtg_data->dtg_path;
+    const plan_dtg_var_t *dtg;
+    plan_heur_dtg_path_t *path;
+    plan_heur_dtg_path_pre_t *pre;
+    size_t size;
+    int var, val;
+
+    if (pc->table != NULL)
+        return;
+
+    size = 0;
+    for (var = 0; var < pc->var_size; ++var){
+        dtg = dtg_data->dtg.dtg + var;
+        if (dtg->trans != NULL && dtg->val_size <= max_range)
+            size += (size_t)dtg->val_size * dtg->val_size;
+    }
+    if (size == 0)
+        return;
+
+    pc->table = BOR_ALLOC_ARR(plan_heur_dtg_path_pre_t, size);
+    pre = pc->table;
+    for (var = 0; var < pc->var_size; ++var){
+        dtg = dtg_data->dtg.dtg + var;
+        if (dtg->trans == NULL || dtg->val_size > max_range)
+            continue;
+
+        pc->precomputed[var] = 1;
+        for (val = 0; val < dtg->val_size; ++val){
+            path = dtgPathCache(pc, var, val);
+            if (path->pre != NULL)
+                dtgPathFree(path);
+            path->pre = pre;
+            dtgPathBFS(dtg, val, pre);
+            pre += dtg->val_size;
+        }
+    }
+}
+
 void planHeurDTGDataFree(plan_heur_dtg_data_t *dtg_data)
 {
     dtgPathCacheFree(&dtg_data->dtg_path);
@@ -251,39 +298,47 @@ static void dtgPathExplore(const plan_dtg_t *_dtg, plan_var_id_t var,
                            plan_val_t val, plan_heur_dtg_path_t *path)
 {
     const plan_dtg_var_t *dtg = _dtg->dtg + var;
+
+    if (dtg->trans == NULL)
+        return;
+
+    path->pre = BOR_ALLOC_ARR(plan_heur_dtg_path_pre_t, dtg->val_size);
+    dtgPathBFS(dtg, val, path->pre);
+}
+
+static void dtgPathBFS(const plan_dtg_var_t *dtg, plan_val_t val,
+                       plan_heur_dtg_path_pre_t *pre)
+{
     const plan_dtg_trans_t *trans;
     bor_fifo_t fifo;
     plan_cost_t len;
     plan_val_t v;
     int i;
 
-    if (dtg->trans == NULL)
-        return;
-
-    path->pre = BOR_ALLOC_ARR(plan_heur_dtg_path_pre_t, dtg->val_size);
     for (i = 0; i < dtg->val_size; ++i){
-        path->pre[i].val = -1;
-        path->pre[i].len = INT_MAX;
+        pre[i].val = -1;
+        pre[i].len = INT_MAX;
     }
 
     borFifoInit(&fifo, sizeof(plan_val_t));
-    path->pre[val].val = val;
-    path->pre[val].len = 0;
+    pre[val].val = val;
+    pre[val].len = 0;
     borFifoPush(&fifo, &val);
     while (!borFifoEmpty(&fifo)){
         v = *(plan_val_t *)borFifoFront(&fifo);
         borFifoPop(&fifo);
-        len = path->pre[v].len;
+        len = pre[v].len;
 
         trans = dtg->trans + v;
         for (i = 0; i < dtg->val_size; ++i, trans += dtg->val_size){
-            if (i == v || path->pre[i].val != -1 || trans->ops_size == 0)
+            if (i == v || pre[i].val != -1 || trans->ops_size == 0)
                 continue;
-            path->pre[i].val = v;
-            path->pre[i].len = len + 1;
+            pre[i].val = v;
+            pre[i].len = len + 1;
             borFifoPush(&fifo, &i);
         }
     }
+    borFifoFree(&fifo);
 }
 
 static void dtgPathFree(plan_heur_dtg_path_t *path)
@@ -304,6 +359,8 @@ static void dtgPathCacheInit(plan_heur_dtg_path_cache_t *pc,
         pc->range[i] = dtg->dtg[i].val_size;
     }
     pc->var_size = dtg->var_size;
+    pc->table = NULL;
+    pc->precomputed = BOR_CALLOC_ARR(char, dtg->var_size);
 }
 
 static void dtgPathCacheFree(plan_heur_dtg_path_cache_t *pc)
@@ -311,7 +368,7 @@ static void dtgPathCacheFree(plan_heur_dtg_path_cache_t *pc)
     int i, j;
 
     for (i = 0; i < pc->var_size; ++i){
-        for (j = 0; j < pc->range[i]; ++j){
+        for (j = 0; !pc->precomputed[i] && j < pc->range[i]; ++j){
             if (pc->path[i][j].pre != NULL)
                 dtgPathFree(&pc->path[i][j]);
         }
@@ -319,6 +376,9 @@ static void dtgPathCacheFree(plan_heur_dtg_path_cache_t *pc)
     }
     BOR_FREE(pc->path);
     BOR_FREE(pc->range);
+    BOR_FREE(pc->precomputed);
+    if (pc->table)
+        BOR_FREE(pc->table);
 }
 
 static plan_heur_dtg_path_t *dtgPathCache(plan_heur_dtg_path_cache_t *pc,
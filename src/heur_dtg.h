@@ -22,6 +22,12 @@
 
 #include <plan/dtg.h>
 
+/**
+ * Default maximal range of a variable for which all-pairs paths are
+ * precomputed by planHeurDTGDataPrecompute().
+ */
+#define PLAN_HEUR_DTG_ALL_PAIRS_MAX_RANGE 256
+
 /**
  * Predecessor on the path.
  */
@@ -45,6 +51,10 @@ struct _plan_heur_dtg_path_cache_t {
     plan_heur_dtg_path_t **path; /*!< Array of arrays for each variable and
                                       value */
     int *range;                  /*!< Range of values for each variable */
+    plan_heur_dtg_path_pre_t *table; /*!< Precomputed paths of all
+                                          variables stored contiguously */
+    char *precomputed;           /*!< True for variables with paths stored
+                                      in .table */
 };
 typedef struct _plan_heur_dtg_path_cache_t plan_heur_dtg_path_cache_t;
 
@@ -119,6 +129,16 @@ void planHeurDTGDataInitUnknown(plan_heur_dtg_data_t *dtg_data,
                                 const plan_var_t *var, int var_size,
                                 const plan_op_t *op, int op_size);
 
+/**
+ * Precomputes paths between all pairs of values for each variable with
+ * range at most max_range. The paths of these variables are then stored
+ * in one contiguous table (row per target value) and no exploration is
+ * needed during evaluation of the heuristic. Paths of the larger
+ * variables are still explored on demand.
+ * This must be called after all transitions were added to the DTG.
+ */
+void planHeurDTGDataPrecompute(plan_heur_dtg_data_t *dtg_data, int max_range);
+
 /**
  * Fress allocated resources.
  */
@@ -17,6 +17,7 @@
  * See the License for more information.
  */
 
+#include <math.h>
 #include <boruvka/alloc.h>
 #include <plan/config.h>
 #include <plan/heur.h>
@@ -20,10 +20,41 @@
 #include <boruvka/alloc.h>
 
 #include "plan/heur.h"
+#include "plan/search.h"
+
+/**
+ * Goal values stored in a single word of the packed state.
+ */
+struct _goal_word_t {
+    int pos;                /*!< Position of the word in the buffer */
+    plan_packer_word_t val; /*!< Packed goal values */
+    plan_packer_word_t low; /*!< All bits of goal fields except the highest */
+    plan_packer_word_t hi;  /*!< Highest bit of each goal field */
+};
+typedef struct _goal_word_t goal_word_t;
+
+/**
+ * Goal value of a single variable.
+ */
+struct _goal_var_t {
+    plan_val_t val;          /*!< Goal value or PLAN_VAL_UNDEFINED */
+    int pos;                 /*!< Word where the value is stored */
+    plan_packer_word_t mask; /*!< Mask of the value within the word */
+    plan_packer_word_t pval; /*!< Packed goal value */
+};
+typedef struct _goal_var_t goal_var_t;
 
 struct _plan_heur_goalcount_t {
     plan_heur_t heur;
     const plan_part_state_t *goal;
+
+    const plan_state_pool_t *pool; /*!< State pool the packed goal
+                                        corresponds to */
+    int data_id;          /*!< ID of the data array with goal counts */
+    goal_word_t *word;    /*!< Words containing goal values */
+    int word_size;
+    goal_var_t *var;      /*!< Goal values indexed by variables */
+    int var_size;
 };
 typedef struct _plan_heur_goalcount_t plan_heur_goalcount_t;
 
@@ -32,7 +63,12 @@ typedef struct _plan_heur_goalcount_t plan_heur_goalcount_t;
 
 static void planHeurGoalCount(plan_heur_t *heur, const plan_state_t *state,
                               plan_heur_res_t *res);
+static void planHeurGoalCountNode(plan_heur_t *heur,
+                                  plan_state_id_t state_id,
+                                  plan_search_t *search,
+                                  plan_heur_res_t *res);
 static void planHeurGoalCountDel(plan_heur_t *h);
+static size_t planHeurGoalCountMemUsage(const plan_heur_t *h);
 
 plan_heur_t *planHeurGoalCountNew(const plan_part_state_t *goal)
 {
@@ -40,8 +76,16 @@ plan_heur_t *planHeurGoalCountNew(const plan_part_state_t *goal)
     h = BOR_ALLOC(plan_heur_goalcount_t);
     _planHeurInit(&h->heur,
                   planHeurGoalCountDel,
-                  planHeurGoalCount, NULL);
+                  planHeurGoalCount,
+                  planHeurGoalCountNode);
+    _planHeurMemUsageInit(&h->heur, planHeurGoalCountMemUsage);
     h->goal = goal;
+    h->pool = NULL;
+    h->data_id = -1;
+    h->word = NULL;
+    h->word_size = 0;
+    h->var = NULL;
+    h->var_size = 0;
     return &h->heur;
 }
 
@@ -49,9 +93,23 @@ static void planHeurGoalCountDel(plan_heur_t *_h)
 {
     plan_heur_goalcount_t *h = HEUR_FROM_PARENT(_h);
     _planHeurFree(&h->heur);
+    if (h->word)
+        BOR_FREE(h->word);
+    if (h->var)
+        BOR_FREE(h->var);
     BOR_FREE(h);
 }
 
+static size_t planHeurGoalCountMemUsage(const plan_heur_t *_h)
+{
+    const plan_heur_goalcount_t *h;
+
+    h = bor_container_of(_h, const plan_heur_goalcount_t, heur);
+    return sizeof(*h)
+            + sizeof(goal_word_t) * h->word_size
+            + sizeof(goal_var_t) * h->var_size;
+}
+
 static void planHeurGoalCount(plan_heur_t *_h, const plan_state_t *state,
                               plan_heur_res_t *res)
 {
@@ -69,3 +127,154 @@ static void planHeurGoalCount(plan_heur_t *_h, const plan_state_t *state,
 
     res->heur = heur;
 }
+
+/** Prepares the packed goal for the layout of the given state pool */
+static void packGoal(plan_heur_goalcount_t *h, plan_state_pool_t *pool)
+{
+    const plan_state_packer_t *packer = pool->packer;
+    plan_packer_word_t mask, hi;
+    plan_cost_t init = -1;
+    plan_var_id_t var;
+    plan_val_t val;
+    int i, j, pos, *word_id;
+
+    if (h->word)
+        BOR_FREE(h->word);
+    if (h->var)
+        BOR_FREE(h->var);
+
+    h->pool = pool;
+    h->data_id = planStatePoolDataReserve(pool, sizeof(plan_cost_t),
+                                          NULL, &init);
+
+    h->var_size = pool->num_vars;
+    h->var = BOR_ALLOC_ARR(goal_var_t, h->var_size);
+    for (i = 0; i < h->var_size; ++i){
+        h->var[i].val = PLAN_VAL_UNDEFINED;
+        h->var[i].pos = -1;
+        h->var[i].mask = h->var[i].pval = 0u;
+    }
+
+    word_id = BOR_ALLOC_ARR(int, packer->bufsize);
+    for (i = 0; i < packer->bufsize; ++i)
+        word_id[i] = -1;
+    h->word = BOR_ALLOC_ARR(goal_word_t, h->goal->vals_size);
+    h->word_size = 0;
+
+    PLAN_PART_STATE_FOR_EACH(h->goal, i, var, val){
+        planStatePackerVarField(packer, var, &pos, &mask);
+        h->var[var].val = val;
+        h->var[var].pos = pos;
+        h->var[var].mask = mask;
+        h->var[var].pval = (((plan_packer_word_t)val) << __builtin_ctz(mask))
+                                & mask;
+
+        if (word_id[pos] == -1){
+            word_id[pos] = h->word_size++;
+            j = word_id[pos];
+            h->word[j].pos = pos;
+            h->word[j].val = h->word[j].low = h->word[j].hi = 0u;
+        }
+        j = word_id[pos];
+
+        // Highest bit of the field is the only bit of the mask that is not
+        // set in the mask shifted one bit to the right
+        hi = mask & ~(mask >> 1u);
+        h->word[j].val |= h->var[var].pval;
+        h->word[j].hi |= hi;
+        h->word[j].low |= mask & ~hi;
+    }
+
+    BOR_FREE(word_id);
+}
+
+/** Counts unsatisfied goals directly in the packed state. Each field of
+ *  the word differing from the goal is reduced to its highest bit: adding
+ *  all lower bits of the field to its (masked) lower part carries into
+ *  the highest bit iff any lower bit is set. Fields cannot overflow into
+ *  the neighbouring fields so the whole word is processed at once. */
+static plan_cost_t goalCountPacked(const plan_heur_goalcount_t *h,
+                                   const plan_packer_word_t *buf)
+{
+    const goal_word_t *w;
+    plan_packer_word_t x;
+    int i, count = 0;
+
+    for (i = 0; i < h->word_size; ++i){
+        w = h->word + i;
+        x = (buf[w->pos] ^ w->val) & (w->low | w->hi);
+        if (x != 0u){
+            x = (((x & w->low) + w->low) | x) & w->hi;
+            count += __builtin_popcount(x);
+        }
+    }
+
+    return count;
+}
+
+/** Updates the goal count of the parent state by the effects of the
+ *  operator. Returns -1 if the update is not possible. */
+static plan_cost_t goalCountInc(const plan_heur_goalcount_t *h,
+                                const plan_packer_word_t *parent_buf,
+                                plan_cost_t parent_count,
+                                const plan_op_t *op)
+{
+    const goal_var_t *g;
+    plan_var_id_t var;
+    plan_val_t val;
+    int i, count = parent_count;
+
+    if (op->cond_eff_size > 0)
+        return -1;
+
+    PLAN_PART_STATE_FOR_EACH(op->eff, i, var, val){
+        g = h->var + var;
+        if (g->val == PLAN_VAL_UNDEFINED)
+            continue;
+
+        if (((parent_buf[g->pos] ^ g->pval) & g->mask) != 0u)
+            --count;
+        if (val != g->val)
+            ++count;
+    }
+
+    return count;
+}
+
+static void planHeurGoalCountNode(plan_heur_t *_h,
+                                  plan_state_id_t state_id,
+                                  plan_search_t *search,
+                                  plan_heur_res_t *res)
+{
+    plan_heur_goalcount_t *h = HEUR_FROM_PARENT(_h);
+    plan_state_pool_t *pool = search->state_pool;
+    const plan_state_space_node_t *node;
+    const plan_packer_word_t *buf;
+    plan_cost_t *count, *parent_count;
+
+    if (h->pool != pool)
+        packGoal(h, pool);
+
+    count = planStatePoolData(pool, h->data_id, state_id);
+    if (*count >= 0){
+        res->heur = *count;
+        return;
+    }
+
+    node = planSearchLoadNode(search, state_id);
+    if (node->parent_state_id >= 0 && node->op != NULL){
+        parent_count = planStatePoolData(pool, h->data_id,
+                                         node->parent_state_id);
+        if (*parent_count >= 0){
+            buf = planStatePoolGetPackedState(pool, node->parent_state_id);
+            *count = goalCountInc(h, buf, *parent_count, node->op);
+        }
+    }
+
+    if (*count < 0){
+        buf = planStatePoolGetPackedState(pool, state_id);
+        *count = goalCountPacked(h, buf);
+    }
+
+    res->heur = *count;
+}
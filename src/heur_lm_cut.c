@@ -24,11 +24,10 @@
 #include "plan/fact_id.h"
 #include "plan/heur.h"
 #include "op_id_tr.h"
+#include "fact_op_graph.h"
 
 struct _op_t {
     int op_id;
-    plan_arr_int_t eff; /*!< Facts in its effect */
-    plan_arr_int_t pre; /*!< Facts in its effect */
     int op_cost;        /*!< Original operator's cost */
 
     int cost;           /*!< Current cost of the operator */
@@ -40,8 +39,6 @@ struct _op_t {
 typedef struct _op_t op_t;
 
 struct _fact_t {
-    plan_arr_int_t pre_op; /*!< Operators having this fact as its precond */
-    plan_arr_int_t eff_op; /*!< Operators having this fact as its effect */
     int value;
     plan_pq_el_t heap;     /*!< Connection to priority heap */
     int supp_cnt;          /*!< Number of operators that have this fact as
@@ -125,6 +122,8 @@ struct _plan_heur_lm_cut_t {
     int op_size;
     int op_goal;
 
+    plan_fact_op_graph_t graph; /*!< Operators' preconditions and effects */
+
     plan_arr_int_t state; /*!< Current state from which heur is computed */
     plan_arr_int_t cut;   /*!< Current cut */
 
@@ -141,6 +140,8 @@ typedef struct _plan_heur_lm_cut_t plan_heur_lm_cut_t;
 #define HEUR(parent) bor_container_of((parent), plan_heur_lm_cut_t, heur)
 
 static void heurDel(plan_heur_t *_heur);
+static size_t heurMemUsage(const plan_heur_t *_heur);
+static void heurShedMem(plan_heur_t *_heur, int level);
 static void heurVal(plan_heur_t *_heur, const plan_state_t *state,
                     plan_heur_res_t *res);
 static void heurValIncLocal(plan_heur_t *_heur,
@@ -155,24 +156,22 @@ static void planHeurLMCutStateInc(plan_heur_t *_heur,
                                   const plan_state_t *state,
                                   plan_heur_res_t *res);
 
-static void opFree(op_t *op);
-static void factFree(fact_t *fact);
 static void loadOpFact(plan_heur_lm_cut_t *h, const plan_problem_t *p);
 
 #if 0
 static void debug(plan_heur_lm_cut_t *h)
 {
+    int fact_id, op_id;
+
     for (int i = 0; i < h->fact_size; ++i){
         fprintf(stderr, "F[%03d]: value: %d, supp_cnt: %d",
                 i, FVALUE(h->fact + i), h->fact[i].supp_cnt);
         fprintf(stderr, ", pre:");
-        for (int j = 0; j < h->fact[i].pre_op.size; ++j){
-            fprintf(stderr, " %d", h->fact[i].pre_op.arr[j]);
-        }
+        PLAN_FACT_OP_GRAPH_FACT_PRE_FOR_EACH(&h->graph, i, op_id)
+            fprintf(stderr, " %d", op_id);
         fprintf(stderr, ", eff:");
-        for (int j = 0; j < h->fact[i].eff_op.size; ++j){
-            fprintf(stderr, " %d", h->fact[i].eff_op.arr[j]);
-        }
+        PLAN_FACT_OP_GRAPH_FACT_EFF_FOR_EACH(&h->graph, i, op_id)
+            fprintf(stderr, " %d", op_id);
 
         for (int j = 0; j < h->state.size; ++j){
             if (i == h->state.arr[j]){
@@ -193,13 +192,11 @@ static void debug(plan_heur_lm_cut_t *h)
                 i, h->op[i].cost, h->op[i].unsat, h->op[i].supp,
                 h->op[i].supp_cost, h->op[i].cut_candidate);
         fprintf(stderr, ", pre:");
-        for (int j = 0; j < h->op[i].pre.size; ++j){
-            fprintf(stderr, " %d", h->op[i].pre.arr[j]);
-        }
+        PLAN_FACT_OP_GRAPH_OP_PRE_FOR_EACH(&h->graph, i, fact_id)
+            fprintf(stderr, " %d", fact_id);
         fprintf(stderr, ", eff:");
-        for (int j = 0; j < h->op[i].eff.size; ++j){
-            fprintf(stderr, " %d", h->op[i].eff.arr[j]);
-        }
+        PLAN_FACT_OP_GRAPH_OP_EFF_FOR_EACH(&h->graph, i, fact_id)
+            fprintf(stderr, " %d", fact_id);
         fprintf(stderr, "\n");
     }
 }
@@ -222,6 +219,8 @@ plan_heur_t *lmCutNew(const plan_problem_t *p, unsigned type,
     }else{
         _planHeurInit(&h->heur, heurDel, heurVal, NULL);
     }
+    _planHeurMemUsageInit(&h->heur, heurMemUsage);
+    _planHeurShedMemInit(&h->heur, heurShedMem);
     planFactIdInit(&h->fact_id, p->var, p->var_size, 0);
     loadOpFact(h, p);
 
@@ -259,22 +258,28 @@ plan_heur_t *planHeurLMCutIncCacheNew(const plan_problem_t *p,
     return lmCutNew(p, INC_CACHE, flags, cache_flags);
 }
 
+void planHeurLMCutIncCacheSetMaxMem(plan_heur_t *heur, size_t max_mem)
+{
+    plan_heur_lm_cut_t *h;
+
+    if (heur->del_fn != heurDel)
+        return;
+    h = HEUR(heur);
+    if (h->inc_cache.enabled)
+        planLandmarkCacheSetMaxMem(h->inc_cache.ldm_cache, max_mem);
+}
+
 static void heurDel(plan_heur_t *_heur)
 {
     plan_heur_lm_cut_t *h = HEUR(_heur);
-    int i;
 
     _planHeurFree(&h->heur);
 
-    for (i = 0; i < h->fact_size; ++i)
-        factFree(h->fact + i);
     if (h->fact)
         BOR_FREE(h->fact);
-
-    for (i = 0; i < h->op_size; ++i)
-        opFree(h->op + i);
     if (h->op)
         BOR_FREE(h->op);
+    planFactOpGraphFree(&h->graph);
 
     if (h->inc_local.enabled){
         planLandmarkSetFree(&h->inc_local.ldms);
@@ -296,6 +301,46 @@ static void heurDel(plan_heur_t *_heur)
     BOR_FREE(h);
 }
 
+static size_t heurMemUsage(const plan_heur_t *_heur)
+{
+    const plan_heur_lm_cut_t *h;
+    size_t size;
+
+    h = bor_container_of(_heur, const plan_heur_lm_cut_t, heur);
+    size  = sizeof(*h);
+    size += (sizeof(fact_t) + sizeof(int)) * h->fact_size;
+    size += sizeof(op_t) * h->op_alloc;
+    size += planFactOpGraphMemUsage(&h->graph) - sizeof(h->graph);
+    size += planArrIntMemUsage(&h->state);
+    size += planArrIntMemUsage(&h->cut);
+    size += planArrIntMemUsage(&h->queue);
+
+    if (h->inc_local.enabled){
+        size += planLandmarkSetMemUsage(&h->inc_local.ldms);
+        size += planOpIdTrMemUsage(&h->inc_local.op_id_tr);
+    }
+    if (h->inc_cache.enabled){
+        size += planLandmarkCacheMemUsage(h->inc_cache.ldm_cache);
+        size += planOpIdTrMemUsage(&h->inc_cache.op_id_tr);
+    }
+    return size;
+}
+
+static void heurShedMem(plan_heur_t *_heur, int level)
+{
+    plan_heur_lm_cut_t *h = HEUR(_heur);
+
+    // Missing landmarks of the parent state only mean that the heuristic
+    // is computed from scratch
+    if (!h->inc_cache.enabled)
+        return;
+    if (level >= PLAN_MEM_PRESSURE_HIGH){
+        planLandmarkCacheClear(h->inc_cache.ldm_cache);
+    }else{
+        planLandmarkPrune(h->inc_cache.ldm_cache);
+    }
+}
+
 static void initFacts(plan_heur_lm_cut_t *h)
 {
     int i;
@@ -311,7 +356,7 @@ static void initOps(plan_heur_lm_cut_t *h, int init_cost)
     int i;
 
     for (i = 0; i < h->op_size; ++i){
-        h->op[i].unsat = h->op[i].pre.size;
+        h->op[i].unsat = planFactOpGraphOpPreSize(&h->graph, i);
         h->op[i].supp = -1;
         h->op[i].supp_cost = INT_MAX;
         if (init_cost)
@@ -341,10 +386,10 @@ static void enqueueOpEffects(plan_heur_lm_cut_t *h,
 {
     fact_t *fact;
     int value = op->cost + fact_value;
-    int i;
+    int fact_id;
 
-    for (i = 0; i < op->eff.size; ++i){
-        fact = h->fact + op->eff.arr[i];
+    PLAN_FACT_OP_GRAPH_OP_EFF_FOR_EACH(&h->graph, op - h->op, fact_id){
+        fact = h->fact + fact_id;
         if (FVALUE(fact) > value)
             FPUSH(pq, value, fact);
     }
@@ -356,7 +401,7 @@ static void hMaxFull(plan_heur_lm_cut_t *h, const plan_state_t *state,
     plan_pq_t pq;
     fact_t *fact;
     op_t *op;
-    int i, value;
+    int op_id, value;
 
     planPQInit(&pq);
     initFacts(h);
@@ -366,8 +411,8 @@ static void hMaxFull(plan_heur_lm_cut_t *h, const plan_state_t *state,
         fact = FPOP(&pq, &value);
         ASSERT(FVALUE(fact) == value);
 
-        for (i = 0; i < fact->pre_op.size; ++i){
-            op = h->op + fact->pre_op.arr[i];
+        PLAN_FACT_OP_GRAPH_FACT_PRE_FOR_EACH(&h->graph, FID(h, fact), op_id){
+            op = h->op + op_id;
             if (--op->unsat == 0){
                 // Set as supporter the last fact that enabled this
                 // operator (it must be one of those that have maximum
@@ -386,7 +431,7 @@ static void updateSupp(plan_heur_lm_cut_t *h, op_t *op)
     fact_t *fact;
     int fact_id, supp = -1, value = -1;
 
-    PLAN_ARR_INT_FOR_EACH(&op->pre, fact_id){
+    PLAN_FACT_OP_GRAPH_OP_PRE_FOR_EACH(&h->graph, op - h->op, fact_id){
         fact = h->fact + fact_id;
         if (FVALUE_IS_SET(fact) && FVALUE(fact) > value){
             value = FVALUE(fact);
@@ -406,7 +451,7 @@ static void enqueueOpEffectsInc(plan_heur_lm_cut_t *h, op_t *op,
     int fact_id;
 
     // Check all base effects
-    PLAN_ARR_INT_FOR_EACH(&op->eff, fact_id){
+    PLAN_FACT_OP_GRAPH_OP_EFF_FOR_EACH(&h->graph, op - h->op, fact_id){
         fact = h->fact + fact_id;
         if (FVALUE(fact) > value)
             FPUSH(pq, value, fact);
@@ -450,7 +495,7 @@ static void hMaxInc(plan_heur_lm_cut_t *h, const plan_arr_int_t *cut)
         fact = FPOP(&h->pq, &fact_value);
         fact_id = FID(h, fact);
 
-        PLAN_ARR_INT_FOR_EACH(&fact->pre_op, op_id){
+        PLAN_FACT_OP_GRAPH_FACT_PRE_FOR_EACH(&h->graph, fact_id, op_id){
             op = h->op + op_id;
             hMaxIncUpdateOp(h, op, fact_id, fact_value);
         }
@@ -465,7 +510,6 @@ static void hMaxInc(plan_heur_lm_cut_t *h, const plan_arr_int_t *cut)
 /** Mark facts connected with the goal with zero cost paths */
 static void markGoalZone(plan_heur_lm_cut_t *h)
 {
-    fact_t *fact;
     op_t *op;
     int fact_id, op_id;
 
@@ -474,8 +518,7 @@ static void markGoalZone(plan_heur_lm_cut_t *h)
     h->fact_state[h->fact_goal] = CUT_GOAL;
     while (h->queue.size > 0){
         fact_id = h->queue.arr[--h->queue.size];
-        fact = h->fact + fact_id;
-        PLAN_ARR_INT_FOR_EACH(&fact->eff_op, op_id){
+        PLAN_FACT_OP_GRAPH_FACT_EFF_FOR_EACH(&h->graph, fact_id, op_id){
             op = h->op + op_id;
             if (op->supp >= 0 && h->fact_state[op->supp] == CUT_UNDEF){
                 if (op->cost == 0){
@@ -517,7 +560,7 @@ static int findCut(plan_heur_lm_cut_t *h)
     h->cut.size = 0;
     while (h->queue.size > 0){
         fact_id = h->queue.arr[--h->queue.size];
-        PLAN_ARR_INT_FOR_EACH(&h->fact[fact_id].pre_op, op_id){
+        PLAN_FACT_OP_GRAPH_FACT_PRE_FOR_EACH(&h->graph, fact_id, op_id){
             op = h->op + op_id;
             if (op->supp != fact_id)
                 continue;
@@ -527,7 +570,7 @@ static int findCut(plan_heur_lm_cut_t *h)
                 continue;
             }
 
-            PLAN_ARR_INT_FOR_EACH(&op->eff, next){
+            PLAN_FACT_OP_GRAPH_OP_EFF_FOR_EACH(&h->graph, op_id, next){
                 if (h->fact_state[next] == CUT_UNDEF){
                     if (F_IS_SUPP(h->fact + next)){
                         h->fact_state[next] = CUT_INIT;
@@ -800,18 +843,6 @@ static void heurValIncCache(plan_heur_t *_heur,
     bzero(&res_out->landmarks, sizeof(res_out->landmarks));
 }
 
-static void opFree(op_t *op)
-{
-    planArrIntFree(&op->eff);
-    planArrIntFree(&op->pre);
-}
-
-static void factFree(fact_t *fact)
-{
-    planArrIntFree(&fact->pre_op);
-    planArrIntFree(&fact->eff_op);
-}
-
 static op_t *nextOp(plan_heur_lm_cut_t *h)
 {
     if (h->op_size == h->op_alloc){
@@ -837,10 +868,11 @@ static int getCost(const plan_heur_lm_cut_t *h, const plan_op_t *op)
 
 static void addOp(plan_heur_lm_cut_t *h, const plan_op_t *pop,
                   int parent_op_id,
-                  const plan_op_cond_eff_t *cond_eff)
+                  const plan_op_cond_eff_t *cond_eff,
+                  plan_arr_int_t *eff)
 {
     op_t *op;
-    int op_id, fid;
+    int op_id, fid, pre_size;
 
     if (cond_eff != NULL){
         op = nextOp(h);
@@ -852,41 +884,39 @@ static void addOp(plan_heur_lm_cut_t *h, const plan_op_t *pop,
     op->op_id = parent_op_id;
     op->op_cost = getCost(h, pop);
 
-    // Set effects
-    PLAN_FACT_ID_FOR_EACH_PART_STATE(&h->fact_id, pop->eff, fid){
-        planArrIntAdd(&op->eff, fid);
-        planArrIntAdd(&h->fact[fid].eff_op, op_id);
-    }
+    // Set effects, sorted by fact ID
+    eff->size = 0;
+    PLAN_FACT_ID_FOR_EACH_PART_STATE(&h->fact_id, pop->eff, fid)
+        planArrIntAdd(eff, fid);
     if (cond_eff){
-        PLAN_FACT_ID_FOR_EACH_PART_STATE(&h->fact_id, cond_eff->eff, fid){
-            planArrIntAdd(&op->eff, fid);
-            planArrIntAdd(&h->fact[fid].eff_op, op_id);
-        }
+        PLAN_FACT_ID_FOR_EACH_PART_STATE(&h->fact_id, cond_eff->eff, fid)
+            planArrIntAdd(eff, fid);
     }
+    planArrIntSort(eff);
+    PLAN_ARR_INT_FOR_EACH(eff, fid)
+        planFactOpGraphAddEff(&h->graph, op_id, fid);
 
     // Set preconditions
+    pre_size = 0;
     PLAN_FACT_ID_FOR_EACH_PART_STATE(&h->fact_id, pop->pre, fid){
-        planArrIntAdd(&h->fact[fid].pre_op, op_id);
-        planArrIntAdd(&op->pre, fid);
+        planFactOpGraphAddPre(&h->graph, op_id, fid);
+        ++pre_size;
     }
     if (cond_eff){
         PLAN_FACT_ID_FOR_EACH_PART_STATE(&h->fact_id, cond_eff->pre, fid){
-            planArrIntAdd(&h->fact[fid].pre_op, op_id);
-            planArrIntAdd(&op->pre, fid);
+            planFactOpGraphAddPre(&h->graph, op_id, fid);
+            ++pre_size;
         }
     }
 
     // Record operator with no preconditions
-    if (op->pre.size == 0){
-        planArrIntAdd(&h->fact[h->fact_nopre].pre_op, op_id);
-        planArrIntAdd(&h->op[op_id].pre, h->fact_nopre);
-    }
-
-    planArrIntSort(&op->eff);
+    if (pre_size == 0)
+        planFactOpGraphAddPre(&h->graph, op_id, h->fact_nopre);
 }
 
 static void loadOpFact(plan_heur_lm_cut_t *h, const plan_problem_t *p)
 {
+    plan_arr_int_t eff;
     op_t *op;
     int i, op_id, fid;
 
@@ -902,22 +932,23 @@ static void loadOpFact(plan_heur_lm_cut_t *h, const plan_problem_t *p)
     h->op = BOR_CALLOC_ARR(op_t, h->op_size);
     h->op_goal = h->op_size - 1;
 
+    planFactOpGraphInit(&h->graph, h->fact_size, h->op_size);
+    planArrIntInit(&eff, 8);
     for (op_id = 0; op_id < p->op_size; ++op_id){
-        addOp(h, p->op + op_id, op_id, NULL);
+        addOp(h, p->op + op_id, op_id, NULL, &eff);
         for (i = 0; i < p->op[op_id].cond_eff_size; ++i)
-            addOp(h, p->op + op_id, op_id, p->op[op_id].cond_eff + i);
+            addOp(h, p->op + op_id, op_id, p->op[op_id].cond_eff + i, &eff);
     }
+    planArrIntFree(&eff);
 
     // Set up goal operator
     op = h->op + h->op_goal;
-    planArrIntAdd(&op->eff, h->fact_goal);
     op->op_cost = 0;
+    planFactOpGraphAddEff(&h->graph, h->op_goal, h->fact_goal);
+    PLAN_FACT_ID_FOR_EACH_PART_STATE(&h->fact_id, p->goal, fid)
+        planFactOpGraphAddPre(&h->graph, h->op_goal, fid);
 
-    PLAN_FACT_ID_FOR_EACH_PART_STATE(&h->fact_id, p->goal, fid){
-        planArrIntAdd(&h->fact[fid].pre_op, h->op_goal);
-        planArrIntAdd(&op->pre, fid);
-    }
-    planArrIntAdd(&h->fact[h->fact_goal].eff_op, h->op_goal);
+    planFactOpGraphFinalize(&h->graph);
 }
 
 
@@ -22,17 +22,12 @@
 #include "plan/pq.h"
 #include "plan/fact_id.h"
 #include "plan/heur.h"
-
-struct _op_base_t {
-    plan_arr_int_t eff; /*!< Facts in its effect */
-    plan_arr_int_t pre; /*!< Precondition facts */
-    int cost;
-};
-typedef struct _op_base_t op_base_t;
+#include "fact_op_graph.h"
 
 struct _op_t {
     int parent;           /*!< ID of the parent operator or -1 */
-    plan_arr_int_t child; /*!< List of child operators */
+    int child_beg;        /*!< ID of the first child operator */
+    int child_end;        /*!< ID after the last child operator */
     int pre_size;         /*!< Number of preconditions */
     int ext_fact;         /*!< Extension fact or -1 */
 
@@ -48,13 +43,22 @@ typedef struct _op_t op_t;
 #define OPID(H, OP) ((int)((OP) - (H)->op))
 #define OP_HAS_PARENT(OP) ((OP)->parent >= 0)
 #define OP_PARENT(H, OP) ((H)->op + (op)->parent)
-#define OPBASE_FROM_OP(H, OP) \
-    ((H)->op_base + ((OP)->parent >= 0 ? (OP)->parent : OPID((H), (OP))))
+#define OPBASE_ID(H, OP) \
+    ((OP)->parent >= 0 ? (OP)->parent : OPID((H), (OP)))
+#define OP_CHILD_FOR_EACH(OP, CHILD_ID) \
+    for ((CHILD_ID) = (OP)->child_beg; (CHILD_ID) < (OP)->child_end; \
+         ++(CHILD_ID))
+
+/** Iterates over base facts of the operator, i.e., over the facts of the
+ *  parent operator */
+#define OP_BASE_PRE_FOR_EACH(H, OP, FACT_ID) \
+    PLAN_FACT_OP_GRAPH_OP_PRE_FOR_EACH(&(H)->graph, OPBASE_ID((H), (OP)), \
+                                       (FACT_ID))
+#define OP_BASE_EFF_FOR_EACH(H, OP, FACT_ID) \
+    PLAN_FACT_OP_GRAPH_OP_EFF_FOR_EACH(&(H)->graph, OPBASE_ID((H), (OP)), \
+                                       (FACT_ID))
 
 struct _fact_t {
-    plan_arr_int_t pre_op; /*!< Operators having this fact as its
-                                precondition */
-    plan_arr_int_t eff_op; /*!< Operators having this fact as its effect */
     int value;
     plan_pq_el_t heap;     /*!< Connection to priority heap */
     int supp_cnt;          /*!< Number of operators that have this fact as
@@ -111,13 +115,18 @@ struct _plan_heur_lm_cut2_t {
     int fact_goal; /*!< ID of the artificial goal fact */
     int fact_nopre; /*!< ID of the fact representing empty preconditions */
 
-    op_base_t *op_base;
+    int *op_base_cost; /*!< Costs of the base operators */
     int op_base_size;
     op_t *op;
     int op_size;
     int op_alloc;
     int op_goal;
 
+    /** Preconditions and effects of the base operators. The extension
+     *  operators have as preconditions (effects) the extension fact
+     *  combined with the preconditions (effects) of its parent. */
+    plan_fact_op_graph_t graph;
+
     plan_arr_int_t state; /*!< Current state from which heur is computed */
     plan_arr_int_t cut;   /*!< Current cut */
 
@@ -134,9 +143,6 @@ static void heurDel(plan_heur_t *_heur);
 static void heurVal(plan_heur_t *_heur, const plan_state_t *state,
                     plan_heur_res_t *res);
 
-static void opBaseFree(op_base_t *op);
-static void opFree(op_t *op);
-static void factFree(fact_t *fact);
 static void loadOpFact(plan_heur_lm_cut2_t *h, const plan_problem_t *p);
 
 #ifdef PLAN_DEBUG
@@ -163,24 +169,16 @@ plan_heur_t *planHeurLMCut2New(const plan_problem_t *p, unsigned flags)
 static void heurDel(plan_heur_t *_heur)
 {
     plan_heur_lm_cut2_t *h = HEUR(_heur);
-    int i;
 
     _planHeurFree(&h->heur);
 
-    for (i = 0; i < h->fact_size; ++i)
-        factFree(h->fact + i);
     if (h->fact)
         BOR_FREE(h->fact);
-
-    for (i = 0; i < h->op_base_size; ++i)
-        opBaseFree(h->op_base + i);
-    if (h->op_base)
-        BOR_FREE(h->op_base);
-
-    for (i = 0; i < h->op_size; ++i)
-        opFree(h->op + i);
+    if (h->op_base_cost)
+        BOR_FREE(h->op_base_cost);
     if (h->op)
         BOR_FREE(h->op);
+    planFactOpGraphFree(&h->graph);
 
     if (h->fact_state)
         BOR_FREE(h->fact_state);
@@ -212,7 +210,7 @@ static void initOps(plan_heur_lm_cut2_t *h, int init_cost)
         op->supp = -1;
         op->supp_cost = INT_MAX;
         if (init_cost)
-            op->cost = OPBASE_FROM_OP(h, op)->cost;
+            op->cost = h->op_base_cost[OPBASE_ID(h, op)];
         op->goal_zone = 0;
     }
 }
@@ -235,7 +233,6 @@ static void addInitState(plan_heur_lm_cut2_t *h,
 static void enqueueOpEffects(plan_heur_lm_cut2_t *h, op_t *op,
                              int enable_fact, int fact_value, plan_pq_t *pq)
 {
-    op_base_t *op_base = OPBASE_FROM_OP(h, op);
     fact_t *fact;
     op_t *child_op;
     int value = op->cost + fact_value;
@@ -247,7 +244,7 @@ static void enqueueOpEffects(plan_heur_lm_cut2_t *h, op_t *op,
     F_SET_SUPP(h->fact + enable_fact);
 
     // Check all base effects
-    PLAN_ARR_INT_FOR_EACH(&op_base->eff, fact_id){
+    OP_BASE_EFF_FOR_EACH(h, op, fact_id){
         fact = h->fact + fact_id;
         if (FVALUE(fact) > value)
             FPUSH(pq, value, fact);
@@ -255,11 +252,7 @@ static void enqueueOpEffects(plan_heur_lm_cut2_t *h, op_t *op,
 
     // Check all extension effects if necessary
     if (OP_HAS_PARENT(op)){
-        PLAN_ARR_INT_FOR_EACH(&op_base->eff, fact_id){
-            if (fact_id >= h->fact_id.fact1_size)
-                break;
-
-            fact_id = planFactIdFact2(&h->fact_id, fact_id, op->ext_fact);
+        PLAN_FACT_OP_GRAPH_OP_EFF_FOR_EACH(&h->graph, OPID(h, op), fact_id){
             fact = h->fact + fact_id;
             if (FVALUE(fact) > value)
                 FPUSH(pq, value, fact);
@@ -268,7 +261,7 @@ static void enqueueOpEffects(plan_heur_lm_cut2_t *h, op_t *op,
 
     // Process all children operators if they have satisfied all
     // preconditions
-    PLAN_ARR_INT_FOR_EACH(&op->child, op_id){
+    OP_CHILD_FOR_EACH(op, op_id){
         child_op = h->op + op_id;
         if (child_op->unsat == 0)
             enqueueOpEffects(h, child_op, enable_fact, fact_value, pq);
@@ -291,7 +284,7 @@ static void hMaxFull(plan_heur_lm_cut2_t *h, const plan_state_t *state,
 
         // Check operators of which the current fact is in their
         // preconditions
-        PLAN_ARR_INT_FOR_EACH(&fact->pre_op, op_id){
+        PLAN_FACT_OP_GRAPH_FACT_PRE_FOR_EACH(&h->graph, FID(h, fact), op_id){
             op = h->op + op_id;
             if (--op->unsat == 0
                     && (!OP_HAS_PARENT(op) || OP_PARENT(h, op)->unsat == 0)){
@@ -312,22 +305,15 @@ static void hMaxFull(plan_heur_lm_cut2_t *h, const plan_state_t *state,
 
 static void updateSupp(plan_heur_lm_cut2_t *h, op_t *op)
 {
-    op_base_t *op_base = OPBASE_FROM_OP(h, op);
     int fact_id, supp = -1, value = -1;
 
-    PLAN_ARR_INT_FOR_EACH(&op_base->pre, fact_id)
+    OP_BASE_PRE_FOR_EACH(h, op, fact_id)
         UPDATE_SUPP(fact_id);
 
+    // The extension fact and its combinations with the base preconditions
     if (OP_HAS_PARENT(op)){
-        UPDATE_SUPP(op->ext_fact);
-
-        PLAN_ARR_INT_FOR_EACH(&op_base->pre, fact_id){
-            if (fact_id >= h->fact_id.fact1_size)
-                break;
-
-            fact_id = planFactIdFact2(&h->fact_id, fact_id, op->ext_fact);
+        PLAN_FACT_OP_GRAPH_OP_PRE_FOR_EACH(&h->graph, OPID(h, op), fact_id)
             UPDATE_SUPP(fact_id);
-        }
     }
 
     ASSERT(supp != -1);
@@ -340,13 +326,12 @@ static void updateSupp(plan_heur_lm_cut2_t *h, op_t *op)
 static void enqueueOpEffectsInc(plan_heur_lm_cut2_t *h, op_t *op,
                                 int fact_value, plan_pq_t *pq)
 {
-    op_base_t *op_base = OPBASE_FROM_OP(h, op);
     fact_t *fact;
     int value = op->cost + fact_value;
     int fact_id;
 
     // Check all base effects
-    PLAN_ARR_INT_FOR_EACH(&op_base->eff, fact_id){
+    OP_BASE_EFF_FOR_EACH(h, op, fact_id){
         fact = h->fact + fact_id;
         if (FVALUE(fact) > value)
             FPUSH(pq, value, fact);
@@ -354,11 +339,7 @@ static void enqueueOpEffectsInc(plan_heur_lm_cut2_t *h, op_t *op,
 
     // Check all extension effects if necessary
     if (OP_HAS_PARENT(op)){
-        PLAN_ARR_INT_FOR_EACH(&op_base->eff, fact_id){
-            if (fact_id >= h->fact_id.fact1_size)
-                break;
-
-            fact_id = planFactIdFact2(&h->fact_id, fact_id, op->ext_fact);
+        PLAN_FACT_OP_GRAPH_OP_EFF_FOR_EACH(&h->graph, OPID(h, op), fact_id){
             fact = h->fact + fact_id;
             if (FVALUE(fact) > value)
                 FPUSH(pq, value, fact);
@@ -371,7 +352,7 @@ static void hMaxIncUpdateOp(plan_heur_lm_cut2_t *h, op_t *op,
 {
     int old_supp_value, child_id;
 
-    PLAN_ARR_INT_FOR_EACH(&op->child, child_id)
+    OP_CHILD_FOR_EACH(op, child_id)
         hMaxIncUpdateOp(h, h->op + child_id, fact_id, fact_value);
 
     if (op->supp != fact_id || op->unsat > 0)
@@ -406,7 +387,7 @@ static void hMaxInc(plan_heur_lm_cut2_t *h)
         fact = FPOP(&h->pq, &fact_value);
         fact_id = FID(h, fact);
 
-        PLAN_ARR_INT_FOR_EACH(&fact->pre_op, op_id){
+        PLAN_FACT_OP_GRAPH_FACT_PRE_FOR_EACH(&h->graph, FID(h, fact), op_id){
             op = h->op + op_id;
             hMaxIncUpdateOp(h, op, fact_id, fact_value);
         }
@@ -426,14 +407,13 @@ static void markGoalZoneOp(plan_heur_lm_cut2_t *h, op_t *op)
         }
     }
 
-    PLAN_ARR_INT_FOR_EACH(&op->child, child_id)
+    OP_CHILD_FOR_EACH(op, child_id)
         markGoalZoneOp(h, h->op + child_id);
 }
 
 /** Mark facts connected with the goal with zero cost paths */
 static void markGoalZone(plan_heur_lm_cut2_t *h)
 {
-    fact_t *fact;
     int fact_id, op_id;
 
     h->queue.size = 0;
@@ -441,9 +421,8 @@ static void markGoalZone(plan_heur_lm_cut2_t *h)
     h->fact_state[h->fact_goal] = CUT_GOAL;
     while (h->queue.size > 0){
         fact_id = h->queue.arr[--h->queue.size];
-        fact = h->fact + fact_id;
 
-        PLAN_ARR_INT_FOR_EACH(&fact->eff_op, op_id)
+        PLAN_FACT_OP_GRAPH_FACT_EFF_FOR_EACH(&h->graph, fact_id, op_id)
             markGoalZoneOp(h, h->op + op_id);
     }
 }
@@ -460,20 +439,14 @@ static void markGoalZone(plan_heur_lm_cut2_t *h)
 static void findCutOpExpand(plan_heur_lm_cut2_t *h, int op_id)
 {
     op_t *op = h->op + op_id;
-    op_base_t *op_base = OPBASE_FROM_OP(h, op);
     int fact_id;
 
-    PLAN_ARR_INT_FOR_EACH(&op_base->eff, fact_id)
+    OP_BASE_EFF_FOR_EACH(h, op, fact_id)
         CUT_ENQUEUE_FACT(h, fact_id);
 
     if (OP_HAS_PARENT(op)){
-        PLAN_ARR_INT_FOR_EACH(&op_base->eff, fact_id){
-            if (fact_id >= h->fact_id.fact1_size)
-                break;
-
-            fact_id = planFactIdFact2(&h->fact_id, fact_id, op->ext_fact);
+        PLAN_FACT_OP_GRAPH_OP_EFF_FOR_EACH(&h->graph, op_id, fact_id)
             CUT_ENQUEUE_FACT(h, fact_id);
-        }
     }
 }
 
@@ -495,7 +468,7 @@ static int findCut(plan_heur_lm_cut2_t *h)
     h->cut.size = 0;
     while (h->queue.size > 0){
         fact_id = h->queue.arr[--h->queue.size];
-        PLAN_ARR_INT_FOR_EACH(&h->fact[fact_id].pre_op, op_id){
+        PLAN_FACT_OP_GRAPH_FACT_PRE_FOR_EACH(&h->graph, fact_id, op_id){
             op = h->op + op_id;
             if (op->supp == fact_id){
                 if (op->goal_zone){
@@ -506,7 +479,7 @@ static int findCut(plan_heur_lm_cut2_t *h)
                 }
             }
 
-            PLAN_ARR_INT_FOR_EACH(&op->child, child_id){
+            OP_CHILD_FOR_EACH(op, child_id){
                 child = h->op + child_id;
                 if (child->supp == fact_id){
                     if (child->goal_zone){
@@ -575,22 +548,6 @@ static void heurVal(plan_heur_t *_heur, const plan_state_t *state,
 
 
 
-static void opBaseFree(op_base_t *op)
-{
-    planArrIntFree(&op->eff);
-    planArrIntFree(&op->pre);
-}
-
-static void opFree(op_t *op)
-{
-}
-
-static void factFree(fact_t *fact)
-{
-    planArrIntFree(&fact->pre_op);
-    planArrIntFree(&fact->eff_op);
-}
-
 static op_t *nextOp(plan_heur_lm_cut2_t *h)
 {
     if (h->op_size == h->op_alloc){
@@ -602,17 +559,17 @@ static op_t *nextOp(plan_heur_lm_cut2_t *h)
     return h->op + h->op_size++;
 }
 
-static void addPrevail(plan_heur_lm_cut2_t *h, int op_id, int fact_id)
+static void addPrevail(plan_heur_lm_cut2_t *h, plan_arr_int_t *eff,
+                       int fact_id)
 {
-    op_base_t *op_base = h->op_base + op_id;
-    int size = op_base->eff.size;
+    int size = eff->size;
     int i, fid;
 
     // Add all combinations of the prevail condition with unary effect
     // facts (those are always at the beggining of the array).
-    for (i = 0; i < size && op_base->eff.arr[i] < h->fact_id.fact1_size; ++i){
-        fid = planFactIdFact2(&h->fact_id, op_base->eff.arr[i], fact_id);
-        planArrIntAdd(&op_base->eff, fid);
+    for (i = 0; i < size && eff->arr[i] < h->fact_id.fact1_size; ++i){
+        fid = planFactIdFact2(&h->fact_id, eff->arr[i], fact_id);
+        planArrIntAdd(eff, fid);
     }
 }
 
@@ -629,16 +586,19 @@ static void addOpExtFact(plan_heur_lm_cut2_t *h, const plan_problem_t *p,
     op_id = op - h->op;
     op->parent = parent_id;
     op->ext_fact = fact_id;
-    planArrIntAdd(&h->op[parent_id].child, op_id);
+    op->child_beg = op->child_end = 0;
+    if (h->op[parent_id].child_beg == h->op[parent_id].child_end)
+        h->op[parent_id].child_beg = op_id;
+    h->op[parent_id].child_end = op_id + 1;
 
     // Cross reference extension fact and all its combinations with unary
     // facts from the operator
-    planArrIntAdd(&h->fact[fact_id].pre_op, op_id);
+    planFactOpGraphAddPre(&h->graph, op_id, fact_id);
     for (i = 0; i < pre->vals_size; ++i){
         fact_id2 = planFactIdVar(&h->fact_id, pre->vals[i].var,
                                               pre->vals[i].val);
         res_fact_id = planFactIdFact2(&h->fact_id, fact_id, fact_id2);
-        planArrIntAdd(&h->fact[res_fact_id].pre_op, op_id);
+        planFactOpGraphAddPre(&h->graph, op_id, res_fact_id);
     }
     // Set up number of preconditions that must be fullfilled
     op->pre_size = pre->vals_size + 1;
@@ -648,12 +608,13 @@ static void addOpExtFact(plan_heur_lm_cut2_t *h, const plan_problem_t *p,
         fact_id2 = planFactIdVar(&h->fact_id, eff->vals[i].var,
                                               eff->vals[i].val);
         res_fact_id = planFactIdFact2(&h->fact_id, fact_id, fact_id2);
-        planArrIntAdd(&h->fact[res_fact_id].eff_op, op_id);
+        planFactOpGraphAddEff(&h->graph, op_id, res_fact_id);
     }
 }
 
 static void addPrevailAndExtPre(plan_heur_lm_cut2_t *h,
-                                const plan_problem_t *p, int op_id)
+                                const plan_problem_t *p, int op_id,
+                                plan_arr_int_t *op_eff)
 {
     const plan_part_state_t *pre = p->op[op_id].pre;
     const plan_part_state_t *eff = p->op[op_id].eff;
@@ -675,7 +636,7 @@ static void addPrevailAndExtPre(plan_heur_lm_cut2_t *h,
         // conditions
         if (prei < pre->vals_size && var == pre->vals[prei].var){
             fact_id = planFactIdVar(&h->fact_id, var, pre->vals[prei].val);
-            addPrevail(h, op_id, fact_id);
+            addPrevail(h, op_eff, fact_id);
             ++prei;
             continue;
         }
@@ -691,7 +652,7 @@ static void addPrevailAndExtPre(plan_heur_lm_cut2_t *h,
 
 static void loadOpFact(plan_heur_lm_cut2_t *h, const plan_problem_t *p)
 {
-    op_base_t *op_base;
+    plan_arr_int_t op_eff;
     op_t *op;
     int op_id, fid, size;
 
@@ -704,11 +665,12 @@ static void loadOpFact(plan_heur_lm_cut2_t *h, const plan_problem_t *p)
 
     // Allocate base operators
     h->op_base_size = p->op_size + 1;
-    h->op_base = BOR_CALLOC_ARR(op_base_t, h->op_base_size);
+    h->op_base_cost = BOR_CALLOC_ARR(int, h->op_base_size);
     h->op_size = h->op_alloc = p->op_size + 1;
     h->op = BOR_CALLOC_ARR(op_t, h->op_alloc);
     h->op_goal = h->op_size - 1;
 
+    planFactOpGraphInit(&h->graph, h->fact_size, h->op_size);
     for (op_id = 0; op_id < p->op_size; ++op_id){
         if (p->op[op_id].cond_eff_size > 0){
             fprintf(stderr, "ERROR: Conditional effects are not"
@@ -716,55 +678,51 @@ static void loadOpFact(plan_heur_lm_cut2_t *h, const plan_problem_t *p)
             exit(-1);
         }
 
-        op_base = h->op_base + op_id;
-        op_base->cost = p->op[op_id].cost;
+        h->op_base_cost[op_id] = p->op[op_id].cost;
 
         op = h->op + op_id;
         op->parent = -1;
         op->ext_fact = -1;
 
         // Set up effects
-        op_base->eff.arr = planFactIdPartState2(&h->fact_id, p->op[op_id].eff,
-                                                &size);
-        op_base->eff.alloc = op_base->eff.size = size;
+        op_eff.arr = planFactIdPartState2(&h->fact_id, p->op[op_id].eff,
+                                          &size);
+        op_eff.alloc = op_eff.size = size;
 
         // and preconditions
         op->pre_size = 0;
         PLAN_FACT_ID_FOR_EACH_PART_STATE(&h->fact_id, p->op[op_id].pre, fid){
-            planArrIntAdd(&h->fact[fid].pre_op, op_id);
+            planFactOpGraphAddPre(&h->graph, op_id, fid);
             ++op->pre_size;
-            planArrIntAdd(&op_base->pre, fid);
         }
 
         // Record operator with no preconditions
         if (p->op[op_id].pre->vals_size == 0){
-            planArrIntAdd(&h->fact[h->fact_nopre].pre_op, op_id);
+            planFactOpGraphAddPre(&h->graph, op_id, h->fact_nopre);
             op->pre_size = 1;
-            planArrIntAdd(&op_base->pre, h->fact_nopre);
         }
 
         // Extend operator with prevail condition and add extension facts
-        addPrevailAndExtPre(h, p, op_id);
+        addPrevailAndExtPre(h, p, op_id, &op_eff);
 
-        PLAN_ARR_INT_FOR_EACH(&op_base->eff, fid)
-            planArrIntAdd(&h->fact[fid].eff_op, op_id);
+        PLAN_ARR_INT_FOR_EACH(&op_eff, fid)
+            planFactOpGraphAddEff(&h->graph, op_id, fid);
+        planArrIntFree(&op_eff);
     }
 
     // Set up goal operator
-    op_base = h->op_base + h->op_goal;
     op = h->op + h->op_goal;
     op->parent = -1;
     op->ext_fact = -1;
-    planArrIntAdd(&op_base->eff, h->fact_goal);
+    planFactOpGraphAddEff(&h->graph, h->op_goal, h->fact_goal);
     op->cost = 0;
 
     op->pre_size = 0;
     PLAN_FACT_ID_FOR_EACH_PART_STATE(&h->fact_id, p->goal, fid){
-        planArrIntAdd(&h->fact[fid].pre_op, h->op_goal);
+        planFactOpGraphAddPre(&h->graph, h->op_goal, fid);
         ++op->pre_size;
-        planArrIntAdd(&op_base->pre, fid);
     }
-    planArrIntAdd(&h->fact[h->fact_goal].eff_op, h->op_goal);
+    planFactOpGraphFinalize(&h->graph);
 
     // Free unneeded memory
     h->op_alloc = h->op_size;
@@ -793,10 +751,10 @@ static void debug(plan_heur_lm_cut2_t *h, const char *header)
 
         fprintf(stderr, " value: %d", FVALUE(h->fact + i));
         fprintf(stderr, " pre_op:");
-        PLAN_ARR_INT_FOR_EACH(&h->fact[i].pre_op, j)
+        PLAN_FACT_OP_GRAPH_FACT_PRE_FOR_EACH(&h->graph, i, j)
             fprintf(stderr, " %d", j);
         fprintf(stderr, ", eff_op:");
-        PLAN_ARR_INT_FOR_EACH(&h->fact[i].eff_op, j)
+        PLAN_FACT_OP_GRAPH_FACT_EFF_FOR_EACH(&h->graph, i, j)
             fprintf(stderr, " %d", j);
         fprintf(stderr, " | supp_cnt: %d", h->fact[i].supp_cnt);
         fprintf(stderr, "\n");
@@ -810,16 +768,16 @@ static void debug(plan_heur_lm_cut2_t *h, const char *header)
             fprintf(stderr, " parent: %d", h->op[i].parent);
         }else{
             fprintf(stderr, " child:");
-            PLAN_ARR_INT_FOR_EACH(&h->op[i].child, j)
+            OP_CHILD_FOR_EACH(h->op + i, j)
                 fprintf(stderr, " %d", j);
         }
         fprintf(stderr, ", pre_size: %d", h->op[i].pre_size);
         fprintf(stderr, ", ext_fact: %d", h->op[i].ext_fact);
 
         if (i < h->op_base_size){
-            fprintf(stderr, ", cost: %d", h->op_base[i].cost);
+            fprintf(stderr, ", cost: %d", h->op_base_cost[i]);
             fprintf(stderr, ", eff:");
-            PLAN_ARR_INT_FOR_EACH(&h->op_base[i].eff, j)
+            PLAN_FACT_OP_GRAPH_OP_EFF_FOR_EACH(&h->graph, i, j)
                 fprintf(stderr, " %d", j);
         }
 
@@ -107,7 +107,8 @@ static int hdtgStep(plan_heur_ma_dtg_t *hdtg, plan_ma_comm_t *comm);
 static int update(plan_heur_ma_dtg_t *hdtg, plan_ma_comm_t *comm,
                   const plan_ma_msg_t *msg);
 
-plan_heur_t *planHeurMADTGNew(const plan_problem_t *agent_def)
+plan_heur_t *planHeurMADTGNew(const plan_problem_t *agent_def,
+                              unsigned flags)
 {
     plan_heur_ma_dtg_t *hdtg;
 
@@ -116,6 +117,10 @@ plan_heur_t *planHeurMADTGNew(const plan_problem_t *agent_def)
     _planHeurMAInit(&hdtg->heur, hdtgHeur, NULL, hdtgUpdate, hdtgRequest);
     initFakeOp(hdtg, agent_def);
     initDTGData(hdtg, agent_def);
+    if (flags & PLAN_HEUR_DTG_ALL_PAIRS){
+        planHeurDTGDataPrecompute(&hdtg->data,
+                                  PLAN_HEUR_DTG_ALL_PAIRS_MAX_RANGE);
+    }
     planHeurDTGCtxInit(&hdtg->ctx, &hdtg->data);
 
     planPartStateInit(&hdtg->goal, agent_def->var_size);
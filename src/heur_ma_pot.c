@@ -17,6 +17,7 @@
  * See the License for more information.
  */
 
+#include <math.h>
 #include <boruvka/alloc.h>
 #include <boruvka/rand.h>
 #include "plan/search.h"
@@ -18,16 +18,22 @@
  */
 
 #include <boruvka/alloc.h>
+#include <boruvka/rand.h>
 #include <plan/config.h>
 #include <plan/heur.h>
 
 #ifdef PLAN_LP
 #include "plan/pot.h"
 
+/** Seed of the random walks sampling states for the ensemble */
+#define ENSEMBLE_SEED 1234
+
 struct _plan_heur_potential_t {
     plan_heur_t heur;
     plan_pot_t pot;
     plan_lp_t *lp;
+    plan_pot_ensemble_t ens;
+    int use_ens;
 };
 typedef struct _plan_heur_potential_t plan_heur_potential_t;
 #define HEUR(parent) bor_container_of((parent), plan_heur_potential_t, heur)
@@ -35,6 +41,9 @@ typedef struct _plan_heur_potential_t plan_heur_potential_t;
 static void heurPotentialDel(plan_heur_t *_heur);
 static void heurPotential(plan_heur_t *_heur, const plan_state_t *state,
                           plan_heur_res_t *res);
+static void heurPotentialEnsemble(plan_heur_t *_heur,
+                                  const plan_state_t *state,
+                                  plan_heur_res_t *res);
 
 plan_heur_t *planHeurPotentialNew(const plan_problem_t *p,
                                   const plan_state_t *init_state,
@@ -53,10 +62,124 @@ plan_heur_t *planHeurPotentialNew(const plan_problem_t *p,
     return &heur->heur;
 }
 
+/** Applies the operator on the state */
+static void applyOp(const plan_op_t *op, const plan_state_t *state,
+                    plan_state_t *out)
+{
+    int i;
+
+    planStateCopy(out, state);
+    planPartStateUpdateState(op->eff, out);
+    for (i = 0; i < op->cond_eff_size; ++i){
+        if (planPartStateIsSubsetState(op->cond_eff[i].pre, state))
+            planPartStateUpdateState(op->cond_eff[i].eff, out);
+    }
+}
+
+/**
+ * Samples states by random walks from the initial state. The length of
+ * each walk is chosen uniformly from [0, 2 * L] where L is the estimate
+ * of the number of steps to the goal, i.e., the potential of the initial
+ * state divided by the average cost of the operators.
+ */
+static void sampleStates(const plan_problem_t *p,
+                         const plan_state_t *init_state,
+                         double init_pot, unsigned flags,
+                         plan_state_t **states, int num_states)
+{
+    bor_rand_t rnd;
+    plan_op_t **ops;
+    plan_state_t *cur, *next, *tmp;
+    double avg_cost;
+    int i, j, len, max_len, ops_size, cost;
+
+    avg_cost = 0.;
+    for (i = 0; i < p->op_size; ++i){
+        cost = p->op[i].cost;
+        if (flags & PLAN_HEUR_OP_UNIT_COST){
+            cost = 1;
+        }else if (flags & PLAN_HEUR_OP_COST_PLUS_ONE){
+            cost = cost + 1;
+        }
+        avg_cost += cost;
+    }
+    if (p->op_size > 0)
+        avg_cost /= p->op_size;
+    avg_cost = BOR_MAX(avg_cost, 1.);
+    max_len = 2 * (int)(BOR_MAX(init_pot, 0.) / avg_cost + 0.5);
+
+    borRandInitSeed(&rnd, ENSEMBLE_SEED);
+    ops = BOR_ALLOC_ARR(plan_op_t *, p->op_size + 1);
+    cur = planStateNew(p->state_pool->num_vars);
+    next = planStateNew(p->state_pool->num_vars);
+    for (i = 0; i < num_states; ++i){
+        planStateCopy(cur, init_state);
+        len = borRand(&rnd, 0., max_len + 1);
+        for (j = 0; j < len; ++j){
+            ops_size = planSuccGenFind(p->succ_gen, cur, ops, p->op_size);
+            if (ops_size == 0){
+                // Dead-end: restart the walk from the initial state
+                planStateCopy(cur, init_state);
+                continue;
+            }
+            applyOp(ops[(int)borRand(&rnd, 0., ops_size)], cur, next);
+            BOR_SWAP(cur, next, tmp);
+        }
+        planStateCopy(states[i], cur);
+    }
+
+    planStateDel(cur);
+    planStateDel(next);
+    BOR_FREE(ops);
+}
+
+plan_heur_t *planHeurPotentialEnsembleNew(const plan_problem_t *p,
+                                          const plan_state_t *init_state,
+                                          int ensemble_size, int num_threads,
+                                          unsigned flags)
+{
+    plan_heur_potential_t *heur;
+    plan_state_t **states;
+    double init_pot;
+    int i;
+
+    if (ensemble_size <= 1)
+        return planHeurPotentialNew(p, init_state, flags);
+
+    heur = BOR_ALLOC(plan_heur_potential_t);
+    bzero(heur, sizeof(*heur));
+    _planHeurInit(&heur->heur, heurPotentialDel, heurPotentialEnsemble, NULL);
+
+    planPotInit(&heur->pot, p->var, p->var_size, p->goal,
+                p->op, p->op_size, init_state, flags, 0);
+    planPotCompute(&heur->pot);
+    init_pot = planPotStatePot(&heur->pot, init_state);
+
+    // The first function is the one optimized for the initial state (or
+    // all syntactic states), the rest for the sampled states.
+    states = BOR_CALLOC_ARR(plan_state_t *, ensemble_size);
+    for (i = 1; i < ensemble_size; ++i)
+        states[i] = planStateNew(p->state_pool->num_vars);
+    sampleStates(p, init_state, init_pot, flags,
+                 states + 1, ensemble_size - 1);
+
+    planPotEnsembleInit(&heur->ens, &heur->pot, states, ensemble_size,
+                        num_threads);
+    heur->use_ens = 1;
+
+    for (i = 1; i < ensemble_size; ++i)
+        planStateDel(states[i]);
+    BOR_FREE(states);
+
+    return &heur->heur;
+}
+
 static void heurPotentialDel(plan_heur_t *_heur)
 {
     plan_heur_potential_t *h = HEUR(_heur);
 
+    if (h->use_ens)
+        planPotEnsembleFree(&h->ens);
     planPotFree(&h->pot);
     _planHeurFree(&h->heur);
     BOR_FREE(h);
@@ -71,6 +194,16 @@ static void heurPotential(plan_heur_t *_heur, const plan_state_t *state,
     res->heur = BOR_MAX(0, res->heur);
 }
 
+static void heurPotentialEnsemble(plan_heur_t *_heur,
+                                  const plan_state_t *state,
+                                  plan_heur_res_t *res)
+{
+    plan_heur_potential_t *h = HEUR(_heur);
+
+    res->heur = planPotEnsembleStatePot(&h->ens, &h->pot, state);
+    res->heur = BOR_MAX(0, res->heur);
+}
+
 #else /* PLAN_LP */
 
 plan_heur_t *planHeurPotentialNew(const plan_problem_t *p,
@@ -80,4 +213,12 @@ plan_heur_t *planHeurPotentialNew(const plan_problem_t *p,
     fprintf(stderr, "Fatal Error: heur-potential needs some LP library!\n");
     return NULL;
 }
+
+plan_heur_t *planHeurPotentialEnsembleNew(const plan_problem_t *p,
+                                          const plan_state_t *init_state,
+                                          int ensemble_size, int num_threads,
+                                          unsigned flags)
+{
+    return planHeurPotentialNew(p, init_state, flags);
+}
 #endif /* PLAN_LP */
@@ -89,6 +89,22 @@ void planHeurRelaxFree(plan_heur_relax_t *relax)
     planFactOpCrossRefFree(&relax->cref);
 }
 
+size_t planHeurRelaxMemUsage(const plan_heur_relax_t *relax)
+{
+    size_t size;
+
+    size  = 2 * sizeof(plan_heur_relax_op_t) * relax->cref.op_size;
+    size += 2 * sizeof(plan_heur_relax_fact_t) * relax->cref.fact_size;
+    if (relax->plan_fact)
+        size += sizeof(int) * relax->cref.fact_size;
+    if (relax->plan_op)
+        size += sizeof(int) * relax->cref.op_size;
+    if (relax->goal_fact)
+        size += sizeof(int) * relax->cref.fact_size;
+    size += planFactOpCrossRefMemUsage(&relax->cref);
+    return size;
+}
+
 static void relaxInit(plan_heur_relax_t *relax)
 {
     memcpy(relax->op, relax->op_init,
@@ -74,6 +74,12 @@ void planHeurRelaxInit(plan_heur_relax_t *relax, int type,
  */
 void planHeurRelaxFree(plan_heur_relax_t *relax);
 
+/**
+ * Returns number of bytes allocated by the relaxation arrays including
+ * the cross reference table.
+ */
+size_t planHeurRelaxMemUsage(const plan_heur_relax_t *relax);
+
 /**
  * Runs relaxation from the specified state until goal is reached.
  */
@@ -39,6 +39,14 @@ static void heurDel(plan_heur_t *_heur)
     BOR_FREE(heur);
 }
 
+static size_t heurMemUsage(const plan_heur_t *_heur)
+{
+    const plan_heur_relax_add_max_t *heur;
+
+    heur = bor_container_of(_heur, const plan_heur_relax_add_max_t, heur);
+    return sizeof(*heur) + planHeurRelaxMemUsage(&heur->relax);
+}
+
 static void prefOps(plan_heur_relax_add_max_t *heur, plan_heur_res_t *res)
 {
     plan_pref_op_selector_t sel;
@@ -83,6 +91,7 @@ static plan_heur_t *heurNew(const plan_problem_t *p,
     heur->base_op = p->op;
 
     _planHeurInit(&heur->heur, heurDel, heurVal, NULL);
+    _planHeurMemUsageInit(&heur->heur, heurMemUsage);
     planHeurRelaxInit(&heur->relax, relax_op,
                       p->var, p->var_size, p->goal, p->op, p->op_size, flags);
 
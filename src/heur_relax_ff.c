@@ -39,6 +39,14 @@ static void heurDel(plan_heur_t *_heur)
     BOR_FREE(heur);
 }
 
+static size_t heurMemUsage(const plan_heur_t *_heur)
+{
+    const plan_heur_relax_ff_t *heur;
+
+    heur = bor_container_of(_heur, const plan_heur_relax_ff_t, heur);
+    return sizeof(*heur) + planHeurRelaxMemUsage(&heur->relax);
+}
+
 static void prefOps(plan_heur_relax_ff_t *heur, plan_heur_res_t *res)
 {
     plan_pref_op_selector_t sel;
@@ -86,6 +94,7 @@ plan_heur_t *planHeurRelaxFFNew(const plan_problem_t *p, unsigned flags)
     heur = BOR_ALLOC(plan_heur_relax_ff_t);
     heur->base_op = p->op;
     _planHeurInit(&heur->heur, heurDel, heurVal, NULL);
+    _planHeurMemUsageInit(&heur->heur, heurMemUsage);
     planHeurRelaxInit(&heur->relax, PLAN_HEUR_RELAX_TYPE_ADD,
                       p->var, p->var_size, p->goal, p->op, p->op_size, flags);
 
@@ -59,6 +59,10 @@ typedef struct _plan_heur_lm_cut_t plan_heur_lm_cut_t;
 
 /** Delete method */
 static void planHeurLMCutDel(plan_heur_t *_heur);
+/** Returns allocated memory */
+static size_t planHeurLMCutMemUsage(const plan_heur_t *_heur);
+/** Releases landmark cache under memory pressure */
+static void planHeurLMCutShedMem(plan_heur_t *_heur, int level);
 /** Main function that returns heuristic value. */
 static void planHeurLMCutState(plan_heur_t *_heur, const plan_state_t *state,
                                plan_heur_res_t *res);
@@ -93,6 +97,8 @@ static plan_heur_t *lmCutNew(const plan_problem_t *p,
     }else{
         _planHeurInit(&heur->heur, planHeurLMCutDel, planHeurLMCutState, NULL);
     }
+    _planHeurMemUsageInit(&heur->heur, planHeurLMCutMemUsage);
+    _planHeurShedMemInit(&heur->heur, planHeurLMCutShedMem);
     planHeurRelaxInit(&heur->relax, PLAN_HEUR_RELAX_TYPE_MAX,
                       p->var, p->var_size, p->goal, p->op, p->op_size, flags);
 
@@ -134,6 +140,17 @@ plan_heur_t *planHeurRelaxLMCutIncCacheNew(const plan_problem_t *p,
     return lmCutNew(p, 2, flags, cache_flags);
 }
 
+void planHeurRelaxLMCutIncCacheSetMaxMem(plan_heur_t *heur, size_t max_mem)
+{
+    plan_heur_lm_cut_t *h;
+
+    if (heur->del_fn != planHeurLMCutDel)
+        return;
+    h = HEUR(heur);
+    if (h->inc_cache.enabled)
+        planLandmarkCacheSetMaxMem(h->inc_cache.ldm_cache, max_mem);
+}
+
 plan_heur_t *planHeurH2LMCutNew(const plan_problem_t *p, unsigned flags)
 {
     flags |= PLAN_HEUR_H2;
@@ -160,6 +177,40 @@ static void planHeurLMCutDel(plan_heur_t *_heur)
     BOR_FREE(heur);
 }
 
+static size_t planHeurLMCutMemUsage(const plan_heur_t *_heur)
+{
+    const plan_heur_lm_cut_t *heur;
+    size_t size;
+
+    heur = bor_container_of(_heur, const plan_heur_lm_cut_t, heur);
+    size  = sizeof(*heur);
+    size += planHeurRelaxMemUsage(&heur->relax);
+    size += 2 * sizeof(int) * heur->relax.cref.fact_size;
+    size += planArrIntMemUsage(&heur->cut);
+    if (heur->inc_local.enabled){
+        size += planLandmarkSetMemUsage(&heur->inc_local.ldms);
+        size += planOpIdTrMemUsage(&heur->inc_local.op_id_tr);
+    }
+    if (heur->inc_cache.enabled){
+        size += planLandmarkCacheMemUsage(heur->inc_cache.ldm_cache);
+        size += planOpIdTrMemUsage(&heur->inc_cache.op_id_tr);
+    }
+    return size;
+}
+
+static void planHeurLMCutShedMem(plan_heur_t *_heur, int level)
+{
+    plan_heur_lm_cut_t *heur = HEUR(_heur);
+
+    if (!heur->inc_cache.enabled)
+        return;
+    if (level >= PLAN_MEM_PRESSURE_HIGH){
+        planLandmarkCacheClear(heur->inc_cache.ldm_cache);
+    }else{
+        planLandmarkPrune(heur->inc_cache.ldm_cache);
+    }
+}
+
 
 
 static void markGoalZoneRecursive(plan_heur_lm_cut_t *heur, int fact_id)
@@ -21,33 +21,85 @@
 #include <boruvka/hfunc.h>
 #include "plan/landmark.h"
 
-/** Landmark record in hash table */
+/** Landmark record, shared by all sets containing the landmark */
 struct _ldm_t {
-    plan_landmark_t ldm;
+    plan_landmark_t ldm; /*!< Landmark, .op_id points to .op[] */
     int refcount;      /*!< Reference counter */
     bor_list_t htable; /*!< Connection to the hash table */
+    int op[];          /*!< Storage of operator IDs */
 };
 typedef struct _ldm_t ldm_t;
 #define LDM(lst) BOR_LIST_ENTRY((lst), ldm_t, htable)
 
 /** Landmark set */
 struct _ldm_set_t {
-    int size;
-    ldm_t **ldm_pts;
-    bor_splaytree_int_node_t tree; /*!< Connection to the list of landmarks */
+    int id;           /*!< ID under which the set is stored */
+    int size;         /*!< Number of landmarks */
+    bor_list_t lru;   /*!< Connection to the LRU list */
     bor_list_t prune; /*!< Connection to list of prune-ready landmarks */
+    ldm_t *ldm[];     /*!< Landmarks of the set */
 };
 typedef struct _ldm_set_t ldm_set_t;
 
+/** Slot of the open-addressing index of landmark sets */
+struct _plan_landmark_cache_slot_t {
+    int id;
+    ldm_set_t *set; /*!< NULL if the slot is empty */
+};
+typedef struct _plan_landmark_cache_slot_t slot_t;
+
+/**
+ * Arena of records. Memory is taken from large blocks and released
+ * records are kept in free lists indexed by their size. A free record is
+ * reused by a record of the same size or, before a new block is
+ * allocated, it is split to fit a smaller record. Records larger than
+ * ARENA_MAX_CHUNK are allocated directly.
+ */
+struct _plan_landmark_arena_t {
+    char **block;    /*!< Allocated blocks */
+    int block_size;  /*!< Number of allocated blocks */
+    char *cur;       /*!< Free space in the last block */
+    size_t left;     /*!< Number of bytes left in .cur */
+    void **free;     /*!< Free lists indexed by size / ARENA_ALIGN */
+    int free_size;   /*!< Number of elements of .free[] */
+    size_t large;    /*!< Bytes of records allocated directly */
+};
+typedef struct _plan_landmark_arena_t arena_t;
+
+#define ARENA_ALIGN sizeof(void *)
+#define ARENA_BLOCK_SIZE (64 * 1024)
+#define ARENA_MAX_CHUNK (ARENA_BLOCK_SIZE / 8)
+#define ARENA_CHUNK(size) \
+    (((size) + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN)
+
+static arena_t *arenaNew(void);
+static void arenaDel(arena_t *arena);
+static void *arenaAlloc(arena_t *arena, size_t size);
+static void arenaFree(arena_t *arena, void *ptr, size_t size);
+static void arenaPushFree(arena_t *arena, void *ptr, int cls);
+
+/** Initial number of slots of the index */
+#define INDEX_INIT_SIZE 64
+
+static void indexInit(plan_landmark_cache_t *ldmc, int size);
+static slot_t *indexFind(const plan_landmark_cache_t *ldmc, int id);
+static void indexRemove(plan_landmark_cache_t *ldmc, slot_t *slot);
+static void indexGrow(plan_landmark_cache_t *ldmc);
+
 static bor_htable_key_t ldmHash(const bor_list_t *k, void *ud);
 static int ldmEq(const bor_list_t *k1, const bor_list_t *k2, void *ud);
 
-static ldm_set_t *ldmSetNew(plan_landmark_set_t *l);
-static void ldmSetSoftDel(ldm_set_t *ldms);
 static void ldmSetDel(plan_landmark_cache_t *ldmc, ldm_set_t *ldms);
 static ldm_t *ldmInsert(plan_landmark_cache_t *ldmc,
                         plan_landmark_t *ldm);
-static void ldmDel(ldm_t *ldm);
+static void ldmDel(plan_landmark_cache_t *ldmc, ldm_t *ldm);
+static void evict(plan_landmark_cache_t *ldmc, const ldm_set_t *keep);
+
+/** Number of bytes allocated by the landmark set stored in cache */
+#define LDM_SET_MEM(size) \
+    ARENA_CHUNK(sizeof(ldm_set_t) + sizeof(ldm_t *) * (size))
+/** Number of bytes allocated by the landmark stored in cache */
+#define LDM_MEM(size) ARENA_CHUNK(sizeof(ldm_t) + sizeof(int) * (size))
 
 
 void planLandmarkInit(plan_landmark_t *ldm, int size, const int *op_id)
@@ -101,6 +153,17 @@ void planLandmarkSetFree(plan_landmark_set_t *ldms)
     }
 }
 
+size_t planLandmarkSetMemUsage(const plan_landmark_set_t *ldms)
+{
+    size_t size;
+    int i;
+
+    size = sizeof(plan_landmark_t) * ldms->size;
+    for (i = 0; i < ldms->size; ++i)
+        size += sizeof(int) * ldms->landmark[i].size;
+    return size;
+}
+
 void planLandmarkSetAdd(plan_landmark_set_t *ldms, int size, int *op_id)
 {
     plan_landmark_t *ldm;
@@ -120,96 +183,130 @@ plan_landmark_cache_t *planLandmarkCacheNew(unsigned flags)
 
     ldmc = BOR_ALLOC(plan_landmark_cache_t);
     ldmc->ldm_table = borHTableNew(ldmHash, ldmEq, NULL);
-    ldmc->ldms = borSplayTreeIntNew();
+    indexInit(ldmc, INDEX_INIT_SIZE);
+    borListInit(&ldmc->lru);
     borListInit(&ldmc->prune);
     ldmc->prune_enable = 0;
     if (flags & PLAN_LANDMARK_CACHE_PRUNE)
         ldmc->prune_enable = 1;
+    ldmc->max_mem = 0;
+    ldmc->arena = arenaNew();
 
     planLandmarkSetInit(&ldmc->ldms_out);
     ldmc->ldms_alloc = 0;
+    ldmc->mem = 0;
 
     return ldmc;
 }
 
 void planLandmarkCacheDel(plan_landmark_cache_t *ldmc)
 {
-    bor_splaytree_int_node_t *node, *tmp;
-    ldm_set_t *ldms;
-
-    BOR_SPLAYTREE_INT_FOR_EACH_SAFE(ldmc->ldms, node, tmp){
-        ldms = bor_container_of(node, ldm_set_t, tree);
-        ldmSetDel(ldmc, ldms);
-    }
+    planLandmarkCacheClear(ldmc);
 
     borHTableDel(ldmc->ldm_table);
-    borSplayTreeIntDel(ldmc->ldms);
+    BOR_FREE(ldmc->index);
+    arenaDel(ldmc->arena);
     if (ldmc->ldms_out.landmark)
         BOR_FREE(ldmc->ldms_out.landmark);
     BOR_FREE(ldmc);
 }
 
+void planLandmarkCacheSetMaxMem(plan_landmark_cache_t *ldmc, size_t max_mem)
+{
+    ldmc->max_mem = max_mem;
+    evict(ldmc, NULL);
+}
+
 int planLandmarkCacheAdd(plan_landmark_cache_t *ldmc,
                          int id, plan_landmark_set_t *ldms_in)
 {
-    bor_splaytree_int_node_t *ins;
+    slot_t *slot;
     ldm_set_t *ldms;
-    ldm_t *ldm;
     int i;
 
+    if (indexFind(ldmc, id)->set != NULL)
+        return -1;
+
     // Prune old landmarks if pruning is enable
     if (ldmc->prune_enable){
         planLandmarkPrune(ldmc);
     }
 
-    ldms = ldmSetNew(ldms_in);
-    ins = borSplayTreeIntInsert(ldmc->ldms, id, &ldms->tree);
-    if (ins != NULL){
-        ldmSetSoftDel(ldms);
-        return -1;
-    }
+    if (2 * (ldmc->num_sets + 1) > ldmc->index_size)
+        indexGrow(ldmc);
 
-    for (i = 0; i < ldms->size; ++i){
-        ldm = ldmInsert(ldmc, ldms_in->landmark + i);
-        ldms->ldm_pts[i] = ldm;
-    }
+    ldms = arenaAlloc(ldmc->arena, LDM_SET_MEM(ldms_in->size));
+    ldms->id = id;
+    ldms->size = ldms_in->size;
+    borListInit(&ldms->prune);
+    borListPrepend(&ldmc->lru, &ldms->lru);
+    ldmc->mem += LDM_SET_MEM(ldms->size);
 
-    BOR_FREE(ldms_in->landmark);
+    slot = indexFind(ldmc, id);
+    slot->id = id;
+    slot->set = ldms;
+    ++ldmc->num_sets;
+
+    for (i = 0; i < ldms->size; ++i)
+        ldms->ldm[i] = ldmInsert(ldmc, ldms_in->landmark + i);
+
+    if (ldms_in->landmark != NULL)
+        BOR_FREE(ldms_in->landmark);
     bzero(ldms_in, sizeof(*ldms_in));
+
+    evict(ldmc, ldms);
     return 0;
 }
 
 const plan_landmark_set_t *planLandmarkCacheGet(plan_landmark_cache_t *ldmc,
                                                 int ldmid)
 {
-    bor_splaytree_int_node_t *node;
     ldm_set_t *ldms;
     plan_landmark_set_t *out = &ldmc->ldms_out;
     int i;
 
-    node = borSplayTreeIntFind(ldmc->ldms, ldmid);
-    if (node == NULL)
+    ldms = indexFind(ldmc, ldmid)->set;
+    if (ldms == NULL)
         return NULL;
 
-    ldms = bor_container_of(node, ldm_set_t, tree);
     if (ldms->size > ldmc->ldms_alloc){
         ldmc->ldms_alloc = ldms->size;
         out->landmark = BOR_REALLOC_ARR(out->landmark, plan_landmark_t,
                                         ldmc->ldms_alloc);
     }
 
-    // If prunig is enabled and the landmark was not marked for pruning
-    // yet, add the landmark to the list of prune-ready landmarks.
-    if (ldmc->prune_enable && borListEmpty(&ldms->prune)){
+    // If the landmark was not marked for pruning yet, add the landmark to
+    // the list of prune-ready landmarks.
+    if (borListEmpty(&ldms->prune)){
         borListAppend(&ldmc->prune, &ldms->prune);
     }
 
+    // Move the set to the front of the LRU list
+    borListDel(&ldms->lru);
+    borListPrepend(&ldmc->lru, &ldms->lru);
+
     out->size = ldms->size;
     for (i = 0; i < ldms->size; ++i)
-        out->landmark[i] = ldms->ldm_pts[i]->ldm;
+        out->landmark[i] = ldms->ldm[i]->ldm;
     return out;
 }
 
+size_t planLandmarkCacheMemUsage(const plan_landmark_cache_t *ldmc)
+{
+    size_t size;
+
+    size  = sizeof(*ldmc);
+    size += ldmc->ldm_table->size * sizeof(bor_list_t);
+    size += ldmc->index_size * sizeof(slot_t);
+    size += sizeof(arena_t);
+    size += (size_t)ldmc->arena->block_size * ARENA_BLOCK_SIZE;
+    size += ldmc->arena->large;
+    size += ldmc->arena->block_size * sizeof(char *);
+    size += ldmc->arena->free_size * sizeof(void *);
+    size += ldmc->ldms_alloc * sizeof(plan_landmark_t);
+    return size;
+}
+
 int planLandmarkPrune(plan_landmark_cache_t *ldmc)
 {
     int cnt = 0;
@@ -225,17 +322,212 @@ int planLandmarkPrune(plan_landmark_cache_t *ldmc)
         if (borListNext(item) == &ldmc->prune)
             break;
 
-        // Delete landmark from the list
-        borListDel(item);
-
-        // Delete landmark
+        // Delete landmark (it is also removed from the list)
         ldms = BOR_LIST_ENTRY(item, ldm_set_t, prune);
         ldmSetDel(ldmc, ldms);
+        ++cnt;
     }
 
     return cnt;
 }
 
+void planLandmarkCacheClear(plan_landmark_cache_t *ldmc)
+{
+    ldm_set_t *ldms;
+
+    while (!borListEmpty(&ldmc->lru)){
+        ldms = BOR_LIST_ENTRY(borListNext(&ldmc->lru), ldm_set_t, lru);
+        ldmSetDel(ldmc, ldms);
+    }
+
+    // Give the memory back instead of keeping it in the free lists
+    arenaDel(ldmc->arena);
+    ldmc->arena = arenaNew();
+    BOR_FREE(ldmc->index);
+    indexInit(ldmc, INDEX_INIT_SIZE);
+}
+
+static arena_t *arenaNew(void)
+{
+    arena_t *arena;
+
+    arena = BOR_ALLOC(arena_t);
+    bzero(arena, sizeof(*arena));
+    return arena;
+}
+
+static void arenaDel(arena_t *arena)
+{
+    int i;
+
+    for (i = 0; i < arena->block_size; ++i)
+        BOR_FREE(arena->block[i]);
+    if (arena->block != NULL)
+        BOR_FREE(arena->block);
+    if (arena->free != NULL)
+        BOR_FREE(arena->free);
+    BOR_FREE(arena);
+}
+
+/** Takes a free record of at least the given size and returns the unused
+ *  rest of it back to the free lists. Returns NULL if there is no such
+ *  record. */
+static void *arenaSplitFree(arena_t *arena, size_t size)
+{
+    void *ptr;
+    int cls;
+
+    for (cls = size / ARENA_ALIGN + 1; cls < arena->free_size; ++cls){
+        if (arena->free[cls] == NULL)
+            continue;
+
+        ptr = arena->free[cls];
+        arena->free[cls] = *(void **)ptr;
+        arenaPushFree(arena, (char *)ptr + size,
+                      cls - size / ARENA_ALIGN);
+        return ptr;
+    }
+    return NULL;
+}
+
+static void *arenaAlloc(arena_t *arena, size_t size)
+{
+    void *ptr;
+    int cls;
+
+    size = ARENA_CHUNK(size);
+    if (size > ARENA_MAX_CHUNK){
+        arena->large += size;
+        return BOR_MALLOC(size);
+    }
+
+    cls = size / ARENA_ALIGN;
+    if (cls < arena->free_size && arena->free[cls] != NULL){
+        ptr = arena->free[cls];
+        arena->free[cls] = *(void **)ptr;
+        return ptr;
+    }
+
+    if (size > arena->left
+            && (ptr = arenaSplitFree(arena, size)) != NULL){
+        return ptr;
+    }
+
+    if (size > arena->left){
+        // Put the rest of the current block to the free list so it is
+        // not wasted
+        if (arena->left >= ARENA_ALIGN)
+            arenaFree(arena, arena->cur, arena->left);
+
+        ++arena->block_size;
+        arena->block = BOR_REALLOC_ARR(arena->block, char *,
+                                       arena->block_size);
+        arena->cur = BOR_ALLOC_ARR(char, ARENA_BLOCK_SIZE);
+        arena->block[arena->block_size - 1] = arena->cur;
+        arena->left = ARENA_BLOCK_SIZE;
+    }
+
+    ptr = arena->cur;
+    arena->cur += size;
+    arena->left -= size;
+    return ptr;
+}
+
+static void arenaFree(arena_t *arena, void *ptr, size_t size)
+{
+    size = ARENA_CHUNK(size);
+    if (size > ARENA_MAX_CHUNK){
+        arena->large -= size;
+        BOR_FREE(ptr);
+        return;
+    }
+    arenaPushFree(arena, ptr, size / ARENA_ALIGN);
+}
+
+/** Puts the free chunk of cls * ARENA_ALIGN bytes to its free list */
+static void arenaPushFree(arena_t *arena, void *ptr, int cls)
+{
+    int i;
+
+    if (cls >= arena->free_size){
+        arena->free = BOR_REALLOC_ARR(arena->free, void *, cls + 1);
+        for (i = arena->free_size; i <= cls; ++i)
+            arena->free[i] = NULL;
+        arena->free_size = cls + 1;
+    }
+    *(void **)ptr = arena->free[cls];
+    arena->free[cls] = ptr;
+}
+
+_bor_inline int indexHome(const plan_landmark_cache_t *ldmc, int id)
+{
+    unsigned h = (unsigned)id * 2654435769u;
+    return (h ^ (h >> 16)) & (ldmc->index_size - 1);
+}
+
+static void indexInit(plan_landmark_cache_t *ldmc, int size)
+{
+    int i;
+
+    ldmc->index_size = size;
+    ldmc->index = BOR_ALLOC_ARR(slot_t, size);
+    for (i = 0; i < size; ++i)
+        ldmc->index[i].set = NULL;
+    ldmc->num_sets = 0;
+}
+
+static slot_t *indexFind(const plan_landmark_cache_t *ldmc, int id)
+{
+    int mask = ldmc->index_size - 1;
+    int i;
+
+    for (i = indexHome(ldmc, id); ldmc->index[i].set != NULL;
+            i = (i + 1) & mask){
+        if (ldmc->index[i].id == id)
+            break;
+    }
+    return ldmc->index + i;
+}
+
+static void indexRemove(plan_landmark_cache_t *ldmc, slot_t *slot)
+{
+    int mask = ldmc->index_size - 1;
+    int i, j, k;
+
+    // Backward shift deletion: move the following entries of the probe
+    // sequence to the freed slot unless they are already at a position
+    // between their home slot and the freed slot.
+    i = j = slot - ldmc->index;
+    while (1){
+        j = (j + 1) & mask;
+        if (ldmc->index[j].set == NULL)
+            break;
+        k = indexHome(ldmc, ldmc->index[j].id);
+        if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+            continue;
+        ldmc->index[i] = ldmc->index[j];
+        i = j;
+    }
+    ldmc->index[i].set = NULL;
+    --ldmc->num_sets;
+}
+
+static void indexGrow(plan_landmark_cache_t *ldmc)
+{
+    slot_t *old = ldmc->index;
+    int old_size = ldmc->index_size;
+    int num_sets = ldmc->num_sets;
+    int i;
+
+    indexInit(ldmc, 2 * old_size);
+    for (i = 0; i < old_size; ++i){
+        if (old[i].set != NULL)
+            *indexFind(ldmc, old[i].id) = old[i];
+    }
+    ldmc->num_sets = num_sets;
+    BOR_FREE(old);
+}
+
 static bor_htable_key_t ldmHash(const bor_list_t *k, void *ud)
 {
     ldm_t *ldm = LDM(k);
@@ -252,63 +544,72 @@ static int ldmEq(const bor_list_t *k1, const bor_list_t *k2, void *ud)
     return !memcmp(l1->ldm.op_id, l2->ldm.op_id, sizeof(int) * l1->ldm.size);
 }
 
-static ldm_set_t *ldmSetNew(plan_landmark_set_t *l)
-{
-    ldm_set_t *ldms;
-
-    ldms = BOR_ALLOC(ldm_set_t);
-    ldms->size = l->size;
-    ldms->ldm_pts = BOR_ALLOC_ARR(ldm_t *, ldms->size);
-    borListInit(&ldms->prune);
-    return ldms;
-}
-
-static void ldmSetSoftDel(ldm_set_t *ldms)
-{
-    BOR_FREE(ldms->ldm_pts);
-    BOR_FREE(ldms);
-}
-
 static void ldmSetDel(plan_landmark_cache_t *ldmc, ldm_set_t *ldms)
 {
     int i;
 
-    borSplayTreeIntRemove(ldmc->ldms, &ldms->tree);
+    indexRemove(ldmc, indexFind(ldmc, ldms->id));
+    borListDel(&ldms->lru);
+    if (!borListEmpty(&ldms->prune))
+        borListDel(&ldms->prune);
     for (i = 0; i < ldms->size; ++i){
-        if (--ldms->ldm_pts[i]->refcount == 0){
-            borHTableErase(ldmc->ldm_table, &ldms->ldm_pts[i]->htable);
-            ldmDel(ldms->ldm_pts[i]);
+        if (--ldms->ldm[i]->refcount == 0){
+            borHTableErase(ldmc->ldm_table, &ldms->ldm[i]->htable);
+            ldmDel(ldmc, ldms->ldm[i]);
         }
     }
-    BOR_FREE(ldms->ldm_pts);
-    BOR_FREE(ldms);
+    ldmc->mem -= LDM_SET_MEM(ldms->size);
+    arenaFree(ldmc->arena, ldms, LDM_SET_MEM(ldms->size));
 }
 
 static ldm_t *ldmInsert(plan_landmark_cache_t *ldmc,
                         plan_landmark_t *ldm)
 {
-    ldm_t *l;
-    bor_list_t *ins;
+    ldm_t key, *l;
+    bor_list_t *found;
 
     planLandmarkUnify(ldm);
 
-    l = BOR_ALLOC(ldm_t);
-    l->ldm = *ldm;
-    l->refcount = 1;
-
-    ins = borHTableInsertUnique(ldmc->ldm_table, &l->htable);
-    if (ins != NULL){
-        BOR_FREE(l);
-        planLandmarkFree(ldm);
-        l = LDM(ins);
+    // Look up the landmark using the caller's array as a key
+    key.ldm = *ldm;
+    found = borHTableFind(ldmc->ldm_table, &key.htable);
+    if (found != NULL){
+        l = LDM(found);
         ++l->refcount;
+        planLandmarkFree(ldm);
+        return l;
     }
 
+    l = arenaAlloc(ldmc->arena, LDM_MEM(ldm->size));
+    l->ldm.size = ldm->size;
+    l->ldm.op_id = l->op;
+    memcpy(l->op, ldm->op_id, sizeof(int) * ldm->size);
+    l->refcount = 1;
+    borHTableInsert(ldmc->ldm_table, &l->htable);
+    ldmc->mem += LDM_MEM(l->ldm.size);
+    planLandmarkFree(ldm);
     return l;
 }
 
-static void ldmDel(ldm_t *ldm)
+static void ldmDel(plan_landmark_cache_t *ldmc, ldm_t *ldm)
+{
+    ldmc->mem -= LDM_MEM(ldm->ldm.size);
+    arenaFree(ldmc->arena, ldm, LDM_MEM(ldm->ldm.size));
+}
+
+/** Evicts the least recently used sets until the cache fits into the
+ *  budget, the set keep is never evicted */
+static void evict(plan_landmark_cache_t *ldmc, const ldm_set_t *keep)
 {
-    planLandmarkFree(&ldm->ldm);
-    BOR_FREE(ldm);
+    ldm_set_t *ldms;
+
+    if (ldmc->max_mem == 0)
+        return;
+
+    while (ldmc->mem > ldmc->max_mem && !borListEmpty(&ldmc->lru)){
+        ldms = BOR_LIST_ENTRY(borListPrev(&ldmc->lru), ldm_set_t, lru);
+        if (ldms == keep)
+            break;
+        ldmSetDel(ldmc, ldms);
+    }
 }
@@ -24,13 +24,15 @@ void _planListInit(plan_list_t *l,
                    plan_list_push_fn push_fn,
                    plan_list_pop_fn pop_fn,
                    plan_list_top_fn top_fn,
-                   plan_list_clear_fn clear_fn)
+                   plan_list_clear_fn clear_fn,
+                   plan_list_mem_usage_fn mem_usage_fn)
 {
     l->del_fn   = del_fn;
     l->push_fn  = push_fn;
     l->pop_fn   = pop_fn;
     l->top_fn   = top_fn;
     l->clear_fn = clear_fn;
+    l->mem_usage_fn = mem_usage_fn;
 }
 
 void _planListFree(plan_list_t *l)
@@ -56,6 +56,7 @@ static int planListLazyBucketPop(plan_list_lazy_t *l,
                                  plan_state_id_t *parent_state_id,
                                  plan_op_t **op);
 static void planListLazyBucketClear(plan_list_lazy_t *l);
+static size_t planListLazyBucketMemUsage(const plan_list_lazy_t *l);
 
 
 plan_list_lazy_t *planListLazyBucketNew(void)
@@ -77,7 +78,8 @@ plan_list_lazy_t *planListLazyBucketNew(void)
                      planListLazyBucketDel,
                      planListLazyBucketPush,
                      planListLazyBucketPop,
-                     planListLazyBucketClear);
+                     planListLazyBucketClear,
+                     planListLazyBucketMemUsage);
 
     return &b->list_lazy;
 }
@@ -175,4 +177,18 @@ static void planListLazyBucketClear(plan_list_lazy_t *_l)
     for (i = l->lowest_key; i < l->bucket_size; ++i){
         borFifoClear(l->bucket + i);
     }
+    l->lowest_key = INT_MAX;
+    l->size = 0;
+}
+
+static size_t planListLazyBucketMemUsage(const plan_list_lazy_t *_l)
+{
+    const plan_list_lazy_bucket_t *l;
+    size_t size;
+
+    l = bor_container_of(_l, const plan_list_lazy_bucket_t, list_lazy);
+    size  = sizeof(*l);
+    size += l->bucket_size * sizeof(bor_fifo_t);
+    size += l->size * sizeof(node_t);
+    return size;
 }
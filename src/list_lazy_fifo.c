@@ -25,6 +25,7 @@
 struct _plan_list_lazy_fifo_t {
     plan_list_lazy_t list;
     bor_fifo_t *fifo;
+    long size; /*!< Number of stored elements */
 };
 typedef struct _plan_list_lazy_fifo_t plan_list_lazy_fifo_t;
 
@@ -46,6 +47,7 @@ static int planListLazyFifoPop(plan_list_lazy_t *l,
                                plan_state_id_t *parent_state_id,
                                plan_op_t **op);
 static void planListLazyFifoClear(plan_list_lazy_t *l);
+static size_t planListLazyFifoMemUsage(const plan_list_lazy_t *l);
 
 
 plan_list_lazy_t *planListLazyFifoNew(void)
@@ -58,11 +60,13 @@ plan_list_lazy_t *planListLazyFifoNew(void)
                      planListLazyFifoDel,
                      planListLazyFifoPush,
                      planListLazyFifoPop,
-                     planListLazyFifoClear);
+                     planListLazyFifoClear,
+                     planListLazyFifoMemUsage);
 
     segment_size = sysconf(_SC_PAGESIZE);
     segment_size *= 4;
     l->fifo = borFifoNewSize(sizeof(plan_list_lazy_fifo_el_t), segment_size);
+    l->size = 0;
 
 
     return &l->list;
@@ -88,6 +92,7 @@ static void planListLazyFifoPush(plan_list_lazy_t *_l,
     el.op = op;
 
     borFifoPush(l->fifo, &el);
+    ++l->size;
 }
 
 static int planListLazyFifoPop(plan_list_lazy_t *_l,
@@ -107,6 +112,7 @@ static int planListLazyFifoPop(plan_list_lazy_t *_l,
     *op = el->op;
 
     borFifoPop(l->fifo);
+    --l->size;
 
     return 0;
 }
@@ -115,4 +121,16 @@ static void planListLazyFifoClear(plan_list_lazy_t *_l)
 {
     plan_list_lazy_fifo_t *l = LIST_FROM_PARENT(_l);
     borFifoClear(l->fifo);
+    l->size = 0;
+}
+
+static size_t planListLazyFifoMemUsage(const plan_list_lazy_t *_l)
+{
+    const plan_list_lazy_fifo_t *l;
+    size_t size;
+
+    l = bor_container_of(_l, const plan_list_lazy_fifo_t, list);
+    size  = sizeof(*l) + sizeof(bor_fifo_t);
+    size += l->size * sizeof(plan_list_lazy_fifo_el_t);
+    return size;
 }
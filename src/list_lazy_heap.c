@@ -24,6 +24,7 @@
 struct _plan_list_lazy_heap_t {
     plan_list_lazy_t list;
     bor_pairheap_t *heap;
+    long size; /*!< Number of nodes in the heap */
 };
 typedef struct _plan_list_lazy_heap_t plan_list_lazy_heap_t;
 
@@ -50,6 +51,7 @@ static int planListLazyHeapPop(plan_list_lazy_t *,
                                plan_state_id_t *parent_state_id,
                                plan_op_t **op);
 static void planListLazyHeapClear(plan_list_lazy_t *);
+static size_t planListLazyHeapMemUsage(const plan_list_lazy_t *);
 
 
 plan_list_lazy_t *planListLazyHeapNew(void)
@@ -58,11 +60,13 @@ plan_list_lazy_t *planListLazyHeapNew(void)
 
     l = BOR_ALLOC(plan_list_lazy_heap_t);
     l->heap = borPairHeapNew(heapLessThan, NULL);
+    l->size = 0;
     planListLazyInit(&l->list,
                      planListLazyHeapDel,
                      planListLazyHeapPush,
                      planListLazyHeapPop,
-                     planListLazyHeapClear);
+                     planListLazyHeapClear,
+                     planListLazyHeapMemUsage);
 
     return &l->list;
 }
@@ -88,6 +92,7 @@ static void planListLazyHeapPush(plan_list_lazy_t *_l,
     n->parent_state_id = parent_state_id;
     n->op              = op;
     borPairHeapAdd(l->heap, &n->heap);
+    ++l->size;
 }
 
 static int planListLazyHeapPop(plan_list_lazy_t *_l,
@@ -107,6 +112,7 @@ static int planListLazyHeapPop(plan_list_lazy_t *_l,
     *parent_state_id = n->parent_state_id;
     *op              = n->op;
     BOR_FREE(n);
+    --l->size;
 
     return 0;
 }
@@ -120,6 +126,15 @@ static void planListLazyHeapClear(plan_list_lazy_t *_l)
 {
     plan_list_lazy_heap_t *l = LIST_FROM_PARENT(_l);
     borPairHeapClear(l->heap, clearFn, NULL);
+    l->size = 0;
+}
+
+static size_t planListLazyHeapMemUsage(const plan_list_lazy_t *_l)
+{
+    const plan_list_lazy_heap_t *l;
+
+    l = bor_container_of(_l, const plan_list_lazy_heap_t, list);
+    return sizeof(*l) + sizeof(bor_pairheap_t) + l->size * sizeof(heap_node_t);
 }
 
 
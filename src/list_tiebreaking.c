@@ -47,6 +47,8 @@ struct _plan_list_tiebreaking_t {
     keynode_t *pre_keynode; /*!< Preinitialized key-node */
     int size;               /*!< Number of cost values the list is
                                  considering */
+    long keynode_size;      /*!< Number of key-nodes in the tree */
+    long node_size;         /*!< Number of stored values */
 };
 typedef struct _plan_list_tiebreaking_t plan_list_tiebreaking_t;
 
@@ -65,6 +67,7 @@ static int planListTieBreakingTop(plan_list_t *list,
                                   plan_state_id_t *state_id,
                                   plan_cost_t *cost);
 static void planListTieBreakingClear(plan_list_t *list);
+static size_t planListTieBreakingMemUsage(const plan_list_t *list);
 
 
 _bor_inline int keynodeCmp(const plan_cost_t *kn1,
@@ -93,8 +96,11 @@ plan_list_t *planListTieBreaking(int num_costs)
                   planListTieBreakingPush,
                   planListTieBreakingPop,
                   planListTieBreakingTop,
-                  planListTieBreakingClear);
+                  planListTieBreakingClear,
+                  planListTieBreakingMemUsage);
     list->size = num_costs;
+    list->keynode_size = 0;
+    list->node_size = 0;
     list->pre_keynode = keynodeNew(list->size);
 
     borSplayInit(list);
@@ -130,11 +136,13 @@ static void planListTieBreakingPush(plan_list_t *_list,
         // preallocate next key-node for next time.
         kn = list->pre_keynode;
         list->pre_keynode = keynodeNew(list->size);
+        ++list->keynode_size;
     }
 
     // Push next node into key-node container
     node.state_id = state_id;
     borFifoPush(&kn->fifo, &node);
+    ++list->node_size;
 }
 
 static int planListTieBreakingPop(plan_list_t *_list,
@@ -158,11 +166,13 @@ static int planListTieBreakingPop(plan_list_t *_list,
     *state_id = n->state_id;
     memcpy(cost, KEYNODE_COST(kn), sizeof(plan_cost_t) * list->size);
     borFifoPop(&kn->fifo);
+    --list->node_size;
 
     // If the key-node is empty, remove it from the tree
     if (borFifoEmpty(&kn->fifo)){
         borSplayRemove(list, kn);
         keynodeDel(kn);
+        --list->keynode_size;
     }
 
     return 0;
@@ -199,6 +209,21 @@ static void planListTieBreakingClear(plan_list_t *_list)
         borSplayRemove(list, list->root);
         keynodeDel(kn);
     }
+    list->keynode_size = 0;
+    list->node_size = 0;
+}
+
+static size_t planListTieBreakingMemUsage(const plan_list_t *_list)
+{
+    const plan_list_tiebreaking_t *list;
+    size_t size;
+
+    list = bor_container_of(_list, const plan_list_tiebreaking_t, list);
+    size  = sizeof(*list);
+    size += (list->keynode_size + 1)
+                * (sizeof(keynode_t) + sizeof(plan_cost_t) * list->size);
+    size += list->node_size * sizeof(node_t);
+    return size;
 }
 
 _bor_inline int keynodeCmp(const plan_cost_t *kn1,
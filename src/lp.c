@@ -27,6 +27,11 @@
 # error "Only one LP solver can be defined!"
 #endif /* defined(PLAN_USE_LP_SOLVE) && defined(PLAN_USE_CPLEX) */
 
+#ifdef PLAN_USE_LP_NATIVE
+# include "lp_native.h"
+# define NATIVE(lp) ((plan_lp_native_t *)(lp))
+#endif /* PLAN_USE_LP_NATIVE */
+
 #ifdef PLAN_USE_LP_SOLVE
 # include <lpsolve/lp_lib.h>
 
@@ -93,6 +98,10 @@ static double cplexObjVal(plan_lp_t *lp)
 
 plan_lp_t *planLPNew(int rows, int cols, unsigned flags)
 {
+#ifdef PLAN_USE_LP_NATIVE
+    return (plan_lp_t *)planLPNativeNew(rows, cols, (flags & 0x1u));
+#endif /* PLAN_USE_LP_NATIVE */
+
 #ifdef PLAN_USE_LP_SOLVE
     lprec *lp;
 
@@ -155,6 +164,11 @@ plan_lp_t *planLPNew(int rows, int cols, unsigned flags)
 
 void planLPDel(plan_lp_t *lp)
 {
+#ifdef PLAN_USE_LP_NATIVE
+    planLPNativeDel(NATIVE(lp));
+    return;
+#endif /* PLAN_USE_LP_NATIVE */
+
 #ifdef PLAN_USE_LP_SOLVE
     lprec *l = (lprec *)lp;
     delete_lp(l);
@@ -171,6 +185,10 @@ void planLPDel(plan_lp_t *lp)
 
 void planLPSetObj(plan_lp_t *lp, int i, double coef)
 {
+#ifdef PLAN_USE_LP_NATIVE
+    planLPNativeSetObj(NATIVE(lp), i, coef);
+#endif /* PLAN_USE_LP_NATIVE */
+
 #ifdef PLAN_USE_LP_SOLVE
     lprec *l = (lprec *)lp;
     set_obj(l, i + 1, coef);
@@ -187,6 +205,10 @@ void planLPSetObj(plan_lp_t *lp, int i, double coef)
 
 void planLPSetVarRange(plan_lp_t *lp, int i, double lb, double ub)
 {
+#ifdef PLAN_USE_LP_NATIVE
+    planLPNativeSetVarRange(NATIVE(lp), i, lb, ub);
+#endif /* PLAN_USE_LP_NATIVE */
+
 #ifdef PLAN_USE_LP_SOLVE
     lprec *l = (lprec *)lp;
     set_lowbo(l, i + 1, lb);
@@ -208,6 +230,11 @@ void planLPSetVarRange(plan_lp_t *lp, int i, double lb, double ub)
 
 void planLPSetVarFree(plan_lp_t *lp, int i)
 {
+#ifdef PLAN_USE_LP_NATIVE
+    planLPNativeSetVarRange(NATIVE(lp), i, -PLAN_LP_NATIVE_INF,
+                            PLAN_LP_NATIVE_INF);
+#endif /* PLAN_USE_LP_NATIVE */
+
 #ifdef PLAN_USE_LP_SOLVE
     lprec *l = (lprec *)lp;
     set_unbounded(l, i + 1);
@@ -220,6 +247,10 @@ void planLPSetVarFree(plan_lp_t *lp, int i)
 
 void planLPSetVarInt(plan_lp_t *lp, int i)
 {
+#ifdef PLAN_USE_LP_NATIVE
+    planLPNativeSetVarInt(NATIVE(lp), i);
+#endif /* PLAN_USE_LP_NATIVE */
+
 #ifdef PLAN_USE_LP_SOLVE
     lprec *l = (lprec *)lp;
     set_int(l, i + 1, 1);
@@ -238,6 +269,11 @@ void planLPSetVarInt(plan_lp_t *lp, int i)
 
 void planLPSetVarBinary(plan_lp_t *lp, int i)
 {
+#ifdef PLAN_USE_LP_NATIVE
+    planLPNativeSetVarRange(NATIVE(lp), i, 0., 1.);
+    planLPNativeSetVarInt(NATIVE(lp), i);
+#endif /* PLAN_USE_LP_NATIVE */
+
 #ifdef PLAN_USE_LP_SOLVE
     planLPSetVarRange(lp, i, 0, 1);
     planLPSetVarInt(lp, i);
@@ -256,6 +292,10 @@ void planLPSetVarBinary(plan_lp_t *lp, int i)
 
 void planLPSetCoef(plan_lp_t *lp, int row, int col, double coef)
 {
+#ifdef PLAN_USE_LP_NATIVE
+    planLPNativeSetCoef(NATIVE(lp), row, col, coef);
+#endif /* PLAN_USE_LP_NATIVE */
+
 #ifdef PLAN_USE_LP_SOLVE
     lprec *l = (lprec *)lp;
     set_mat(l, row + 1, col + 1, coef);
@@ -272,6 +312,10 @@ void planLPSetCoef(plan_lp_t *lp, int row, int col, double coef)
 
 void planLPSetRHS(plan_lp_t *lp, int row, double rhs, char sense)
 {
+#ifdef PLAN_USE_LP_NATIVE
+    planLPNativeSetRHS(NATIVE(lp), row, rhs, sense);
+#endif /* PLAN_USE_LP_NATIVE */
+
 #ifdef PLAN_USE_LP_SOLVE
     lprec *l = (lprec *)lp;
     set_rh(l, row + 1, rhs);
@@ -293,6 +337,10 @@ void planLPSetRHS(plan_lp_t *lp, int row, double rhs, char sense)
 
 void planLPAddRows(plan_lp_t *lp, int cnt, const double *rhs, const char *sense)
 {
+#ifdef PLAN_USE_LP_NATIVE
+    planLPNativeAddRows(NATIVE(lp), cnt, rhs, sense);
+#endif /* PLAN_USE_LP_NATIVE */
+
 #ifdef PLAN_USE_LP_SOLVE
     lprec *l = (lprec *)lp;
     int i, vsen = EQ;
@@ -319,6 +367,10 @@ void planLPAddRows(plan_lp_t *lp, int cnt, const double *rhs, const char *sense)
 
 void planLPDelRows(plan_lp_t *lp, int begin, int end)
 {
+#ifdef PLAN_USE_LP_NATIVE
+    planLPNativeDelRows(NATIVE(lp), begin, end);
+#endif /* PLAN_USE_LP_NATIVE */
+
 #ifdef PLAN_USE_LP_SOLVE
     lprec *l = (lprec *)lp;
     int i;
@@ -338,6 +390,10 @@ void planLPDelRows(plan_lp_t *lp, int begin, int end)
 
 int planLPNumRows(const plan_lp_t *lp)
 {
+#ifdef PLAN_USE_LP_NATIVE
+    return planLPNativeNumRows(NATIVE(lp));
+#endif /* PLAN_USE_LP_NATIVE */
+
 #ifdef PLAN_USE_LP_SOLVE
     lprec *l = (lprec *)lp;
     return get_Nrows(l);
@@ -350,6 +406,10 @@ int planLPNumRows(const plan_lp_t *lp)
 
 int planLPSolve(plan_lp_t *lp, double *val, double *obj)
 {
+#ifdef PLAN_USE_LP_NATIVE
+    return planLPNativeSolve(NATIVE(lp), val, obj);
+#endif /* PLAN_USE_LP_NATIVE */
+
 #ifdef PLAN_USE_LP_SOLVE
     lprec *l = (lprec *)lp;
     int ret;
@@ -403,6 +463,10 @@ int planLPSolve(plan_lp_t *lp, double *val, double *obj)
 
 void planLPWrite(plan_lp_t *lp, const char *fn)
 {
+#ifdef PLAN_USE_LP_NATIVE
+    planLPNativeWrite(NATIVE(lp), fn);
+#endif /* PLAN_USE_LP_NATIVE */
+
 #ifdef PLAN_USE_LP_SOLVE
     lprec *l = (lprec *)lp;
     write_lp(l, (char *)fn);
@@ -0,0 +1,1524 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include <boruvka/alloc.h>
+#include "lp_native.h"
+
+#define INF PLAN_LP_NATIVE_INF
+#define TOL_PRIMAL 1E-7
+#define TOL_DUAL 1E-7
+#define TOL_PIVOT 1E-9
+#define TOL_INT 1E-6
+
+/** Number of product-form updates before the basis is refactorized */
+#define REFACTOR_ETAS 64
+/** Number of consecutive degenerate iterations before switching to the
+ *  Bland's rule */
+#define BLAND_AFTER 50
+/** Number of re-verifications of the optimal basis */
+#define MAX_VERIFY 5
+
+#define ST_BASIC 0
+#define ST_LB    1
+#define ST_UB    2
+#define ST_FREE  3
+
+#define RES_OPTIMAL    0
+#define RES_INFEASIBLE 1
+#define RES_UNBOUNDED  2
+#define RES_LIMIT      3
+#define RES_DUAL_LOST  4
+
+/** Sparse column of the constraint matrix */
+struct _col_t {
+    int *row;
+    double *val;
+    int size;
+    int alloc;
+};
+typedef struct _col_t col_t;
+
+/** Growable sparse list of (index, value) pairs */
+struct _sparse_t {
+    int *idx;
+    double *val;
+    int size;
+    int alloc;
+};
+typedef struct _sparse_t sparse_t;
+
+/**
+ * LU factorization of the basis matrix B in the form E B = U where E is
+ * a product of elementary lower triangular matrices (stored as lists of
+ * multipliers) and U is a row and column permuted upper triangular
+ * matrix, followed by the product-form updates.
+ */
+struct _lu_t {
+    int m;
+    int *piv_row;     /*!< Pivot row of k'th step */
+    int *piv_col;     /*!< Pivot column (basis position) of k'th step */
+    double *piv_val;  /*!< Pivot value */
+    int *l_beg;       /*!< Multipliers of k'th step, l_beg[k]..l_beg[k+1] */
+    sparse_t l;
+    int *u_beg;       /*!< Off-diagonal elements of k'th row of U */
+    sparse_t u;
+
+    int eta_size;     /*!< Number of product-form updates */
+    int eta_alloc;
+    int *eta_pos;     /*!< Basis position replaced by the update */
+    double *eta_piv;  /*!< Pivot element of the updating column */
+    int *eta_beg;
+    sparse_t eta;
+};
+typedef struct _lu_t lu_t;
+
+struct _plan_lp_native_t {
+    int rows;
+    int cols;
+    int maximize;
+    double *obj;    /*!< Objective coefficients as given */
+    double *cost;   /*!< Minimization costs of structural variables */
+    char *is_int;
+    int has_int;
+    col_t *col;
+
+    /** Bounds, status and values of all variables: structural variables
+     *  are followed by logical variables, i-th logical variable equals to
+     *  the value of the left hand side of i-th row. */
+    double *lb;
+    double *ub;
+    char *stat;
+    double *x;
+    int var_alloc;
+
+    int *head;      /*!< Basic variable at each basis position */
+    int factorized;
+    lu_t lu;
+
+    double *d;      /*!< Reduced costs */
+    double *y;      /*!< Duals */
+    double *alpha;  /*!< Transformed entering column */
+    double *rho;    /*!< Row of the basis inverse */
+    double *w1;
+    double *w2;
+    int *iw1;
+    int *iw2;
+    int work_alloc;
+};
+
+static void sparseAdd(sparse_t *s, int idx, double val)
+{
+    if (s->size == s->alloc){
+        s->alloc = 2 * s->alloc + 16;
+        s->idx = BOR_REALLOC_ARR(s->idx, int, s->alloc);
+        s->val = BOR_REALLOC_ARR(s->val, double, s->alloc);
+    }
+    s->idx[s->size] = idx;
+    s->val[s->size++] = val;
+}
+
+static void sparseFree(sparse_t *s)
+{
+    if (s->idx != NULL)
+        BOR_FREE(s->idx);
+    if (s->val != NULL)
+        BOR_FREE(s->val);
+}
+
+static int isFinite(double v)
+{
+    return v > -INF && v < INF;
+}
+
+static int isSlack(const plan_lp_native_t *lp, int var)
+{
+    return var >= lp->cols;
+}
+
+
+/*** LU factorization ***/
+static void luFree(lu_t *lu)
+{
+    if (lu->piv_row != NULL)
+        BOR_FREE(lu->piv_row);
+    if (lu->piv_col != NULL)
+        BOR_FREE(lu->piv_col);
+    if (lu->piv_val != NULL)
+        BOR_FREE(lu->piv_val);
+    if (lu->l_beg != NULL)
+        BOR_FREE(lu->l_beg);
+    if (lu->u_beg != NULL)
+        BOR_FREE(lu->u_beg);
+    sparseFree(&lu->l);
+    sparseFree(&lu->u);
+    if (lu->eta_pos != NULL)
+        BOR_FREE(lu->eta_pos);
+    if (lu->eta_piv != NULL)
+        BOR_FREE(lu->eta_piv);
+    if (lu->eta_beg != NULL)
+        BOR_FREE(lu->eta_beg);
+    sparseFree(&lu->eta);
+    bzero(lu, sizeof(*lu));
+}
+
+static void luReset(lu_t *lu, int m)
+{
+    if (lu->m != m){
+        lu->m = m;
+        lu->piv_row = BOR_REALLOC_ARR(lu->piv_row, int, m + 1);
+        lu->piv_col = BOR_REALLOC_ARR(lu->piv_col, int, m + 1);
+        lu->piv_val = BOR_REALLOC_ARR(lu->piv_val, double, m + 1);
+        lu->l_beg = BOR_REALLOC_ARR(lu->l_beg, int, m + 1);
+        lu->u_beg = BOR_REALLOC_ARR(lu->u_beg, int, m + 1);
+    }
+    lu->l.size = 0;
+    lu->u.size = 0;
+    lu->eta_size = 0;
+    lu->eta.size = 0;
+    if (lu->eta_beg == NULL){
+        lu->eta_alloc = REFACTOR_ETAS + 1;
+        lu->eta_pos = BOR_ALLOC_ARR(int, lu->eta_alloc);
+        lu->eta_piv = BOR_ALLOC_ARR(double, lu->eta_alloc);
+        lu->eta_beg = BOR_ALLOC_ARR(int, lu->eta_alloc + 1);
+    }
+    lu->eta_beg[0] = 0;
+}
+
+/**
+ * Computes B^{-1} b. The input vector b is indexed by rows and it is
+ * destroyed, the result is written to x indexed by basis positions.
+ */
+static void luFTran(const lu_t *lu, double *b, double *x)
+{
+    int k, i, p;
+    double v, xp;
+
+    for (k = 0; k < lu->m; ++k){
+        if (lu->l_beg[k] == lu->l_beg[k + 1])
+            continue;
+        v = b[lu->piv_row[k]];
+        if (v == 0.)
+            continue;
+        for (i = lu->l_beg[k]; i < lu->l_beg[k + 1]; ++i)
+            b[lu->l.idx[i]] -= lu->l.val[i] * v;
+    }
+
+    for (k = lu->m - 1; k >= 0; --k){
+        v = b[lu->piv_row[k]];
+        for (i = lu->u_beg[k]; i < lu->u_beg[k + 1]; ++i)
+            v -= lu->u.val[i] * x[lu->u.idx[i]];
+        x[lu->piv_col[k]] = v / lu->piv_val[k];
+    }
+
+    for (k = 0; k < lu->eta_size; ++k){
+        p = lu->eta_pos[k];
+        xp = x[p] / lu->eta_piv[k];
+        if (xp != 0.){
+            for (i = lu->eta_beg[k]; i < lu->eta_beg[k + 1]; ++i)
+                x[lu->eta.idx[i]] -= lu->eta.val[i] * xp;
+        }
+        x[p] = xp;
+    }
+}
+
+/**
+ * Computes B^{-T} d. The input vector d is indexed by basis positions and
+ * it is destroyed, the result is written to y indexed by rows.
+ */
+static void luBTran(const lu_t *lu, double *d, double *y)
+{
+    int k, i, p;
+    double v;
+
+    for (k = lu->eta_size - 1; k >= 0; --k){
+        p = lu->eta_pos[k];
+        v = d[p];
+        for (i = lu->eta_beg[k]; i < lu->eta_beg[k + 1]; ++i)
+            v -= lu->eta.val[i] * d[lu->eta.idx[i]];
+        d[p] = v / lu->eta_piv[k];
+    }
+
+    for (k = 0; k < lu->m; ++k){
+        v = d[lu->piv_col[k]] / lu->piv_val[k];
+        y[lu->piv_row[k]] = v;
+        if (v == 0.)
+            continue;
+        for (i = lu->u_beg[k]; i < lu->u_beg[k + 1]; ++i)
+            d[lu->u.idx[i]] -= lu->u.val[i] * v;
+    }
+
+    for (k = lu->m - 1; k >= 0; --k){
+        v = 0.;
+        for (i = lu->l_beg[k]; i < lu->l_beg[k + 1]; ++i)
+            v += lu->l.val[i] * y[lu->l.idx[i]];
+        y[lu->piv_row[k]] -= v;
+    }
+}
+
+/** Adds product-form update replacing basis position pos by the column
+ *  alpha = B^{-1} a (indexed by basis positions) */
+static void luUpdate(lu_t *lu, int pos, const double *alpha)
+{
+    int i, k;
+
+    k = lu->eta_size++;
+    lu->eta_pos[k] = pos;
+    lu->eta_piv[k] = alpha[pos];
+    for (i = 0; i < lu->m; ++i){
+        if (i != pos && alpha[i] != 0.)
+            sparseAdd(&lu->eta, i, alpha[i]);
+    }
+    lu->eta_beg[k + 1] = lu->eta.size;
+}
+
+/**
+ * Factorizes the basis matrix. Row and column singletons are eliminated
+ * first (no fill-in and no numerical updates are needed for them) and
+ * the remaining kernel is factorized as a dense matrix with partial
+ * pivoting. Returns the number of basis positions that could not be
+ * pivoted because the basis is singular, these positions are stored in
+ * sing_pos and the unpivoted rows in sing_row.
+ */
+static int luFactor(plan_lp_native_t *lp, int *sing_pos, int *sing_row)
+{
+    lu_t *lu = &lp->lu;
+    int m = lp->rows;
+    int *cbeg, *crow, *rbeg, *rpos, *row_cnt, *col_cnt, *stack, *R, *C;
+    double *cval, *rval, *K, v, l, bv;
+    char *row_act, *col_act, *row_done;
+    int nnz, i, j, e, p, r, c, k, kr, ii, jj, best, var;
+    int stack_size, sing_size;
+
+    luReset(lu, m);
+    lu->l_beg[0] = lu->u_beg[0] = 0;
+    if (m <= 0)
+        return 0;
+
+    // Basis matrix stored by columns and by rows
+    nnz = 0;
+    for (p = 0; p < m; ++p){
+        var = lp->head[p];
+        nnz += (isSlack(lp, var) ? 1 : lp->col[var].size);
+    }
+    cbeg = BOR_ALLOC_ARR(int, m + 1);
+    crow = BOR_ALLOC_ARR(int, nnz + 1);
+    cval = BOR_ALLOC_ARR(double, nnz + 1);
+    rbeg = BOR_CALLOC_ARR(int, m + 1);
+    rpos = BOR_ALLOC_ARR(int, nnz + 1);
+    rval = BOR_ALLOC_ARR(double, nnz + 1);
+    nnz = 0;
+    for (p = 0; p < m; ++p){
+        cbeg[p] = nnz;
+        var = lp->head[p];
+        if (isSlack(lp, var)){
+            crow[nnz] = var - lp->cols;
+            cval[nnz++] = -1.;
+        }else{
+            for (i = 0; i < lp->col[var].size; ++i){
+                crow[nnz] = lp->col[var].row[i];
+                cval[nnz++] = lp->col[var].val[i];
+            }
+        }
+    }
+    cbeg[m] = nnz;
+    for (e = 0; e < nnz; ++e)
+        ++rbeg[crow[e]];
+    for (i = 0, j = 0; i < m; ++i){
+        r = rbeg[i];
+        rbeg[i] = j;
+        j += r;
+    }
+    rbeg[m] = j;
+    row_cnt = BOR_ALLOC_ARR(int, m);
+    for (i = 0; i < m; ++i)
+        row_cnt[i] = rbeg[i];
+    for (p = 0; p < m; ++p){
+        for (e = cbeg[p]; e < cbeg[p + 1]; ++e){
+            r = crow[e];
+            rpos[row_cnt[r]] = p;
+            rval[row_cnt[r]++] = cval[e];
+        }
+    }
+
+    col_cnt = BOR_ALLOC_ARR(int, m);
+    for (i = 0; i < m; ++i){
+        row_cnt[i] = rbeg[i + 1] - rbeg[i];
+        col_cnt[i] = cbeg[i + 1] - cbeg[i];
+    }
+    row_act = BOR_ALLOC_ARR(char, m);
+    col_act = BOR_ALLOC_ARR(char, m);
+    memset(row_act, 1, m);
+    memset(col_act, 1, m);
+    stack = BOR_ALLOC_ARR(int, m + nnz + 1);
+
+    k = 0;
+
+    // Column singletons
+    stack_size = 0;
+    for (p = 0; p < m; ++p){
+        if (col_cnt[p] == 1)
+            stack[stack_size++] = p;
+    }
+    while (stack_size > 0){
+        p = stack[--stack_size];
+        if (!col_act[p] || col_cnt[p] != 1)
+            continue;
+
+        for (e = cbeg[p]; !row_act[crow[e]]; ++e);
+        r = crow[e];
+        lu->piv_row[k] = r;
+        lu->piv_col[k] = p;
+        lu->piv_val[k] = cval[e];
+        for (e = rbeg[r]; e < rbeg[r + 1]; ++e){
+            c = rpos[e];
+            if (!col_act[c] || c == p)
+                continue;
+            sparseAdd(&lu->u, c, rval[e]);
+            if (--col_cnt[c] == 1)
+                stack[stack_size++] = c;
+        }
+        row_act[r] = col_act[p] = 0;
+        lu->l_beg[k + 1] = lu->l.size;
+        lu->u_beg[k + 1] = lu->u.size;
+        ++k;
+    }
+
+    // Row singletons
+    stack_size = 0;
+    for (r = 0; r < m; ++r){
+        if (row_act[r]){
+            row_cnt[r] = 0;
+            for (e = rbeg[r]; e < rbeg[r + 1]; ++e)
+                row_cnt[r] += col_act[rpos[e]];
+            if (row_cnt[r] == 1)
+                stack[stack_size++] = r;
+        }
+    }
+    while (stack_size > 0){
+        r = stack[--stack_size];
+        if (!row_act[r] || row_cnt[r] != 1)
+            continue;
+
+        for (e = rbeg[r]; !col_act[rpos[e]]; ++e);
+        p = rpos[e];
+        v = rval[e];
+        lu->piv_row[k] = r;
+        lu->piv_col[k] = p;
+        lu->piv_val[k] = v;
+        for (e = cbeg[p]; e < cbeg[p + 1]; ++e){
+            i = crow[e];
+            if (!row_act[i] || i == r)
+                continue;
+            sparseAdd(&lu->l, i, cval[e] / v);
+            if (--row_cnt[i] == 1)
+                stack[stack_size++] = i;
+        }
+        row_act[r] = col_act[p] = 0;
+        lu->l_beg[k + 1] = lu->l.size;
+        lu->u_beg[k + 1] = lu->u.size;
+        ++k;
+    }
+
+    // Dense kernel
+    kr = m - k;
+    sing_size = 0;
+    if (kr > 0){
+        R = BOR_ALLOC_ARR(int, kr);
+        C = BOR_ALLOC_ARR(int, kr);
+        for (i = 0, ii = 0, jj = 0; i < m; ++i){
+            if (row_act[i]){
+                row_cnt[i] = ii;
+                R[ii++] = i;
+            }
+            if (col_act[i])
+                C[jj++] = i;
+        }
+
+        K = BOR_CALLOC_ARR(double, (size_t)kr * kr);
+        for (jj = 0; jj < kr; ++jj){
+            p = C[jj];
+            for (e = cbeg[p]; e < cbeg[p + 1]; ++e){
+                if (row_act[crow[e]])
+                    K[(size_t)row_cnt[crow[e]] * kr + jj] = cval[e];
+            }
+        }
+
+        row_done = BOR_CALLOC_ARR(char, kr);
+        for (jj = 0; jj < kr; ++jj){
+            best = -1;
+            bv = TOL_PIVOT;
+            for (ii = 0; ii < kr; ++ii){
+                if (!row_done[ii] && fabs(K[(size_t)ii * kr + jj]) > bv){
+                    best = ii;
+                    bv = fabs(K[(size_t)ii * kr + jj]);
+                }
+            }
+            if (best < 0){
+                sing_pos[sing_size++] = C[jj];
+                continue;
+            }
+
+            v = K[(size_t)best * kr + jj];
+            lu->piv_row[k] = R[best];
+            lu->piv_col[k] = C[jj];
+            lu->piv_val[k] = v;
+            row_done[best] = 1;
+            for (ii = 0; ii < kr; ++ii){
+                if (row_done[ii] || K[(size_t)ii * kr + jj] == 0.)
+                    continue;
+                l = K[(size_t)ii * kr + jj] / v;
+                sparseAdd(&lu->l, R[ii], l);
+                for (j = jj + 1; j < kr; ++j)
+                    K[(size_t)ii * kr + j] -= l * K[(size_t)best * kr + j];
+            }
+            for (j = jj + 1; j < kr; ++j){
+                if (K[(size_t)best * kr + j] != 0.)
+                    sparseAdd(&lu->u, C[j], K[(size_t)best * kr + j]);
+            }
+            lu->l_beg[k + 1] = lu->l.size;
+            lu->u_beg[k + 1] = lu->u.size;
+            ++k;
+        }
+
+        for (ii = 0, j = 0; ii < kr; ++ii){
+            if (!row_done[ii])
+                sing_row[j++] = R[ii];
+        }
+
+        BOR_FREE(row_done);
+        BOR_FREE(K);
+        BOR_FREE(R);
+        BOR_FREE(C);
+    }
+
+    BOR_FREE(cbeg);
+    BOR_FREE(crow);
+    BOR_FREE(cval);
+    BOR_FREE(rbeg);
+    BOR_FREE(rpos);
+    BOR_FREE(rval);
+    BOR_FREE(row_cnt);
+    BOR_FREE(col_cnt);
+    BOR_FREE(row_act);
+    BOR_FREE(col_act);
+    BOR_FREE(stack);
+    return sing_size;
+}
+
+
+/*** Simplex method ***/
+static void setNonbasic(plan_lp_native_t *lp, int var)
+{
+    if (isFinite(lp->lb[var])){
+        lp->stat[var] = ST_LB;
+        lp->x[var] = lp->lb[var];
+    }else if (isFinite(lp->ub[var])){
+        lp->stat[var] = ST_UB;
+        lp->x[var] = lp->ub[var];
+    }else{
+        lp->stat[var] = ST_FREE;
+        lp->x[var] = 0.;
+    }
+}
+
+/** Makes status of non-basic variables consistent with their bounds */
+static void fixNonbasic(plan_lp_native_t *lp)
+{
+    int var;
+
+    for (var = 0; var < lp->cols + lp->rows; ++var){
+        if (lp->stat[var] == ST_BASIC)
+            continue;
+        if (lp->stat[var] == ST_UB && isFinite(lp->ub[var])){
+            lp->x[var] = lp->ub[var];
+        }else if (lp->stat[var] == ST_LB && isFinite(lp->lb[var])){
+            lp->x[var] = lp->lb[var];
+        }else{
+            setNonbasic(lp, var);
+        }
+    }
+}
+
+/** Factorizes the basis, singular bases are repaired by replacing the
+ *  dependent columns by logical variables */
+static void factorize(plan_lp_native_t *lp)
+{
+    int i, ns, var, slack;
+
+    while ((ns = luFactor(lp, lp->iw1, lp->iw2)) > 0){
+        for (i = 0; i < ns; ++i){
+            var = lp->head[lp->iw1[i]];
+            setNonbasic(lp, var);
+            slack = lp->cols + lp->iw2[i];
+            lp->head[lp->iw1[i]] = slack;
+            lp->stat[slack] = ST_BASIC;
+        }
+    }
+    lp->factorized = 1;
+}
+
+/** Stores a column of the variable into the dense vector b */
+static void loadCol(const plan_lp_native_t *lp, int var, double *b)
+{
+    const col_t *col;
+    int i;
+
+    bzero(b, sizeof(double) * lp->rows);
+    if (isSlack(lp, var)){
+        b[var - lp->cols] = -1.;
+    }else{
+        col = lp->col + var;
+        for (i = 0; i < col->size; ++i)
+            b[col->row[i]] = col->val[i];
+    }
+}
+
+static double colDot(const plan_lp_native_t *lp, int var, const double *y)
+{
+    const col_t *col;
+    double v;
+    int i;
+
+    if (isSlack(lp, var))
+        return -y[var - lp->cols];
+
+    col = lp->col + var;
+    v = 0.;
+    for (i = 0; i < col->size; ++i)
+        v += col->val[i] * y[col->row[i]];
+    return v;
+}
+
+/** Computes values of basic variables from the non-basic ones */
+static void computeXB(plan_lp_native_t *lp)
+{
+    const col_t *col;
+    double *b = lp->w1;
+    int var, i, p;
+
+    bzero(b, sizeof(double) * lp->rows);
+    for (var = 0; var < lp->cols + lp->rows; ++var){
+        if (lp->stat[var] == ST_BASIC || lp->x[var] == 0.)
+            continue;
+        if (isSlack(lp, var)){
+            b[var - lp->cols] += lp->x[var];
+        }else{
+            col = lp->col + var;
+            for (i = 0; i < col->size; ++i)
+                b[col->row[i]] -= col->val[i] * lp->x[var];
+        }
+    }
+
+    luFTran(&lp->lu, b, lp->alpha);
+    for (p = 0; p < lp->rows; ++p)
+        lp->x[lp->head[p]] = lp->alpha[p];
+}
+
+static int isPrimalFeasible(const plan_lp_native_t *lp)
+{
+    int p, var;
+
+    for (p = 0; p < lp->rows; ++p){
+        var = lp->head[p];
+        if (lp->x[var] < lp->lb[var] - TOL_PRIMAL
+                || lp->x[var] > lp->ub[var] + TOL_PRIMAL)
+            return 0;
+    }
+    return 1;
+}
+
+/** Computes duals and reduced costs. In phase 1 the costs are given by
+ *  the infeasibilities of the basic variables. */
+static void computeDuals(plan_lp_native_t *lp, int phase1)
+{
+    double *cb = lp->w1;
+    double x, c;
+    int p, var;
+
+    for (p = 0; p < lp->rows; ++p){
+        var = lp->head[p];
+        if (phase1){
+            x = lp->x[var];
+            cb[p] = 0.;
+            if (x < lp->lb[var] - TOL_PRIMAL){
+                cb[p] = -1.;
+            }else if (x > lp->ub[var] + TOL_PRIMAL){
+                cb[p] = 1.;
+            }
+        }else{
+            cb[p] = (isSlack(lp, var) ? 0. : lp->cost[var]);
+        }
+    }
+    luBTran(&lp->lu, cb, lp->y);
+
+    for (var = 0; var < lp->cols + lp->rows; ++var){
+        if (lp->stat[var] == ST_BASIC)
+            continue;
+        c = (phase1 || isSlack(lp, var) ? 0. : lp->cost[var]);
+        lp->d[var] = c - colDot(lp, var, lp->y);
+    }
+}
+
+/** Returns true if the reduced cost of the non-basic variable has the
+ *  wrong sign */
+static int isDualInfeasible(const plan_lp_native_t *lp, int var, double tol)
+{
+    if (lp->lb[var] == lp->ub[var])
+        return 0;
+    if (lp->stat[var] == ST_LB)
+        return lp->d[var] < -tol;
+    if (lp->stat[var] == ST_UB)
+        return lp->d[var] > tol;
+    if (lp->stat[var] == ST_FREE)
+        return fabs(lp->d[var]) > tol;
+    return 0;
+}
+
+/** Tries to reach dual feasibility by moving boxed variables to their
+ *  opposite bounds. Returns true on success. */
+static int makeDualFeasible(plan_lp_native_t *lp)
+{
+    int var, flips;
+
+    computeDuals(lp, 0);
+    for (var = 0; var < lp->cols + lp->rows; ++var){
+        if (lp->stat[var] != ST_BASIC
+                && isDualInfeasible(lp, var, TOL_DUAL)
+                && (lp->stat[var] == ST_FREE
+                        || !isFinite(lp->lb[var])
+                        || !isFinite(lp->ub[var]))){
+            return 0;
+        }
+    }
+
+    flips = 0;
+    for (var = 0; var < lp->cols + lp->rows; ++var){
+        if (lp->stat[var] == ST_BASIC
+                || !isDualInfeasible(lp, var, TOL_DUAL))
+            continue;
+        if (lp->stat[var] == ST_LB){
+            lp->stat[var] = ST_UB;
+            lp->x[var] = lp->ub[var];
+        }else{
+            lp->stat[var] = ST_LB;
+            lp->x[var] = lp->lb[var];
+        }
+        ++flips;
+    }
+    if (flips > 0)
+        computeXB(lp);
+    return 1;
+}
+
+/** Replaces basic variable at position r by the variable q, lp->alpha
+ *  must contain the transformed column of q. */
+static void pivot(plan_lp_native_t *lp, int r, int q)
+{
+    luUpdate(&lp->lu, r, lp->alpha);
+    lp->head[r] = q;
+    lp->stat[q] = ST_BASIC;
+    if (lp->lu.eta_size >= REFACTOR_ETAS){
+        factorize(lp);
+        computeXB(lp);
+    }
+}
+
+/** Bound the basic variable at position p is moving to if it changes
+ *  with the given rate. Returns 0 if there is no such bound. */
+static int primalRatioBound(const plan_lp_native_t *lp, int p, double rate,
+                            double *bound)
+{
+    int var = lp->head[p];
+    double x = lp->x[var];
+
+    if (rate > 0.){
+        if (x < lp->lb[var] - TOL_PRIMAL){
+            *bound = lp->lb[var];
+        }else if (x > lp->ub[var] + TOL_PRIMAL || !isFinite(lp->ub[var])){
+            return 0;
+        }else{
+            *bound = lp->ub[var];
+        }
+    }else{
+        if (x > lp->ub[var] + TOL_PRIMAL){
+            *bound = lp->ub[var];
+        }else if (x < lp->lb[var] - TOL_PRIMAL || !isFinite(lp->lb[var])){
+            return 0;
+        }else{
+            *bound = lp->lb[var];
+        }
+    }
+    return 1;
+}
+
+/** Distance of the basic variable at position p to the bound in the
+ *  direction of its change */
+static double primalDist(const plan_lp_native_t *lp, int p, double rate,
+                         double bound)
+{
+    double dist;
+
+    if (rate > 0.){
+        dist = bound - lp->x[lp->head[p]];
+    }else{
+        dist = lp->x[lp->head[p]] - bound;
+    }
+    return (dist > 0. ? dist : 0.);
+}
+
+/**
+ * Primal simplex with the composite phase 1 minimizing the sum of
+ * infeasibilities. Dantzig pricing, Harris ratio test and the Bland's
+ * rule after a series of degenerate iterations.
+ */
+static int primal(plan_lp_native_t *lp, long *iter_left)
+{
+    int nvars = lp->cols + lp->rows;
+    int var, q, r, p, dir, qdir, phase1, flip, degen, bland;
+    double score, best, rate, bound, rbound, ratio, theta, t, a, range;
+
+    degen = 0;
+    while (1){
+        if ((*iter_left)-- <= 0)
+            return RES_LIMIT;
+
+        phase1 = !isPrimalFeasible(lp);
+        computeDuals(lp, phase1);
+        bland = (degen > BLAND_AFTER);
+
+        // Pricing
+        q = -1;
+        qdir = 0;
+        best = 0.;
+        for (var = 0; var < nvars; ++var){
+            if (lp->stat[var] == ST_BASIC || lp->lb[var] == lp->ub[var])
+                continue;
+            if (lp->stat[var] != ST_UB && lp->d[var] < -TOL_DUAL){
+                dir = 1;
+            }else if (lp->stat[var] != ST_LB && lp->d[var] > TOL_DUAL){
+                dir = -1;
+            }else{
+                continue;
+            }
+
+            score = fabs(lp->d[var]);
+            if (bland || score > best){
+                q = var;
+                qdir = dir;
+                best = score;
+                if (bland)
+                    break;
+            }
+        }
+        if (q < 0)
+            return (phase1 ? RES_INFEASIBLE : RES_OPTIMAL);
+
+        loadCol(lp, q, lp->w1);
+        luFTran(&lp->lu, lp->w1, lp->alpha);
+
+        // Harris ratio test: first the maximal step with relaxed bounds
+        theta = INF;
+        for (p = 0; p < lp->rows; ++p){
+            a = lp->alpha[p];
+            if (fabs(a) <= TOL_PIVOT)
+                continue;
+            rate = -qdir * a;
+            if (!primalRatioBound(lp, p, rate, &bound))
+                continue;
+            ratio = (primalDist(lp, p, rate, bound) + TOL_PRIMAL) / fabs(a);
+            if (ratio < theta)
+                theta = ratio;
+        }
+
+        // ... then the largest pivot within the step
+        r = -1;
+        t = INF;
+        rbound = 0.;
+        best = 0.;
+        for (p = 0; theta < INF && p < lp->rows; ++p){
+            a = lp->alpha[p];
+            if (fabs(a) <= TOL_PIVOT)
+                continue;
+            rate = -qdir * a;
+            if (!primalRatioBound(lp, p, rate, &bound))
+                continue;
+            ratio = primalDist(lp, p, rate, bound) / fabs(a);
+            if (ratio > theta)
+                continue;
+            if (r < 0
+                    || (bland && lp->head[p] < lp->head[r])
+                    || (!bland && fabs(a) > best)){
+                r = p;
+                t = ratio;
+                rbound = bound;
+                best = fabs(a);
+            }
+        }
+
+        range = INF;
+        if (isFinite(lp->lb[q]) && isFinite(lp->ub[q]))
+            range = lp->ub[q] - lp->lb[q];
+        flip = (range < INF && (r < 0 || range <= t));
+        if (r < 0 && !flip)
+            return (phase1 ? RES_INFEASIBLE : RES_UNBOUNDED);
+        if (flip)
+            t = range;
+
+        // Update of the primal solution
+        lp->x[q] += qdir * t;
+        for (p = 0; p < lp->rows; ++p){
+            if (lp->alpha[p] != 0.)
+                lp->x[lp->head[p]] -= qdir * t * lp->alpha[p];
+        }
+        degen = (t <= 1E-12 ? degen + 1 : 0);
+
+        if (flip){
+            lp->stat[q] = (qdir > 0 ? ST_UB : ST_LB);
+            lp->x[q] = (qdir > 0 ? lp->ub[q] : lp->lb[q]);
+            continue;
+        }
+
+        var = lp->head[r];
+        lp->x[var] = rbound;
+        lp->stat[var] = (rbound == lp->lb[var] ? ST_LB : ST_UB);
+        pivot(lp, r, q);
+    }
+}
+
+/**
+ * Dual simplex for dual feasible bases: the most infeasible basic
+ * variable leaves the basis and the entering variable is chosen by the
+ * Harris ratio test so that the dual feasibility is kept.
+ */
+static int dual(plan_lp_native_t *lp, long *iter_left)
+{
+    int nvars = lp->cols + lp->rows;
+    double *arow = lp->w2;
+    int var, lvar, q, r, p, below, s, refactor;
+    double best, infeas, bound, a, theta, ratio, dq;
+
+    refactor = 0;
+    while (1){
+        if ((*iter_left)-- <= 0)
+            return RES_LIMIT;
+
+        computeDuals(lp, 0);
+        for (var = 0; var < nvars; ++var){
+            if (lp->stat[var] != ST_BASIC
+                    && isDualInfeasible(lp, var, 100. * TOL_DUAL))
+                return RES_DUAL_LOST;
+        }
+
+        // The most infeasible basic variable leaves the basis
+        r = -1;
+        best = TOL_PRIMAL;
+        for (p = 0; p < lp->rows; ++p){
+            var = lp->head[p];
+            infeas = 0.;
+            if (lp->x[var] < lp->lb[var] - TOL_PRIMAL){
+                infeas = lp->lb[var] - lp->x[var];
+            }else if (lp->x[var] > lp->ub[var] + TOL_PRIMAL){
+                infeas = lp->x[var] - lp->ub[var];
+            }
+            if (infeas > best){
+                r = p;
+                best = infeas;
+            }
+        }
+        if (r < 0)
+            return RES_OPTIMAL;
+
+        lvar = lp->head[r];
+        below = (lp->x[lvar] < lp->lb[lvar]);
+        s = (below ? 1 : -1);
+        bound = (below ? lp->lb[lvar] : lp->ub[lvar]);
+
+        // r'th row of B^{-1}N
+        bzero(lp->w1, sizeof(double) * lp->rows);
+        lp->w1[r] = 1.;
+        luBTran(&lp->lu, lp->w1, lp->rho);
+
+        // Harris ratio test
+        theta = INF;
+        for (var = 0; var < nvars; ++var){
+            arow[var] = 0.;
+            if (lp->stat[var] == ST_BASIC || lp->lb[var] == lp->ub[var])
+                continue;
+            a = colDot(lp, var, lp->rho);
+            if (fabs(a) <= TOL_PIVOT)
+                continue;
+            if ((lp->stat[var] == ST_LB && s * a >= 0.)
+                    || (lp->stat[var] == ST_UB && s * a <= 0.))
+                continue;
+            arow[var] = a;
+            ratio = (fabs(lp->d[var]) + TOL_DUAL) / fabs(a);
+            if (ratio < theta)
+                theta = ratio;
+        }
+        if (theta == INF)
+            return RES_INFEASIBLE;
+
+        q = -1;
+        best = 0.;
+        for (var = 0; var < nvars; ++var){
+            a = arow[var];
+            if (a == 0. || fabs(lp->d[var]) / fabs(a) > theta)
+                continue;
+            if (fabs(a) > best){
+                q = var;
+                best = fabs(a);
+            }
+        }
+
+        loadCol(lp, q, lp->w1);
+        luFTran(&lp->lu, lp->w1, lp->alpha);
+        if (fabs(lp->alpha[r] - arow[q]) > 1E-6 * (1. + fabs(arow[q]))
+                || fabs(lp->alpha[r]) <= TOL_PIVOT){
+            // Numerical troubles, refactorize and try again
+            if (refactor++ > 2)
+                return RES_DUAL_LOST;
+            factorize(lp);
+            computeXB(lp);
+            continue;
+        }
+        refactor = 0;
+
+        // Update of the primal solution
+        dq = (lp->x[lvar] - bound) / lp->alpha[r];
+        lp->x[q] += dq;
+        for (p = 0; p < lp->rows; ++p){
+            if (lp->alpha[p] != 0.)
+                lp->x[lp->head[p]] -= dq * lp->alpha[p];
+        }
+        lp->x[lvar] = bound;
+        lp->stat[lvar] = (below ? ST_LB : ST_UB);
+        pivot(lp, r, q);
+    }
+}
+
+static int lpSolve(plan_lp_native_t *lp)
+{
+    long iter_left;
+    int verify, res, var;
+
+    iter_left = 100L * (lp->rows + lp->cols) + 10000L;
+    fixNonbasic(lp);
+    if (!lp->factorized)
+        factorize(lp);
+    computeXB(lp);
+
+    for (verify = 0; verify < MAX_VERIFY; ++verify){
+        if (makeDualFeasible(lp)){
+            res = dual(lp, &iter_left);
+            if (res == RES_LIMIT)
+                return res;
+            if (res == RES_INFEASIBLE){
+                // Let the primal phase 1 confirm it
+                factorize(lp);
+                computeXB(lp);
+            }
+        }
+
+        res = primal(lp, &iter_left);
+        if (res != RES_OPTIMAL)
+            return res;
+
+        // Verify the solution with a fresh factorization
+        factorize(lp);
+        computeXB(lp);
+        if (!isPrimalFeasible(lp))
+            continue;
+        computeDuals(lp, 0);
+        for (var = 0; var < lp->cols + lp->rows; ++var){
+            if (lp->stat[var] != ST_BASIC
+                    && isDualInfeasible(lp, var, TOL_DUAL))
+                break;
+        }
+        if (var == lp->cols + lp->rows)
+            return RES_OPTIMAL;
+    }
+
+    // The solution could not be verified, so it may be neither feasible
+    // nor optimal
+    return RES_LIMIT;
+}
+
+static double objVal(const plan_lp_native_t *lp)
+{
+    double z = 0.;
+    int i;
+
+    for (i = 0; i < lp->cols; ++i)
+        z += lp->cost[i] * lp->x[i];
+    return z;
+}
+
+
+/*** Branch and bound ***/
+struct _mip_t {
+    int found;
+    double best;
+    double *x;
+    int int_obj; /*!< True if the objective value is always integer */
+    int limit; /*!< True if some node could not be solved */
+};
+typedef struct _mip_t mip_t;
+
+static void mipBranch(plan_lp_native_t *lp, mip_t *mip)
+{
+    double z, f, frac, best_frac, v, olb, oub;
+    int i, j, up, b, res;
+
+    res = lpSolve(lp);
+    if (res == RES_LIMIT || res == RES_UNBOUNDED){
+        // The subtree cannot be pruned, so no found solution could be
+        // proved optimal
+        mip->limit = 1;
+        return;
+    }
+    if (res != RES_OPTIMAL)
+        return;
+
+    z = objVal(lp);
+    if (mip->found){
+        if (mip->int_obj && ceil(z - TOL_INT) >= mip->best - 0.5)
+            return;
+        if (!mip->int_obj && z >= mip->best - TOL_INT)
+            return;
+    }
+
+    // Branch on the most fractional variable
+    j = -1;
+    best_frac = TOL_INT;
+    for (i = 0; i < lp->cols; ++i){
+        if (!lp->is_int[i])
+            continue;
+        f = lp->x[i] - floor(lp->x[i]);
+        frac = (f < 1. - f ? f : 1. - f);
+        if (frac > best_frac){
+            j = i;
+            best_frac = frac;
+        }
+    }
+
+    if (j < 0){
+        mip->found = 1;
+        mip->best = (mip->int_obj ? floor(z + 0.5) : z);
+        for (i = 0; i < lp->cols; ++i){
+            mip->x[i] = lp->x[i];
+            if (lp->is_int[i])
+                mip->x[i] = floor(lp->x[i] + 0.5);
+        }
+        return;
+    }
+
+    v = lp->x[j];
+    olb = lp->lb[j];
+    oub = lp->ub[j];
+    up = (v - floor(v) > 0.5);
+    for (b = 0; b < 2; ++b){
+        if ((b == 0) == up){
+            lp->lb[j] = ceil(v);
+        }else{
+            lp->ub[j] = floor(v);
+        }
+        mipBranch(lp, mip);
+        lp->lb[j] = olb;
+        lp->ub[j] = oub;
+        if (mip->limit)
+            return;
+    }
+}
+
+static int mipSolve(plan_lp_native_t *lp, double *val, double *obj)
+{
+    mip_t mip;
+    int i;
+
+    mip.found = 0;
+    mip.limit = 0;
+    mip.best = INF;
+    mip.x = BOR_ALLOC_ARR(double, lp->cols + 1);
+    mip.int_obj = 1;
+    for (i = 0; i < lp->cols; ++i){
+        if (lp->cost[i] != 0.
+                && (!lp->is_int[i] || lp->cost[i] != floor(lp->cost[i]))){
+            mip.int_obj = 0;
+        }
+    }
+
+    mipBranch(lp, &mip);
+    if (mip.limit)
+        mip.found = 0;
+    if (mip.found){
+        if (obj != NULL)
+            memcpy(obj, mip.x, sizeof(double) * lp->cols);
+        if (val != NULL)
+            *val = (lp->maximize ? -mip.best : mip.best);
+    }
+    BOR_FREE(mip.x);
+    return (mip.found ? 0 : -1);
+}
+
+
+/*** Problem definition ***/
+static void ensureVars(plan_lp_native_t *lp, int nvars)
+{
+    if (nvars <= lp->var_alloc)
+        return;
+
+    lp->var_alloc = BOR_MAX(nvars, 2 * lp->var_alloc);
+    lp->lb = BOR_REALLOC_ARR(lp->lb, double, lp->var_alloc);
+    lp->ub = BOR_REALLOC_ARR(lp->ub, double, lp->var_alloc);
+    lp->stat = BOR_REALLOC_ARR(lp->stat, char, lp->var_alloc);
+    lp->x = BOR_REALLOC_ARR(lp->x, double, lp->var_alloc);
+    lp->d = BOR_REALLOC_ARR(lp->d, double, lp->var_alloc);
+    lp->w2 = BOR_REALLOC_ARR(lp->w2, double, lp->var_alloc);
+}
+
+static void ensureRows(plan_lp_native_t *lp, int rows)
+{
+    if (rows < lp->work_alloc)
+        return;
+
+    lp->work_alloc = BOR_MAX(rows + 1, 2 * lp->work_alloc);
+    lp->head = BOR_REALLOC_ARR(lp->head, int, lp->work_alloc);
+    lp->y = BOR_REALLOC_ARR(lp->y, double, lp->work_alloc);
+    lp->alpha = BOR_REALLOC_ARR(lp->alpha, double, lp->work_alloc);
+    lp->rho = BOR_REALLOC_ARR(lp->rho, double, lp->work_alloc);
+    lp->w1 = BOR_REALLOC_ARR(lp->w1, double, lp->work_alloc);
+    lp->iw1 = BOR_REALLOC_ARR(lp->iw1, int, lp->work_alloc);
+    lp->iw2 = BOR_REALLOC_ARR(lp->iw2, int, lp->work_alloc);
+}
+
+static void setSlack(plan_lp_native_t *lp, int row, double rhs, char sense)
+{
+    int var = lp->cols + row;
+
+    if (sense == 'L'){
+        lp->lb[var] = -INF;
+        lp->ub[var] = rhs;
+    }else if (sense == 'G'){
+        lp->lb[var] = rhs;
+        lp->ub[var] = INF;
+    }else{
+        if (sense != 'E')
+            fprintf(stderr, "LP Error: Unkown sense: %c\n", sense);
+        lp->lb[var] = lp->ub[var] = rhs;
+    }
+}
+
+plan_lp_native_t *planLPNativeNew(int rows, int cols, int maximize)
+{
+    plan_lp_native_t *lp;
+    int i;
+
+    lp = BOR_ALLOC(plan_lp_native_t);
+    bzero(lp, sizeof(*lp));
+    lp->rows = rows;
+    lp->cols = cols;
+    lp->maximize = maximize;
+    lp->obj = BOR_CALLOC_ARR(double, cols + 1);
+    lp->cost = BOR_CALLOC_ARR(double, cols + 1);
+    lp->is_int = BOR_CALLOC_ARR(char, cols + 1);
+    lp->col = BOR_CALLOC_ARR(col_t, cols + 1);
+
+    ensureVars(lp, cols + rows + 1);
+    ensureRows(lp, rows);
+    for (i = 0; i < cols; ++i){
+        lp->lb[i] = 0.;
+        lp->ub[i] = INF;
+        lp->stat[i] = ST_LB;
+        lp->x[i] = 0.;
+    }
+    for (i = 0; i < rows; ++i){
+        setSlack(lp, i, 0., 'E');
+        lp->stat[cols + i] = ST_BASIC;
+        lp->head[i] = cols + i;
+    }
+    lp->factorized = 0;
+
+    return lp;
+}
+
+void planLPNativeDel(plan_lp_native_t *lp)
+{
+    int i;
+
+    for (i = 0; i < lp->cols; ++i){
+        if (lp->col[i].row != NULL)
+            BOR_FREE(lp->col[i].row);
+        if (lp->col[i].val != NULL)
+            BOR_FREE(lp->col[i].val);
+    }
+    BOR_FREE(lp->col);
+    BOR_FREE(lp->obj);
+    BOR_FREE(lp->cost);
+    BOR_FREE(lp->is_int);
+    BOR_FREE(lp->lb);
+    BOR_FREE(lp->ub);
+    BOR_FREE(lp->stat);
+    BOR_FREE(lp->x);
+    BOR_FREE(lp->d);
+    BOR_FREE(lp->w2);
+    BOR_FREE(lp->head);
+    BOR_FREE(lp->y);
+    BOR_FREE(lp->alpha);
+    BOR_FREE(lp->rho);
+    BOR_FREE(lp->w1);
+    BOR_FREE(lp->iw1);
+    BOR_FREE(lp->iw2);
+    luFree(&lp->lu);
+    BOR_FREE(lp);
+}
+
+void planLPNativeSetObj(plan_lp_native_t *lp, int i, double coef)
+{
+    lp->obj[i] = coef;
+    lp->cost[i] = (lp->maximize ? -coef : coef);
+}
+
+void planLPNativeSetVarRange(plan_lp_native_t *lp, int i,
+                             double lb, double ub)
+{
+    lp->lb[i] = (lb <= -INF ? -INF : lb);
+    lp->ub[i] = (ub >= INF ? INF : ub);
+}
+
+void planLPNativeSetVarInt(plan_lp_native_t *lp, int i)
+{
+    lp->is_int[i] = 1;
+    lp->has_int = 1;
+}
+
+void planLPNativeSetCoef(plan_lp_native_t *lp, int row, int col,
+                         double coef)
+{
+    col_t *c = lp->col + col;
+    int i;
+
+    if (lp->stat[col] == ST_BASIC)
+        lp->factorized = 0;
+
+    for (i = 0; i < c->size; ++i){
+        if (c->row[i] == row){
+            if (coef == 0.){
+                --c->size;
+                c->row[i] = c->row[c->size];
+                c->val[i] = c->val[c->size];
+            }else{
+                c->val[i] = coef;
+            }
+            return;
+        }
+    }
+
+    if (coef == 0.)
+        return;
+    if (c->size == c->alloc){
+        c->alloc = 2 * c->alloc + 4;
+        c->row = BOR_REALLOC_ARR(c->row, int, c->alloc);
+        c->val = BOR_REALLOC_ARR(c->val, double, c->alloc);
+    }
+    c->row[c->size] = row;
+    c->val[c->size++] = coef;
+}
+
+void planLPNativeSetRHS(plan_lp_native_t *lp, int row,
+                        double rhs, char sense)
+{
+    setSlack(lp, row, rhs, sense);
+}
+
+void planLPNativeAddRows(plan_lp_native_t *lp, int cnt,
+                         const double *rhs, const char *sense)
+{
+    int i, row, var;
+
+    ensureVars(lp, lp->cols + lp->rows + cnt + 1);
+    ensureRows(lp, lp->rows + cnt);
+    for (i = 0; i < cnt; ++i){
+        row = lp->rows + i;
+        var = lp->cols + row;
+        setSlack(lp, row, (rhs != NULL ? rhs[i] : 0.),
+                 (sense != NULL ? sense[i] : 'E'));
+        lp->stat[var] = ST_BASIC;
+        lp->x[var] = 0.;
+        lp->head[row] = var;
+    }
+    lp->rows += cnt;
+    lp->factorized = 0;
+}
+
+void planLPNativeDelRows(plan_lp_native_t *lp, int begin, int end)
+{
+    int cnt = end - begin + 1;
+    int i, j, var, size, new_rows;
+    col_t *c;
+
+    // Remove the rows from the constraint matrix
+    for (i = 0; i < lp->cols; ++i){
+        c = lp->col + i;
+        for (j = 0, size = 0; j < c->size; ++j){
+            if (c->row[j] >= begin && c->row[j] <= end)
+                continue;
+            c->row[size] = c->row[j] - (c->row[j] > end ? cnt : 0);
+            c->val[size++] = c->val[j];
+        }
+        c->size = size;
+    }
+
+    // Remove the logical variables from the basis
+    for (i = 0, size = 0; i < lp->rows; ++i){
+        var = lp->head[i];
+        if (var >= lp->cols + begin && var <= lp->cols + end)
+            continue;
+        lp->head[size++] = var - (var > lp->cols + end ? cnt : 0);
+    }
+
+    // Remove the logical variables
+    for (var = lp->cols + end + 1; var < lp->cols + lp->rows; ++var){
+        lp->lb[var - cnt] = lp->lb[var];
+        lp->ub[var - cnt] = lp->ub[var];
+        lp->stat[var - cnt] = lp->stat[var];
+        lp->x[var - cnt] = lp->x[var];
+    }
+    new_rows = lp->rows - cnt;
+    lp->rows = new_rows;
+
+    // Fix the size of the basis
+    for (i = size - 1; size > new_rows && i >= 0; --i){
+        var = lp->head[i];
+        if (isSlack(lp, var))
+            continue;
+        setNonbasic(lp, var);
+        for (j = i; j < size - 1; ++j)
+            lp->head[j] = lp->head[j + 1];
+        --size;
+    }
+    for (i = 0; size < new_rows && i < new_rows; ++i){
+        var = lp->cols + i;
+        if (lp->stat[var] != ST_BASIC){
+            lp->stat[var] = ST_BASIC;
+            lp->head[size++] = var;
+        }
+    }
+    lp->factorized = 0;
+}
+
+int planLPNativeNumRows(const plan_lp_native_t *lp)
+{
+    return lp->rows;
+}
+
+int planLPNativeSolve(plan_lp_native_t *lp, double *val, double *obj)
+{
+    int ret;
+
+    if (lp->has_int){
+        ret = mipSolve(lp, val, obj);
+    }else{
+        ret = (lpSolve(lp) == RES_OPTIMAL ? 0 : -1);
+        if (ret == 0){
+            if (val != NULL)
+                *val = (lp->maximize ? -objVal(lp) : objVal(lp));
+            if (obj != NULL)
+                memcpy(obj, lp->x, sizeof(double) * lp->cols);
+        }
+    }
+
+    if (ret != 0){
+        if (obj != NULL)
+            bzero(obj, sizeof(double) * lp->cols);
+        if (val != NULL)
+            *val = 0.;
+    }
+    return ret;
+}
+
+static void writeBound(FILE *fout, double v)
+{
+    if (v <= -INF){
+        fprintf(fout, "-inf");
+    }else if (v >= INF){
+        fprintf(fout, "+inf");
+    }else{
+        fprintf(fout, "%.12g", v);
+    }
+}
+
+void planLPNativeWrite(const plan_lp_native_t *lp, const char *fn)
+{
+    FILE *fout;
+    const col_t *c;
+    int i, j, row, var;
+
+    fout = fopen(fn, "w");
+    if (fout == NULL){
+        fprintf(stderr, "LP Error: Could not open `%s'\n", fn);
+        return;
+    }
+
+    fprintf(fout, "%s\n obj:", (lp->maximize ? "Maximize" : "Minimize"));
+    for (i = 0; i < lp->cols; ++i){
+        if (lp->obj[i] != 0.)
+            fprintf(fout, " %+.12g x%d", lp->obj[i], i);
+    }
+    fprintf(fout, "\nSubject To\n");
+    for (row = 0; row < lp->rows; ++row){
+        fprintf(fout, " r%d:", row);
+        for (i = 0; i < lp->cols; ++i){
+            c = lp->col + i;
+            for (j = 0; j < c->size; ++j){
+                if (c->row[j] == row)
+                    fprintf(fout, " %+.12g x%d", c->val[j], i);
+            }
+        }
+        var = lp->cols + row;
+        if (lp->lb[var] == lp->ub[var]){
+            fprintf(fout, " = %.12g\n", lp->lb[var]);
+        }else if (isFinite(lp->ub[var])){
+            fprintf(fout, " <= %.12g\n", lp->ub[var]);
+        }else{
+            fprintf(fout, " >= %.12g\n", lp->lb[var]);
+        }
+    }
+    fprintf(fout, "Bounds\n");
+    for (i = 0; i < lp->cols; ++i){
+        fprintf(fout, " ");
+        writeBound(fout, lp->lb[i]);
+        fprintf(fout, " <= x%d <= ", i);
+        writeBound(fout, lp->ub[i]);
+        fprintf(fout, "\n");
+    }
+    if (lp->has_int){
+        fprintf(fout, "Generals\n");
+        for (i = 0; i < lp->cols; ++i){
+            if (lp->is_int[i])
+                fprintf(fout, " x%d\n", i);
+        }
+    }
+    fprintf(fout, "End\n");
+    fclose(fout);
+}
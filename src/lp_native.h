@@ -0,0 +1,114 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+#ifndef __PLAN_LP_NATIVE_H__
+#define __PLAN_LP_NATIVE_H__
+
+/**
+ * Built-in LP/MIP solver used as the plan_lp_t backend if no external
+ * LP library is available.
+ *
+ * The solver is a bounded revised simplex method: a dual simplex is used
+ * whenever the current basis is dual feasible (which is typical after
+ * changing right hand sides, bounds or adding rows) and a primal simplex
+ * with composite phase 1 otherwise (e.g., after changing the objective).
+ * The basis is kept between calls of planLPNativeSolve() so that
+ * subsequent solves of slightly modified problems are warm started.
+ * The basis matrix is factorized by a sparse LU decomposition that
+ * eliminates row and column singletons first and factorizes only the
+ * remaining kernel as a dense matrix; basis changes are handled by
+ * product-form updates until the next refactorization.
+ * Integer variables are handled by a depth-first branch and bound.
+ */
+
+#define PLAN_LP_NATIVE_INF 1E30
+
+typedef struct _plan_lp_native_t plan_lp_native_t;
+
+/**
+ * Creates a new problem with the given number of rows and columns.
+ * All rows are initialized as "= 0" and all columns have bounds [0, inf).
+ */
+plan_lp_native_t *planLPNativeNew(int rows, int cols, int maximize);
+
+/**
+ * Deletes the problem.
+ */
+void planLPNativeDel(plan_lp_native_t *lp);
+
+/**
+ * Sets objective coefficient of the i'th column.
+ */
+void planLPNativeSetObj(plan_lp_native_t *lp, int i, double coef);
+
+/**
+ * Sets bounds of the i'th column, values with the absolute value at least
+ * PLAN_LP_NATIVE_INF are considered infinite.
+ */
+void planLPNativeSetVarRange(plan_lp_native_t *lp, int i,
+                             double lb, double ub);
+
+/**
+ * Sets the i'th column as integer.
+ */
+void planLPNativeSetVarInt(plan_lp_native_t *lp, int i);
+
+/**
+ * Sets coefficient of the constraint matrix.
+ */
+void planLPNativeSetCoef(plan_lp_native_t *lp, int row, int col,
+                         double coef);
+
+/**
+ * Sets right hand side and sense ('L', 'G' or 'E') of the row.
+ */
+void planLPNativeSetRHS(plan_lp_native_t *lp, int row,
+                        double rhs, char sense);
+
+/**
+ * Appends cnt new rows, rhs and sense may be NULL in which case "= 0" is
+ * used.
+ */
+void planLPNativeAddRows(plan_lp_native_t *lp, int cnt,
+                         const double *rhs, const char *sense);
+
+/**
+ * Deletes rows from begin to end (including).
+ */
+void planLPNativeDelRows(plan_lp_native_t *lp, int begin, int end);
+
+/**
+ * Returns number of rows.
+ */
+int planLPNativeNumRows(const plan_lp_native_t *lp);
+
+/**
+ * Solves the problem. Returns 0 if an optimal solution was found in which
+ * case the objective value is stored in val and values of the columns in
+ * obj (if non-NULL). Returns -1 otherwise.
+ */
+int planLPNativeSolve(plan_lp_native_t *lp, double *val, double *obj);
+
+/**
+ * Writes the problem in LP format to the file.
+ */
+void planLPNativeWrite(const plan_lp_native_t *lp, const char *fn);
+
+#endif /* __PLAN_LP_NATIVE_H__ */
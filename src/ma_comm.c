@@ -4,7 +4,8 @@ void _planMACommInit(plan_ma_comm_t *comm, int agent_id, int agent_size,
                      plan_ma_comm_del_fn del_fn,
                      plan_ma_comm_send_to_node_fn send_to_node_fn,
                      plan_ma_comm_recv_fn recv_fn,
-                     plan_ma_comm_recv_block_fn recv_block_fn)
+                     plan_ma_comm_recv_block_fn recv_block_fn,
+                     plan_ma_comm_mem_usage_fn mem_usage_fn)
 {
     comm->node_id = agent_id;
     comm->node_size = agent_size;
@@ -12,5 +13,8 @@ void _planMACommInit(plan_ma_comm_t *comm, int agent_id, int agent_size,
     comm->send_to_node_fn = send_to_node_fn;
     comm->recv_fn = recv_fn;
     comm->recv_block_fn = recv_block_fn;
+    comm->mem_usage_fn = mem_usage_fn;
+    comm->sent_msgs = 0L;
+    comm->recv_msgs = 0L;
 }
 
@@ -26,6 +26,7 @@ static int inprocSendToNode(plan_ma_comm_t *comm, int node_id,
                          const plan_ma_msg_t *msg);
 static plan_ma_msg_t *inprocRecv(plan_ma_comm_t *comm);
 static plan_ma_msg_t *inprocRecvBlock(plan_ma_comm_t *comm, int timeout_in_ms);
+static size_t inprocMemUsage(const plan_ma_comm_t *comm);
 
 plan_ma_comm_inproc_pool_t *planMACommInprocPoolNew(int agent_size)
 {
@@ -64,7 +65,7 @@ plan_ma_comm_t *planMACommInprocNew(plan_ma_comm_inproc_pool_t *pool,
     inproc = BOR_ALLOC(plan_ma_comm_inproc_t);
     _planMACommInit(&inproc->comm, agent_id, pool->size,
                     inprocDel, inprocSendToNode, inprocRecv,
-                    inprocRecvBlock);
+                    inprocRecvBlock, inprocMemUsage);
     inproc->write = pool->queue;
     inproc->read = pool->queue + agent_id;
 
@@ -103,3 +104,10 @@ static plan_ma_msg_t *inprocRecvBlock(plan_ma_comm_t *comm, int timeout_in_ms)
         return borRingQueuePopBlockTimeout(inproc->read, timeout_in_ms);
     }
 }
+
+static size_t inprocMemUsage(const plan_ma_comm_t *comm)
+{
+    // The agent owns the queue it reads from
+    return sizeof(plan_ma_comm_inproc_t)
+            + sizeof(bor_ring_queue_t) + sizeof(void *) * QUEUE_SIZE;
+}
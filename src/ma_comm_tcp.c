@@ -143,6 +143,7 @@ static void _tcpDel(plan_ma_comm_tcp_t *tcp,
 static void *thRecv(void *);
 static plan_ma_msg_t *tcpRecvTh(plan_ma_comm_t *comm);
 static plan_ma_msg_t *tcpRecvBlockTh(plan_ma_comm_t *comm, int timeout_in_ms);
+static size_t tcpMemUsage(const plan_ma_comm_t *comm);
 
 /** Extend memory allocated for the send buffer */
 static void sendbufExtend(plan_ma_comm_tcp_t *tcp, int size);
@@ -192,11 +193,13 @@ plan_ma_comm_t *planMACommTCPNew(int agent_id, int agent_size,
     if (flags & PLAN_MA_COMM_TCP_NO_THREAD){
         tcp->use_th = 0;
         _planMACommInit(&tcp->comm, agent_id, agent_size,
-                        tcpDel, tcpSendToNode, tcpRecv, tcpRecvBlock);
+                        tcpDel, tcpSendToNode, tcpRecv, tcpRecvBlock,
+                        tcpMemUsage);
     }else{
         tcp->use_th = 1;
         _planMACommInit(&tcp->comm, agent_id, agent_size,
-                        tcpDel, tcpSendToNode, tcpRecvTh, tcpRecvBlockTh);
+                        tcpDel, tcpSendToNode, tcpRecvTh, tcpRecvBlockTh,
+                        tcpMemUsage);
     }
     tcp->listen_sock = -1;
     tcp->send_sock = BOR_ALLOC_ARR(int, agent_size);
@@ -501,6 +504,29 @@ static plan_ma_msg_t *tcpRecvBlockTh(plan_ma_comm_t *comm, int timeout_in_ms)
     return borRingQueuePopBlockTimeout(&tcp->th_msgbuf, timeout_in_ms);
 }
 
+static size_t tcpMemUsage(const plan_ma_comm_t *comm)
+{
+    const plan_ma_comm_tcp_t *tcp;
+    size_t size;
+    int i;
+
+    tcp = bor_container_of(comm, const plan_ma_comm_tcp_t, comm);
+    size  = sizeof(*tcp);
+    size += 2 * sizeof(int) * comm->node_size;
+    if (tcp->buf != NULL){
+        size += sizeof(buf_t) * comm->node_size;
+        for (i = 0; i < comm->node_size; ++i)
+            size += tcp->buf[i].size;
+    }
+    size += tcp->sendbuf_size;
+    if (tcp->use_th){
+        size += sizeof(void *) * MSG_RING_BUF_SIZE;
+    }else{
+        size += sizeof(plan_ma_msg_t *) * tcp->msgbuf.size;
+    }
+    return size;
+}
+
 
 static void sendbufExtend(plan_ma_comm_tcp_t *tcp, int size)
 {
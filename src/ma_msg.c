@@ -715,6 +715,13 @@ int planMAMsgPackToBuf(const plan_ma_msg_t *msg, void *buf, int *size)
     return planMsgEncode2(msg, &schema_msg, buf, size);
 }
 
+int planMAMsgPackedSize(const plan_ma_msg_t *msg)
+{
+    int size = 0;
+    planMsgEncode2(msg, &schema_msg, NULL, &size);
+    return size;
+}
+
 plan_ma_msg_t *planMAMsgUnpacked(void *buf, size_t size)
 {
     plan_ma_msg_t *msg;
@@ -20,6 +20,7 @@
 #include "plan/ma_search.h"
 #include "plan/ma_state.h"
 #include "plan/ma_terminate.h"
+#include "plan/trace.h"
 
 #include "ma_snapshot.h"
 
@@ -234,6 +235,11 @@ void planMASearchAbort(plan_ma_search_t *search)
     planSearchAbort(search->search);
 }
 
+void planMASearchMemPressure(plan_ma_search_t *search, int level)
+{
+    planSearchMemPressure(search->search, level);
+}
+
 
 static int searchPostStep(plan_search_t *search, int res, void *ud)
 {
@@ -250,12 +256,14 @@ static int searchPostStep(plan_search_t *search, int res, void *ud)
     }else if (res == PLAN_SEARCH_NOT_FOUND){
         // Block until some message unblocks the process
         ma->blocked = 1;
+        planTraceBegin("ma-search", "blocked");
         msg = planMACommRecvBlock(ma->comm, DEAD_END_BLOCK_TIME);
         while (msg == NULL){
             if (ma->comm->node_id == 0)
                 deadEndVerify(ma);
             msg = planMACommRecvBlock(ma->comm, DEAD_END_BLOCK_TIME);
         }
+        planTraceEnd("ma-search", "blocked");
         processMsg(ma, msg);
         planMAMsgDel(msg);
         res = PLAN_SEARCH_CONT;
@@ -323,6 +331,9 @@ static void searchMAHeur(plan_search_t *search, plan_heur_t *heur,
         return;
     }
 
+    // The whole round trip (requests, responses and processing of
+    // unrelated messages in between)
+    planTraceBeginArgs("ma-heur", "ma-heur", "state", state_id, NULL, 0);
     ret = planHeurMANode(heur, ma->comm, state_id, search, res);
     while (ret == -1
             && ma->term.state == PLAN_MA_TERMINATE_NONE
@@ -335,6 +346,7 @@ static void searchMAHeur(plan_search_t *search, plan_heur_t *heur,
         }
         planMAMsgDel(msg);
     }
+    planTraceEnd("ma-heur", "ma-heur");
 }
 
 static void processMsg(plan_ma_search_t *ma, plan_ma_msg_t *msg)
@@ -391,7 +403,10 @@ static void processMsg(plan_ma_search_t *ma, plan_ma_msg_t *msg)
 
     }else if (type == PLAN_MA_MSG_HEUR){
         if (planMAMsgHeurType(msg) == PLAN_MA_MSG_HEUR_REQUEST && ma->heur){
+            planTraceBeginArgs("ma-heur", "heur-request",
+                               "from", planMAMsgAgent(msg), NULL, 0);
             planHeurMARequest(ma->heur, ma->comm, msg);
+            planTraceEnd("ma-heur", "heur-request");
         }else{
             fprintf(stderr, "[%d] MASearch Error: Unexpected heur message"
                             " (%d) from %d.\n",
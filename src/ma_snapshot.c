@@ -19,6 +19,7 @@
 
 #include <boruvka/alloc.h>
 
+#include "plan/trace.h"
 #include "ma_snapshot.h"
 
 static void planMASnapshotUpdate(plan_ma_snapshot_t *s, plan_ma_msg_t *msg);
@@ -105,6 +106,9 @@ void _planMASnapshotInit(plan_ma_snapshot_t *s,
     s->response_fn = response;
     s->mark_finalize_fn = mark_finalize;
     s->response_finalize_fn = response_finalize;
+
+    planTraceInstant("ma-snapshot", "snapshot-start", "token", token,
+                     NULL, 0, NULL, 0, NULL, 0);
 }
 
 void _planMASnapshotFree(plan_ma_snapshot_t *s)
@@ -172,6 +176,8 @@ static int planMASnapshotSnapshotMsg(plan_ma_snapshot_t *s,
     }
 
     if (mark_finalize){
+        planTraceInstant("ma-snapshot", "snapshot-marked", "token", s->token,
+                         NULL, 0, NULL, 0, NULL, 0);
         if (s->mark_finalize_fn && s->mark_finalize_fn(s) == -1){
             s->del_fn(s);
             del = 1;
@@ -179,6 +185,8 @@ static int planMASnapshotSnapshotMsg(plan_ma_snapshot_t *s,
     }
 
     if (resp_finalize){
+        planTraceInstant("ma-snapshot", "snapshot-done", "token", s->token,
+                         NULL, 0, NULL, 0, NULL, 0);
         if (s->response_finalize_fn)
             s->response_finalize_fn(s);
         s->del_fn(s);
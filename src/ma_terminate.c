@@ -18,6 +18,7 @@
  */
 
 #include "plan/ma_terminate.h"
+#include "plan/trace.h"
 
 void planMATerminateInit(plan_ma_terminate_t *term,
                          plan_ma_terminate_update_fin_msg update_fin_fn,
@@ -56,6 +57,8 @@ int planMATerminateStart(plan_ma_terminate_t *term,
 
     term->state = PLAN_MA_TERMINATE_IN_PROGRESS;
     term->is_initiator = 1;
+    planTraceInstant("ma-terminate", "terminate-start", NULL, 0,
+                     NULL, 0, NULL, 0, NULL, 0);
 
     return 0;
 }
@@ -72,12 +75,14 @@ int planMATerminateWait(plan_ma_terminate_t *term,
         return 0;
 
     // Ignore all non-terminate messages
+    planTraceBegin("ma-terminate", "terminate-wait");
     while (term->state == PLAN_MA_TERMINATE_IN_PROGRESS
             && (msg = planMACommRecvBlock(comm, -1)) != NULL){
         if (planMAMsgType(msg) == PLAN_MA_MSG_TERMINATE)
             planMATerminateProcessMsg(term, msg, comm);
         planMAMsgDel(msg);
     }
+    planTraceEnd("ma-terminate", "terminate-wait");
 
     if (term->state == PLAN_MA_TERMINATE_IN_PROGRESS && msg == NULL)
         return -1;
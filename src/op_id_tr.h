@@ -47,6 +47,11 @@ void planOpIdTrInit(plan_op_id_tr_t *tr, const plan_op_t *op, int op_size);
  */
 void planOpIdTrFree(plan_op_id_tr_t *tr);
 
+/**
+ * Returns number of bytes allocated by the translator.
+ */
+_bor_inline size_t planOpIdTrMemUsage(const plan_op_id_tr_t *tr);
+
 /**
  * Translates global ID to local ID.
  */
@@ -59,6 +64,11 @@ _bor_inline int planOpIdTrGlob(const plan_op_id_tr_t *tr, int loc_id);
 
 
 /**** INLINES: ****/
+_bor_inline size_t planOpIdTrMemUsage(const plan_op_id_tr_t *tr)
+{
+    return sizeof(int) * (tr->loc_to_glob_size + tr->glob_to_loc_size);
+}
+
 _bor_inline int planOpIdTrLoc(const plan_op_id_tr_t *tr, int glob_id)
 {
     if (glob_id >= tr->glob_to_loc_size)
@@ -21,8 +21,9 @@
 #include <boruvka/alloc.h>
 #include "plan/part_state.h"
 
-/** Performs bit operation c = a AND b. */
-_bor_inline void bitAnd(const void *a, const void *b, int size, void *c);
+/** Returns true if (a AND m) == b. */
+_bor_inline int bitAndEq(const void *a, const void *m, const void *b,
+                         int size);
 /** Performs bit operator c = (a AND ~m) OR b. */
 _bor_inline void bitApplyWithMask(const void *a, const void *m, const void *b,
                                   int size, void *c);
@@ -154,23 +155,8 @@ void planPartStateToState(const plan_part_state_t *part_state,
 int planPartStateIsSubsetPackedState(const plan_part_state_t *part_state,
                                      const void *bufstate)
 {
-    void *masked_state;
-    int size, cmp;
-
-    // prepare temporary buffer
-    size = part_state->bufsize;
-    masked_state = BOR_ALLOC_ARR(char, size);
-
-    // mask out values we are not interested in
-    bitAnd(bufstate, part_state->maskbuf, size, masked_state);
-
-    // compare resulting buffers
-    cmp = memcmp(masked_state, part_state->valbuf, size);
-
-    // free temporary buffer
-    BOR_FREE(masked_state);
-
-    return cmp == 0;
+    return bitAndEq(bufstate, part_state->maskbuf, part_state->valbuf,
+                    part_state->bufsize);
 }
 
 int planPartStateIsSubsetState(const plan_part_state_t *part_state,
@@ -233,29 +219,32 @@ void planPartStateCreatePackedState(const plan_part_state_t *ps,
                      ps->bufsize, dst_statebuf);
 }
 
-_bor_inline void bitAnd(const void *a, const void *b, int size, void *c)
+_bor_inline int bitAndEq(const void *a, const void *m, const void *b,
+                         int size)
 {
-    const uint32_t *a32, *b32;
-    uint32_t *c32;
-    const uint8_t *a8, *b8;
-    uint8_t *c8;
+    const uint32_t *a32, *b32, *m32;
+    const uint8_t *a8, *b8, *m8;
     int size32, size8;
 
     size32 = size / 4;
     a32 = a;
     b32 = b;
-    c32 = c;
-    for (; size32 != 0; --size32, ++a32, ++b32, ++c32){
-        *c32 = *a32 & *b32;
+    m32 = m;
+    for (; size32 != 0; --size32, ++a32, ++b32, ++m32){
+        if ((*a32 & *m32) != *b32)
+            return 0;
     }
 
     size8 = size % 4;
     a8 = (uint8_t *)a32;
     b8 = (uint8_t *)b32;
-    c8 = (uint8_t *)c32;
-    for (; size8 != 0; --size8, ++a8, ++b8, ++c8){
-        *c8 = *a8 & *b8;
+    m8 = (uint8_t *)m32;
+    for (; size8 != 0; --size8, ++a8, ++b8, ++m8){
+        if ((*a8 & *m8) != *b8)
+            return 0;
     }
+
+    return 1;
 }
 
 _bor_inline void bitApplyWithMask(const void *a, const void *m, const void *b,
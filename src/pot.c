@@ -18,6 +18,7 @@
  */
 
 #include <boruvka/alloc.h>
+#include <boruvka/tasks.h>
 
 #include "plan/heur.h"
 #include "plan/pot.h"
@@ -533,6 +534,109 @@ void planPotCompute(plan_pot_t *pot)
     planPotCompute2(prob, pot->pot);
 }
 
+/** Number of potential functions computed by a single LP instance. The
+ *  functions are split into fixed blocks so that the results do not
+ *  depend on the number of threads. */
+#define ENSEMBLE_BLOCK 4
+
+struct _pot_ens_block_t {
+    const plan_pot_t *pot;
+    plan_state_t * const *states;
+    plan_pot_ensemble_t *ens;
+    int from; /*!< First function of the block */
+    int to;   /*!< One after the last function of the block */
+};
+typedef struct _pot_ens_block_t pot_ens_block_t;
+
+static void potEnsembleSolve(const pot_ens_block_t *b)
+{
+    const plan_pot_t *pot = b->pot;
+    const plan_pot_prob_t *prob = &pot->prob;
+    plan_lp_t *lp;
+    int *coef;
+    double *sol;
+    int i, j, var_size = prob->var_size, size = b->ens->size;
+
+    lp = lpNew(prob);
+    coef = BOR_ALLOC_ARR(int, var_size);
+    sol = BOR_ALLOC_ARR(double, var_size);
+
+    for (i = b->from; i < b->to; ++i){
+        if (b->states[i] == NULL){
+            memcpy(coef, prob->state_coef, sizeof(int) * var_size);
+        }else{
+            bzero(coef, sizeof(int) * var_size);
+            for (j = 0; j < pot->var_size; ++j){
+                if (j == pot->ma_privacy_var)
+                    continue;
+                coef[pot->var[j].lp_var_id[planStateGet(b->states[i], j)]] = 1;
+            }
+        }
+
+        // Only the objective changes so the LP is warm started
+        for (j = 0; j < var_size; ++j)
+            planLPSetObj(lp, j, coef[j]);
+        if (planLPSolve(lp, NULL, sol) != 0){
+            fprintf(stderr, "Error: LP has no solution!\n");
+            exit(-1);
+        }
+        for (j = 0; j < var_size; ++j)
+            b->ens->pot[(size_t)j * size + i] = sol[j];
+    }
+
+    BOR_FREE(coef);
+    BOR_FREE(sol);
+    planLPDel(lp);
+}
+
+static void potEnsembleTask(int id, void *data, const bor_tasks_thinfo_t *_)
+{
+    potEnsembleSolve((const pot_ens_block_t *)data);
+}
+
+void planPotEnsembleInit(plan_pot_ensemble_t *ens, const plan_pot_t *pot,
+                         plan_state_t * const *states, int states_size,
+                         int num_threads)
+{
+    pot_ens_block_t *block;
+    bor_tasks_t *tasks;
+    int i, block_size;
+
+    ens->size = states_size;
+    ens->pot = BOR_CALLOC_ARR(double, (size_t)pot->lp_var_size * states_size);
+    ens->sum = BOR_ALLOC_ARR(double, states_size);
+
+    block_size = (states_size + ENSEMBLE_BLOCK - 1) / ENSEMBLE_BLOCK;
+    block = BOR_ALLOC_ARR(pot_ens_block_t, block_size);
+    for (i = 0; i < block_size; ++i){
+        block[i].pot = pot;
+        block[i].states = states;
+        block[i].ens = ens;
+        block[i].from = i * ENSEMBLE_BLOCK;
+        block[i].to = BOR_MIN((i + 1) * ENSEMBLE_BLOCK, states_size);
+    }
+
+    if (num_threads <= 1 || block_size == 1){
+        for (i = 0; i < block_size; ++i)
+            potEnsembleSolve(block + i);
+    }else{
+        tasks = borTasksNew(BOR_MIN(num_threads, block_size));
+        for (i = 0; i < block_size; ++i)
+            borTasksAdd(tasks, potEnsembleTask, i, block + i);
+        borTasksRun(tasks);
+        borTasksDel(tasks);
+    }
+    BOR_FREE(block);
+}
+
+void planPotEnsembleFree(plan_pot_ensemble_t *ens)
+{
+    if (ens->pot != NULL)
+        BOR_FREE(ens->pot);
+    if (ens->sum != NULL)
+        BOR_FREE(ens->sum);
+}
+
 int planPotToVarIds(const plan_pot_t *pot, const plan_state_t *state,
                     int *var_ids)
 {
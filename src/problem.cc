@@ -115,7 +115,7 @@ plan_problem_agents_t *planProblemAgentsFromProto(const char *fn, unsigned flags
         return NULL;
 
     p = BOR_ALLOC(plan_problem_agents_t);
-    loadProblem(&p->glob, proto, flags);
+    loadProblem(&p->glob, proto, flags & ~PLAN_PROBLEM_PRUNE_H2);
     loadAgents(p, proto, flags);
     planProblemAgentsPack(p);
 
@@ -182,20 +182,21 @@ static int loadProblem(plan_problem_t *p,
         planCausalGraphBuildFromOps(cg, p->op, p->op_size);
         planCausalGraph(cg, p->goal);
 
-        if (hasUnimportantVars(cg)){
-            size = sizeof(plan_var_id_t) * (cg->var_order_size + 1);
-            var_order = (plan_var_id_t *)alloca(size);
-            memcpy(var_order, cg->var_order, size);
+        size = sizeof(plan_var_id_t) * (cg->var_order_size + 1);
+        var_order = (plan_var_id_t *)alloca(size);
+        memcpy(var_order, cg->var_order, size);
+        if (hasUnimportantVars(cg))
             pruneUnimportantVars(p, proto, cg->important_var, var_order);
-        }else{
-            var_order = cg->var_order;
-        }
 
+        if (flags & PLAN_PROBLEM_PRUNE_H2)
+            planProblemPruneH2(p, var_order);
         if (flags & PLAN_PROBLEM_PRUNE_DUPLICATES)
             pruneDuplicateOps(p);
         p->succ_gen = planSuccGenNew(p->op, p->op_size, var_order);
         planCausalGraphDel(cg);
     }else{
+        if (flags & PLAN_PROBLEM_PRUNE_H2)
+            planProblemPruneH2(p, NULL);
         if (flags & PLAN_PROBLEM_PRUNE_DUPLICATES)
             pruneDuplicateOps(p);
         p->succ_gen = planSuccGenNew(p->op, p->op_size, NULL);
@@ -3,7 +3,7 @@
 
 static int loadFD(plan_problem_t *plan, const char *filename);
 
-plan_problem_t *planProblemFromFD(const char *fn)
+plan_problem_t *planProblemFromFD(const char *fn, unsigned flags)
 {
     plan_problem_t *p;
 
@@ -16,6 +16,9 @@ plan_problem_t *planProblemFromFD(const char *fn)
         return NULL;
     }
 
+    if (flags & PLAN_PROBLEM_PRUNE_H2)
+        planProblemPruneH2(p, NULL);
+
     return p;
 }
 
@@ -0,0 +1,380 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+#include <boruvka/alloc.h>
+
+#include "plan/problem.h"
+#include "plan/h2.h"
+
+/** Returns true if the fact is mutex with any fact from the part-state */
+static int isMutexWith(const plan_h2_t *h2, plan_var_id_t var, plan_val_t val,
+                       const plan_part_state_t *ps)
+{
+    plan_var_id_t var2;
+    plan_val_t val2;
+    int i;
+
+    PLAN_PART_STATE_FOR_EACH(ps, i, var2, val2){
+        if (var2 != var && planH2IsMutex(h2, var, val, var2, val2))
+            return 1;
+    }
+    return 0;
+}
+
+/** Returns true if the part-state contains unreachable fact or a mutex
+ *  pair */
+static int isMutex(const plan_h2_t *h2, const plan_part_state_t *ps)
+{
+    plan_var_id_t var;
+    plan_val_t val;
+    int i;
+
+    PLAN_PART_STATE_FOR_EACH(ps, i, var, val){
+        if (!planH2IsReachable(h2, var, val)
+                || isMutexWith(h2, var, val, ps))
+            return 1;
+    }
+    return 0;
+}
+
+/** Returns true if the conditional effect can never fire */
+static int condEffIsMutex(const plan_h2_t *h2, const plan_op_t *op,
+                          const plan_op_cond_eff_t *ce)
+{
+    plan_var_id_t var;
+    plan_val_t val;
+    int i;
+
+    PLAN_PART_STATE_FOR_EACH(ce->pre, i, var, val){
+        if (planPartStateIsSet(op->pre, var)
+                && planPartStateGet(op->pre, var) != val)
+            return 1;
+        if (!planH2IsReachable(h2, var, val)
+                || isMutexWith(h2, var, val, op->pre)
+                || isMutexWith(h2, var, val, ce->pre))
+            return 1;
+    }
+    return 0;
+}
+
+/** Removes i'th conditional effect keeping the order of the others */
+static void delCondEff(plan_op_t *op, int i)
+{
+    plan_op_cond_eff_t tmp;
+
+    tmp = op->cond_eff[i];
+    for (; i < op->cond_eff_size - 1; ++i)
+        op->cond_eff[i] = op->cond_eff[i + 1];
+    op->cond_eff[op->cond_eff_size - 1] = tmp;
+    planOpDelLastCondEff(op);
+}
+
+/** Removes operators with .global_id set to -1 and returns their number */
+static int squashOps(plan_problem_t *p)
+{
+    int i, ins;
+
+    for (i = 0, ins = 0; i < p->op_size; ++i){
+        if (p->op[i].global_id == -1){
+            planOpFree(p->op + i);
+            continue;
+        }
+        p->op[ins] = p->op[i];
+        p->op[ins].global_id = ins;
+        ++ins;
+    }
+
+    i = p->op_size - ins;
+    p->op_size = ins;
+    return i;
+}
+
+/** Removes operators that are not applicable and conditional effects that
+ *  can never fire. Returns number of removed conditional effects. */
+static int pruneForward(plan_problem_t *p, const plan_h2_t *h2)
+{
+    plan_op_t *op;
+    int i, j, removed = 0;
+
+    for (i = 0; i < p->op_size; ++i){
+        op = p->op + i;
+        if (isMutex(h2, op->pre)){
+            op->global_id = -1;
+            continue;
+        }
+
+        for (j = 0; j < op->cond_eff_size;){
+            if (condEffIsMutex(h2, op, op->cond_eff + j)){
+                delCondEff(op, j);
+                ++removed;
+            }else{
+                ++j;
+            }
+        }
+    }
+
+    p->h2_ops_removed += squashOps(p);
+    return removed;
+}
+
+/** Removes operators that lead to states from which the goal cannot be
+ *  reached. Returns number of removed operators. */
+static int pruneBackward(plan_problem_t *p, const plan_h2_t *h2)
+{
+    plan_op_t *op;
+    plan_part_state_t *after;
+    plan_var_id_t var;
+    plan_val_t val;
+    int i, j, k, removed;
+
+    for (i = 0; i < p->op_size; ++i){
+        op = p->op + i;
+
+        // Facts that surely hold after application of the operator, i.e.,
+        // effects and prevail conditions on variables not changed by
+        // conditional effects
+        after = planPartStateClone(op->pre);
+        PLAN_PART_STATE_FOR_EACH(op->eff, k, var, val){
+            if (planPartStateIsSet(after, var))
+                planPartStateUnset(after, var);
+            planPartStateSet(after, var, val);
+        }
+        for (j = 0; j < op->cond_eff_size; ++j){
+            PLAN_PART_STATE_FOR_EACH(op->cond_eff[j].eff, k, var, val){
+                if (planPartStateIsSet(after, var))
+                    planPartStateUnset(after, var);
+            }
+        }
+
+        if (isMutex(h2, after))
+            op->global_id = -1;
+        planPartStateDel(after);
+    }
+
+    removed = squashOps(p);
+    p->h2_ops_removed += removed;
+    return removed;
+}
+
+static void remapPartState(plan_part_state_t *dst,
+                           const plan_part_state_t *src,
+                           const int *var_map, int **val_map)
+{
+    plan_var_id_t var;
+    plan_val_t val;
+    int i;
+
+    PLAN_PART_STATE_FOR_EACH(src, i, var, val){
+        if (var_map[var] >= 0)
+            planPartStateSet(dst, var_map[var], val_map[var][val]);
+    }
+}
+
+static void remapOp(plan_op_t *dst, plan_op_t *src, int var_size,
+                    const int *var_map, int **val_map)
+{
+    int i, ce;
+
+    planOpInit(dst, var_size);
+    remapPartState(dst->pre, src->pre, var_map, val_map);
+    remapPartState(dst->eff, src->eff, var_map, val_map);
+    for (i = 0; i < src->cond_eff_size; ++i){
+        ce = planOpAddCondEff(dst);
+        remapPartState(dst->cond_eff[ce].pre, src->cond_eff[i].pre,
+                       var_map, val_map);
+        remapPartState(dst->cond_eff[ce].eff, src->cond_eff[i].eff,
+                       var_map, val_map);
+    }
+
+    dst->name = src->name;
+    src->name = NULL;
+    dst->cost = src->cost;
+    dst->global_id = src->global_id;
+    dst->owner = src->owner;
+    dst->ownerarr = src->ownerarr;
+    dst->is_private = src->is_private;
+}
+
+/** Removes unreachable values from variables and variables with single
+ *  value. */
+static void shrinkVars(plan_problem_t *p, const plan_h2_t *h2,
+                       const plan_state_t *init,
+                       plan_var_id_t *var_order)
+{
+    plan_var_t *var, *v;
+    plan_state_pool_t *state_pool;
+    plan_state_t *state;
+    plan_part_state_t *goal;
+    plan_op_t op;
+    int *var_map, **val_map, *range;
+    int old_var_size, var_size, facts_removed, i, j;
+
+    old_var_size = p->var_size;
+    var_map = BOR_ALLOC_ARR(int, p->var_size);
+    val_map = BOR_ALLOC_ARR(int *, p->var_size);
+    range = BOR_CALLOC_ARR(int, p->var_size);
+
+    // Keep reachable values and the values required by the goal (those
+    // may be unreachable if the problem is unsolvable)
+    facts_removed = 0;
+    for (i = 0; i < p->var_size; ++i){
+        val_map[i] = BOR_ALLOC_ARR(int, p->var[i].range);
+        for (j = 0; j < p->var[i].range; ++j){
+            if (planH2IsReachable(h2, i, j)
+                    || planPartStateGet(p->goal, i) == j){
+                val_map[i][j] = range[i]++;
+            }else{
+                val_map[i][j] = -1;
+                ++facts_removed;
+            }
+        }
+    }
+
+    var_size = 0;
+    for (i = 0; i < p->var_size; ++i){
+        if (range[i] > 1){
+            var_map[i] = var_size++;
+        }else{
+            var_map[i] = -1;
+        }
+    }
+
+    // At least one variable is needed for the state pool
+    if (var_size == 0){
+        var_map[0] = 0;
+        var_size = 1;
+    }
+
+    if (facts_removed == 0 && var_size == p->var_size){
+        for (i = 0; i < p->var_size; ++i)
+            BOR_FREE(val_map[i]);
+        BOR_FREE(val_map);
+        BOR_FREE(var_map);
+        BOR_FREE(range);
+        return;
+    }
+
+    p->h2_facts_removed += facts_removed;
+    p->h2_vars_removed += p->var_size - var_size;
+
+    // Variables
+    var = BOR_ALLOC_ARR(plan_var_t, var_size);
+    for (i = 0; i < p->var_size; ++i){
+        if (var_map[i] >= 0){
+            v = var + var_map[i];
+            *v = p->var[i];
+            v->range = range[i];
+            v->val = BOR_CALLOC_ARR(plan_var_val_t, range[i]);
+            for (j = 0; j < p->var[i].range; ++j){
+                if (val_map[i][j] < 0)
+                    continue;
+                v->val[val_map[i][j]] = p->var[i].val[j];
+                p->var[i].val[j].name = NULL;
+            }
+            p->var[i].name = NULL;
+        }
+        planVarFree(p->var + i);
+    }
+
+    // Initial state and goal
+    state_pool = planStatePoolNew(var, var_size);
+    state = planStateNew(var_size);
+    for (i = 0; i < p->var_size; ++i){
+        if (var_map[i] >= 0)
+            planStateSet(state, var_map[i], val_map[i][planStateGet(init, i)]);
+    }
+    p->initial_state = planStatePoolInsert(state_pool, state);
+    planStateDel(state);
+
+    goal = planPartStateNew(var_size);
+    remapPartState(goal, p->goal, var_map, val_map);
+
+    // Operators
+    for (i = 0; i < p->op_size; ++i){
+        remapOp(&op, p->op + i, var_size, var_map, val_map);
+        planOpFree(p->op + i);
+        p->op[i] = op;
+    }
+
+    if (var_order != NULL){
+        for (i = 0, j = 0; var_order[i] != PLAN_VAR_ID_UNDEFINED; ++i){
+            if (var_map[var_order[i]] >= 0)
+                var_order[j++] = var_map[var_order[i]];
+        }
+        var_order[j] = PLAN_VAR_ID_UNDEFINED;
+    }
+
+    BOR_FREE(p->var);
+    p->var = var;
+    p->var_size = var_size;
+    planStatePoolDel(p->state_pool);
+    p->state_pool = state_pool;
+    planPartStateDel(p->goal);
+    p->goal = goal;
+
+    for (i = 0; i < old_var_size; ++i)
+        BOR_FREE(val_map[i]);
+    BOR_FREE(val_map);
+    BOR_FREE(var_map);
+    BOR_FREE(range);
+}
+
+void planProblemPruneH2(plan_problem_t *p, plan_var_id_t *var_order)
+{
+    plan_h2_t fw, bw;
+    plan_state_t *init;
+    int changed, op_size;
+
+    if (p->ma_privacy_var >= 0 || p->proj_op_size > 0)
+        return;
+
+    init = planStateNew(p->state_pool->num_vars);
+    planStatePoolGetState(p->state_pool, p->initial_state, init);
+    op_size = p->op_size;
+
+    // Removal of conditional effects and of operators in the backward
+    // step may create new forward mutexes and vice versa
+    while (1){
+        planH2Init(&fw, p);
+        planH2Mutex(&fw, init);
+        changed = pruneForward(p, &fw);
+
+        planH2InitBackward(&bw, p);
+        planH2MutexBackward(&bw, p->goal);
+        changed += pruneBackward(p, &bw);
+        planH2Free(&bw);
+
+        if (!changed)
+            break;
+        planH2Free(&fw);
+    }
+
+    shrinkVars(p, &fw, init, var_order);
+    planH2Free(&fw);
+    planStateDel(init);
+
+    if (p->succ_gen != NULL
+            && (op_size != p->op_size
+                    || p->h2_facts_removed > 0
+                    || p->h2_vars_removed > 0)){
+        planSuccGenDel(p->succ_gen);
+        p->succ_gen = planSuccGenNew(p->op, p->op_size, NULL);
+    }
+}
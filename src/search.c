@@ -21,12 +21,26 @@
 #include <boruvka/timer.h>
 
 #include "plan/search.h"
+#include "plan/trace.h"
+#include "search_stubborn.h"
+#include "search_dead_end.h"
 
 static plan_state_id_t extractPath(plan_state_space_t *state_space,
                                    plan_state_id_t goal_state,
                                    plan_path_t *path);
 static void _planSearchLoadState(plan_search_t *search,
                                  plan_state_id_t state_id);
+/** Initializes symmetries and canonicalizes the initial state */
+static void symmetryInit(plan_search_t *search, const plan_problem_t *prob);
+/** Frees symmetries */
+static void symmetryFree(plan_search_t *search);
+/** Extracts path from the original initial state to a state symmetric
+ *  to the given goal state. */
+static plan_state_id_t symmetryExtractPath(const plan_search_t *search,
+                                           plan_state_id_t goal_state,
+                                           plan_path_t *path);
+/** Handles pending memory pressure request */
+static void memPressure(plan_search_t *search);
 
 
 
@@ -54,9 +68,13 @@ int planSearchRun(plan_search_t *search, plan_path_t *path)
         res = search->init_step_fn(search);
     }
     while (res == PLAN_SEARCH_CONT){
+        planTraceBegin("search", "step");
         res = search->step_fn(search);
+        planTraceEnd("search", "step");
         if (search->abort)
             res = PLAN_SEARCH_ABORT;
+        if (search->mem_pressure != PLAN_MEM_PRESSURE_NONE)
+            memPressure(search);
 
         ++steps;
         if (res == PLAN_SEARCH_CONT
@@ -74,8 +92,13 @@ int planSearchRun(plan_search_t *search, plan_path_t *path)
     }
 
     if (res == PLAN_SEARCH_FOUND){
-        if (search->goal_state != PLAN_NO_STATE)
-            extractPath(search->state_space, search->goal_state, path);
+        if (search->goal_state != PLAN_NO_STATE){
+            if (search->symmetry){
+                symmetryExtractPath(search, search->goal_state, path);
+            }else{
+                extractPath(search->state_space, search->goal_state, path);
+            }
+        }
         planSearchStatSetFound(&search->stat);
     }else{
         planSearchStatSetNotFound(&search->stat);
@@ -95,10 +118,32 @@ void planSearchAbort(plan_search_t *search)
     search->abort = 1;
 }
 
+void planSearchMemPressure(plan_search_t *search, int level)
+{
+    if (level > search->mem_pressure)
+        search->mem_pressure = level;
+}
+
+size_t planSearchShedMem(plan_search_t *search, int level)
+{
+    size_t size = 0;
+
+    if (level == PLAN_MEM_PRESSURE_NONE)
+        return 0;
+
+    if (search->heur)
+        size += planHeurShedMem(search->heur, level);
+    ++search->mem_shed_count;
+    search->mem_shed_bytes += size;
+    return size;
+}
+
 plan_state_id_t planSearchExtractPath(const plan_search_t *search,
                                       plan_state_id_t goal_state,
                                       plan_path_t *path)
 {
+    if (search->symmetry)
+        return symmetryExtractPath(search, goal_state, path);
     return extractPath(search->state_space, goal_state, path);
 }
 
@@ -159,15 +204,55 @@ plan_state_space_node_t *planSearchLoadNode(plan_search_t *search,
     return planStateSpaceNode(search->state_space, state_id);
 }
 
+long planSearchDeadEndConflicts(const plan_search_t *search)
+{
+    if (search->dead_end == NULL)
+        return 0;
+    return search->dead_end->conflicts;
+}
+
+long planSearchDeadEndPruned(const plan_search_t *search)
+{
+    if (search->dead_end == NULL)
+        return 0;
+    return search->dead_end->pruned;
+}
+
+void planSearchMemUsage(const plan_search_t *search, plan_search_mem_t *mem)
+{
+    const plan_state_pool_t *pool = search->state_pool;
+    int i;
+
+    bzero(mem, sizeof(*mem));
+    mem->state_pool = planStatePoolDataMemUsage(pool, 0);
+    mem->state_pool_index = planStatePoolIndexMemUsage(pool);
+    for (i = 1; i < pool->data_size; ++i)
+        mem->state_pool_data += planStatePoolDataMemUsage(pool, i);
+    if (search->mem_usage_fn)
+        mem->open_list = search->mem_usage_fn(search);
+    if (search->heur)
+        mem->heur = planHeurMemUsage(search->heur);
+}
+
+size_t planSearchMemTotal(const plan_search_mem_t *mem)
+{
+    return mem->state_pool + mem->state_pool_index + mem->state_pool_data
+            + mem->open_list + mem->heur;
+}
+
 void _planSearchInit(plan_search_t *search,
                      const plan_search_params_t *params,
                      plan_search_del_fn del_fn,
                      plan_search_init_step_fn init_step_fn,
                      plan_search_step_fn step_fn,
                      plan_search_insert_node_fn insert_node_fn,
-                     plan_search_top_node_cost_fn top_node_cost_fn)
+                     plan_search_top_node_cost_fn top_node_cost_fn,
+                     plan_search_mem_usage_fn mem_usage_fn)
 {
     search->abort         = 0;
+    search->mem_pressure  = PLAN_MEM_PRESSURE_NONE;
+    search->mem_shed_count = 0L;
+    search->mem_shed_bytes = 0;
     search->heur          = params->heur;
     search->heur_del      = params->heur_del;
     search->initial_state = params->prob->initial_state;
@@ -182,6 +267,7 @@ void _planSearchInit(plan_search_t *search,
     search->step_fn = step_fn;
     search->insert_node_fn = insert_node_fn;
     search->top_node_cost_fn = top_node_cost_fn;
+    search->mem_usage_fn = mem_usage_fn;
     search->poststep_fn = NULL;
     search->poststep_data = NULL;
     search->expanded_node_fn = NULL;
@@ -195,12 +281,36 @@ void _planSearchInit(plan_search_t *search,
     search->state_id = PLAN_NO_STATE;
     planSearchStatInit(&search->stat);
     planSearchApplicableOpsInit(&search->app_ops, params->prob->op_size);
+    search->stubborn = NULL;
+    if (params->stubborn)
+        search->stubborn = planSearchStubbornNew(params->prob);
+    search->symmetry = NULL;
+    search->sym_state = NULL;
+    search->sym_initial_state = search->initial_state;
+    if (params->symmetry)
+        symmetryInit(search, params->prob);
+    search->dead_end = NULL;
+    if (params->dead_end){
+        if (params->heur != NULL && params->heur->ma){
+            fprintf(stderr, "Search Warning: Dead-end learning cannot be"
+                            " used with multi-agent heuristics. It is"
+                            " disabled.\n");
+        }else{
+            search->dead_end = planSearchDeadEndNew(params->prob);
+        }
+    }
     search->goal_state  = PLAN_NO_STATE;
 }
 
 void _planSearchFree(plan_search_t *search)
 {
     planSearchApplicableOpsFree(&search->app_ops);
+    if (search->stubborn)
+        planSearchStubbornDel(search->stubborn);
+    if (search->symmetry)
+        symmetryFree(search);
+    if (search->dead_end)
+        planSearchDeadEndDel(search->dead_end);
     if (search->heur && search->heur_del)
         planHeurDel(search->heur);
     if (search->state)
@@ -212,9 +322,39 @@ void _planSearchFree(plan_search_t *search)
 int _planSearchFindApplicableOps(plan_search_t *search,
                                  plan_state_id_t state_id)
 {
+    int found;
+
     _planSearchLoadState(search, state_id);
-    return planSearchApplicableOpsFind(&search->app_ops, search->state,
-                                       state_id, search->succ_gen);
+    planSearchStatPhaseStart(&search->stat, PLAN_SEARCH_PHASE_SUCC_GEN);
+    found = planSearchApplicableOpsFind(&search->app_ops, search->state,
+                                        state_id, search->succ_gen);
+    planSearchStatPhaseStop(&search->stat, PLAN_SEARCH_PHASE_SUCC_GEN);
+    if (found && search->stubborn)
+        planSearchStubbornPrune(search->stubborn, search->state,
+                                &search->app_ops);
+    return found;
+}
+
+plan_state_id_t _planSearchNextState(plan_search_t *search,
+                                     plan_op_t *op,
+                                     plan_state_id_t state_id)
+{
+    plan_state_id_t next_state;
+
+    planSearchStatPhaseStart(&search->stat, PLAN_SEARCH_PHASE_STATE_POOL);
+    if (search->symmetry == NULL){
+        next_state = planOpApply(op, search->state_pool, state_id);
+    }else{
+        planStatePoolGetState(search->state_pool, state_id,
+                              search->sym_state);
+        planPartStateUpdateState(op->eff, search->sym_state);
+        planSymmetryCanonState(search->symmetry, search->sym_state);
+        next_state = planStatePoolInsert(search->state_pool,
+                                         search->sym_state);
+    }
+    planSearchStatPhaseStop(&search->stat, PLAN_SEARCH_PHASE_STATE_POOL);
+
+    return next_state;
 }
 
 int _planSearchHeur(plan_search_t *search,
@@ -231,6 +371,18 @@ int _planSearchHeur(plan_search_t *search,
         res.pref_op_size = preferred_ops->op_found;
     }
 
+    if (search->dead_end
+            && planSearchDeadEndCheck(search->dead_end,
+                                      planSearchLoadState(search,
+                                                          node->state_id))){
+        if (preferred_ops)
+            preferred_ops->op_preferred = 0;
+        *heur_val = PLAN_HEUR_DEAD_END;
+        return fres;
+    }
+
+    planSearchStatPhaseStart(&search->stat, PLAN_SEARCH_PHASE_HEUR);
+    planTraceBeginArgs("heur", "heur", "state", node->state_id, NULL, 0);
     if (search->heur->ma){
         if (search->ma_heur_fn){
             search->ma_heur_fn(search, search->heur, node->state_id, &res,
@@ -243,12 +395,21 @@ int _planSearchHeur(plan_search_t *search,
     }else{
         planHeurNode(search->heur, node->state_id, search, &res);
     }
+    planTraceEnd("heur", "heur");
+    planSearchStatPhaseStop(&search->stat, PLAN_SEARCH_PHASE_HEUR);
     planSearchStatIncEvaluatedStates(&search->stat);
+    if (res.heur != PLAN_HEUR_DEAD_END)
+        planSearchStatAddHeur(&search->stat, res.heur);
 
     if (preferred_ops){
         preferred_ops->op_preferred = res.pref_size;
     }
 
+    if (search->dead_end && res.heur == PLAN_HEUR_DEAD_END){
+        planSearchDeadEndLearn(search->dead_end,
+                               planSearchLoadState(search, node->state_id));
+    }
+
     *heur_val = res.heur;
     return fres;
 }
@@ -276,7 +437,7 @@ plan_state_id_t planSearchApplyOp(plan_search_t *search,
     plan_cost_t heur;
 
     cur_node = planStateSpaceNode(search->state_space, state_id);
-    next_state = planOpApply(op, search->state_pool, state_id);
+    next_state = _planSearchNextState(search, op, state_id);
     next_node = planStateSpaceNode(search->state_space, next_state);
     _planSearchHeur(search, next_node, &heur, NULL);
 
@@ -316,3 +477,118 @@ static void _planSearchLoadState(plan_search_t *search,
     planStatePoolGetState(search->state_pool, state_id, search->state);
     search->state_id = state_id;
 }
+
+static void symmetryInit(plan_search_t *search, const plan_problem_t *prob)
+{
+    plan_symmetry_t *sym;
+
+    sym = BOR_ALLOC(plan_symmetry_t);
+    if (planSymmetryInit(sym, prob) != 0 || sym->gen_size == 0){
+        // There is nothing to prune
+        planSymmetryFree(sym);
+        BOR_FREE(sym);
+        return;
+    }
+
+    search->symmetry = sym;
+    search->sym_state = planStateNew(search->state_pool->num_vars);
+
+    planStatePoolGetState(search->state_pool, search->initial_state,
+                          search->sym_state);
+    planSymmetryCanonState(sym, search->sym_state);
+    search->initial_state = planStatePoolInsert(search->state_pool,
+                                                search->sym_state);
+
+    if (search->stubborn){
+        fprintf(stderr, "Search Warning: Strong stubborn sets cannot be"
+                        " combined with symmetries. Pruning is disabled.\n");
+        planSearchStubbornDel(search->stubborn);
+        search->stubborn = NULL;
+    }
+}
+
+static void memPressure(plan_search_t *search)
+{
+    int level;
+    size_t size;
+
+    level = search->mem_pressure;
+    search->mem_pressure = PLAN_MEM_PRESSURE_NONE;
+    size = planSearchShedMem(search, level);
+    planTraceInstant("search", "mem-pressure", "level", level,
+                     "released", (long)size, NULL, 0, NULL, 0);
+}
+
+static void symmetryFree(plan_search_t *search)
+{
+    planSymmetryFree(search->symmetry);
+    BOR_FREE(search->symmetry);
+    planStateDel(search->sym_state);
+}
+
+static plan_state_id_t symmetryExtractPath(const plan_search_t *search,
+                                           plan_state_id_t goal_state,
+                                           plan_path_t *path)
+{
+    plan_symmetry_t *sym = search->symmetry;
+    plan_state_pool_t *pool = search->state_pool;
+    plan_state_space_node_t *node, **nodes = NULL;
+    plan_symmetry_gen_t perm;
+    plan_state_t *state;
+    plan_state_id_t *state_id;
+    plan_op_t **op;
+    int i, size = 0;
+
+    planPathInit(path);
+
+    // Collect the path between canonical states
+    node = planStateSpaceNode(search->state_space, goal_state);
+    while (node && node->op){
+        nodes = BOR_REALLOC_ARR(nodes, plan_state_space_node_t *, size + 1);
+        nodes[size++] = node;
+        node = planStateSpaceNode(search->state_space, node->parent_state_id);
+    }
+    if (node == NULL || node->state_id != search->initial_state){
+        if (nodes)
+            BOR_FREE(nodes);
+        return PLAN_NO_STATE;
+    }
+
+    state = planStateNew(pool->num_vars);
+    op = BOR_ALLOC_ARR(plan_op_t *, size + 1);
+    state_id = BOR_ALLOC_ARR(plan_state_id_t, size + 1);
+
+    // perm maps the canonical states on the path to the original states
+    // reachable from the original initial state. The operators are mapped
+    // the same way.
+    planSymmetryGenInit(&perm, sym);
+    planStatePoolGetState(pool, search->sym_initial_state, state);
+    planSymmetryCanonState(sym, state);
+    planSymmetryGenUncanon(&perm, sym);
+
+    state_id[0] = search->sym_initial_state;
+    for (i = 0; i < size; ++i){
+        node = nodes[size - i - 1];
+        op[i] = (plan_op_t *)sym->op + perm.op[node->op - sym->op];
+
+        // Recompute canonicalization of the successor state
+        planStatePoolGetState(pool, node->parent_state_id, state);
+        planPartStateUpdateState(node->op->eff, state);
+        planSymmetryCanonState(sym, state);
+        planSymmetryGenUncanon(&perm, sym);
+
+        state_id[i + 1] = planOpApply(op[i], pool, state_id[i]);
+    }
+
+    for (i = size - 1; i >= 0; --i)
+        planPathPrependOp(path, op[i], state_id[i], state_id[i + 1]);
+
+    planSymmetryGenFree(&perm, sym);
+    BOR_FREE(state_id);
+    BOR_FREE(op);
+    if (nodes)
+        BOR_FREE(nodes);
+    planStateDel(state);
+
+    return search->sym_initial_state;
+}
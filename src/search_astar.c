@@ -43,6 +43,7 @@ static int planSearchAStarStep(plan_search_t *_search);
 static void planSearchAStarInsertNode(plan_search_t *search,
                                       plan_state_space_node_t *node);
 static plan_cost_t planSearchAStarTopNodeCost(const plan_search_t *search);
+static size_t planSearchAStarMemUsage(const plan_search_t *search);
 
 
 void planSearchAStarParamsInit(plan_search_astar_params_t *p)
@@ -62,7 +63,8 @@ plan_search_t *planSearchAStarNew(const plan_search_astar_params_t *params)
                     planSearchAStarInit,
                     planSearchAStarStep,
                     planSearchAStarInsertNode,
-                    planSearchAStarTopNodeCost);
+                    planSearchAStarTopNodeCost,
+                    planSearchAStarMemUsage);
 
     astar->list     = planListTieBreaking(2);
     astar->pathmax  = params->pathmax;
@@ -140,7 +142,10 @@ static int astarInsertState(plan_search_astar_t *astar,
     cost[1] = heur; // tie-breaking value
 
     // Insert into open-list
+    planSearchStatPhaseStart(&search->stat, PLAN_SEARCH_PHASE_LIST);
     planListPush(astar->list, cost, node->state_id);
+    planSearchStatPhaseStop(&search->stat, PLAN_SEARCH_PHASE_LIST);
+    planSearchStatIncOpen(&search->stat);
     planSearchStatIncGeneratedStates(&search->stat);
 
     return PLAN_SEARCH_CONT;
@@ -165,8 +170,12 @@ static int planSearchAStarStep(plan_search_t *search)
     plan_op_t **op;
 
     // Get next state from open list
-    if (planListPop(astar->list, &cur_state, cost) != 0)
+    planSearchStatPhaseStart(&search->stat, PLAN_SEARCH_PHASE_LIST);
+    res = planListPop(astar->list, &cur_state, cost);
+    planSearchStatPhaseStop(&search->stat, PLAN_SEARCH_PHASE_LIST);
+    if (res != 0)
         return PLAN_SEARCH_NOT_FOUND;
+    planSearchStatDecOpen(&search->stat);
 
     // Get corresponding state space node
     cur_node = planStateSpaceNode(search->state_space, cur_state);
@@ -192,7 +201,7 @@ static int planSearchAStarStep(plan_search_t *search)
     op_size = search->app_ops.op_found;
     for (i = 0; i < op_size; ++i){
         // Create a new state
-        next_state = planOpApply(op[i], search->state_pool, cur_state);
+        next_state = _planSearchNextState(search, op[i], cur_state);
         // Compute its g() value
         g_cost = cur_node->cost + op[i]->cost;
 
@@ -225,7 +234,10 @@ static void planSearchAStarInsertNode(plan_search_t *search,
     }else{
         planStateSpaceReopen(search->state_space, node);
     }
+    planSearchStatPhaseStart(&search->stat, PLAN_SEARCH_PHASE_LIST);
     planListPush(astar->list, cost, node->state_id);
+    planSearchStatPhaseStop(&search->stat, PLAN_SEARCH_PHASE_LIST);
+    planSearchStatIncOpen(&search->stat);
 }
 
 static plan_cost_t planSearchAStarTopNodeCost(const plan_search_t *search)
@@ -238,3 +250,9 @@ static plan_cost_t planSearchAStarTopNodeCost(const plan_search_t *search)
         return cost[0] - cost[1];
     return PLAN_COST_MAX;
 }
+
+static size_t planSearchAStarMemUsage(const plan_search_t *search)
+{
+    plan_search_astar_t *astar = SEARCH_FROM_PARENT(search);
+    return sizeof(*astar) + planListMemUsage(astar->list);
+}
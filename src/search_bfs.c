@@ -0,0 +1,838 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <boruvka/alloc.h>
+#include <boruvka/tasks.h>
+
+#include "plan/search.h"
+
+#ifndef _GNU_SOURCE
+/** Declaration of qsort_r() function that should be available in libc */
+void qsort_r(void *base, size_t nmemb, size_t size,
+             int (*compar)(const void *, const void *, void *),
+             void *arg);
+#endif
+
+/**
+ * Number of states in one block of a compressed layer. The first state
+ * of each block is stored without delta compression so that the blocks
+ * can be decoded independently of each other.
+ */
+#define BFS_BLOCK_SIZE 64
+
+/**
+ * One layer of the breadth-first search, i.e., all states in the same
+ * distance from the initial state. Packed states are sorted and each
+ * state is stored as the length of the prefix it shares with the
+ * previous state (varint encoded) followed by the rest of the state.
+ */
+struct _bfs_layer_t {
+    unsigned char *buf; /*!< Compressed states */
+    size_t size;        /*!< Number of used bytes in .buf */
+    size_t alloc;       /*!< Allocated bytes in .buf */
+    size_t *block;      /*!< Offsets of blocks in .buf */
+    long block_size;
+    long block_alloc;
+    long num_states;    /*!< Number of states in the layer */
+    unsigned char *last; /*!< The last inserted state, i.e., the upper
+                              bound of the states in the layer */
+};
+typedef struct _bfs_layer_t bfs_layer_t;
+
+/**
+ * Sequential decoder of a range of blocks of a layer.
+ */
+struct _bfs_layer_it_t {
+    const bfs_layer_t *layer;
+    size_t pos;         /*!< Current position in layer->buf */
+    size_t end;         /*!< End of the decoded range */
+    int bufsize;        /*!< Size of the packed state */
+    unsigned char *cur; /*!< The current state */
+};
+typedef struct _bfs_layer_it_t bfs_layer_it_t;
+
+struct _plan_search_bfs_t;
+
+/**
+ * Per-thread data used for expansion of a part of a layer.
+ */
+struct _bfs_th_t {
+    struct _plan_search_bfs_t *bfs;
+    long block_from;     /*!< First block of the layer to expand */
+    long block_to;       /*!< One past the last block to expand */
+
+    plan_state_t *state; /*!< Unpacked expanded state */
+    plan_state_t *next;  /*!< Unpacked successor state */
+    plan_op_t **op;      /*!< Applicable operators */
+    unsigned char *cur;  /*!< Buffer for the expanded state */
+
+    unsigned char *succ; /*!< Generated packed successors */
+    long succ_size;      /*!< Number of states in .succ */
+    long succ_alloc;
+
+    long expanded;
+    long generated;
+
+    int goal;                  /*!< True if a goal state was generated */
+    unsigned char *goal_state; /*!< The goal state */
+    unsigned char *goal_parent; /*!< Parent of the goal state */
+    plan_op_t *goal_op;        /*!< Operator leading to the goal state */
+};
+typedef struct _bfs_th_t bfs_th_t;
+
+struct _plan_search_bfs_t {
+    plan_search_t search;
+
+    const plan_problem_t *prob;
+    const plan_state_packer_t *packer;
+    int bufsize;         /*!< Size of packed states in bytes */
+    int count_reachable;
+
+    bfs_layer_t *layer;  /*!< All layers found so far */
+    int layer_size;
+    int layer_alloc;
+    long reachable;      /*!< Number of reachable states found so far */
+
+    bfs_th_t *th;        /*!< Per-thread data */
+    int num_threads;
+
+    int goal;            /*!< True if a goal state was found */
+    int goal_layer;      /*!< Layer of the parent of .goal_state */
+    unsigned char *goal_state;
+    unsigned char *goal_parent;
+    plan_op_t *goal_op;
+};
+typedef struct _plan_search_bfs_t plan_search_bfs_t;
+
+#define SEARCH_FROM_PARENT(parent) \
+    bor_container_of((parent), plan_search_bfs_t, search)
+
+/** Frees allocated resorces */
+static void planSearchBFSDel(plan_search_t *_search);
+/** Initializes search. This must be call exactly once. */
+static int planSearchBFSInit(plan_search_t *_search);
+/** Performes one step in the algorithm, i.e., expands one layer. */
+static int planSearchBFSStep(plan_search_t *_search);
+/** Returns memory allocated by the layers and the per-thread buffers */
+static size_t planSearchBFSMemUsage(const plan_search_t *_search);
+
+
+void planSearchBFSParamsInit(plan_search_bfs_params_t *p)
+{
+    bzero(p, sizeof(*p));
+    planSearchParamsInit(&p->search);
+    p->num_threads = 1;
+}
+
+plan_search_t *planSearchBFSNew(const plan_search_bfs_params_t *params)
+{
+    plan_search_bfs_t *bfs;
+    plan_search_params_t search_params;
+    int i;
+
+    // Operators are applied directly on packed states so neither pruning
+    // of operators nor symmetries are used.
+    search_params = params->search;
+    if (search_params.stubborn || search_params.symmetry){
+        fprintf(stderr, "Search Warning: BFS does not support strong"
+                        " stubborn sets and symmetries. They are"
+                        " disabled.\n");
+        search_params.stubborn = 0;
+        search_params.symmetry = 0;
+    }
+    // The heuristic is not used at all
+    search_params.dead_end = 0;
+
+    bfs = BOR_ALLOC(plan_search_bfs_t);
+
+    _planSearchInit(&bfs->search, &search_params,
+                    planSearchBFSDel,
+                    planSearchBFSInit,
+                    planSearchBFSStep,
+                    NULL, NULL,
+                    planSearchBFSMemUsage);
+
+    bfs->prob = params->search.prob;
+    bfs->packer = bfs->prob->state_pool->packer;
+    bfs->bufsize = planStatePackerBufSize(bfs->packer);
+    bfs->count_reachable = params->count_reachable;
+
+    bfs->layer = NULL;
+    bfs->layer_size = bfs->layer_alloc = 0;
+    bfs->reachable = 0;
+
+    bfs->num_threads = BOR_MAX(params->num_threads, 1);
+    bfs->th = BOR_CALLOC_ARR(bfs_th_t, bfs->num_threads);
+    for (i = 0; i < bfs->num_threads; ++i){
+        bfs->th[i].bfs = bfs;
+        bfs->th[i].state = planStateNew(bfs->prob->var_size);
+        bfs->th[i].next = planStateNew(bfs->prob->var_size);
+        bfs->th[i].op = BOR_ALLOC_ARR(plan_op_t *, bfs->prob->op_size);
+        bfs->th[i].cur = BOR_ALLOC_ARR(unsigned char, bfs->bufsize);
+        bfs->th[i].goal_state = BOR_ALLOC_ARR(unsigned char, bfs->bufsize);
+        bfs->th[i].goal_parent = BOR_ALLOC_ARR(unsigned char, bfs->bufsize);
+    }
+
+    bfs->goal = 0;
+    bfs->goal_layer = -1;
+    bfs->goal_state = BOR_ALLOC_ARR(unsigned char, bfs->bufsize);
+    bfs->goal_parent = BOR_ALLOC_ARR(unsigned char, bfs->bufsize);
+    bfs->goal_op = NULL;
+
+    return &bfs->search;
+}
+
+long planSearchBFSReachable(const plan_search_t *search)
+{
+    const plan_search_bfs_t *bfs = SEARCH_FROM_PARENT(search);
+    return bfs->reachable;
+}
+
+int planSearchBFSLayers(const plan_search_t *search)
+{
+    const plan_search_bfs_t *bfs = SEARCH_FROM_PARENT(search);
+    return bfs->layer_size;
+}
+
+static void layerFree(bfs_layer_t *layer)
+{
+    if (layer->buf)
+        BOR_FREE(layer->buf);
+    if (layer->block)
+        BOR_FREE(layer->block);
+    if (layer->last)
+        BOR_FREE(layer->last);
+}
+
+static void planSearchBFSDel(plan_search_t *search)
+{
+    plan_search_bfs_t *bfs = SEARCH_FROM_PARENT(search);
+    int i;
+
+    _planSearchFree(search);
+
+    for (i = 0; i < bfs->layer_size; ++i)
+        layerFree(bfs->layer + i);
+    if (bfs->layer)
+        BOR_FREE(bfs->layer);
+
+    for (i = 0; i < bfs->num_threads; ++i){
+        planStateDel(bfs->th[i].state);
+        planStateDel(bfs->th[i].next);
+        BOR_FREE(bfs->th[i].op);
+        BOR_FREE(bfs->th[i].cur);
+        if (bfs->th[i].succ)
+            BOR_FREE(bfs->th[i].succ);
+        BOR_FREE(bfs->th[i].goal_state);
+        BOR_FREE(bfs->th[i].goal_parent);
+    }
+    BOR_FREE(bfs->th);
+    BOR_FREE(bfs->goal_state);
+    BOR_FREE(bfs->goal_parent);
+    BOR_FREE(bfs);
+}
+
+static size_t planSearchBFSMemUsage(const plan_search_t *search)
+{
+    plan_search_bfs_t *bfs = SEARCH_FROM_PARENT(search);
+    const bfs_layer_t *layer;
+    const bfs_th_t *th;
+    size_t size;
+    int i;
+
+    size  = sizeof(*bfs) + 2 * bfs->bufsize;
+    size += sizeof(bfs_layer_t) * bfs->layer_alloc;
+    for (i = 0; i < bfs->layer_size; ++i){
+        layer = bfs->layer + i;
+        size += layer->alloc;
+        size += sizeof(size_t) * layer->block_alloc;
+        if (layer->last)
+            size += bfs->bufsize;
+    }
+
+    size += sizeof(bfs_th_t) * bfs->num_threads;
+    for (i = 0; i < bfs->num_threads; ++i){
+        th = bfs->th + i;
+        size += sizeof(plan_op_t *) * bfs->prob->op_size;
+        size += 3 * bfs->bufsize;
+        size += (size_t)th->succ_alloc * bfs->bufsize;
+    }
+    return size;
+}
+
+
+/*** Compressed layers ***/
+static bfs_layer_t *layerAdd(plan_search_bfs_t *bfs)
+{
+    bfs_layer_t *layer;
+
+    if (bfs->layer_size == bfs->layer_alloc){
+        bfs->layer_alloc = BOR_MAX(2 * bfs->layer_alloc, 8);
+        bfs->layer = BOR_REALLOC_ARR(bfs->layer, bfs_layer_t,
+                                     bfs->layer_alloc);
+    }
+    layer = bfs->layer + bfs->layer_size++;
+    bzero(layer, sizeof(*layer));
+    layer->last = BOR_ALLOC_ARR(unsigned char, bfs->bufsize);
+    return layer;
+}
+
+/** Releases memory that is not needed once the layer is complete */
+static void layerFinalize(bfs_layer_t *layer)
+{
+    if (layer->size > 0 && layer->size < layer->alloc){
+        layer->buf = BOR_REALLOC_ARR(layer->buf, unsigned char, layer->size);
+        layer->alloc = layer->size;
+    }
+}
+
+_bor_inline void layerReserve(bfs_layer_t *layer, size_t size)
+{
+    if (layer->size + size > layer->alloc){
+        layer->alloc = BOR_MAX(2 * layer->alloc, layer->size + size);
+        layer->alloc = BOR_MAX(layer->alloc, 1024);
+        layer->buf = BOR_REALLOC_ARR(layer->buf, unsigned char, layer->alloc);
+    }
+}
+
+_bor_inline void layerWriteVarint(bfs_layer_t *layer, int val)
+{
+    while (val >= 0x80){
+        layer->buf[layer->size++] = (val & 0x7f) | 0x80;
+        val >>= 7;
+    }
+    layer->buf[layer->size++] = val;
+}
+
+/** Appends state to the layer. States must be inserted in sorted order. */
+static void layerPush(bfs_layer_t *layer, const unsigned char *state,
+                      int bufsize)
+{
+    int prefix = 0;
+
+    if (layer->num_states % BFS_BLOCK_SIZE == 0){
+        if (layer->block_size == layer->block_alloc){
+            layer->block_alloc = BOR_MAX(2 * layer->block_alloc, 16);
+            layer->block = BOR_REALLOC_ARR(layer->block, size_t,
+                                           layer->block_alloc);
+        }
+        layer->block[layer->block_size++] = layer->size;
+
+    }else{
+        for (; prefix < bufsize && state[prefix] == layer->last[prefix];
+                ++prefix);
+    }
+
+    layerReserve(layer, bufsize - prefix + 5);
+    layerWriteVarint(layer, prefix);
+    memcpy(layer->buf + layer->size, state + prefix, bufsize - prefix);
+    layer->size += bufsize - prefix;
+    memcpy(layer->last, state, bufsize);
+    ++layer->num_states;
+}
+
+/** Initializes iterator over blocks [block_from, block_to) of the layer.
+ *  cur must be a buffer of bufsize bytes. */
+static void layerItInit(bfs_layer_it_t *it, const bfs_layer_t *layer,
+                        long block_from, long block_to,
+                        int bufsize, unsigned char *cur)
+{
+    it->layer = layer;
+    it->bufsize = bufsize;
+    it->cur = cur;
+    it->pos = it->end = 0;
+    if (block_from < block_to && block_from < layer->block_size){
+        it->pos = layer->block[block_from];
+        it->end = layer->size;
+        if (block_to < layer->block_size)
+            it->end = layer->block[block_to];
+    }
+}
+
+/** Decodes the next state into it->cur. Returns 0 if there are no more
+ *  states. */
+_bor_inline int layerItNext(bfs_layer_it_t *it)
+{
+    const unsigned char *buf = it->layer->buf;
+    int prefix = 0, shift = 0;
+
+    if (it->pos >= it->end)
+        return 0;
+
+    do {
+        prefix |= (buf[it->pos] & 0x7f) << shift;
+        shift += 7;
+    } while (buf[it->pos++] & 0x80);
+
+    memcpy(it->cur + prefix, buf + it->pos, it->bufsize - prefix);
+    it->pos += it->bufsize - prefix;
+    return 1;
+}
+
+
+/*** Expansion of states ***/
+static int stateCmp(const void *a, const void *b, void *bufsize)
+{
+    return memcmp(a, b, *(int *)bufsize);
+}
+
+/** Writes the state resulting from application of the operator on the
+ *  state to the buffer out. state and buf are the unpacked and packed
+ *  variant of the same state. */
+static void applyOp(bfs_th_t *th, const plan_op_t *op,
+                    const plan_state_t *state, const unsigned char *buf,
+                    unsigned char *out)
+{
+    const plan_state_packer_t *packer = th->bfs->packer;
+    int i;
+
+    if (op->cond_eff_size == 0 && op->eff->bufsize > 0){
+        memcpy(out, buf, th->bfs->bufsize);
+        planPartStateUpdatePackedState(op->eff, out);
+        return;
+    }
+
+    planStateCopy(th->next, state);
+    planPartStateUpdateState(op->eff, th->next);
+    for (i = 0; i < op->cond_eff_size; ++i){
+        if (planPartStateIsSubsetState(op->cond_eff[i].pre, state))
+            planPartStateUpdateState(op->cond_eff[i].eff, th->next);
+    }
+    bzero(out, th->bfs->bufsize);
+    planStatePackerPack(packer, th->next, out);
+}
+
+_bor_inline int isGoal(const plan_search_bfs_t *bfs,
+                       const unsigned char *buf, plan_state_t *tmp)
+{
+    const plan_part_state_t *goal = bfs->prob->goal;
+
+    if (goal->bufsize > 0)
+        return planPartStateIsSubsetPackedState(goal, buf);
+    planStatePackerUnpack(bfs->packer, buf, tmp);
+    return planPartStateIsSubsetState(goal, tmp);
+}
+
+_bor_inline unsigned char *succNext(bfs_th_t *th)
+{
+    int bufsize = th->bfs->bufsize;
+
+    if (th->succ_size == th->succ_alloc){
+        th->succ_alloc = BOR_MAX(2 * th->succ_alloc, 1024);
+        th->succ = BOR_REALLOC_ARR(th->succ, unsigned char,
+                                   th->succ_alloc * bufsize);
+    }
+    return th->succ + th->succ_size * bufsize;
+}
+
+/** Expands all states from the assigned blocks of the last layer */
+static void thExpand(bfs_th_t *th)
+{
+    plan_search_bfs_t *bfs = th->bfs;
+    const bfs_layer_t *layer = bfs->layer + bfs->layer_size - 1;
+    bfs_layer_it_t it;
+    unsigned char *succ;
+    int i, op_size;
+
+    layerItInit(&it, layer, th->block_from, th->block_to,
+                bfs->bufsize, th->cur);
+    while (layerItNext(&it)){
+        planStatePackerUnpack(bfs->packer, th->cur, th->state);
+        op_size = planSuccGenFind(bfs->search.succ_gen, th->state,
+                                  th->op, bfs->prob->op_size);
+        ++th->expanded;
+
+        for (i = 0; i < op_size; ++i){
+            succ = succNext(th);
+            applyOp(th, th->op[i], th->state, th->cur, succ);
+            ++th->generated;
+
+            if (!th->goal && isGoal(bfs, succ, th->next)){
+                th->goal = 1;
+                memcpy(th->goal_state, succ, bfs->bufsize);
+                memcpy(th->goal_parent, th->cur, bfs->bufsize);
+                th->goal_op = th->op[i];
+                if (!bfs->count_reachable)
+                    return;
+            }
+
+            ++th->succ_size;
+        }
+    }
+}
+
+/** Sorts generated states and removes duplicates among them */
+static void thSortUnique(bfs_th_t *th)
+{
+    int bufsize = th->bfs->bufsize;
+    long i, ins;
+
+    if (th->succ_size == 0)
+        return;
+
+    qsort_r(th->succ, th->succ_size, bufsize, stateCmp, &bufsize);
+    for (i = 1, ins = 1; i < th->succ_size; ++i){
+        if (memcmp(th->succ + (ins - 1) * bufsize,
+                   th->succ + i * bufsize, bufsize) != 0){
+            if (ins != i){
+                memcpy(th->succ + ins * bufsize,
+                       th->succ + i * bufsize, bufsize);
+            }
+            ++ins;
+        }
+    }
+    th->succ_size = ins;
+}
+
+/** Returns the first state of the block. The first state of each block
+ *  is stored with zero-length prefix, i.e., it is a single zero byte
+ *  followed by the whole state. */
+_bor_inline const unsigned char *layerBlockState(const bfs_layer_t *layer,
+                                                 long block)
+{
+    return layer->buf + layer->block[block] + 1;
+}
+
+/** Returns the last block in [from, block_size) starting with a state that
+ *  is not greater than the given state, or from if there is no such
+ *  block. */
+static long layerFindBlock(const bfs_layer_t *layer, long from,
+                           const unsigned char *state, int bufsize)
+{
+    long lo = from, hi = layer->block_size - 1, mid;
+
+    while (lo < hi){
+        mid = (lo + hi + 1) / 2;
+        if (memcmp(layerBlockState(layer, mid), state, bufsize) <= 0){
+            lo = mid;
+        }else{
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+/** Marks states from .succ that are in the layer. Both .succ and the
+ *  layer are sorted, so the layer is decoded sequentially, but whenever
+ *  the iterator enters a new block and the current successor lies behind
+ *  the following block, it jumps directly to the block that may contain
+ *  the successor. Therefore only the blocks containing some successors
+ *  are decoded. */
+static void thMarkDuplicates(bfs_th_t *th, const bfs_layer_t *layer,
+                             char *dup)
+{
+    int bufsize = th->bfs->bufsize;
+    const unsigned char *s;
+    bfs_layer_it_t it;
+    long i, block;
+    int cmp, has;
+
+    if (layer->num_states == 0)
+        return;
+
+    // The whole layer is outside the range of successors
+    if (memcmp(th->succ + (th->succ_size - 1) * bufsize,
+               layerBlockState(layer, 0), bufsize) < 0
+            || memcmp(th->succ, layer->last, bufsize) > 0){
+        return;
+    }
+
+    block = layerFindBlock(layer, 0, th->succ, bufsize);
+    layerItInit(&it, layer, block, layer->block_size, bufsize, th->cur);
+    has = layerItNext(&it);
+    for (i = 0; i < th->succ_size && has; ++i){
+        s = th->succ + i * bufsize;
+        while ((cmp = memcmp(th->cur, s, bufsize)) < 0){
+            if (block + 1 < layer->block_size
+                    && it.pos == layer->block[block + 1]){
+                ++block;
+                if (block + 1 < layer->block_size
+                        && memcmp(layerBlockState(layer, block + 1),
+                                  s, bufsize) <= 0){
+                    block = layerFindBlock(layer, block + 1, s, bufsize);
+                    layerItInit(&it, layer, block, layer->block_size,
+                                bufsize, th->cur);
+                }
+            }
+            if (!(has = layerItNext(&it)))
+                break;
+        }
+        if (cmp == 0)
+            dup[i] = 1;
+    }
+}
+
+/** Removes generated states that are already in any of the previous
+ *  layers. */
+static void thRemoveDuplicates(bfs_th_t *th)
+{
+    plan_search_bfs_t *bfs = th->bfs;
+    int bufsize = bfs->bufsize;
+    char *dup;
+    long i, ins;
+    int li;
+
+    if (th->succ_size == 0)
+        return;
+
+    dup = BOR_CALLOC_ARR(char, th->succ_size);
+    for (li = 0; li < bfs->layer_size; ++li)
+        thMarkDuplicates(th, bfs->layer + li, dup);
+
+    for (i = 0, ins = 0; i < th->succ_size; ++i){
+        if (dup[i])
+            continue;
+        if (ins != i){
+            memcpy(th->succ + ins * bufsize, th->succ + i * bufsize, bufsize);
+        }
+        ++ins;
+    }
+    th->succ_size = ins;
+    BOR_FREE(dup);
+}
+
+static void thRun(bfs_th_t *th)
+{
+    thExpand(th);
+    if (th->goal && !th->bfs->count_reachable)
+        return;
+    thSortUnique(th);
+    thRemoveDuplicates(th);
+}
+
+static void thTask(int id, void *data, const bor_tasks_thinfo_t *_)
+{
+    thRun((bfs_th_t *)data);
+}
+
+/** Merges sorted states of all threads into a new layer */
+static void mergeLayer(plan_search_bfs_t *bfs, bfs_layer_t *layer)
+{
+    int bufsize = bfs->bufsize;
+    long pos[bfs->num_threads];
+    const unsigned char *min, *s;
+    int i, min_th;
+
+    bzero(pos, sizeof(long) * bfs->num_threads);
+    while (1){
+        min = NULL;
+        min_th = -1;
+        for (i = 0; i < bfs->num_threads; ++i){
+            if (pos[i] >= bfs->th[i].succ_size)
+                continue;
+            s = bfs->th[i].succ + pos[i] * bufsize;
+            if (min == NULL || memcmp(s, min, bufsize) < 0){
+                min = s;
+                min_th = i;
+            }
+        }
+        if (min == NULL)
+            break;
+
+        // The same state can be generated by several threads
+        if (layer->num_states == 0
+                || memcmp(layer->last, min, bufsize) != 0){
+            layerPush(layer, min, bufsize);
+        }
+        ++pos[min_th];
+    }
+    layerFinalize(layer);
+}
+
+
+/*** Plan reconstruction ***/
+/** Finds a state in the layer and an operator leading from that state to
+ *  the state target. The found state is written to target. */
+static plan_op_t *findPredecessor(plan_search_bfs_t *bfs, int layer_id,
+                                  unsigned char *target)
+{
+    bfs_th_t *th = bfs->th;
+    bfs_layer_it_t it;
+    unsigned char succ[bfs->bufsize];
+    int i, op_size;
+
+    layerItInit(&it, bfs->layer + layer_id, 0,
+                bfs->layer[layer_id].block_size, bfs->bufsize, th->cur);
+    while (layerItNext(&it)){
+        planStatePackerUnpack(bfs->packer, th->cur, th->state);
+        op_size = planSuccGenFind(bfs->search.succ_gen, th->state,
+                                  th->op, bfs->prob->op_size);
+        for (i = 0; i < op_size; ++i){
+            applyOp(th, th->op[i], th->state, th->cur, succ);
+            if (memcmp(succ, target, bfs->bufsize) == 0){
+                memcpy(target, th->cur, bfs->bufsize);
+                return th->op[i];
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/** Reconstructs path from the initial state to the found goal state and
+ *  stores it in the state space so that it can be extracted the same way
+ *  as for the other searches. */
+static int extractPlan(plan_search_bfs_t *bfs)
+{
+    plan_search_t *search = &bfs->search;
+    plan_state_space_node_t *node, *parent_node;
+    plan_op_t **ops;
+    unsigned char target[bfs->bufsize];
+    plan_state_id_t state_id, next_state;
+    int i, len;
+
+    // The initial state itself is the goal
+    if (bfs->goal_layer < 0){
+        search->goal_state = search->initial_state;
+        return PLAN_SEARCH_FOUND;
+    }
+
+    len = bfs->goal_layer + 1;
+    ops = BOR_ALLOC_ARR(plan_op_t *, len);
+    ops[len - 1] = bfs->goal_op;
+    memcpy(target, bfs->goal_parent, bfs->bufsize);
+    for (i = bfs->goal_layer - 1; i >= 0; --i){
+        ops[i] = findPredecessor(bfs, i, target);
+        if (ops[i] == NULL){
+            fprintf(stderr, "Search Error: BFS could not reconstruct the"
+                            " plan.\n");
+            BOR_FREE(ops);
+            return PLAN_SEARCH_NOT_FOUND;
+        }
+    }
+
+    state_id = search->initial_state;
+    node = planStateSpaceNode(search->state_space, state_id);
+    node->parent_state_id = PLAN_NO_STATE;
+    node->op = NULL;
+    node->cost = 0;
+    for (i = 0; i < len; ++i){
+        next_state = planOpApply(ops[i], search->state_pool, state_id);
+        parent_node = planStateSpaceNode(search->state_space, state_id);
+        node = planStateSpaceNode(search->state_space, next_state);
+        node->parent_state_id = state_id;
+        node->op = ops[i];
+        node->cost = parent_node->cost + ops[i]->cost;
+        state_id = next_state;
+    }
+    search->goal_state = state_id;
+
+    BOR_FREE(ops);
+    return PLAN_SEARCH_FOUND;
+}
+
+
+static int planSearchBFSInit(plan_search_t *search)
+{
+    plan_search_bfs_t *bfs = SEARCH_FROM_PARENT(search);
+    plan_state_space_node_t *node;
+    unsigned char buf[bfs->bufsize];
+    bfs_layer_t *layer;
+
+    node = planStateSpaceNode(search->state_space, search->initial_state);
+    node->parent_state_id = PLAN_NO_STATE;
+    node->op = NULL;
+    node->cost = 0;
+
+    bzero(buf, bfs->bufsize);
+    planStatePoolGetState(search->state_pool, search->initial_state,
+                          search->state);
+    planStatePackerPack(bfs->packer, search->state, buf);
+
+    layer = layerAdd(bfs);
+    layerPush(layer, buf, bfs->bufsize);
+    layerFinalize(layer);
+    bfs->reachable = 1;
+    planSearchStatIncGeneratedStates(&search->stat);
+
+    if (_planSearchCheckGoal(search, node)){
+        if (!bfs->count_reachable)
+            return PLAN_SEARCH_FOUND;
+        bfs->goal = 1;
+        bfs->goal_layer = -1;
+    }
+    return PLAN_SEARCH_CONT;
+}
+
+static int planSearchBFSStep(plan_search_t *search)
+{
+    plan_search_bfs_t *bfs = SEARCH_FROM_PARENT(search);
+    bfs_layer_t *layer;
+    bfs_th_t *th;
+    bor_tasks_t *tasks;
+    long num_blocks;
+    int i;
+
+    layer = bfs->layer + bfs->layer_size - 1;
+    // Split blocks of the last layer between threads
+    num_blocks = layer->block_size;
+    for (i = 0; i < bfs->num_threads; ++i){
+        th = bfs->th + i;
+        th->block_from = (num_blocks * i) / bfs->num_threads;
+        th->block_to = (num_blocks * (i + 1)) / bfs->num_threads;
+        th->succ_size = 0;
+        th->expanded = th->generated = 0;
+        th->goal = 0;
+    }
+
+    if (bfs->num_threads == 1){
+        thRun(bfs->th);
+    }else{
+        tasks = borTasksNew(bfs->num_threads);
+        for (i = 0; i < bfs->num_threads; ++i)
+            borTasksAdd(tasks, thTask, i, bfs->th + i);
+        borTasksRun(tasks);
+        borTasksDel(tasks);
+    }
+
+    for (i = 0; i < bfs->num_threads; ++i){
+        th = bfs->th + i;
+        search->stat.expanded_states += th->expanded;
+        search->stat.generated_states += th->generated;
+
+        if (th->goal && !bfs->goal){
+            bfs->goal = 1;
+            bfs->goal_layer = bfs->layer_size - 1;
+            memcpy(bfs->goal_state, th->goal_state, bfs->bufsize);
+            memcpy(bfs->goal_parent, th->goal_parent, bfs->bufsize);
+            bfs->goal_op = th->goal_op;
+        }
+    }
+
+    if (bfs->goal && !bfs->count_reachable)
+        return extractPlan(bfs);
+
+    layer = layerAdd(bfs);
+    mergeLayer(bfs, layer);
+    planSearchStatUpdatePeakMemory(&search->stat);
+    planSearchStatSetOpen(&search->stat, layer->num_states);
+
+    // No new state was found, i.e., the whole reachable state space was
+    // explored
+    if (layer->num_states == 0){
+        layerFree(layer);
+        --bfs->layer_size;
+        if (bfs->goal)
+            return extractPlan(bfs);
+        return PLAN_SEARCH_NOT_FOUND;
+    }
+
+    bfs->reachable += layer->num_states;
+    return PLAN_SEARCH_CONT;
+}
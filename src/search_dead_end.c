@@ -0,0 +1,254 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+#include <boruvka/alloc.h>
+
+#include "search_dead_end.h"
+
+plan_search_dead_end_t *planSearchDeadEndNew(const plan_problem_t *prob)
+{
+    plan_search_dead_end_t *de;
+
+    de = BOR_ALLOC(plan_search_dead_end_t);
+    de->var = prob->var;
+    de->var_size = prob->var_size;
+    planFactOpCrossRefInit(&de->cr, prob->var, prob->var_size, prob->goal,
+                           prob->op, prob->op_size, 0);
+
+    de->op_unsat = BOR_ALLOC_ARR(int, de->cr.op_size);
+    de->fact_reached = BOR_ALLOC_ARR(char, de->cr.fact_size);
+    de->queue = BOR_ALLOC_ARR(int, de->cr.fact_size);
+    de->var_free = BOR_ALLOC_ARR(char, de->var_size);
+
+    de->fact_conflict = BOR_ALLOC_ARR(plan_arr_int_t, de->cr.fact_size);
+    bzero(de->fact_conflict, sizeof(plan_arr_int_t) * de->cr.fact_size);
+    de->conflict_alloc = 64;
+    de->conflict_size = BOR_ALLOC_ARR(int, de->conflict_alloc);
+    de->conflict_hit = BOR_CALLOC_ARR(int, de->conflict_alloc);
+    de->unsolvable = 0;
+
+    de->conflicts = 0;
+    de->pruned = 0;
+    return de;
+}
+
+void planSearchDeadEndDel(plan_search_dead_end_t *de)
+{
+    int i;
+
+    for (i = 0; i < de->cr.fact_size; ++i)
+        planArrIntFree(de->fact_conflict + i);
+    BOR_FREE(de->fact_conflict);
+    BOR_FREE(de->conflict_size);
+    BOR_FREE(de->conflict_hit);
+
+    BOR_FREE(de->op_unsat);
+    BOR_FREE(de->fact_reached);
+    BOR_FREE(de->queue);
+    BOR_FREE(de->var_free);
+    planFactOpCrossRefFree(&de->cr);
+    BOR_FREE(de);
+}
+
+int planSearchDeadEndCheck(plan_search_dead_end_t *de,
+                           const plan_state_t *state)
+{
+    const plan_arr_int_t *confs;
+    int var, fact_id, conf_id, found = 0;
+
+    if (de->unsolvable){
+        ++de->pruned;
+        return 1;
+    }
+    if (de->conflicts == 0)
+        return 0;
+
+    for (var = 0; var < de->var_size; ++var){
+        fact_id = planFactIdVar(&de->cr.fact_id, var,
+                                planStateGet(state, var));
+        if (fact_id < 0)
+            continue;
+
+        confs = de->fact_conflict + fact_id;
+        PLAN_ARR_INT_FOR_EACH(confs, conf_id){
+            if (++de->conflict_hit[conf_id] == de->conflict_size[conf_id])
+                found = 1;
+        }
+    }
+
+    // Reset the counters for the next call
+    for (var = 0; var < de->var_size; ++var){
+        fact_id = planFactIdVar(&de->cr.fact_id, var,
+                                planStateGet(state, var));
+        if (fact_id < 0)
+            continue;
+
+        confs = de->fact_conflict + fact_id;
+        PLAN_ARR_INT_FOR_EACH(confs, conf_id)
+            de->conflict_hit[conf_id] = 0;
+    }
+
+    if (found)
+        ++de->pruned;
+    return found;
+}
+
+_bor_inline void reachFact(plan_search_dead_end_t *de, int fact_id,
+                           int *queue_size)
+{
+    if (fact_id < 0 || de->fact_reached[fact_id])
+        return;
+    de->fact_reached[fact_id] = 1;
+    de->queue[(*queue_size)++] = fact_id;
+}
+
+_bor_inline void reachOp(plan_search_dead_end_t *de, int op_id,
+                         int *queue_size)
+{
+    int fact_id;
+
+    PLAN_ARR_INT_FOR_EACH(de->cr.op_eff + op_id, fact_id)
+        reachFact(de, fact_id, queue_size);
+}
+
+/** Computes relaxed reachable facts from the state where all values of
+ *  free variables are considered as reached. Returns true if the goal is
+ *  reachable. */
+static int reachGoal(plan_search_dead_end_t *de, const plan_state_t *state)
+{
+    int i, var, val, op_id, fact_id, queue_size = 0;
+
+    bzero(de->fact_reached, sizeof(char) * de->cr.fact_size);
+    for (i = 0; i < de->cr.op_size; ++i)
+        de->op_unsat[i] = de->cr.op_pre[i].size;
+
+    for (var = 0; var < de->var_size; ++var){
+        if (de->var_free[var]){
+            for (val = 0; val < de->var[var].range; ++val)
+                reachFact(de, planFactIdVar(&de->cr.fact_id, var, val),
+                          &queue_size);
+        }else{
+            reachFact(de, planFactIdVar(&de->cr.fact_id, var,
+                                        planStateGet(state, var)),
+                      &queue_size);
+        }
+    }
+    reachFact(de, de->cr.fake_pre[0].fact_id, &queue_size);
+    for (i = 0; i < de->cr.op_size; ++i){
+        if (de->op_unsat[i] == 0)
+            reachOp(de, i, &queue_size);
+    }
+
+    for (i = 0; i < queue_size && !de->fact_reached[de->cr.goal_id]; ++i){
+        fact_id = de->queue[i];
+        PLAN_ARR_INT_FOR_EACH(de->cr.fact_pre + fact_id, op_id){
+            if (--de->op_unsat[op_id] == 0)
+                reachOp(de, op_id, &queue_size);
+        }
+    }
+
+    return de->fact_reached[de->cr.goal_id];
+}
+
+/** Returns true if all values of the variable are reached */
+static int varReached(const plan_search_dead_end_t *de, int var)
+{
+    int val, fact_id;
+
+    for (val = 0; val < de->var[var].range; ++val){
+        fact_id = planFactIdVar(&de->cr.fact_id, var, val);
+        if (fact_id >= 0 && !de->fact_reached[fact_id])
+            return 0;
+    }
+    return 1;
+}
+
+static void addConflict(plan_search_dead_end_t *de, const plan_state_t *state)
+{
+    int var, fact_id, conf_id, size;
+
+    conf_id = de->conflicts;
+    if (conf_id == de->conflict_alloc){
+        de->conflict_alloc *= 2;
+        de->conflict_size = BOR_REALLOC_ARR(de->conflict_size, int,
+                                            de->conflict_alloc);
+        de->conflict_hit = BOR_REALLOC_ARR(de->conflict_hit, int,
+                                           de->conflict_alloc);
+        bzero(de->conflict_hit + conf_id,
+              sizeof(int) * (de->conflict_alloc - conf_id));
+    }
+
+    size = 0;
+    for (var = 0; var < de->var_size; ++var){
+        if (de->var_free[var])
+            continue;
+        fact_id = planFactIdVar(&de->cr.fact_id, var,
+                                planStateGet(state, var));
+        if (fact_id < 0)
+            continue;
+        planArrIntAdd(de->fact_conflict + fact_id, conf_id);
+        ++size;
+    }
+
+    de->conflict_size[conf_id] = size;
+    ++de->conflicts;
+    if (size == 0)
+        de->unsolvable = 1;
+}
+
+void planSearchDeadEndLearn(plan_search_dead_end_t *de,
+                            const plan_state_t *state)
+{
+    int var, changed;
+
+    bzero(de->var_free, sizeof(char) * de->var_size);
+    if (reachGoal(de, state))
+        return;
+
+    // Greedily free variables while the goal remains unreachable.
+    // Variables whose all values are already reached can be freed without
+    // changing the set of reachable facts.
+    changed = 0;
+    for (var = 0; var < de->var_size; ++var){
+        if (!changed && varReached(de, var)){
+            de->var_free[var] = 1;
+            continue;
+        }
+
+        de->var_free[var] = 1;
+        if (reachGoal(de, state)){
+            de->var_free[var] = 0;
+            changed = 1;
+        }else{
+            changed = 0;
+        }
+    }
+
+    // Recompute the reachable facts of the final conflict and free the
+    // remaining variables that are fully reached.
+    if (changed)
+        reachGoal(de, state);
+    for (var = 0; var < de->var_size; ++var){
+        if (!de->var_free[var] && varReached(de, var))
+            de->var_free[var] = 1;
+    }
+
+    addConflict(de, state);
+}
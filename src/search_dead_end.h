@@ -0,0 +1,90 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+#ifndef __PLAN_SEARCH_DEAD_END_H__
+#define __PLAN_SEARCH_DEAD_END_H__
+
+#include "plan/search.h"
+#include "fact_op_cross_ref.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Dead-end learning.
+ *
+ * Each dead end reported by the heuristic is checked by relaxed
+ * reachability and, if the goal is not relaxed-reachable, it is
+ * generalized to a partial state (conflict) such that every state
+ * containing the conflict is a dead end as well. The generalization
+ * greedily frees variables (i.e., all their values are assumed to be
+ * reachable) as long as the goal stays unreachable. States are matched
+ * against the stored conflicts before the heuristic is called.
+ */
+struct _plan_search_dead_end_t {
+    const plan_var_t *var;       /*!< Variables of the problem */
+    int var_size;                /*!< Number of variables */
+    plan_fact_op_cross_ref_t cr; /*!< Fact/operator cross reference */
+
+    int *op_unsat;      /*!< Number of unsatisfied preconditions */
+    char *fact_reached; /*!< Marks relaxed reachable facts */
+    int *queue;         /*!< Queue of reached facts */
+    char *var_free;     /*!< Marks variables freed in generalization */
+
+    plan_arr_int_t *fact_conflict; /*!< Conflicts containing the fact */
+    int *conflict_size;  /*!< Number of facts of each conflict */
+    int *conflict_hit;   /*!< Number of matched facts (during matching) */
+    int conflict_alloc;
+    int unsolvable;      /*!< True if the empty conflict was learned */
+
+    long conflicts; /*!< Number of learned conflicts */
+    long pruned;    /*!< Number of states matched by a conflict */
+};
+
+/**
+ * Creates a dead-end store for the given problem.
+ */
+plan_search_dead_end_t *planSearchDeadEndNew(const plan_problem_t *prob);
+
+/**
+ * Deletes the object.
+ */
+void planSearchDeadEndDel(plan_search_dead_end_t *de);
+
+/**
+ * Returns true if the state contains any of the learned conflicts, i.e.,
+ * it is a dead end.
+ */
+int planSearchDeadEndCheck(plan_search_dead_end_t *de,
+                           const plan_state_t *state);
+
+/**
+ * Learns a conflict from the state the heuristic marked as a dead end.
+ * Nothing is learned if the goal is relaxed-reachable from the state.
+ */
+void planSearchDeadEndLearn(plan_search_dead_end_t *de,
+                            const plan_state_t *state);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __PLAN_SEARCH_DEAD_END_H__ */
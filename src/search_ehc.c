@@ -17,14 +17,84 @@
  * See the License for more information.
  */
 
+#include <pthread.h>
 #include <boruvka/alloc.h>
 
 #include "plan/search.h"
 #include "search_lazy_base.h"
 
+/**
+ * Number of states per thread evaluated at once in the layered
+ * improvement search. After each chunk the states are checked for an
+ * improvement so that the rest of the layer need not be evaluated.
+ */
+#define EHC_CHUNK_PER_THREAD 32
+
+struct _plan_search_ehc_t;
+
+/**
+ * Node of a layer of the layered improvement search.
+ */
+struct _ehc_node_t {
+    plan_state_id_t state_id;
+    plan_cost_t heur; /*!< Heuristic value */
+    plan_op_t **op;   /*!< Operators that will be used for expansion */
+    int op_size;
+};
+typedef struct _ehc_node_t ehc_node_t;
+
+/**
+ * Layer of the improvement search.
+ */
+struct _ehc_layer_t {
+    ehc_node_t *node;
+    int size;
+    int alloc;
+};
+typedef struct _ehc_layer_t ehc_layer_t;
+
+/**
+ * Worker evaluating a part of a chunk of a layer.
+ */
+struct _ehc_th_t {
+    struct _plan_search_ehc_t *ehc;
+    plan_heur_t *heur;   /*!< Heuristic owned by this thread */
+    plan_state_t *state; /*!< Preallocated state */
+    plan_search_applicable_ops_t app_ops;
+    ehc_node_t *node;    /*!< Nodes that ought to be evaluated */
+    int node_size;
+    long evaluated;
+    pthread_t thread;    /*!< Thread of the worker (except the first one) */
+    long round;          /*!< The last round evaluated by the worker */
+};
+typedef struct _ehc_th_t ehc_th_t;
+
+/**
+ * Pool of threads of the workers. The threads are created once with the
+ * search and they wait for the next round of evaluation. The first
+ * worker always runs in the search thread.
+ */
+struct _ehc_pool_t {
+    pthread_mutex_t lock;
+    pthread_cond_t start; /*!< Signals a new round or termination */
+    pthread_cond_t done;  /*!< Signals that all workers are finished */
+    long round;           /*!< Number of the current round */
+    int running;          /*!< Number of workers evaluating the round */
+    int quit;             /*!< True if the threads should terminate */
+};
+typedef struct _ehc_pool_t ehc_pool_t;
+
 struct _plan_search_ehc_t {
     plan_search_lazy_base_t lazy;
     plan_cost_t best_heur;  /*!< Value of the best heuristic value found so far */
+
+    ehc_th_t *th;       /*!< Workers of the layered improvement search */
+    int th_size;
+    int th_parallel;    /*!< True if the workers can run in parallel */
+    ehc_pool_t pool;    /*!< Threads of the workers */
+    int pool_started;   /*!< True if the threads of .pool are running */
+    ehc_layer_t layer;  /*!< The current layer */
+    ehc_layer_t next;   /*!< The next layer */
 };
 typedef struct _plan_search_ehc_t plan_search_ehc_t;
 
@@ -39,6 +109,17 @@ static void planSearchEHCDel(plan_search_t *_ehc);
 static int planSearchEHCInit(plan_search_t *);
 /** Performes one step in the algorithm. */
 static int planSearchEHCStep(plan_search_t *);
+/** Initializes the layered variant of the search. */
+static int planSearchEHCLayerInit(plan_search_t *);
+/** Performes one step of the layered variant, i.e., finds one improving
+ *  state. */
+static int planSearchEHCLayerStep(plan_search_t *);
+/** Returns memory allocated by the lazy list and the layers */
+static size_t planSearchEHCMemUsage(const plan_search_t *);
+/** Starts threads of all workers but the first one */
+static void poolStart(plan_search_ehc_t *ehc);
+/** Terminates the threads of the workers */
+static void poolStop(plan_search_ehc_t *ehc);
 
 
 void planSearchEHCParamsInit(plan_search_ehc_params_t *p)
@@ -50,15 +131,48 @@ void planSearchEHCParamsInit(plan_search_ehc_params_t *p)
 plan_search_t *planSearchEHCNew(const plan_search_ehc_params_t *params)
 {
     plan_search_ehc_t *ehc;
+    plan_search_params_t search_params;
+    const plan_problem_t *prob = params->search.prob;
+    int i, layered;
+
+    layered = (params->thread_heur != NULL && params->thread_heur_size > 0);
+
+    // Applicable operators are computed by the workers in the layered
+    // variant and the pruning is not thread-safe.
+    search_params = params->search;
+    if (layered && search_params.stubborn){
+        fprintf(stderr, "Search Warning: Strong stubborn sets are not"
+                        " supported by the parallel EHC. Pruning is"
+                        " disabled.\n");
+        search_params.stubborn = 0;
+    }
+
+    // The same holds for heuristic values and the dead-end store.
+    if (layered && search_params.dead_end){
+        fprintf(stderr, "Search Warning: Dead-end learning is not"
+                        " supported by the parallel EHC. It is"
+                        " disabled.\n");
+        search_params.dead_end = 0;
+    }
 
     ehc = BOR_ALLOC(plan_search_ehc_t);
 
-    _planSearchInit(&ehc->lazy.search, &params->search,
-                    planSearchEHCDel,
-                    planSearchEHCInit,
-                    planSearchEHCStep,
-                    planSearchLazyBaseInsertNode,
-                    NULL);
+    if (layered){
+        _planSearchInit(&ehc->lazy.search, &search_params,
+                        planSearchEHCDel,
+                        planSearchEHCLayerInit,
+                        planSearchEHCLayerStep,
+                        NULL, NULL,
+                        planSearchEHCMemUsage);
+    }else{
+        _planSearchInit(&ehc->lazy.search, &search_params,
+                        planSearchEHCDel,
+                        planSearchEHCInit,
+                        planSearchEHCStep,
+                        planSearchLazyBaseInsertNode,
+                        NULL,
+                        planSearchEHCMemUsage);
+    }
 
     // Note that lazy-fifo list ignores cost during insertion
     planSearchLazyBaseInit(&ehc->lazy, planListLazyFifoNew(), 1,
@@ -66,12 +180,100 @@ plan_search_t *planSearchEHCNew(const plan_search_ehc_params_t *params)
 
     ehc->best_heur = PLAN_COST_MAX;
 
+    ehc->th = NULL;
+    ehc->th_size = 0;
+    ehc->th_parallel = 0;
+    bzero(&ehc->layer, sizeof(ehc->layer));
+    bzero(&ehc->next, sizeof(ehc->next));
+    if (layered){
+        ehc->th_size = params->thread_heur_size;
+        ehc->th = BOR_CALLOC_ARR(ehc_th_t, ehc->th_size);
+        ehc->th_parallel = 1;
+        for (i = 0; i < ehc->th_size; ++i){
+            ehc->th[i].ehc = ehc;
+            ehc->th[i].heur = params->thread_heur[i];
+            ehc->th[i].state = planStateNew(prob->var_size);
+            planSearchApplicableOpsInit(&ehc->th[i].app_ops, prob->op_size);
+
+            // Heuristics computed from the search state space (or in
+            // cooperation with other agents) must be called from the
+            // main thread.
+            if (ehc->th[i].heur->heur_node_fn != NULL
+                    || ehc->th[i].heur->ma)
+                ehc->th_parallel = 0;
+        }
+        if (search_params.heur->heur_node_fn != NULL
+                || search_params.heur->ma)
+            ehc->th_parallel = 0;
+
+        if (!ehc->th_parallel){
+            fprintf(stderr, "Search Warning: The heuristic must be computed"
+                            " in the search thread. The parallel EHC"
+                            " evaluates states sequentially.\n");
+        }
+    }
+
+    ehc->pool_started = 0;
+    if (layered && ehc->th_parallel && ehc->th_size > 1)
+        poolStart(ehc);
+
     return &ehc->lazy.search;
 }
 
+static void layerFree(ehc_layer_t *layer)
+{
+    int i;
+
+    for (i = 0; i < layer->size; ++i){
+        if (layer->node[i].op)
+            BOR_FREE(layer->node[i].op);
+    }
+    if (layer->node)
+        BOR_FREE(layer->node);
+    bzero(layer, sizeof(*layer));
+}
+
+static size_t layerMemUsage(const ehc_layer_t *layer)
+{
+    size_t size;
+    int i;
+
+    size = sizeof(ehc_node_t) * layer->alloc;
+    for (i = 0; i < layer->size; ++i)
+        size += sizeof(plan_op_t *) * layer->node[i].op_size;
+    return size;
+}
+
+static size_t planSearchEHCMemUsage(const plan_search_t *search)
+{
+    plan_search_ehc_t *ehc = EHC(search);
+    size_t size;
+
+    size  = planSearchLazyBaseMemUsage(search);
+    size += sizeof(*ehc) - sizeof(ehc->lazy);
+    size += sizeof(ehc_th_t) * ehc->th_size;
+    size += layerMemUsage(&ehc->layer);
+    size += layerMemUsage(&ehc->next);
+    return size;
+}
+
 static void planSearchEHCDel(plan_search_t *_ehc)
 {
     plan_search_ehc_t *ehc = EHC(_ehc);
+    int i;
+
+    if (ehc->pool_started)
+        poolStop(ehc);
+    for (i = 0; i < ehc->th_size; ++i){
+        if (ehc->lazy.search.heur_del)
+            planHeurDel(ehc->th[i].heur);
+        planStateDel(ehc->th[i].state);
+        planSearchApplicableOpsFree(&ehc->th[i].app_ops);
+    }
+    if (ehc->th)
+        BOR_FREE(ehc->th);
+    layerFree(&ehc->layer);
+    layerFree(&ehc->next);
 
     _planSearchFree(&ehc->lazy.search);
     planSearchLazyBaseFree(&ehc->lazy);
@@ -100,6 +302,7 @@ static int planSearchEHCStep(plan_search_t *search)
         // EHC algorithm with an empty list.
         if (cur_node->heuristic < ehc->best_heur){
             planListLazyClear(ehc->lazy.list);
+            planSearchStatSetOpen(&ehc->lazy.search.stat, 0);
             ehc->best_heur = cur_node->heuristic;
         }
         planSearchLazyBaseExpand(&ehc->lazy, cur_node);
@@ -107,3 +310,376 @@ static int planSearchEHCStep(plan_search_t *search)
 
     return PLAN_SEARCH_CONT;
 }
+
+
+
+/*** Layered improvement search ***/
+/** Removes all nodes from the layer */
+static void layerReset(ehc_layer_t *layer)
+{
+    int i;
+
+    for (i = 0; i < layer->size; ++i){
+        if (layer->node[i].op)
+            BOR_FREE(layer->node[i].op);
+    }
+    layer->size = 0;
+}
+
+static ehc_node_t *layerAdd(ehc_layer_t *layer, plan_state_id_t state_id)
+{
+    ehc_node_t *node;
+
+    if (layer->size == layer->alloc){
+        layer->alloc = BOR_MAX(2 * layer->alloc, 16);
+        layer->node = BOR_REALLOC_ARR(layer->node, ehc_node_t,
+                                      layer->alloc);
+    }
+    node = layer->node + layer->size++;
+    node->state_id = state_id;
+    node->heur = PLAN_HEUR_DEAD_END;
+    node->op = NULL;
+    node->op_size = 0;
+    return node;
+}
+
+/** Stores operators that will be used for expansion of the node */
+static void nodeSetOps(plan_search_ehc_t *ehc, ehc_node_t *node,
+                       const plan_search_applicable_ops_t *app_ops)
+{
+    node->op_size = app_ops->op_found;
+    if (ehc->lazy.use_preferred_ops == PLAN_SEARCH_PREFERRED_ONLY)
+        node->op_size = app_ops->op_preferred;
+
+    node->op = NULL;
+    if (node->op_size > 0){
+        node->op = BOR_ALLOC_ARR(plan_op_t *, node->op_size);
+        memcpy(node->op, app_ops->op, sizeof(plan_op_t *) * node->op_size);
+    }
+}
+
+/** Evaluates all nodes assigned to the worker */
+static void thEval(ehc_th_t *th)
+{
+    plan_search_ehc_t *ehc = th->ehc;
+    plan_search_t *search = &ehc->lazy.search;
+    plan_heur_res_t res;
+    ehc_node_t *node;
+    int i;
+
+    for (i = 0; i < th->node_size; ++i){
+        node = th->node + i;
+        planStatePoolGetState(search->state_pool, node->state_id, th->state);
+        planSearchApplicableOpsFind(&th->app_ops, th->state, node->state_id,
+                                    search->succ_gen);
+
+        planHeurResInit(&res);
+        if (ehc->lazy.use_preferred_ops){
+            res.pref_op = th->app_ops.op;
+            res.pref_op_size = th->app_ops.op_found;
+        }
+        planHeurState(th->heur, th->state, &res);
+        th->app_ops.op_preferred = res.pref_size;
+        ++th->evaluated;
+
+        node->heur = res.heur;
+        if (node->heur != PLAN_HEUR_DEAD_END)
+            nodeSetOps(ehc, node, &th->app_ops);
+    }
+}
+
+/** Main loop of the thread of a worker */
+static void *thRun(void *data)
+{
+    ehc_th_t *th = (ehc_th_t *)data;
+    ehc_pool_t *pool = &th->ehc->pool;
+
+    while (1){
+        pthread_mutex_lock(&pool->lock);
+        while (pool->round == th->round && !pool->quit)
+            pthread_cond_wait(&pool->start, &pool->lock);
+        if (pool->quit){
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        th->round = pool->round;
+        pthread_mutex_unlock(&pool->lock);
+
+        thEval(th);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->running == 0)
+            pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return NULL;
+}
+
+static void poolStart(plan_search_ehc_t *ehc)
+{
+    ehc_pool_t *pool = &ehc->pool;
+    int i;
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    pool->round = 0;
+    pool->running = 0;
+    pool->quit = 0;
+    for (i = 1; i < ehc->th_size; ++i){
+        ehc->th[i].round = 0;
+        pthread_create(&ehc->th[i].thread, NULL, thRun, ehc->th + i);
+    }
+    ehc->pool_started = 1;
+}
+
+static void poolStop(plan_search_ehc_t *ehc)
+{
+    ehc_pool_t *pool = &ehc->pool;
+    int i;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (i = 1; i < ehc->th_size; ++i)
+        pthread_join(ehc->th[i].thread, NULL);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+    pthread_mutex_destroy(&pool->lock);
+    ehc->pool_started = 0;
+}
+
+/** Evaluates the assigned nodes by all workers, the first worker runs in
+ *  the calling thread */
+static void poolEval(plan_search_ehc_t *ehc)
+{
+    ehc_pool_t *pool = &ehc->pool;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->running = ehc->th_size - 1;
+    ++pool->round;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    thEval(ehc->th);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->running > 0)
+        pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/** Evaluates the node in the main thread using the search's heuristic */
+static int evalNodeSeq(plan_search_ehc_t *ehc, ehc_node_t *node)
+{
+    plan_search_t *search = &ehc->lazy.search;
+    plan_search_applicable_ops_t *pref_ops = NULL;
+    plan_state_space_node_t *sn;
+    int res;
+
+    sn = planStateSpaceNode(search->state_space, node->state_id);
+    _planSearchFindApplicableOps(search, node->state_id);
+    if (ehc->lazy.use_preferred_ops)
+        pref_ops = &search->app_ops;
+    res = _planSearchHeur(search, sn, &node->heur, pref_ops);
+    if (res == PLAN_SEARCH_CONT && node->heur != PLAN_HEUR_DEAD_END)
+        nodeSetOps(ehc, node, &search->app_ops);
+    return res;
+}
+
+/** Computes heuristic values of the given nodes */
+static int evalNodes(plan_search_ehc_t *ehc, ehc_node_t *node, int size)
+{
+    plan_search_t *search = &ehc->lazy.search;
+    int i, from, to, res;
+
+    if (!ehc->th_parallel){
+        for (i = 0; i < size; ++i){
+            res = evalNodeSeq(ehc, node + i);
+            if (res != PLAN_SEARCH_CONT)
+                return res;
+        }
+        return PLAN_SEARCH_CONT;
+    }
+
+    for (i = 0; i < ehc->th_size; ++i){
+        from = (size * i) / ehc->th_size;
+        to = (size * (i + 1)) / ehc->th_size;
+        ehc->th[i].node = node + from;
+        ehc->th[i].node_size = to - from;
+        ehc->th[i].evaluated = 0;
+    }
+
+    if (ehc->th_size == 1){
+        thEval(ehc->th);
+    }else{
+        poolEval(ehc);
+    }
+
+    for (i = 0; i < ehc->th_size; ++i)
+        search->stat.evaluated_states += ehc->th[i].evaluated;
+    for (i = 0; i < size; ++i){
+        if (node[i].heur != PLAN_HEUR_DEAD_END)
+            planSearchStatAddHeur(&search->stat, node[i].heur);
+    }
+    return PLAN_SEARCH_CONT;
+}
+
+/** Restarts the improvement search from the given node */
+static void restart(plan_search_ehc_t *ehc, ehc_node_t *node)
+{
+    ehc_node_t n = *node;
+
+    // The operators are moved to the new layer
+    node->op = NULL;
+    layerReset(&ehc->layer);
+    *layerAdd(&ehc->layer, n.state_id) = n;
+    ehc->best_heur = n.heur;
+}
+
+static int planSearchEHCLayerInit(plan_search_t *search)
+{
+    plan_search_ehc_t *ehc = EHC(search);
+    plan_state_space_node_t *node;
+    ehc_node_t *enode;
+    int res;
+
+    node = planStateSpaceNode(search->state_space, search->initial_state);
+    planStateSpaceOpen(search->state_space, node);
+    planStateSpaceClose(search->state_space, node);
+    node->parent_state_id = PLAN_NO_STATE;
+    node->op = NULL;
+    node->cost = 0;
+
+    if (_planSearchCheckGoal(search, node))
+        return PLAN_SEARCH_FOUND;
+
+    layerReset(&ehc->layer);
+    layerReset(&ehc->next);
+    enode = layerAdd(&ehc->layer, search->initial_state);
+    res = evalNodes(ehc, enode, 1);
+    if (res != PLAN_SEARCH_CONT)
+        return res;
+    node->heuristic = enode->heur;
+    if (enode->heur == PLAN_HEUR_DEAD_END)
+        return PLAN_SEARCH_NOT_FOUND;
+
+    ehc->best_heur = enode->heur;
+    return PLAN_SEARCH_CONT;
+}
+
+/** Expands all nodes of the current layer into the next layer */
+static void expandLayer(plan_search_ehc_t *ehc)
+{
+    plan_search_t *search = &ehc->lazy.search;
+    plan_state_space_node_t *node, *parent;
+    plan_state_id_t state_id;
+    ehc_node_t *enode;
+    int i, j;
+
+    layerReset(&ehc->next);
+    for (i = 0; i < ehc->layer.size; ++i){
+        enode = ehc->layer.node + i;
+        parent = planStateSpaceNode(search->state_space, enode->state_id);
+        _planSearchExpandedNode(search, parent);
+        planSearchStatIncExpandedStates(&search->stat);
+
+        for (j = 0; j < enode->op_size; ++j){
+            state_id = _planSearchNextState(search, enode->op[j],
+                                            enode->state_id);
+            planSearchStatIncGeneratedStates(&search->stat);
+
+            node = planStateSpaceNode(search->state_space, state_id);
+            if (!planStateSpaceNodeIsNew(node))
+                continue;
+
+            // The node stays open until it is evaluated
+            planStateSpaceOpen(search->state_space, node);
+            node->parent_state_id = enode->state_id;
+            node->op = enode->op[j];
+            node->cost = parent->cost + enode->op[j]->cost;
+            layerAdd(&ehc->next, state_id);
+        }
+    }
+}
+
+/** Forgets the nodes of the next layer starting from the node from so
+ *  that they can be reached again from the new starting node. This
+ *  way the search continues the same way as if the nodes were evaluated
+ *  one by one regardless of the size of chunks. */
+static void forgetNodes(plan_search_ehc_t *ehc, int from)
+{
+    plan_search_t *search = &ehc->lazy.search;
+    plan_state_space_node_t *node;
+    int i;
+
+    for (i = from; i < ehc->next.size; ++i){
+        node = planStateSpaceNode(search->state_space,
+                                  ehc->next.node[i].state_id);
+        planStateSpaceNodeInit(node);
+    }
+}
+
+static int planSearchEHCLayerStep(plan_search_t *search)
+{
+    plan_search_ehc_t *ehc = EHC(search);
+    plan_state_space_node_t *node;
+    ehc_layer_t tmp;
+    int chunk, from, to, i, ins, res;
+
+    expandLayer(ehc);
+    planSearchStatSetOpen(&search->stat, ehc->next.size);
+    if (ehc->next.size == 0)
+        return PLAN_SEARCH_NOT_FOUND;
+
+    // Evaluate the next layer by chunks and restart from the first
+    // improving state
+    chunk = EHC_CHUNK_PER_THREAD * ehc->th_size;
+    for (from = 0; from < ehc->next.size; from = to){
+        to = BOR_MIN(from + chunk, ehc->next.size);
+
+        for (i = from; i < to; ++i){
+            node = planStateSpaceNode(search->state_space,
+                                      ehc->next.node[i].state_id);
+            if (_planSearchCheckGoal(search, node))
+                return PLAN_SEARCH_FOUND;
+        }
+
+        res = evalNodes(ehc, ehc->next.node + from, to - from);
+        if (res != PLAN_SEARCH_CONT)
+            return res;
+        planSearchStatSetOpen(&search->stat, ehc->next.size - to);
+
+        for (i = from; i < to; ++i){
+            node = planStateSpaceNode(search->state_space,
+                                      ehc->next.node[i].state_id);
+            planStateSpaceClose(search->state_space, node);
+            node->heuristic = ehc->next.node[i].heur;
+        }
+
+        for (i = from; i < to; ++i){
+            if (ehc->next.node[i].heur != PLAN_HEUR_DEAD_END
+                    && ehc->next.node[i].heur < ehc->best_heur){
+                forgetNodes(ehc, i + 1);
+                restart(ehc, ehc->next.node + i);
+                return PLAN_SEARCH_CONT;
+            }
+        }
+    }
+
+    // No improvement in this layer -- continue with the next layer
+    // without dead-ends.
+    for (i = 0, ins = 0; i < ehc->next.size; ++i){
+        if (ehc->next.node[i].heur != PLAN_HEUR_DEAD_END)
+            ehc->next.node[ins++] = ehc->next.node[i];
+    }
+    ehc->next.size = ins;
+    planSearchStatSetOpen(&search->stat, ins);
+
+    tmp = ehc->layer;
+    ehc->layer = ehc->next;
+    ehc->next = tmp;
+    return PLAN_SEARCH_CONT;
+}
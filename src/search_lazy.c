@@ -46,7 +46,8 @@ plan_search_t *planSearchLazyNew(const plan_search_lazy_params_t *params)
                     planSearchLazyBaseInitStep,
                     planSearchLazyStep,
                     planSearchLazyBaseInsertNode,
-                    NULL);
+                    NULL,
+                    planSearchLazyBaseMemUsage);
     planSearchLazyBaseInit(lazy, params->list, params->list_del,
                            params->use_preferred_ops);
 
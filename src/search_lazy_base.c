@@ -64,7 +64,10 @@ int planSearchLazyBaseInitStep(plan_search_t *search)
     if (res != PLAN_SEARCH_CONT)
         return res;
 
+    planSearchStatPhaseStart(&search->stat, PLAN_SEARCH_PHASE_LIST);
     planListLazyPush(lb->list, node->heuristic, init_state, NULL);
+    planSearchStatPhaseStop(&search->stat, PLAN_SEARCH_PHASE_LIST);
+    planSearchStatIncOpen(&search->stat);
     return PLAN_SEARCH_CONT;
 }
 
@@ -80,9 +83,13 @@ int planSearchLazyBaseNext(plan_search_lazy_base_t *lb,
 
     *node = NULL;
 
-    if (planListLazyPop(lb->list, &parent_state_id, &parent_op) != 0){
+    planSearchStatPhaseStart(&lb->search.stat, PLAN_SEARCH_PHASE_LIST);
+    ret = planListLazyPop(lb->list, &parent_state_id, &parent_op);
+    planSearchStatPhaseStop(&lb->search.stat, PLAN_SEARCH_PHASE_LIST);
+    if (ret != 0){
         return PLAN_SEARCH_NOT_FOUND;
     }
+    planSearchStatDecOpen(&lb->search.stat);
 
     if (parent_op){
         cur_node = createNode(lb, parent_state_id, parent_op, &ret);
@@ -122,8 +129,11 @@ void planSearchLazyBaseExpand(plan_search_lazy_base_t *lb,
         op_size = search->app_ops.op_preferred;
 
     for (i = 0; i < op_size; ++i){
+        planSearchStatPhaseStart(&search->stat, PLAN_SEARCH_PHASE_LIST);
         planListLazyPush(lb->list, node->heuristic, node->state_id,
                          search->app_ops.op[i]);
+        planSearchStatPhaseStop(&search->stat, PLAN_SEARCH_PHASE_LIST);
+        planSearchStatIncOpen(&search->stat);
         planSearchStatIncGeneratedStates(&search->stat);
     }
 }
@@ -141,7 +151,21 @@ void planSearchLazyBaseInsertNode(plan_search_t *search,
         planStateSpaceClose(search->state_space, node);
     }
 
+    planSearchStatPhaseStart(&search->stat, PLAN_SEARCH_PHASE_LIST);
     planListLazyPush(lb->list, node->heuristic, node->state_id, NULL);
+    planSearchStatPhaseStop(&search->stat, PLAN_SEARCH_PHASE_LIST);
+    planSearchStatIncOpen(&search->stat);
+}
+
+size_t planSearchLazyBaseMemUsage(const plan_search_t *search)
+{
+    plan_search_lazy_base_t *lb = LAZYBASE(search);
+    size_t size;
+
+    size = sizeof(*lb);
+    if (lb->list)
+        size += planListLazyMemUsage(lb->list);
+    return size;
 }
 
 static plan_state_space_node_t *createNode(plan_search_lazy_base_t *lb,
@@ -157,7 +181,8 @@ static plan_state_space_node_t *createNode(plan_search_lazy_base_t *lb,
     int res;
 
     // Create a new state and check whether the state was already visited
-    cur_state_id = planOpApply(parent_op, search->state_pool, parent_state_id);
+    cur_state_id = _planSearchNextState(search, parent_op,
+                                        parent_state_id);
     cur_node = planStateSpaceNode(search->state_space, cur_state_id);
     if (!planStateSpaceNodeIsNew(cur_node)){
         *ret = PLAN_SEARCH_CONT;
@@ -194,7 +219,7 @@ static plan_state_space_node_t *createNode(plan_search_lazy_base_t *lb,
     planStateSpaceOpen(search->state_space, cur_node);
     planStateSpaceClose(search->state_space, cur_node);
     cur_node->cost = parent_node->cost + parent_op->cost;
-    planSearchStatIncExpandedStates(&lb->search.stat);
+    planSearchStatIncExpandedStates(&search->stat);
 
     return cur_node;
 }
@@ -75,6 +75,11 @@ void planSearchLazyBaseExpand(plan_search_lazy_base_t *lb,
 void planSearchLazyBaseInsertNode(plan_search_t *search,
                                   plan_state_space_node_t *node);
 
+/**
+ * Mem-usage callback for plan_search_t structure.
+ */
+size_t planSearchLazyBaseMemUsage(const plan_search_t *search);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
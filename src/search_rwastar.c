@@ -0,0 +1,336 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <boruvka/alloc.h>
+
+#include "plan/search.h"
+#include "plan/list.h"
+
+/** Default sequence of weights (the same as used in LAMA) */
+static int default_weight[] = { 5, 3, 2, 1 };
+static int default_weight_size = sizeof(default_weight) / sizeof(int);
+
+struct _plan_search_rwastar_t {
+    plan_search_t search;
+
+    plan_list_t *list; /*!< Open-list */
+    int *weight;       /*!< Sequence of weights */
+    int weight_size;   /*!< Number of weights */
+    int weight_cur;    /*!< Index of the currently used weight */
+    int iter;          /*!< ID of the current iteration */
+    int iter_data_id;  /*!< ID of the per-state iteration marker in the
+                            state pool */
+    plan_cost_t bound; /*!< Cost of the best plan found so far */
+
+    plan_search_improved_plan_fn improved_fn;
+    void *improved_data;
+};
+typedef struct _plan_search_rwastar_t plan_search_rwastar_t;
+
+#define SEARCH_FROM_PARENT(parent) \
+    bor_container_of((parent), plan_search_rwastar_t, search)
+
+/** Frees allocated resorces */
+static void planSearchRWAStarDel(plan_search_t *_search);
+/** Initializes search. This must be call exactly once. */
+static int planSearchRWAStarInit(plan_search_t *_search);
+/** Performes one step in the algorithm. */
+static int planSearchRWAStarStep(plan_search_t *_search);
+/** Inserts node into open-list */
+static void planSearchRWAStarInsertNode(plan_search_t *search,
+                                        plan_state_space_node_t *node);
+static plan_cost_t planSearchRWAStarTopNodeCost(const plan_search_t *search);
+static size_t planSearchRWAStarMemUsage(const plan_search_t *search);
+
+
+void planSearchRWAStarParamsInit(plan_search_rwastar_params_t *p)
+{
+    bzero(p, sizeof(*p));
+    planSearchParamsInit(&p->search);
+}
+
+plan_search_t *planSearchRWAStarNew(const plan_search_rwastar_params_t *params)
+{
+    plan_search_rwastar_t *rwa;
+    const int *weight = default_weight;
+    int i, weight_size = default_weight_size;
+    int iter_init = -1;
+
+    if (params->weight != NULL && params->weight_size > 0){
+        weight = params->weight;
+        weight_size = params->weight_size;
+    }
+
+    for (i = 0; i < weight_size; ++i){
+        if (weight[i] < 1){
+            fprintf(stderr, "Search Error: Weights of RWA* must be"
+                            " positive integers (weight[%d] = %d).\n",
+                            i, weight[i]);
+            return NULL;
+        }
+    }
+
+    rwa = BOR_ALLOC(plan_search_rwastar_t);
+
+    _planSearchInit(&rwa->search, &params->search,
+                    planSearchRWAStarDel,
+                    planSearchRWAStarInit,
+                    planSearchRWAStarStep,
+                    planSearchRWAStarInsertNode,
+                    planSearchRWAStarTopNodeCost,
+                    planSearchRWAStarMemUsage);
+
+    rwa->list = planListTieBreaking(2);
+    rwa->weight_size = weight_size;
+    rwa->weight = BOR_ALLOC_ARR(int, weight_size);
+    memcpy(rwa->weight, weight, sizeof(int) * weight_size);
+    rwa->weight_cur = 0;
+    rwa->iter = 0;
+    rwa->iter_data_id = planStatePoolDataReserve(rwa->search.state_pool,
+                                                 sizeof(int), NULL,
+                                                 &iter_init);
+    rwa->bound = PLAN_COST_MAX;
+    rwa->improved_fn = params->improved_fn;
+    rwa->improved_data = params->improved_data;
+
+    return &rwa->search;
+}
+
+static void planSearchRWAStarDel(plan_search_t *search)
+{
+    plan_search_rwastar_t *rwa = SEARCH_FROM_PARENT(search);
+
+    _planSearchFree(search);
+    if (rwa->list)
+        planListDel(rwa->list);
+    if (rwa->weight)
+        BOR_FREE(rwa->weight);
+    BOR_FREE(rwa);
+}
+
+_bor_inline void rwastarPush(plan_search_rwastar_t *rwa,
+                             plan_state_space_node_t *node)
+{
+    plan_cost_t cost[2], heur;
+
+    heur = BOR_MAX(node->heuristic, 0);
+    cost[0] = node->cost + rwa->weight[rwa->weight_cur] * heur;
+    cost[1] = heur;
+    planSearchStatPhaseStart(&rwa->search.stat, PLAN_SEARCH_PHASE_LIST);
+    planListPush(rwa->list, cost, node->state_id);
+    planSearchStatPhaseStop(&rwa->search.stat, PLAN_SEARCH_PHASE_LIST);
+    planSearchStatIncOpen(&rwa->search.stat);
+}
+
+_bor_inline void rwastarSetNode(plan_state_space_node_t *node,
+                                plan_cost_t g_cost,
+                                plan_op_t *op,
+                                plan_state_space_node_t *parent_node)
+{
+    node->parent_state_id = PLAN_NO_STATE;
+    if (parent_node)
+        node->parent_state_id = parent_node->state_id;
+    node->op   = op;
+    node->cost = g_cost;
+}
+
+static int rwastarInsertState(plan_search_rwastar_t *rwa,
+                              plan_state_space_node_t *node,
+                              plan_op_t *op,
+                              plan_state_space_node_t *parent_node)
+{
+    plan_search_t *search = &rwa->search;
+    plan_cost_t heur, g_cost = 0;
+    int *iter, res;
+
+    if (parent_node)
+        g_cost += parent_node->cost;
+    if (op)
+        g_cost += op->cost;
+
+    iter = planStatePoolData(search->state_pool, rwa->iter_data_id,
+                             node->state_id);
+
+    if (planStateSpaceNodeIsNew(node)){
+        // The state was never seen before -- this is the only place where
+        // the heuristic is computed.
+        planStateSpaceOpen(search->state_space, node);
+        rwastarSetNode(node, g_cost, op, parent_node);
+
+        res = _planSearchHeur(search, node, &heur, NULL);
+        if (res != PLAN_SEARCH_CONT)
+            return res;
+        node->heuristic = heur;
+
+    }else if (*iter != rwa->iter){
+        // The state was reached in one of the previous iterations, so we
+        // reuse its heuristic value and keep the cheaper of the two paths.
+        if (g_cost < node->cost)
+            rwastarSetNode(node, g_cost, op, parent_node);
+        if (planStateSpaceNodeIsClosed(node))
+            planStateSpaceReopen(search->state_space, node);
+
+    }else if (g_cost < node->cost){
+        // Cheaper path to the state was found in the current iteration
+        rwastarSetNode(node, g_cost, op, parent_node);
+        if (planStateSpaceNodeIsClosed(node))
+            planStateSpaceReopen(search->state_space, node);
+
+    }else{
+        return PLAN_SEARCH_CONT;
+    }
+
+    *iter = rwa->iter;
+
+    // Skip dead-end states and states that cannot improve the incumbent
+    if (node->heuristic == PLAN_HEUR_DEAD_END || node->cost >= rwa->bound)
+        return PLAN_SEARCH_CONT;
+
+    rwastarPush(rwa, node);
+    planSearchStatIncGeneratedStates(&search->stat);
+
+    return PLAN_SEARCH_CONT;
+}
+
+static int rwastarRestart(plan_search_rwastar_t *rwa)
+{
+    plan_search_t *search = &rwa->search;
+    plan_state_space_node_t *node;
+
+    planListClear(rwa->list);
+    planSearchStatSetOpen(&rwa->search.stat, 0);
+    ++rwa->iter;
+
+    node = planStateSpaceNode(search->state_space, search->initial_state);
+    return rwastarInsertState(rwa, node, NULL, NULL);
+}
+
+static int rwastarImprovedPlan(plan_search_rwastar_t *rwa,
+                               plan_state_space_node_t *goal_node)
+{
+    plan_search_t *search = &rwa->search;
+    plan_path_t path;
+
+    rwa->bound = goal_node->cost;
+    if (rwa->improved_fn){
+        planSearchExtractPath(search, goal_node->state_id, &path);
+        rwa->improved_fn(search, &path, rwa->bound, rwa->improved_data);
+        planPathFree(&path);
+    }
+
+    // Restart with the next weight or continue with the last one until
+    // the open-list is exhausted.
+    if (rwa->weight_cur < rwa->weight_size - 1){
+        ++rwa->weight_cur;
+        return rwastarRestart(rwa);
+    }
+    return PLAN_SEARCH_CONT;
+}
+
+static int planSearchRWAStarInit(plan_search_t *search)
+{
+    plan_search_rwastar_t *rwa = SEARCH_FROM_PARENT(search);
+    plan_state_space_node_t *node;
+
+    node = planStateSpaceNode(search->state_space, search->initial_state);
+    return rwastarInsertState(rwa, node, NULL, NULL);
+}
+
+static int planSearchRWAStarStep(plan_search_t *search)
+{
+    plan_search_rwastar_t *rwa = SEARCH_FROM_PARENT(search);
+    plan_cost_t cost[2];
+    plan_state_id_t cur_state, next_state;
+    plan_state_space_node_t *cur_node, *next_node;
+    int i, op_size, res;
+    plan_op_t **op;
+
+    // Empty open-list means that there is no plan cheaper than the
+    // incumbent, i.e., the last plan found is optimal.
+    planSearchStatPhaseStart(&search->stat, PLAN_SEARCH_PHASE_LIST);
+    res = planListPop(rwa->list, &cur_state, cost);
+    planSearchStatPhaseStop(&search->stat, PLAN_SEARCH_PHASE_LIST);
+    if (res != 0){
+        if (rwa->bound != PLAN_COST_MAX)
+            return PLAN_SEARCH_FOUND;
+        return PLAN_SEARCH_NOT_FOUND;
+    }
+
+    // Skip already closed nodes and nodes that became too expensive
+    cur_node = planStateSpaceNode(search->state_space, cur_state);
+    if (!planStateSpaceNodeIsOpen(cur_node) || cur_node->cost >= rwa->bound)
+        return PLAN_SEARCH_CONT;
+
+    planStateSpaceClose(search->state_space, cur_node);
+
+    if (_planSearchCheckGoal(search, cur_node))
+        return rwastarImprovedPlan(rwa, cur_node);
+
+    _planSearchFindApplicableOps(search, cur_state);
+    planSearchStatIncExpandedStates(&search->stat);
+    _planSearchExpandedNode(search, cur_node);
+
+    op      = search->app_ops.op;
+    op_size = search->app_ops.op_found;
+    for (i = 0; i < op_size; ++i){
+        next_state = _planSearchNextState(search, op[i], cur_state);
+        next_node = planStateSpaceNode(search->state_space, next_state);
+
+        res = rwastarInsertState(rwa, next_node, op[i], cur_node);
+        if (res != PLAN_SEARCH_CONT)
+            return res;
+    }
+    return PLAN_SEARCH_CONT;
+}
+
+static void planSearchRWAStarInsertNode(plan_search_t *search,
+                                        plan_state_space_node_t *node)
+{
+    plan_search_rwastar_t *rwa = SEARCH_FROM_PARENT(search);
+    int *iter;
+
+    if (planStateSpaceNodeIsNew(node)){
+        planStateSpaceOpen(search->state_space, node);
+    }else{
+        planStateSpaceReopen(search->state_space, node);
+    }
+
+    iter = planStatePoolData(search->state_pool, rwa->iter_data_id,
+                             node->state_id);
+    *iter = rwa->iter;
+    rwastarPush(rwa, node);
+}
+
+static plan_cost_t planSearchRWAStarTopNodeCost(const plan_search_t *search)
+{
+    plan_search_rwastar_t *rwa = SEARCH_FROM_PARENT(search);
+    plan_state_id_t state_id;
+    plan_cost_t cost[2];
+
+    if (planListTop(rwa->list, &state_id, cost) == 0)
+        return cost[0] - rwa->weight[rwa->weight_cur] * cost[1];
+    return PLAN_COST_MAX;
+}
+
+static size_t planSearchRWAStarMemUsage(const plan_search_t *search)
+{
+    plan_search_rwastar_t *rwa = SEARCH_FROM_PARENT(search);
+    return sizeof(*rwa) + sizeof(int) * rwa->weight_size
+            + planListMemUsage(rwa->list);
+}
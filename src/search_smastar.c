@@ -0,0 +1,486 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <boruvka/alloc.h>
+
+#include "plan/search.h"
+
+/** Initial number of buckets of the open-list */
+#define BUCKET_INIT_SIZE 1024
+
+/**
+ * Per-state data of the SMA* algorithm stored in the state pool.
+ */
+struct _smastar_node_t {
+    bor_list_t open; /*!< Connector to the open-list bucket */
+    plan_state_id_t state_id; /*!< ID of the corresponding state */
+    plan_cost_t f;   /*!< f-value, possibly backed up from forgotten
+                          successors */
+    int children;    /*!< Number of successors held in memory */
+    int in_open;     /*!< True if the node is in open-list */
+};
+typedef struct _smastar_node_t smastar_node_t;
+
+struct _plan_search_smastar_t {
+    plan_search_t search;
+
+    size_t max_states; /*!< Maximal number of states in the pool */
+    int data_id;       /*!< ID of smastar_node_t data in the state pool */
+
+    bor_list_t **bucket; /*!< Open-list as buckets indexed by f-value */
+    int bucket_size;
+    int bucket_lowest;   /*!< Lowest non-empty bucket (lower bound) */
+    int bucket_highest;  /*!< Highest non-empty bucket (upper bound) */
+    long open_size;      /*!< Number of nodes in the open-list */
+    long evicted;        /*!< Number of evicted states */
+};
+typedef struct _plan_search_smastar_t plan_search_smastar_t;
+
+#define SEARCH_FROM_PARENT(parent) \
+    bor_container_of((parent), plan_search_smastar_t, search)
+
+/** Frees allocated resorces */
+static void planSearchSMAStarDel(plan_search_t *_search);
+/** Initializes search. This must be call exactly once. */
+static int planSearchSMAStarInit(plan_search_t *_search);
+/** Performes one step in the algorithm. */
+static int planSearchSMAStarStep(plan_search_t *_search);
+/** Inserts node into open-list */
+static void planSearchSMAStarInsertNode(plan_search_t *search,
+                                        plan_state_space_node_t *node);
+static plan_cost_t planSearchSMAStarTopNodeCost(const plan_search_t *search);
+static size_t planSearchSMAStarMemUsage(const plan_search_t *search);
+
+
+void planSearchSMAStarParamsInit(plan_search_smastar_params_t *p)
+{
+    bzero(p, sizeof(*p));
+    planSearchParamsInit(&p->search);
+}
+
+plan_search_t *planSearchSMAStarNew(const plan_search_smastar_params_t *params)
+{
+    plan_search_smastar_t *sma;
+    smastar_node_t node_init;
+
+    sma = BOR_ALLOC(plan_search_smastar_t);
+
+    _planSearchInit(&sma->search, &params->search,
+                    planSearchSMAStarDel,
+                    planSearchSMAStarInit,
+                    planSearchSMAStarStep,
+                    planSearchSMAStarInsertNode,
+                    planSearchSMAStarTopNodeCost,
+                    planSearchSMAStarMemUsage);
+
+    sma->max_states = params->max_states;
+
+    bzero(&node_init, sizeof(node_init));
+    node_init.f = -1;
+    sma->data_id = planStatePoolDataReserve(sma->search.state_pool,
+                                            sizeof(smastar_node_t),
+                                            NULL, &node_init);
+
+    sma->bucket_size = BUCKET_INIT_SIZE;
+    sma->bucket = BOR_CALLOC_ARR(bor_list_t *, sma->bucket_size);
+    sma->bucket_lowest = sma->bucket_size;
+    sma->bucket_highest = -1;
+    sma->open_size = 0;
+    sma->evicted = 0;
+
+    return &sma->search;
+}
+
+long planSearchSMAStarEvicted(const plan_search_t *search)
+{
+    const plan_search_smastar_t *sma = SEARCH_FROM_PARENT(search);
+    return sma->evicted;
+}
+
+static void planSearchSMAStarDel(plan_search_t *search)
+{
+    plan_search_smastar_t *sma = SEARCH_FROM_PARENT(search);
+    int i;
+
+    _planSearchFree(search);
+    for (i = 0; i < sma->bucket_size; ++i){
+        if (sma->bucket[i])
+            BOR_FREE(sma->bucket[i]);
+    }
+    BOR_FREE(sma->bucket);
+    BOR_FREE(sma);
+}
+
+_bor_inline smastar_node_t *smaNode(plan_search_smastar_t *sma,
+                                    plan_state_id_t state_id)
+{
+    smastar_node_t *n;
+    n = planStatePoolData(sma->search.state_pool, sma->data_id, state_id);
+    n->state_id = state_id;
+    return n;
+}
+
+/** Inserts the node into the open-list. If back is true, the node is
+ *  inserted as the shallowest one within its bucket. */
+static void openPush(plan_search_smastar_t *sma, smastar_node_t *n,
+                     plan_cost_t f, int back)
+{
+    int i, size;
+
+    planSearchStatPhaseStart(&sma->search.stat, PLAN_SEARCH_PHASE_LIST);
+    if (f >= sma->bucket_size){
+        size = BOR_MAX(2 * sma->bucket_size, f + 1);
+        sma->bucket = BOR_REALLOC_ARR(sma->bucket, bor_list_t *, size);
+        for (i = sma->bucket_size; i < size; ++i)
+            sma->bucket[i] = NULL;
+        sma->bucket_size = size;
+    }
+
+    if (sma->bucket[f] == NULL){
+        sma->bucket[f] = BOR_ALLOC(bor_list_t);
+        borListInit(sma->bucket[f]);
+    }
+
+    // The most recently inserted nodes are at the front so that the
+    // deepest node is expanded first and the shallowest is evicted first.
+    n->f = f;
+    n->in_open = 1;
+    if (back){
+        borListAppend(sma->bucket[f], &n->open);
+    }else{
+        borListPrepend(sma->bucket[f], &n->open);
+    }
+    sma->bucket_lowest = BOR_MIN(sma->bucket_lowest, f);
+    sma->bucket_highest = BOR_MAX(sma->bucket_highest, f);
+    ++sma->open_size;
+    planSearchStatSetOpen(&sma->search.stat, sma->open_size);
+    planSearchStatPhaseStop(&sma->search.stat, PLAN_SEARCH_PHASE_LIST);
+}
+
+static void openRemove(plan_search_smastar_t *sma, smastar_node_t *n)
+{
+    borListDel(&n->open);
+    n->in_open = 0;
+    --sma->open_size;
+    planSearchStatSetOpen(&sma->search.stat, sma->open_size);
+}
+
+static smastar_node_t *openPopMin(plan_search_smastar_t *sma)
+{
+    bor_list_t *item;
+    smastar_node_t *n;
+
+    if (sma->open_size == 0)
+        return NULL;
+
+    planSearchStatPhaseStart(&sma->search.stat, PLAN_SEARCH_PHASE_LIST);
+    for (; sma->bucket_lowest < sma->bucket_size; ++sma->bucket_lowest){
+        if (sma->bucket[sma->bucket_lowest] != NULL
+                && !borListEmpty(sma->bucket[sma->bucket_lowest]))
+            break;
+    }
+
+    item = borListNext(sma->bucket[sma->bucket_lowest]);
+    n = BOR_LIST_ENTRY(item, smastar_node_t, open);
+    openRemove(sma, n);
+    planSearchStatPhaseStop(&sma->search.stat, PLAN_SEARCH_PHASE_LIST);
+    return n;
+}
+
+
+/** Removes the state from memory. The ID of the state can be reused by
+ *  the state pool so anything cached by the ID must be invalidated. */
+static void smaRemoveState(plan_search_smastar_t *sma,
+                           plan_state_id_t state_id)
+{
+    plan_search_t *search = &sma->search;
+
+    planStatePoolRemove(search->state_pool, state_id);
+    if (search->state_id == state_id)
+        search->state_id = PLAN_NO_STATE;
+    if (search->app_ops.state == state_id)
+        search->app_ops.state = PLAN_NO_STATE;
+}
+
+/** Evicts the shallowest leaf with the highest f-value from the open-list
+ *  and backs up its f-value into its parent. Returns 0 on success, -1 if
+ *  there is no leaf that could be evicted. */
+static int evictWorstLeaf(plan_search_smastar_t *sma)
+{
+    plan_search_t *search = &sma->search;
+    plan_state_space_node_t *node, *parent_node;
+    smastar_node_t *n, *parent;
+    bor_list_t *item;
+    int f;
+
+    n = NULL;
+    for (f = sma->bucket_highest; f >= 0 && n == NULL; --f){
+        if (sma->bucket[f] == NULL || borListEmpty(sma->bucket[f])){
+            if (f == sma->bucket_highest)
+                --sma->bucket_highest;
+            continue;
+        }
+
+        for (item = borListPrev(sma->bucket[f]);
+                item != sma->bucket[f]; item = borListPrev(item)){
+            n = BOR_LIST_ENTRY(item, smastar_node_t, open);
+            if (n->children == 0 && n->state_id != search->initial_state)
+                break;
+            n = NULL;
+        }
+    }
+
+    if (n == NULL)
+        return -1;
+
+    openRemove(sma, n);
+    node = planStateSpaceNode(search->state_space, n->state_id);
+
+    // Back up the f-value into the parent and make sure the parent is
+    // in the open-list so that the forgotten subtree can be regenerated.
+    // The parent is shallower than the remaining leaves with the same
+    // f-value so it must not be expanded before them, otherwise it would
+    // only regenerate the evicted leaf over and over.
+    parent_node = planStateSpaceNode(search->state_space,
+                                     node->parent_state_id);
+    parent = smaNode(sma, node->parent_state_id);
+    --parent->children;
+    if (!parent->in_open){
+        planStateSpaceReopen(search->state_space, parent_node);
+        openPush(sma, parent, n->f, 1);
+    }else if (n->f < parent->f){
+        openRemove(sma, parent);
+        openPush(sma, parent, n->f, 1);
+    }
+
+    smaRemoveState(sma, n->state_id);
+    ++sma->evicted;
+    return 0;
+}
+
+/** Removes the closed node without any successors in memory, and
+ *  recursively its ancestors that become such nodes, as long as the
+ *  budget is exceeded. */
+static void forgetClosedLeaf(plan_search_smastar_t *sma,
+                             plan_state_space_node_t *node)
+{
+    plan_search_t *search = &sma->search;
+    plan_state_id_t parent_id;
+    smastar_node_t *n;
+
+    n = smaNode(sma, node->state_id);
+    while (planStatePoolSize(search->state_pool) > sma->max_states
+            && n->children == 0
+            && !n->in_open
+            && node->state_id != search->initial_state){
+        parent_id = node->parent_state_id;
+        smaRemoveState(sma, node->state_id);
+        ++sma->evicted;
+
+        node = planStateSpaceNode(search->state_space, parent_id);
+        n = smaNode(sma, parent_id);
+        --n->children;
+    }
+}
+
+static void setParent(plan_search_smastar_t *sma,
+                      plan_state_space_node_t *node,
+                      plan_cost_t g_cost,
+                      plan_op_t *op,
+                      plan_state_space_node_t *parent_node)
+{
+    if (node->parent_state_id != PLAN_NO_STATE)
+        --smaNode(sma, node->parent_state_id)->children;
+
+    node->parent_state_id = PLAN_NO_STATE;
+    if (parent_node){
+        node->parent_state_id = parent_node->state_id;
+        ++smaNode(sma, parent_node->state_id)->children;
+    }
+    node->op   = op;
+    node->cost = g_cost;
+}
+
+static int smaInsertState(plan_search_smastar_t *sma,
+                          plan_state_space_node_t *node,
+                          plan_op_t *op,
+                          plan_state_space_node_t *parent_node)
+{
+    plan_search_t *search = &sma->search;
+    smastar_node_t *n;
+    plan_cost_t heur, g_cost = 0, f;
+    int res;
+
+    if (parent_node)
+        g_cost += parent_node->cost;
+    if (op)
+        g_cost += op->cost;
+
+    n = smaNode(sma, node->state_id);
+
+    if (planStateSpaceNodeIsNew(node)){
+        res = _planSearchHeur(search, node, &heur, NULL);
+        if (res != PLAN_SEARCH_CONT)
+            return res;
+
+        planStateSpaceOpen(search->state_space, node);
+        node->heuristic = heur;
+
+        // Dead-end states are not kept in memory if memory is bounded
+        if (heur == PLAN_HEUR_DEAD_END){
+            if (sma->max_states > 0
+                    && node->state_id != search->initial_state){
+                smaRemoveState(sma, node->state_id);
+            }
+            return PLAN_SEARCH_CONT;
+        }
+
+    }else if (g_cost < node->cost){
+        if (n->in_open){
+            openRemove(sma, n);
+        }else{
+            planStateSpaceReopen(search->state_space, node);
+        }
+
+    }else{
+        return PLAN_SEARCH_CONT;
+    }
+
+    setParent(sma, node, g_cost, op, parent_node);
+
+    // f-values are monotone along paths which ensures that the backed up
+    // f-value of the parent is inherited by the regenerated successors.
+    f = g_cost + BOR_MAX(node->heuristic, 0);
+    if (parent_node)
+        f = BOR_MAX(f, smaNode(sma, parent_node->state_id)->f);
+    openPush(sma, n, f, 0);
+    planSearchStatIncGeneratedStates(&search->stat);
+
+    return PLAN_SEARCH_CONT;
+}
+
+static int planSearchSMAStarInit(plan_search_t *search)
+{
+    plan_search_smastar_t *sma = SEARCH_FROM_PARENT(search);
+    plan_state_space_node_t *node;
+
+    node = planStateSpaceNode(search->state_space, search->initial_state);
+    return smaInsertState(sma, node, NULL, NULL);
+}
+
+static int planSearchSMAStarStep(plan_search_t *search)
+{
+    plan_search_smastar_t *sma = SEARCH_FROM_PARENT(search);
+    plan_state_id_t cur_state, next_state;
+    plan_state_space_node_t *cur_node, *next_node;
+    smastar_node_t *cur;
+    int i, op_size, res;
+    plan_op_t **op;
+
+    cur = openPopMin(sma);
+    if (cur == NULL)
+        return PLAN_SEARCH_NOT_FOUND;
+
+    cur_state = cur->state_id;
+    cur_node = planStateSpaceNode(search->state_space, cur_state);
+    planStateSpaceClose(search->state_space, cur_node);
+
+    if (_planSearchCheckGoal(search, cur_node))
+        return PLAN_SEARCH_FOUND;
+
+    _planSearchFindApplicableOps(search, cur_state);
+    planSearchStatIncExpandedStates(&search->stat);
+    _planSearchExpandedNode(search, cur_node);
+
+    op      = search->app_ops.op;
+    op_size = search->app_ops.op_found;
+    for (i = 0; i < op_size; ++i){
+        next_state = _planSearchNextState(search, op[i], cur_state);
+        next_node = planStateSpaceNode(search->state_space, next_state);
+
+        res = smaInsertState(sma, next_node, op[i], cur_node);
+        if (res != PLAN_SEARCH_CONT)
+            return res;
+    }
+
+    // Get back within the budget. The budget can be exceeded if there
+    // is no leaf to evict, i.e., if all states in memory lie on paths to
+    // the open nodes.
+    if (sma->max_states > 0){
+        forgetClosedLeaf(sma, cur_node);
+        while (planStatePoolSize(search->state_pool) > sma->max_states
+                && evictWorstLeaf(sma) == 0);
+    }
+
+    return PLAN_SEARCH_CONT;
+}
+
+static void planSearchSMAStarInsertNode(plan_search_t *search,
+                                        plan_state_space_node_t *node)
+{
+    plan_search_smastar_t *sma = SEARCH_FROM_PARENT(search);
+    smastar_node_t *n;
+
+    if (planStateSpaceNodeIsNew(node)){
+        planStateSpaceOpen(search->state_space, node);
+    }else{
+        planStateSpaceReopen(search->state_space, node);
+    }
+
+    n = smaNode(sma, node->state_id);
+    if (n->in_open)
+        openRemove(sma, n);
+    openPush(sma, n, node->cost + BOR_MAX(node->heuristic, 0), 0);
+}
+
+static plan_cost_t planSearchSMAStarTopNodeCost(const plan_search_t *search)
+{
+    plan_search_smastar_t *sma = SEARCH_FROM_PARENT(search);
+    plan_state_space_node_t *node;
+    smastar_node_t *n;
+    int f;
+
+    if (sma->open_size == 0)
+        return PLAN_COST_MAX;
+
+    for (f = sma->bucket_lowest; f < sma->bucket_size; ++f){
+        if (sma->bucket[f] != NULL && !borListEmpty(sma->bucket[f]))
+            break;
+    }
+
+    n = BOR_LIST_ENTRY(borListNext(sma->bucket[f]), smastar_node_t, open);
+    node = planStateSpaceNode(search->state_space, n->state_id);
+    return node->cost;
+}
+
+static size_t planSearchSMAStarMemUsage(const plan_search_t *search)
+{
+    plan_search_smastar_t *sma = SEARCH_FROM_PARENT(search);
+    size_t size;
+    int i;
+
+    // Nodes themselves are stored in the state pool
+    size  = sizeof(*sma);
+    size += sizeof(bor_list_t *) * sma->bucket_size;
+    for (i = 0; i < sma->bucket_size; ++i){
+        if (sma->bucket[i] != NULL)
+            size += sizeof(bor_list_t);
+    }
+    return size;
+}
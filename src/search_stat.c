@@ -17,9 +17,17 @@
  * See the License for more information.
  */
 
+#include <strings.h>
 #include <sys/resource.h>
 #include "plan/search_stat.h"
 
+static const char *phase_name[PLAN_SEARCH_PHASE_SIZE] = {
+    "succ-gen",
+    "state-pool",
+    "heur",
+    "list",
+};
+
 void planSearchStatInit(plan_search_stat_t *stat)
 {
     stat->elapsed_time = 0.f;
@@ -29,6 +37,16 @@ void planSearchStatInit(plan_search_stat_t *stat)
     stat->generated_states = 0L;
     stat->peak_memory = 0L;
     stat->found = -1;
+    stat->open_size = 0L;
+    stat->heur_min = PLAN_COST_MAX;
+    stat->heur_sum = 0.;
+    stat->heur_count = 0L;
+    bzero(stat->phase, sizeof(stat->phase));
+}
+
+const char *planSearchStatPhaseName(int phase)
+{
+    return phase_name[phase];
 }
 
 void planSearchStatStartTimer(plan_search_stat_t *stat)
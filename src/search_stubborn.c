@@ -0,0 +1,237 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <boruvka/alloc.h>
+
+#include "search_stubborn.h"
+
+/** Returns fact ID of var/val pair or -1 */
+_bor_inline int factId(const plan_search_stubborn_t *ss,
+                       plan_var_id_t var, plan_val_t val)
+{
+    return planFactIdVar(&ss->cr.fact_id, var, val);
+}
+
+/** Adds operator to the stubborn set if it isn't already there */
+_bor_inline void addOp(plan_search_stubborn_t *ss, int op_id)
+{
+    if (op_id >= ss->op_size || ss->in_set[op_id])
+        return;
+    ss->in_set[op_id] = 1;
+    ss->queue[ss->queue_size++] = op_id;
+}
+
+/** Adds all operators from the list to the stubborn set */
+_bor_inline void addOps(plan_search_stubborn_t *ss, const plan_arr_int_t *ops)
+{
+    int op_id;
+
+    PLAN_ARR_INT_FOR_EACH(ops, op_id)
+        addOp(ss, op_id);
+}
+
+/** Adds achievers of the specified fact to the stubborn set */
+_bor_inline void addAchievers(plan_search_stubborn_t *ss,
+                              plan_var_id_t var, plan_val_t val)
+{
+    int fact_id = factId(ss, var, val);
+    if (fact_id >= 0)
+        addOps(ss, ss->cr.fact_eff + fact_id);
+}
+
+/** Adds operators from ops[] to interfere (except op_id itself) */
+static void interfereAdd(plan_search_stubborn_t *ss, int op_id,
+                         plan_arr_int_t *interfere, char *mark,
+                         const plan_arr_int_t *ops)
+{
+    int id;
+
+    PLAN_ARR_INT_FOR_EACH(ops, id){
+        if (id >= ss->op_size || id == op_id || mark[id])
+            continue;
+        mark[id] = 1;
+        planArrIntAdd(interfere, id);
+    }
+}
+
+/** Computes operators interfering with the operator op_id, i.e., those
+ *  that can disable op_id, can be disabled by op_id or are in conflict
+ *  with op_id. */
+static void interfereCompute(plan_search_stubborn_t *ss, int op_id)
+{
+    const plan_op_t *op = ss->op + op_id;
+    plan_arr_int_t *interfere = ss->interfere + op_id;
+    char *mark;
+    plan_var_id_t var;
+    plan_val_t val, v;
+    int i, fact_id;
+
+    mark = BOR_CALLOC_ARR(char, ss->op_size);
+    planArrIntInit(interfere, 4);
+
+    // op_id disables operators requiring a different value of any of its
+    // effect variables and is in conflict with operators setting a
+    // different value of the same variable.
+    for (i = 0; i < op->eff->vals_size; ++i){
+        var = op->eff->vals[i].var;
+        val = op->eff->vals[i].val;
+        for (v = 0; v < ss->var[var].range; ++v){
+            if (v == val || (fact_id = factId(ss, var, v)) < 0)
+                continue;
+            interfereAdd(ss, op_id, interfere, mark, ss->cr.fact_pre + fact_id);
+            interfereAdd(ss, op_id, interfere, mark, ss->cr.fact_eff + fact_id);
+        }
+    }
+
+    // op_id is disabled by operators setting a different value of any of
+    // its precondition variables.
+    for (i = 0; i < op->pre->vals_size; ++i){
+        var = op->pre->vals[i].var;
+        val = op->pre->vals[i].val;
+        for (v = 0; v < ss->var[var].range; ++v){
+            if (v == val || (fact_id = factId(ss, var, v)) < 0)
+                continue;
+            interfereAdd(ss, op_id, interfere, mark, ss->cr.fact_eff + fact_id);
+        }
+    }
+
+    BOR_FREE(mark);
+    ss->interfere_set[op_id] = 1;
+}
+
+/** Returns first precondition of the operator that is not satisfied in
+ *  the state or -1 if the operator is applicable. */
+_bor_inline int unsatisfiedPre(const plan_part_state_t *pre,
+                               const plan_state_t *state)
+{
+    int i;
+
+    for (i = 0; i < pre->vals_size; ++i){
+        if (planStateGet(state, pre->vals[i].var) != pre->vals[i].val)
+            return i;
+    }
+    return -1;
+}
+
+plan_search_stubborn_t *planSearchStubbornNew(const plan_problem_t *prob)
+{
+    plan_search_stubborn_t *ss;
+    int i;
+
+    for (i = 0; i < prob->op_size; ++i){
+        if (prob->op[i].cond_eff_size > 0){
+            fprintf(stderr, "Search Warning: Strong stubborn sets are not"
+                            " supported for conditional effects. Pruning"
+                            " is disabled.\n");
+            return NULL;
+        }
+    }
+
+    ss = BOR_ALLOC(plan_search_stubborn_t);
+    ss->op = prob->op;
+    ss->op_size = prob->op_size;
+    ss->var = prob->var;
+    ss->goal = prob->goal;
+    planFactOpCrossRefInit(&ss->cr, prob->var, prob->var_size, prob->goal,
+                           prob->op, prob->op_size, 0);
+
+    ss->interfere = BOR_ALLOC_ARR(plan_arr_int_t, ss->op_size);
+    ss->interfere_set = BOR_CALLOC_ARR(char, ss->op_size);
+    ss->in_set = BOR_CALLOC_ARR(char, ss->op_size);
+    ss->queue = BOR_ALLOC_ARR(int, ss->op_size);
+    ss->queue_size = 0;
+
+    ss->enabled = 1;
+    ss->calls = 0;
+    ss->ops_all = 0;
+    ss->ops_pruned = 0;
+
+    return ss;
+}
+
+void planSearchStubbornDel(plan_search_stubborn_t *ss)
+{
+    int i;
+
+    for (i = 0; i < ss->op_size; ++i){
+        if (ss->interfere_set[i])
+            planArrIntFree(ss->interfere + i);
+    }
+    BOR_FREE(ss->interfere);
+    BOR_FREE(ss->interfere_set);
+    BOR_FREE(ss->in_set);
+    BOR_FREE(ss->queue);
+    planFactOpCrossRefFree(&ss->cr);
+    BOR_FREE(ss);
+}
+
+void planSearchStubbornPrune(plan_search_stubborn_t *ss,
+                             const plan_state_t *state,
+                             plan_search_applicable_ops_t *app)
+{
+    const plan_op_t *op;
+    int i, op_id, pre, ins;
+
+    if (!ss->enabled || app->op_found <= 1)
+        return;
+
+    bzero(ss->in_set, sizeof(char) * ss->op_size);
+    ss->queue_size = 0;
+
+    // Start with achievers of an unsatisfied goal. If all goals are
+    // satisfied, nothing is pruned.
+    pre = unsatisfiedPre(ss->goal, state);
+    if (pre < 0)
+        return;
+    addAchievers(ss, ss->goal->vals[pre].var, ss->goal->vals[pre].val);
+
+    // Close the set: applicable operators bring in all interfering
+    // operators, inapplicable operators bring in achievers of one of
+    // their unsatisfied preconditions (necessary enabling set).
+    while (ss->queue_size > 0){
+        op_id = ss->queue[--ss->queue_size];
+        op = ss->op + op_id;
+
+        pre = unsatisfiedPre(op->pre, state);
+        if (pre < 0){
+            if (!ss->interfere_set[op_id])
+                interfereCompute(ss, op_id);
+            addOps(ss, ss->interfere + op_id);
+        }else{
+            addAchievers(ss, op->pre->vals[pre].var, op->pre->vals[pre].val);
+        }
+    }
+
+    // Keep only applicable operators from the stubborn set
+    for (i = 0, ins = 0; i < app->op_found; ++i){
+        if (ss->in_set[app->op[i] - ss->op])
+            app->op[ins++] = app->op[i];
+    }
+
+    ++ss->calls;
+    ss->ops_all += app->op_found;
+    ss->ops_pruned += app->op_found - ins;
+    app->op_found = ins;
+
+    // Disable pruning if it does not pay off
+    if (ss->calls == PLAN_SEARCH_STUBBORN_CHECK_CALLS
+            && ss->ops_pruned < PLAN_SEARCH_STUBBORN_MIN_RATIO * ss->ops_all){
+        ss->enabled = 0;
+    }
+}
@@ -0,0 +1,89 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#ifndef __PLAN_SEARCH_STUBBORN_H__
+#define __PLAN_SEARCH_STUBBORN_H__
+
+#include "plan/search.h"
+#include "fact_op_cross_ref.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Number of pruning calls after which the pruning ratio is checked.
+ */
+#define PLAN_SEARCH_STUBBORN_CHECK_CALLS 1000
+
+/**
+ * Minimal ratio of pruned operators. If the ratio is lower after
+ * PLAN_SEARCH_STUBBORN_CHECK_CALLS calls, the pruning is disabled.
+ */
+#define PLAN_SEARCH_STUBBORN_MIN_RATIO 0.2
+
+/**
+ * Partial-order reduction using strong stubborn sets.
+ */
+struct _plan_search_stubborn_t {
+    const plan_op_t *op;       /*!< Operators of the problem */
+    int op_size;               /*!< Number of operators */
+    const plan_var_t *var;     /*!< Variables of the problem */
+    const plan_part_state_t *goal; /*!< Goal of the problem */
+    plan_fact_op_cross_ref_t cr;   /*!< Fact/operator cross reference */
+
+    plan_arr_int_t *interfere; /*!< Lazily computed interfering operators */
+    char *interfere_set;       /*!< True if .interfere[op] was computed */
+
+    char *in_set;  /*!< Marks operators in the stubborn set */
+    int *queue;    /*!< Queue of unprocessed operators */
+    int queue_size;
+
+    int enabled;   /*!< True if the pruning is enabled */
+    long calls;    /*!< Number of calls of the pruning */
+    long ops_all;  /*!< Number of applicable operators before pruning */
+    long ops_pruned; /*!< Number of pruned operators */
+};
+
+/**
+ * Creates a strong stubborn sets pruning for the given problem.
+ * Returns NULL if the problem is not supported (i.e., it has conditional
+ * effects).
+ */
+plan_search_stubborn_t *planSearchStubbornNew(const plan_problem_t *prob);
+
+/**
+ * Deletes the object.
+ */
+void planSearchStubbornDel(plan_search_stubborn_t *ss);
+
+/**
+ * Removes all operators that are not in the strong stubborn set of the
+ * given state from app->op[]. The order of the remaining operators is
+ * preserved.
+ */
+void planSearchStubbornPrune(plan_search_stubborn_t *ss,
+                             const plan_state_t *state,
+                             plan_search_applicable_ops_t *app);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __PLAN_SEARCH_STUBBORN_H__ */
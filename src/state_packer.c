@@ -268,6 +268,14 @@ void planStatePackerPackPartState(const plan_state_packer_t *p,
     }
 }
 
+void planStatePackerVarField(const plan_state_packer_t *p,
+                             plan_var_id_t var,
+                             int *pos, plan_packer_word_t *mask)
+{
+    *pos = p->vars[var].pos;
+    *mask = p->vars[var].mask;
+}
+
 void planStatePackerExtractPubPart(const plan_state_packer_t *p,
                                    const void *bufstate,
                                    void *pubbuf)
@@ -43,6 +43,9 @@ _bor_inline void *stateBuf(const plan_state_packed_t *s);
 _bor_inline plan_state_packed_t *statePacked(const plan_state_pool_t *pool,
                                              plan_state_id_t sid);
 
+/** Returns ID the next inserted state would get. */
+_bor_inline plan_state_id_t nextStateId(const plan_state_pool_t *pool);
+
 /** Inserts state into hash table and returns ID under which it is stored. */
 _bor_inline plan_state_id_t insertIntoHTable(plan_state_pool_t *pool,
                                              plan_state_packed_t *sp);
@@ -54,6 +57,13 @@ static int htableEq(const bor_list_t *k1, const bor_list_t *k2, void *ud);
 /** Initialization function for data array holding plan_state_packed_t */
 static void statePackedInit(void *el, int id, const void *ud);
 
+/** Remembers initial value of the data array */
+static void dataInitSet(plan_state_pool_data_init_t *init, size_t el_size,
+                        bor_extarr_el_init_fn init_fn, const void *init_data);
+/** Resets data element to its initial value */
+static void dataInitReset(const plan_state_pool_data_init_t *init,
+                          void *el, int id);
+
 plan_state_pool_t *planStatePoolNew(const plan_var_t *var, int var_size)
 {
     int state_size, size;
@@ -66,14 +76,18 @@ plan_state_pool_t *planStatePoolNew(const plan_var_t *var, int var_size)
     state_size = planStatePackerBufSize(pool->packer);
 
     pool->data = BOR_ALLOC_ARR(bor_extarr_t *, 2);
+    pool->data_init = BOR_ALLOC_ARR(plan_state_pool_data_init_t, 2);
 
     size  = sizeof(plan_state_packed_t);
     size += state_size;
     pool->data[0] = borExtArrNew2(size, 128, 256, statePackedInit, pool);
+    dataInitSet(pool->data_init, size, statePackedInit, pool);
 
     pool->data_size = 1;
     pool->htable = borHTableNew(htableHash, htableEq, (void *)pool);
     pool->num_states = 0;
+    pool->free_id = NULL;
+    pool->free_id_size = pool->free_id_alloc = 0;
 
     return pool;
 }
@@ -87,8 +101,13 @@ void planStatePoolDel(plan_state_pool_t *pool)
 
     for (i = 0; i < pool->data_size; ++i){
         borExtArrDel(pool->data[i]);
+        if (pool->data_init[i].el)
+            BOR_FREE(pool->data_init[i].el);
     }
     BOR_FREE(pool->data);
+    BOR_FREE(pool->data_init);
+    if (pool->free_id)
+        BOR_FREE(pool->free_id);
 
     if (pool->packer)
         planStatePackerDel(pool->packer);
@@ -100,21 +119,44 @@ plan_state_pool_t *planStatePoolClone(const plan_state_pool_t *sp)
 {
     plan_state_pool_t *pool;
     plan_state_packed_t *state;
+    char *removed;
     int i;
 
     pool = BOR_ALLOC(plan_state_pool_t);
     memcpy(pool, sp, sizeof(*sp));
     pool->packer = planStatePackerClone(sp->packer);
     pool->data = BOR_ALLOC_ARR(bor_extarr_t *, sp->data_size);
-    for (i = 0; i < sp->data_size; ++i)
+    pool->data_init = BOR_ALLOC_ARR(plan_state_pool_data_init_t,
+                                    sp->data_size);
+    for (i = 0; i < sp->data_size; ++i){
         pool->data[i] = borExtArrClone(sp->data[i]);
+        dataInitSet(pool->data_init + i, sp->data_init[i].el_size,
+                    sp->data_init[i].fn,
+                    (sp->data_init[i].fn ? sp->data_init[i].data
+                                         : sp->data_init[i].el));
+    }
+    pool->data_init[0].data = pool;
+
+    pool->free_id = NULL;
+    if (sp->free_id_size > 0){
+        pool->free_id = BOR_ALLOC_ARR(plan_state_id_t, sp->free_id_size);
+        memcpy(pool->free_id, sp->free_id,
+               sizeof(plan_state_id_t) * sp->free_id_size);
+    }
+    pool->free_id_alloc = sp->free_id_size;
+
+    removed = BOR_CALLOC_ARR(char, sp->num_states + 1);
+    for (i = 0; i < sp->free_id_size; ++i)
+        removed[sp->free_id[i]] = 1;
 
     pool->htable = borHTableNew(htableHash, htableEq, (void *)pool);
-    pool->num_states = 0;
     for (i = 0; i < sp->num_states; ++i){
+        if (removed[i])
+            continue;
         state = statePacked(pool, i);
-        insertIntoHTable(pool, state);
+        borHTableInsert(pool->htable, &state->htable);
     }
+    BOR_FREE(removed);
 
     return pool;
 }
@@ -130,8 +172,12 @@ int planStatePoolDataReserve(plan_state_pool_t *pool,
     ++pool->data_size;
     pool->data = BOR_REALLOC_ARR(pool->data, bor_extarr_t *,
                                  pool->data_size);
+    pool->data_init = BOR_REALLOC_ARR(pool->data_init,
+                                      plan_state_pool_data_init_t,
+                                      pool->data_size);
     pool->data[data_id] = borExtArrNew2(element_size, 128, 256,
                                         init_fn, init_data);
+    dataInitSet(pool->data_init + data_id, element_size, init_fn, init_data);
     return data_id;
 }
 
@@ -152,7 +198,7 @@ plan_state_id_t planStatePoolInsert(plan_state_pool_t *pool,
     plan_state_packed_t *sp;
 
     // determine state ID
-    sid = pool->num_states;
+    sid = nextStateId(pool);
 
     // allocate a new state and initialize it with the given values
     sp = statePacked(pool, sid);
@@ -168,7 +214,7 @@ plan_state_id_t planStatePoolInsertPacked(plan_state_pool_t *pool,
     plan_state_packed_t *sp;
 
     // determine state ID
-    sid = pool->num_states;
+    sid = nextStateId(pool);
 
     // allocate a new state and initialize it with the given values
     sp = statePacked(pool, sid);
@@ -177,6 +223,50 @@ plan_state_id_t planStatePoolInsertPacked(plan_state_pool_t *pool,
     return insertIntoHTable(pool, sp);
 }
 
+int planStatePoolRemove(plan_state_pool_t *pool, plan_state_id_t sid)
+{
+    plan_state_packed_t *sp;
+    int i;
+
+    if (sid >= pool->num_states)
+        return -1;
+
+    sp = statePacked(pool, sid);
+    if (borHTableErase(pool->htable, &sp->htable) != 0)
+        return -1;
+
+    for (i = 1; i < pool->data_size; ++i){
+        dataInitReset(pool->data_init + i,
+                      borExtArrGet(pool->data[i], sid), sid);
+    }
+
+    if (pool->free_id_size == pool->free_id_alloc){
+        pool->free_id_alloc = BOR_MAX(2 * pool->free_id_alloc, 64);
+        pool->free_id = BOR_REALLOC_ARR(pool->free_id, plan_state_id_t,
+                                        pool->free_id_alloc);
+    }
+    pool->free_id[pool->free_id_size++] = sid;
+
+    return 0;
+}
+
+size_t planStatePoolDataMemUsage(const plan_state_pool_t *pool, int data_id)
+{
+    if (data_id >= pool->data_size)
+        return 0;
+    return borExtArrSize(pool->data[data_id])
+                * pool->data_init[data_id].el_size;
+}
+
+size_t planStatePoolIndexMemUsage(const plan_state_pool_t *pool)
+{
+    size_t size;
+
+    size  = pool->htable->size * sizeof(bor_list_t);
+    size += pool->free_id_alloc * sizeof(plan_state_id_t);
+    return size;
+}
+
 plan_state_id_t planStatePoolFind(const plan_state_pool_t *pool,
                                   const plan_state_t *state)
 {
@@ -262,7 +352,7 @@ _bor_inline plan_state_id_t applyPartStatePacked(plan_state_pool_t *pool,
     sp = statePacked(pool, sid);
 
     // remember ID of the new state (if it will be inserted)
-    newid = pool->num_states;
+    newid = nextStateId(pool);
 
     // get buffer of the new state
     newsp = statePacked(pool, newid);
@@ -312,7 +402,7 @@ _bor_inline plan_state_id_t applyPartStatesPacked(plan_state_pool_t *pool,
     sp = statePacked(pool, sid);
 
     // remember ID of the new state (if it will be inserted)
-    newid = pool->num_states;
+    newid = nextStateId(pool);
 
     // get buffer of the new state
     newsp = statePacked(pool, newid);
@@ -366,6 +456,13 @@ _bor_inline plan_state_packed_t *statePacked(const plan_state_pool_t *pool,
     return (plan_state_packed_t *)borExtArrGet(pool->data[0], sid);
 }
 
+_bor_inline plan_state_id_t nextStateId(const plan_state_pool_t *pool)
+{
+    if (pool->free_id_size > 0)
+        return pool->free_id[pool->free_id_size - 1];
+    return pool->num_states;
+}
+
 _bor_inline plan_state_id_t insertIntoHTable(plan_state_pool_t *pool,
                                              plan_state_packed_t *sp)
 {
@@ -376,8 +473,13 @@ _bor_inline plan_state_id_t insertIntoHTable(plan_state_pool_t *pool,
 
     if (hstate == NULL){
         // NULL is returned if the element was inserted into table, so
-        // increase number of elements in the pool
-        ++pool->num_states;
+        // either consume the reused ID or increase number of elements in
+        // the pool
+        if (sp->state_id < pool->num_states){
+            --pool->free_id_size;
+        }else{
+            ++pool->num_states;
+        }
         return sp->state_id;
 
     }else{
@@ -413,3 +515,26 @@ static void statePackedInit(void *el, int id, const void *ud)
     sp->state_id = id;
     memset(stateBuf(sp), 0, size);
 }
+
+static void dataInitSet(plan_state_pool_data_init_t *init, size_t el_size,
+                        bor_extarr_el_init_fn init_fn, const void *init_data)
+{
+    init->el_size = el_size;
+    init->fn = init_fn;
+    init->data = init_data;
+    init->el = NULL;
+    if (init_fn == NULL && init_data != NULL){
+        init->el = BOR_ALLOC_ARR(char, el_size);
+        memcpy(init->el, init_data, el_size);
+    }
+}
+
+static void dataInitReset(const plan_state_pool_data_init_t *init,
+                          void *el, int id)
+{
+    if (init->fn){
+        init->fn(el, id, init->data);
+    }else if (init->el){
+        memcpy(el, init->el, init->el_size);
+    }
+}
@@ -0,0 +1,630 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <boruvka/alloc.h>
+#include "plan/symmetry.h"
+
+#ifndef _GNU_SOURCE
+/** Declaration of qsort_r() function that should be available in libc */
+void qsort_r(void *base, size_t nmemb, size_t size,
+             int (*compar)(const void *, const void *, void *),
+             void *arg);
+#endif
+
+/**
+ * Problem description graph.
+ * Vertices [0, var_size) are variables, vertex of the fact (var, val) is
+ * fact_offset[var] + val and vertices [op_offset, vert_size) are
+ * operators.
+ */
+struct _pdg_t {
+    int vert_size;
+    int var_size;
+    int *fact_offset;
+    int op_offset;
+    int *color;   /*!< Initial coloring of vertices */
+
+    int *out_beg; /*!< Outgoing edges in CSR format (sorted) */
+    int *out;
+    int *in_beg;  /*!< Incoming edges in CSR format */
+    int *in;
+
+    int *sig_beg; /*!< Signatures of vertices used during refinement */
+    int *sig;
+    int *order;
+    int *tmp;
+};
+typedef struct _pdg_t pdg_t;
+
+static int intCmp(const void *a, const void *b)
+{
+    return *(const int *)a - *(const int *)b;
+}
+
+static int costCmp(const void *a, const void *b)
+{
+    plan_cost_t c1 = *(const plan_cost_t *)a;
+    plan_cost_t c2 = *(const plan_cost_t *)b;
+    if (c1 < c2)
+        return -1;
+    return c1 > c2;
+}
+
+/** Compares signatures of two vertices */
+static int sigCmp(const void *a, const void *b, void *ud)
+{
+    const pdg_t *g = ud;
+    int v1 = *(const int *)a;
+    int v2 = *(const int *)b;
+    int len1 = g->sig_beg[v1 + 1] - g->sig_beg[v1];
+    int len2 = g->sig_beg[v2 + 1] - g->sig_beg[v2];
+    const int *s1 = g->sig + g->sig_beg[v1];
+    const int *s2 = g->sig + g->sig_beg[v2];
+    int i;
+
+    // Compare colors first so that the order of cells is preserved
+    if (s1[0] != s2[0])
+        return s1[0] - s2[0];
+    if (len1 != len2)
+        return len1 - len2;
+    for (i = 1; i < len1; ++i){
+        if (s1[i] != s2[i])
+            return s1[i] - s2[i];
+    }
+    return 0;
+}
+
+/** Fills CSR arrays from the list of edges */
+static void csrBuild(int vert_size, int edge_size,
+                     const int *from, const int *to,
+                     int **beg_out, int **adj_out)
+{
+    int *beg, *adj, *cur;
+    int i;
+
+    beg = BOR_CALLOC_ARR(int, vert_size + 1);
+    adj = BOR_ALLOC_ARR(int, BOR_MAX(edge_size, 1));
+    cur = BOR_ALLOC_ARR(int, vert_size);
+
+    for (i = 0; i < edge_size; ++i)
+        ++beg[from[i] + 1];
+    for (i = 0; i < vert_size; ++i)
+        beg[i + 1] += beg[i];
+    memcpy(cur, beg, sizeof(int) * vert_size);
+    for (i = 0; i < edge_size; ++i)
+        adj[cur[from[i]]++] = to[i];
+    for (i = 0; i < vert_size; ++i)
+        qsort(adj + beg[i], beg[i + 1] - beg[i], sizeof(int), intCmp);
+
+    BOR_FREE(cur);
+    *beg_out = beg;
+    *adj_out = adj;
+}
+
+static void pdgInit(pdg_t *g, const plan_problem_t *prob)
+{
+    const plan_op_t *op;
+    plan_cost_t *cost;
+    int *from, *to;
+    int i, j, var, edge_size, edge_alloc, cost_size, len;
+
+    g->var_size = prob->var_size;
+    g->fact_offset = BOR_ALLOC_ARR(int, prob->var_size);
+    g->vert_size = prob->var_size;
+    for (i = 0; i < prob->var_size; ++i){
+        g->fact_offset[i] = g->vert_size;
+        g->vert_size += prob->var[i].range;
+    }
+    g->op_offset = g->vert_size;
+    g->vert_size += prob->op_size;
+
+    // Initial coloring: variables, facts, goal facts and operators
+    // partitioned by their costs
+    cost = BOR_ALLOC_ARR(plan_cost_t, BOR_MAX(prob->op_size, 1));
+    for (i = 0; i < prob->op_size; ++i)
+        cost[i] = prob->op[i].cost;
+    qsort(cost, prob->op_size, sizeof(plan_cost_t), costCmp);
+    for (i = 0, cost_size = 0; i < prob->op_size; ++i){
+        if (cost_size == 0 || cost[cost_size - 1] != cost[i])
+            cost[cost_size++] = cost[i];
+    }
+
+    g->color = BOR_ALLOC_ARR(int, g->vert_size);
+    for (i = 0; i < g->op_offset; ++i)
+        g->color[i] = (i < g->var_size ? 0 : 1);
+    for (i = 0; i < prob->goal->vals_size; ++i){
+        var = prob->goal->vals[i].var;
+        g->color[g->fact_offset[var] + prob->goal->vals[i].val] = 2;
+    }
+    for (i = 0; i < prob->op_size; ++i){
+        g->color[g->op_offset + i] = 3 + ((plan_cost_t *)bsearch(
+                                                &prob->op[i].cost, cost,
+                                                cost_size, sizeof(plan_cost_t),
+                                                costCmp) - cost);
+    }
+    BOR_FREE(cost);
+
+    // Edges: variable -> fact, precondition -> operator -> effect
+    edge_alloc = g->op_offset - g->var_size;
+    for (i = 0; i < prob->op_size; ++i)
+        edge_alloc += prob->op[i].pre->vals_size + prob->op[i].eff->vals_size;
+    from = BOR_ALLOC_ARR(int, BOR_MAX(edge_alloc, 1));
+    to = BOR_ALLOC_ARR(int, BOR_MAX(edge_alloc, 1));
+    edge_size = 0;
+    for (i = 0; i < prob->var_size; ++i){
+        for (j = 0; j < prob->var[i].range; ++j){
+            from[edge_size] = i;
+            to[edge_size++] = g->fact_offset[i] + j;
+        }
+    }
+    for (i = 0; i < prob->op_size; ++i){
+        op = prob->op + i;
+        for (j = 0; j < op->pre->vals_size; ++j){
+            var = op->pre->vals[j].var;
+            from[edge_size] = g->fact_offset[var] + op->pre->vals[j].val;
+            to[edge_size++] = g->op_offset + i;
+        }
+        for (j = 0; j < op->eff->vals_size; ++j){
+            var = op->eff->vals[j].var;
+            from[edge_size] = g->op_offset + i;
+            to[edge_size++] = g->fact_offset[var] + op->eff->vals[j].val;
+        }
+    }
+
+    csrBuild(g->vert_size, edge_size, from, to, &g->out_beg, &g->out);
+    csrBuild(g->vert_size, edge_size, to, from, &g->in_beg, &g->in);
+    BOR_FREE(from);
+    BOR_FREE(to);
+
+    // Signature of a vertex: color, out-degree, colors of successors and
+    // colors of predecessors
+    g->sig_beg = BOR_ALLOC_ARR(int, g->vert_size + 1);
+    g->sig_beg[0] = 0;
+    for (i = 0; i < g->vert_size; ++i){
+        len  = 2 + g->out_beg[i + 1] - g->out_beg[i];
+        len += g->in_beg[i + 1] - g->in_beg[i];
+        g->sig_beg[i + 1] = g->sig_beg[i] + len;
+    }
+    g->sig = BOR_ALLOC_ARR(int, g->sig_beg[g->vert_size]);
+    g->order = BOR_ALLOC_ARR(int, g->vert_size);
+    g->tmp = BOR_ALLOC_ARR(int, g->vert_size);
+}
+
+static void pdgFree(pdg_t *g)
+{
+    BOR_FREE(g->fact_offset);
+    BOR_FREE(g->color);
+    BOR_FREE(g->out_beg);
+    BOR_FREE(g->out);
+    BOR_FREE(g->in_beg);
+    BOR_FREE(g->in);
+    BOR_FREE(g->sig_beg);
+    BOR_FREE(g->sig);
+    BOR_FREE(g->order);
+    BOR_FREE(g->tmp);
+}
+
+/** Refines coloring to the equitable one. The colors are renumbered so
+ *  that they form a range starting from zero and the order of the
+ *  original cells is preserved. Returns number of colors. */
+static int refine(pdg_t *g, int *color)
+{
+    int v, i, *s, outdeg, indeg, ncolors = -1, c;
+
+    while (1){
+        for (v = 0; v < g->vert_size; ++v){
+            outdeg = g->out_beg[v + 1] - g->out_beg[v];
+            indeg = g->in_beg[v + 1] - g->in_beg[v];
+
+            s = g->sig + g->sig_beg[v];
+            s[0] = color[v];
+            s[1] = outdeg;
+            s += 2;
+            for (i = 0; i < outdeg; ++i)
+                s[i] = color[g->out[g->out_beg[v] + i]];
+            qsort(s, outdeg, sizeof(int), intCmp);
+            s += outdeg;
+            for (i = 0; i < indeg; ++i)
+                s[i] = color[g->in[g->in_beg[v] + i]];
+            qsort(s, indeg, sizeof(int), intCmp);
+            g->order[v] = v;
+        }
+
+        qsort_r(g->order, g->vert_size, sizeof(int), sigCmp, g);
+        c = 0;
+        g->tmp[g->order[0]] = 0;
+        for (i = 1; i < g->vert_size; ++i){
+            if (sigCmp(g->order + i - 1, g->order + i, g) != 0)
+                ++c;
+            g->tmp[g->order[i]] = c;
+        }
+        memcpy(color, g->tmp, sizeof(int) * g->vert_size);
+
+        if (c + 1 == ncolors)
+            break;
+        ncolors = c + 1;
+    }
+
+    return ncolors;
+}
+
+/** Gives vertex v its own cell placed right before its original cell */
+static int individualize(pdg_t *g, int *color, int v)
+{
+    int u;
+
+    for (u = 0; u < g->vert_size; ++u)
+        color[u] = 2 * color[u] + (u == v ? 0 : 1);
+    return refine(g, color);
+}
+
+/** Returns the first vertex of the first non-singleton cell or -1 if
+ *  all variable and fact vertices are in singleton cells. Operators in
+ *  the same cell are twins at that point (they have the very same
+ *  neighbors), so they need not be individualized. */
+static int firstCellVert(const pdg_t *g, const int *color, int ncolors,
+                         int *cnt)
+{
+    int v, c;
+
+    bzero(cnt, sizeof(int) * ncolors);
+    for (v = 0; v < g->vert_size; ++v)
+        ++cnt[color[v]];
+    for (c = 0; c < ncolors && cnt[c] == 1; ++c);
+    for (v = 0; v < g->op_offset && color[v] != c; ++v);
+    if (v == g->op_offset)
+        return -1;
+    return v;
+}
+
+/** Sorts vertices by their colors (and IDs within the same color) */
+static void colorOrder(const pdg_t *g, const int *color, int *cnt, int *ord)
+{
+    int v, c, sum, n = g->vert_size;
+
+    bzero(cnt, sizeof(int) * n);
+    for (v = 0; v < n; ++v)
+        ++cnt[color[v]];
+    for (c = 0, sum = 0; c < n; ++c){
+        sum += cnt[c];
+        cnt[c] = sum - cnt[c];
+    }
+    for (v = 0; v < n; ++v)
+        ord[cnt[color[v]]++] = v;
+}
+
+/** Returns true if perm is an automorphism of the graph */
+static int isAutomorphism(const pdg_t *g, const int *perm)
+{
+    int u, pu, i, x;
+    const int *adj;
+    size_t adj_size;
+
+    for (u = 0; u < g->vert_size; ++u){
+        pu = perm[u];
+        if (g->color[u] != g->color[pu])
+            return 0;
+        if (g->out_beg[u + 1] - g->out_beg[u]
+                != g->out_beg[pu + 1] - g->out_beg[pu])
+            return 0;
+
+        adj = g->out + g->out_beg[pu];
+        adj_size = g->out_beg[pu + 1] - g->out_beg[pu];
+        for (i = g->out_beg[u]; i < g->out_beg[u + 1]; ++i){
+            x = perm[g->out[i]];
+            if (bsearch(&x, adj, adj_size, sizeof(int), intCmp) == NULL)
+                return 0;
+        }
+    }
+    return 1;
+}
+
+static int ufFind(int *uf, int v)
+{
+    int root = v, next;
+
+    while (uf[root] != root)
+        root = uf[root];
+    while (uf[v] != root){
+        next = uf[v];
+        uf[v] = root;
+        v = next;
+    }
+    return root;
+}
+
+static void ufUnion(int *uf, int u, int v)
+{
+    u = ufFind(uf, u);
+    v = ufFind(uf, v);
+    if (u < v){
+        uf[v] = u;
+    }else{
+        uf[u] = v;
+    }
+}
+
+/** Stores the automorphism as a generator unless it is identity on facts */
+static int addGen(plan_symmetry_t *sym, const pdg_t *g, const int *perm)
+{
+    plan_symmetry_gen_t *gen;
+    int v, x, o, ident = 1;
+
+    for (v = 0; v < g->op_offset && ident; ++v)
+        ident = (perm[v] == v);
+    if (ident)
+        return 0;
+
+    sym->gen = BOR_REALLOC_ARR(sym->gen, plan_symmetry_gen_t,
+                               sym->gen_size + 1);
+    gen = sym->gen + sym->gen_size++;
+    planSymmetryGenInit(gen, sym);
+    for (v = 0; v < g->var_size; ++v){
+        gen->var[v] = perm[v];
+        for (x = 0; x < sym->var_range[v]; ++x){
+            gen->val[v][x] = perm[g->fact_offset[v] + x]
+                                - g->fact_offset[perm[v]];
+        }
+    }
+    for (o = 0; o < sym->op_size; ++o)
+        gen->op[o] = perm[g->op_offset + o] - g->op_offset;
+    return 1;
+}
+
+static void findGenerators(plan_symmetry_t *sym, pdg_t *g)
+{
+    int n = g->vert_size;
+    int **lvl_color = NULL, *lvl_vert = NULL, depth = 0;
+    int *color, *leaf0, *cnt, *ord0, *ord, *perm, *uf;
+    int i, k, v, w, ncolors, branches;
+
+    color = BOR_ALLOC_ARR(int, n);
+    leaf0 = BOR_ALLOC_ARR(int, n);
+    cnt = BOR_ALLOC_ARR(int, n);
+    ord0 = BOR_ALLOC_ARR(int, n);
+    ord = BOR_ALLOC_ARR(int, n);
+    perm = BOR_ALLOC_ARR(int, n);
+    uf = BOR_ALLOC_ARR(int, n);
+
+    // Follow the first path to a leaf and remember partitions along the
+    // way
+    memcpy(color, g->color, sizeof(int) * n);
+    ncolors = refine(g, color);
+    while ((v = firstCellVert(g, color, ncolors, cnt)) >= 0){
+        lvl_color = BOR_REALLOC_ARR(lvl_color, int *, depth + 1);
+        lvl_vert = BOR_REALLOC_ARR(lvl_vert, int, depth + 1);
+        lvl_color[depth] = BOR_ALLOC_ARR(int, n);
+        memcpy(lvl_color[depth], color, sizeof(int) * n);
+        lvl_vert[depth] = v;
+        ncolors = individualize(g, color, v);
+        ++depth;
+    }
+    colorOrder(g, color, cnt, ord0);
+    memcpy(leaf0, color, sizeof(int) * n);
+
+    // Try to map the individualized vertex to the other vertices from its
+    // cell, bottom-up so that orbits of already found generators can be
+    // used for pruning.
+    for (v = 0; v < n; ++v)
+        uf[v] = v;
+    branches = 0;
+    for (k = depth - 1; k >= 0; --k){
+        for (w = 0; w < n && branches < PLAN_SYMMETRY_MAX_BRANCHES; ++w){
+            if (w == lvl_vert[k]
+                    || lvl_color[k][w] != lvl_color[k][lvl_vert[k]]
+                    || ufFind(uf, w) == ufFind(uf, lvl_vert[k])){
+                continue;
+            }
+
+            ++branches;
+            memcpy(color, lvl_color[k], sizeof(int) * n);
+            ncolors = individualize(g, color, w);
+            while ((v = firstCellVert(g, color, ncolors, cnt)) >= 0)
+                ncolors = individualize(g, color, v);
+
+            // Map vertices with the same colors onto each other
+            colorOrder(g, color, cnt, ord);
+            for (i = 0; i < n && leaf0[ord0[i]] == color[ord[i]]; ++i)
+                perm[ord0[i]] = ord[i];
+            if (i == n && isAutomorphism(g, perm)){
+                addGen(sym, g, perm);
+                for (v = 0; v < n; ++v)
+                    ufUnion(uf, v, perm[v]);
+            }
+        }
+    }
+
+    for (i = 0; i < depth; ++i)
+        BOR_FREE(lvl_color[i]);
+    if (lvl_color)
+        BOR_FREE(lvl_color);
+    if (lvl_vert)
+        BOR_FREE(lvl_vert);
+    BOR_FREE(color);
+    BOR_FREE(leaf0);
+    BOR_FREE(cnt);
+    BOR_FREE(ord0);
+    BOR_FREE(ord);
+    BOR_FREE(perm);
+    BOR_FREE(uf);
+}
+
+int planSymmetryInit(plan_symmetry_t *sym, const plan_problem_t *prob)
+{
+    pdg_t g;
+    int i;
+
+    bzero(sym, sizeof(*sym));
+    sym->var_size = prob->var_size;
+    sym->op = prob->op;
+    sym->op_size = prob->op_size;
+
+    for (i = 0; i < prob->op_size; ++i){
+        if (prob->op[i].cond_eff_size > 0){
+            fprintf(stderr, "Symmetry Error: Conditional effects are not"
+                            " supported.\n");
+            return -1;
+        }
+    }
+
+    sym->state = planStateNew(prob->var_size);
+    sym->var_range = BOR_ALLOC_ARR(plan_val_t, BOR_MAX(prob->var_size, 1));
+    for (i = 0; i < prob->var_size; ++i)
+        sym->var_range[i] = prob->var[i].range;
+    if (prob->var_size == 0)
+        return 0;
+
+    pdgInit(&g, prob);
+    findGenerators(sym, &g);
+    pdgFree(&g);
+    return 0;
+}
+
+void planSymmetryFree(plan_symmetry_t *sym)
+{
+    int i;
+
+    for (i = 0; i < sym->gen_size; ++i)
+        planSymmetryGenFree(sym->gen + i, sym);
+    if (sym->gen)
+        BOR_FREE(sym->gen);
+    if (sym->state)
+        planStateDel(sym->state);
+    if (sym->var_range)
+        BOR_FREE(sym->var_range);
+    if (sym->trace)
+        BOR_FREE(sym->trace);
+}
+
+void planSymmetryGenApply(const plan_symmetry_gen_t *gen, int var_size,
+                          const plan_state_t *src, plan_state_t *dst)
+{
+    int v;
+
+    for (v = 0; v < var_size; ++v)
+        planStateSet(dst, gen->var[v], gen->val[v][planStateGet(src, v)]);
+}
+
+/** Returns true if s1 is lexicographically smaller than s2 */
+static int stateLess(const plan_state_t *s1, const plan_state_t *s2,
+                     int var_size)
+{
+    int v;
+    plan_val_t v1, v2;
+
+    for (v = 0; v < var_size; ++v){
+        v1 = planStateGet(s1, v);
+        v2 = planStateGet(s2, v);
+        if (v1 != v2)
+            return v1 < v2;
+    }
+    return 0;
+}
+
+void planSymmetryCanonState(plan_symmetry_t *sym, plan_state_t *state)
+{
+    int i, changed = 1;
+
+    sym->trace_size = 0;
+    while (changed){
+        changed = 0;
+        for (i = 0; i < sym->gen_size; ++i){
+            planSymmetryGenApply(sym->gen + i, sym->var_size,
+                                 state, sym->state);
+            if (stateLess(sym->state, state, sym->var_size)){
+                planStateCopy(state, sym->state);
+                changed = 1;
+
+                if (sym->trace_size == sym->trace_alloc){
+                    sym->trace_alloc = BOR_MAX(2 * sym->trace_alloc, 8);
+                    sym->trace = BOR_REALLOC_ARR(sym->trace, int,
+                                                 sym->trace_alloc);
+                }
+                sym->trace[sym->trace_size++] = i;
+            }
+        }
+    }
+}
+
+void planSymmetryGenInit(plan_symmetry_gen_t *gen, const plan_symmetry_t *sym)
+{
+    int v, x, o;
+
+    gen->var = BOR_ALLOC_ARR(plan_var_id_t, BOR_MAX(sym->var_size, 1));
+    gen->val = BOR_ALLOC_ARR(plan_val_t *, BOR_MAX(sym->var_size, 1));
+    for (v = 0; v < sym->var_size; ++v){
+        gen->var[v] = v;
+        gen->val[v] = BOR_ALLOC_ARR(plan_val_t, sym->var_range[v]);
+        for (x = 0; x < sym->var_range[v]; ++x)
+            gen->val[v][x] = x;
+    }
+
+    gen->op = BOR_ALLOC_ARR(int, BOR_MAX(sym->op_size, 1));
+    for (o = 0; o < sym->op_size; ++o)
+        gen->op[o] = o;
+}
+
+void planSymmetryGenFree(plan_symmetry_gen_t *gen, const plan_symmetry_t *sym)
+{
+    int v;
+
+    for (v = 0; v < sym->var_size; ++v)
+        BOR_FREE(gen->val[v]);
+    BOR_FREE(gen->val);
+    BOR_FREE(gen->var);
+    BOR_FREE(gen->op);
+}
+
+/** Sets dst = src o g^-1, i.e., dst(g(x)) = src(x) */
+static void composeInv(plan_symmetry_gen_t *dst,
+                       const plan_symmetry_gen_t *src,
+                       const plan_symmetry_gen_t *g,
+                       const plan_symmetry_t *sym)
+{
+    int v, x, o;
+
+    for (v = 0; v < sym->var_size; ++v){
+        dst->var[g->var[v]] = src->var[v];
+        for (x = 0; x < sym->var_range[v]; ++x)
+            dst->val[g->var[v]][g->val[v][x]] = src->val[v][x];
+    }
+    for (o = 0; o < sym->op_size; ++o)
+        dst->op[g->op[o]] = src->op[o];
+}
+
+void planSymmetryGenUncanon(plan_symmetry_gen_t *gen,
+                            const plan_symmetry_t *sym)
+{
+    plan_symmetry_gen_t tmp, swp;
+    int i;
+
+    if (sym->trace_size == 0)
+        return;
+
+    // The canonicalization is g_k o ... o g_1, so its inverse is
+    // g_1^-1 o ... o g_k^-1
+    planSymmetryGenInit(&tmp, sym);
+    for (i = 0; i < sym->trace_size; ++i){
+        composeInv(&tmp, gen, sym->gen + sym->trace[i], sym);
+        swp = *gen;
+        *gen = tmp;
+        tmp = swp;
+    }
+    planSymmetryGenFree(&tmp, sym);
+}
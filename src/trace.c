@@ -0,0 +1,255 @@
+/***
+ * maplan
+ * -------
+ * Copyright (c)2015 Daniel Fiser <danfis@danfis.cz>,
+ * Agent Technology Center, Department of Computer Science,
+ * Faculty of Electrical Engineering, Czech Technical University in Prague.
+ * All rights reserved.
+ *
+ * This file is part of maplan.
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file BDS-LICENSE for details or see
+ * <http://www.opensource.org/licenses/bsd-license.php>.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <boruvka/alloc.h>
+
+#include "plan/trace.h"
+
+/** One recorded event */
+struct _event_t {
+    long ts;           /*!< Timestamp in nanoseconds */
+    const char *cat;
+    const char *name;
+    const char *arg[4];
+    long val[4];
+    char ph;           /*!< Phase: 'B', 'E', 'i' */
+};
+typedef struct _event_t event_t;
+
+/** Per-thread buffer of events */
+typedef struct _thread_buf_t thread_buf_t;
+struct _thread_buf_t {
+    int tid;
+    char name[32];
+    event_t *event;
+    int event_size;
+    int event_alloc;
+    long dropped;
+    thread_buf_t *next;
+};
+
+int plan_trace_enabled = 0;
+
+static FILE *trace_fout = NULL;
+static long trace_start = 0L;
+static thread_buf_t *trace_bufs = NULL;
+static int trace_next_tid = 0;
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static int trace_gen = 0;
+static __thread thread_buf_t *trace_buf = NULL;
+static __thread int trace_buf_gen = -1;
+
+static long nowNS(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000000L + t.tv_nsec;
+}
+
+static thread_buf_t *threadBuf(void)
+{
+    thread_buf_t *buf;
+
+    /* Buffers of the previous runs are already freed */
+    if (trace_buf != NULL && trace_buf_gen == trace_gen)
+        return trace_buf;
+
+    buf = BOR_ALLOC(thread_buf_t);
+    bzero(buf, sizeof(*buf));
+
+    pthread_mutex_lock(&trace_lock);
+    buf->tid = trace_next_tid++;
+    buf->next = trace_bufs;
+    trace_bufs = buf;
+    pthread_mutex_unlock(&trace_lock);
+
+    trace_buf = buf;
+    trace_buf_gen = trace_gen;
+    return buf;
+}
+
+int planTraceStart(const char *fn)
+{
+    if (plan_trace_enabled){
+        fprintf(stderr, "Trace Error: Tracing is already running.\n");
+        return -1;
+    }
+
+    trace_fout = fopen(fn, "w");
+    if (trace_fout == NULL){
+        fprintf(stderr, "Trace Error: Could not open `%s'.\n", fn);
+        return -1;
+    }
+
+    trace_start = nowNS();
+    plan_trace_enabled = 1;
+    return 0;
+}
+
+static void writeStr(FILE *fout, const char *s)
+{
+    fputc('"', fout);
+    for (; *s; ++s){
+        if (*s == '"' || *s == '\\'){
+            fputc('\\', fout);
+            fputc(*s, fout);
+        }else if ((unsigned char)*s < 0x20){
+            fprintf(fout, "\\u%04x", (int)(unsigned char)*s);
+        }else{
+            fputc(*s, fout);
+        }
+    }
+    fputc('"', fout);
+}
+
+static void writeEvent(FILE *fout, int pid, int tid, const event_t *ev)
+{
+    int i, first;
+
+    fprintf(fout, "{\"ph\":\"%c\",\"pid\":%d,\"tid\":%d,\"ts\":%ld.%03ld,",
+            ev->ph, pid, tid, ev->ts / 1000L, ev->ts % 1000L);
+    fprintf(fout, "\"cat\":");
+    writeStr(fout, ev->cat);
+    fprintf(fout, ",\"name\":");
+    writeStr(fout, ev->name);
+    if (ev->ph == 'i')
+        fprintf(fout, ",\"s\":\"t\"");
+
+    first = 1;
+    for (i = 0; i < 4; ++i){
+        if (ev->arg[i] == NULL)
+            continue;
+        fprintf(fout, first ? ",\"args\":{" : ",");
+        writeStr(fout, ev->arg[i]);
+        fprintf(fout, ":%ld", ev->val[i]);
+        first = 0;
+    }
+    if (!first)
+        fprintf(fout, "}");
+    fprintf(fout, "}");
+}
+
+void planTraceStop(void)
+{
+    thread_buf_t *buf, *next;
+    int i, pid, first;
+    long dropped = 0L;
+
+    if (!plan_trace_enabled)
+        return;
+    plan_trace_enabled = 0;
+
+    pid = getpid();
+    fprintf(trace_fout, "{\"traceEvents\":[\n");
+    first = 1;
+    for (buf = trace_bufs; buf != NULL; buf = buf->next){
+        if (buf->name[0] != 0x0){
+            fprintf(trace_fout, "%s{\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+                                "\"name\":\"thread_name\",\"args\":{\"name\":",
+                    (first ? "" : ",\n"), pid, buf->tid);
+            writeStr(trace_fout, buf->name);
+            fprintf(trace_fout, "}}");
+            first = 0;
+        }
+
+        for (i = 0; i < buf->event_size; ++i){
+            if (!first)
+                fprintf(trace_fout, ",\n");
+            writeEvent(trace_fout, pid, buf->tid, buf->event + i);
+            first = 0;
+        }
+        dropped += buf->dropped;
+    }
+    fprintf(trace_fout, "\n],\"displayTimeUnit\":\"ms\","
+                        "\"otherData\":{\"dropped_events\":%ld}}\n", dropped);
+    fclose(trace_fout);
+    trace_fout = NULL;
+
+    if (dropped > 0L){
+        fprintf(stderr, "Trace Warning: %ld events were dropped.\n",
+                dropped);
+    }
+
+    for (buf = trace_bufs; buf != NULL; buf = next){
+        next = buf->next;
+        if (buf->event)
+            BOR_FREE(buf->event);
+        BOR_FREE(buf);
+    }
+    trace_bufs = NULL;
+    trace_next_tid = 0;
+    ++trace_gen;
+}
+
+void planTraceThreadName(const char *name)
+{
+    thread_buf_t *buf;
+
+    if (!plan_trace_enabled)
+        return;
+
+    buf = threadBuf();
+    strncpy(buf->name, name, sizeof(buf->name) - 1);
+    buf->name[sizeof(buf->name) - 1] = 0x0;
+}
+
+void _planTraceEvent(char ph, const char *cat, const char *name,
+                     const char *arg1, long val1,
+                     const char *arg2, long val2,
+                     const char *arg3, long val3,
+                     const char *arg4, long val4)
+{
+    thread_buf_t *buf = threadBuf();
+    event_t *ev;
+
+    if (buf->event_size == buf->event_alloc){
+        if (buf->event_alloc >= PLAN_TRACE_MAX_EVENTS){
+            ++buf->dropped;
+            return;
+        }
+
+        if (buf->event_alloc == 0){
+            buf->event_alloc = 1024;
+        }else{
+            buf->event_alloc *= 2;
+        }
+        buf->event_alloc = BOR_MIN(buf->event_alloc, PLAN_TRACE_MAX_EVENTS);
+        buf->event = BOR_REALLOC_ARR(buf->event, event_t, buf->event_alloc);
+    }
+
+    ev = buf->event + buf->event_size++;
+    ev->ts = nowNS() - trace_start;
+    ev->ph = ph;
+    ev->cat = cat;
+    ev->name = name;
+    ev->arg[0] = arg1;
+    ev->val[0] = val1;
+    ev->arg[1] = arg2;
+    ev->val[1] = val2;
+    ev->arg[2] = arg3;
+    ev->val[2] = val3;
+    ev->arg[3] = arg4;
+    ev->val[3] = val4;
+}
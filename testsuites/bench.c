@@ -0,0 +1,623 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <dirent.h>
+#include <boruvka/alloc.h>
+#include <plan/problem.h>
+#include <plan/heur.h>
+#include <plan/list.h>
+#include <plan/list_lazy.h>
+
+/**
+ * Microbenchmarks of core kernels of the planner.
+ *
+ * For each problem a corpus of states is sampled by random walks from the
+ * initial state (with a fixed seed, so the corpus is always the same) and
+ * each kernel is run over the whole corpus. Every kernel is first run
+ * -w times without measurement and then -r times measured. The median,
+ * minimum and maximum time per operation over the measured repetitions
+ * is reported as CSV or as JSON lines.
+ */
+
+#define DEFAULT_PROTO_DIR "proto"
+#define WALK_LEN 50
+
+struct _bench_opts_t {
+    int reps;
+    int warmup;
+    int num_states;
+    unsigned long seed;
+    int json;
+    const char *heur;   /*!< Comma-separated list of heuristics or NULL */
+    const char *kernel; /*!< Only kernels with this prefix or NULL */
+};
+typedef struct _bench_opts_t bench_opts_t;
+
+struct _corpus_t {
+    plan_problem_t *prob;
+    plan_state_t **state;   /*!< Unpacked states */
+    plan_state_id_t *id;    /*!< IDs of the states in prob->state_pool */
+    int size;
+    plan_op_t **op;         /*!< Preallocated array for applicable ops */
+    plan_state_id_t *succ;  /*!< Buffer for successor IDs */
+    plan_cost_t *cost;      /*!< Pseudo-random costs for open-lists */
+};
+typedef struct _corpus_t corpus_t;
+
+/** Runs the kernel once over the whole corpus and returns number of
+ *  performed operations. */
+typedef long (*kernel_fn)(corpus_t *c, void *data);
+/** Prepares data for one run of the kernel or cleans up after it. It is
+ *  called outside of the measured time. */
+typedef void (*kernel_prep_fn)(corpus_t *c, void *data);
+
+static bench_opts_t opts;
+static int printed_header = 0;
+
+/** Simple deterministic generator so that the corpus does not depend on
+ *  the libc implementation. */
+static unsigned long rnd_state;
+static unsigned long rnd(void)
+{
+    rnd_state ^= rnd_state << 13;
+    rnd_state ^= rnd_state >> 7;
+    rnd_state ^= rnd_state << 17;
+    return rnd_state;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1E-9;
+}
+
+static int cmpDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    if (x < y)
+        return -1;
+    if (x > y)
+        return 1;
+    return 0;
+}
+
+static int cmpStr(const void *a, const void *b)
+{
+    return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+static const char *baseName(const char *fn)
+{
+    const char *s = strrchr(fn, '/');
+    if (s != NULL)
+        return s + 1;
+    return fn;
+}
+
+static void report(const char *proto, const char *kernel, long ops,
+                   double *ns, int reps)
+{
+    double med;
+
+    qsort(ns, reps, sizeof(double), cmpDouble);
+    if (reps % 2 == 1){
+        med = ns[reps / 2];
+    }else{
+        med = (ns[reps / 2 - 1] + ns[reps / 2]) / 2.;
+    }
+
+    if (opts.json){
+        printf("{\"problem\":\"%s\",\"kernel\":\"%s\",\"ops\":%ld,"
+               "\"reps\":%d,\"ns_per_op_median\":%.3f,"
+               "\"ns_per_op_min\":%.3f,\"ns_per_op_max\":%.3f,"
+               "\"ops_per_sec\":%.1f}\n",
+               proto, kernel, ops, reps, med, ns[0], ns[reps - 1],
+               (med > 0. ? 1E9 / med : 0.));
+    }else{
+        if (!printed_header){
+            printf("problem,kernel,ops,reps,ns_per_op_median,"
+                   "ns_per_op_min,ns_per_op_max,ops_per_sec\n");
+            printed_header = 1;
+        }
+        printf("%s,%s,%ld,%d,%.3f,%.3f,%.3f,%.1f\n",
+               proto, kernel, ops, reps, med, ns[0], ns[reps - 1],
+               (med > 0. ? 1E9 / med : 0.));
+    }
+    fflush(stdout);
+}
+
+static void run(corpus_t *c, const char *proto, const char *kernel,
+                kernel_fn fn, kernel_prep_fn prep, kernel_prep_fn clean,
+                void *data)
+{
+    double *ns, start;
+    long ops = 0;
+    int i;
+
+    if (opts.kernel != NULL
+            && strncmp(kernel, opts.kernel, strlen(opts.kernel)) != 0)
+        return;
+
+    for (i = 0; i < opts.warmup; ++i){
+        if (prep != NULL)
+            prep(c, data);
+        fn(c, data);
+        if (clean != NULL)
+            clean(c, data);
+    }
+
+    ns = BOR_ALLOC_ARR(double, opts.reps);
+    for (i = 0; i < opts.reps; ++i){
+        if (prep != NULL)
+            prep(c, data);
+        start = now();
+        ops = fn(c, data);
+        ns[i] = (now() - start) * 1E9 / BOR_MAX(ops, 1);
+        if (clean != NULL)
+            clean(c, data);
+    }
+    report(proto, kernel, ops, ns, opts.reps);
+    BOR_FREE(ns);
+}
+
+
+/*** Corpus ***/
+static void corpusInit(corpus_t *c, plan_problem_t *prob)
+{
+    PLAN_STATE_STACK(state, prob->var_size);
+    plan_state_id_t cur;
+    size_t pool_size;
+    int i, len, num_ops, attempts;
+
+    bzero(c, sizeof(*c));
+    c->prob = prob;
+    c->state = BOR_ALLOC_ARR(plan_state_t *, opts.num_states);
+    c->id = BOR_ALLOC_ARR(plan_state_id_t, opts.num_states);
+    c->op = BOR_ALLOC_ARR(plan_op_t *, BOR_MAX(prob->op_size, 1));
+    c->succ = BOR_ALLOC_ARR(plan_state_id_t, opts.num_states);
+    c->cost = BOR_ALLOC_ARR(plan_cost_t, opts.num_states);
+
+    rnd_state = opts.seed;
+    cur = prob->initial_state;
+    len = 0;
+    attempts = 0;
+    c->id[c->size++] = cur;
+    while (c->size < opts.num_states && attempts < 100 * opts.num_states){
+        ++attempts;
+        planStatePoolGetState(prob->state_pool, cur, &state);
+        num_ops = planSuccGenFind(prob->succ_gen, &state,
+                                  c->op, prob->op_size);
+        if (num_ops == 0 || len >= WALK_LEN){
+            cur = prob->initial_state;
+            len = 0;
+            continue;
+        }
+
+        pool_size = planStatePoolSize(prob->state_pool);
+        cur = planOpApply(c->op[rnd() % num_ops], prob->state_pool, cur);
+        // Only states that were not seen yet are added to the corpus
+        if (planStatePoolSize(prob->state_pool) > pool_size)
+            c->id[c->size++] = cur;
+        ++len;
+    }
+
+    for (i = 0; i < c->size; ++i){
+        c->state[i] = planStateNew(prob->var_size);
+        planStatePoolGetState(prob->state_pool, c->id[i], c->state[i]);
+        c->cost[i] = rnd() % 100;
+    }
+}
+
+static void corpusFree(corpus_t *c)
+{
+    int i;
+
+    for (i = 0; i < c->size; ++i)
+        planStateDel(c->state[i]);
+    BOR_FREE(c->state);
+    BOR_FREE(c->id);
+    BOR_FREE(c->op);
+    BOR_FREE(c->succ);
+    BOR_FREE(c->cost);
+}
+
+
+/*** State pool, successor generator, operators ***/
+static void kStatePoolInsertPrep(corpus_t *c, void *data)
+{
+    plan_state_pool_t **pool = (plan_state_pool_t **)data;
+    *pool = planStatePoolNew(c->prob->var, c->prob->var_size);
+}
+
+static long kStatePoolInsert(corpus_t *c, void *data)
+{
+    plan_state_pool_t *pool = *(plan_state_pool_t **)data;
+    int i;
+
+    for (i = 0; i < c->size; ++i)
+        planStatePoolInsert(pool, c->state[i]);
+    return c->size;
+}
+
+static void kStatePoolInsertClean(corpus_t *c, void *data)
+{
+    planStatePoolDel(*(plan_state_pool_t **)data);
+}
+
+static long kStatePoolFind(corpus_t *c, void *_)
+{
+    int i;
+
+    for (i = 0; i < c->size; ++i)
+        c->succ[i] = planStatePoolFind(c->prob->state_pool, c->state[i]);
+    return c->size;
+}
+
+static long kSuccGenFind(corpus_t *c, void *_)
+{
+    int i;
+
+    for (i = 0; i < c->size; ++i){
+        planSuccGenFind(c->prob->succ_gen, c->state[i],
+                        c->op, c->prob->op_size);
+    }
+    return c->size;
+}
+
+static long kOpApply(corpus_t *c, void *_)
+{
+    const plan_op_t *op;
+    long ops = 0;
+    int i, o;
+
+    // Applies each operator on each state where it is applicable. After
+    // the warmup, all successors are already in the pool so this measures
+    // application of the operator and the look-up of the result.
+    for (i = 0; i < c->size; ++i){
+        for (o = 0; o < c->prob->op_size; ++o){
+            op = c->prob->op + o;
+            if (!planPartStateIsSubsetState(op->pre, c->state[i]))
+                continue;
+            planOpApply(op, c->prob->state_pool, c->id[i]);
+            ++ops;
+        }
+    }
+    return ops;
+}
+
+
+/*** Heuristics ***/
+static plan_heur_t *heurNew(const char *name, const plan_problem_t *p)
+{
+    if (strcmp(name, "goalcount") == 0)
+        return planHeurGoalCountNew(p->goal);
+    if (strcmp(name, "add") == 0)
+        return planHeurAddNew(p, 0);
+    if (strcmp(name, "relax-add") == 0)
+        return planHeurRelaxAddNew(p, 0);
+    if (strcmp(name, "max") == 0)
+        return planHeurMaxNew(p, 0);
+    if (strcmp(name, "relax-max") == 0)
+        return planHeurRelaxMaxNew(p, 0);
+    if (strcmp(name, "ff") == 0)
+        return planHeurRelaxFFNew(p, 0);
+    if (strcmp(name, "lm-cut") == 0)
+        return planHeurLMCutNew(p, 0);
+    if (strcmp(name, "relax-lm-cut") == 0)
+        return planHeurRelaxLMCutNew(p, 0);
+    if (strcmp(name, "max2") == 0)
+        return planHeurMax2New(p, 0);
+    if (strcmp(name, "lm-cut2") == 0)
+        return planHeurLMCut2New(p, 0);
+    if (strcmp(name, "dtg") == 0)
+        return planHeurDTGNew(p, 0);
+#ifdef PLAN_LP
+    if (strcmp(name, "flow") == 0)
+        return planHeurFlowNew(p, 0);
+    if (strcmp(name, "pot") == 0){
+        PLAN_STATE_STACK(state, p->var_size);
+        planStatePoolGetState(p->state_pool, p->initial_state, &state);
+        return planHeurPotentialNew(p, &state, 0);
+    }
+#endif /* PLAN_LP */
+    return NULL;
+}
+
+struct _heur_bench_t {
+    const char *name;
+    int max_states;   /*!< Only a prefix of the corpus is used if the
+                           heuristic is too expensive (-1 for no limit) */
+    int no_cond_eff;  /*!< True if conditional effects are not supported */
+    plan_heur_t *heur;
+};
+typedef struct _heur_bench_t heur_bench_t;
+
+/** Incremental LM-Cut needs the state space of a search algorithm so it
+ *  cannot be measured on a bare corpus of states. */
+static heur_bench_t heurs[] = {
+    { "goalcount", -1, 0, NULL },
+    { "add", -1, 0, NULL },
+    { "relax-add", -1, 0, NULL },
+    { "max", -1, 0, NULL },
+    { "relax-max", -1, 0, NULL },
+    { "ff", -1, 0, NULL },
+    { "lm-cut", -1, 0, NULL },
+    { "relax-lm-cut", -1, 0, NULL },
+    { "max2", 20, 0, NULL },
+    { "lm-cut2", 10, 1, NULL },
+    { "dtg", -1, 0, NULL },
+#ifdef PLAN_LP
+    { "flow", 100, 0, NULL },
+    { "pot", -1, 0, NULL },
+#endif /* PLAN_LP */
+};
+static int heurs_size = sizeof(heurs) / sizeof(heur_bench_t);
+
+static long kHeur(corpus_t *c, void *data)
+{
+    heur_bench_t *hb = (heur_bench_t *)data;
+    plan_heur_res_t res;
+    int i, size;
+
+    size = c->size;
+    if (hb->max_states > 0)
+        size = BOR_MIN(size, hb->max_states);
+    for (i = 0; i < size; ++i){
+        planHeurResInit(&res);
+        planHeurState(hb->heur, c->state[i], &res);
+    }
+    return size;
+}
+
+static int hasCondEff(const plan_problem_t *p)
+{
+    int i;
+
+    for (i = 0; i < p->op_size; ++i){
+        if (p->op[i].cond_eff_size > 0)
+            return 1;
+    }
+    return 0;
+}
+
+static int heurSelected(const char *name)
+{
+    const char *s;
+    int len = strlen(name);
+
+    if (opts.heur == NULL)
+        return 1;
+    for (s = opts.heur; s != NULL; s = strchr(s, ',')){
+        if (*s == ',')
+            ++s;
+        if (strncmp(s, name, len) == 0 && (s[len] == ',' || s[len] == 0))
+            return 1;
+    }
+    return 0;
+}
+
+
+/*** Open-lists ***/
+static long kList(corpus_t *c, void *_)
+{
+    plan_list_t *list;
+    plan_cost_t cost[2];
+    plan_state_id_t sid;
+    long ops = 0;
+    int i;
+
+    list = planListTieBreaking(2);
+    for (i = 0; i < c->size; ++i){
+        cost[0] = c->cost[i];
+        cost[1] = c->cost[c->size - i - 1];
+        planListPush(list, cost, c->id[i]);
+        ++ops;
+    }
+    while (planListPop(list, &sid, cost) == 0)
+        ++ops;
+    planListDel(list);
+    return ops;
+}
+
+struct _lazy_list_t {
+    const char *name;
+    plan_list_lazy_t *(*new_fn)(void);
+};
+typedef struct _lazy_list_t lazy_list_t;
+
+static lazy_list_t lazy_lists[] = {
+    { "list-lazy-fifo", planListLazyFifoNew },
+    { "list-lazy-heap", planListLazyHeapNew },
+    { "list-lazy-bucket", planListLazyBucketNew },
+    { "list-lazy-rbtree", planListLazyRBTreeNew },
+    { "list-lazy-splaytree", planListLazySplayTreeNew },
+};
+static int lazy_lists_size = sizeof(lazy_lists) / sizeof(lazy_list_t);
+
+static long kListLazy(corpus_t *c, void *data)
+{
+    const lazy_list_t *ll = (const lazy_list_t *)data;
+    plan_list_lazy_t *list;
+    plan_state_id_t sid;
+    plan_op_t *op;
+    long ops = 0;
+    int i;
+
+    list = ll->new_fn();
+    for (i = 0; i < c->size; ++i){
+        planListLazyPush(list, c->cost[i], c->id[i], NULL);
+        ++ops;
+    }
+    while (planListLazyPop(list, &sid, &op) == 0)
+        ++ops;
+    planListLazyDel(list);
+    return ops;
+}
+
+
+static int benchProblem(const char *fn)
+{
+    plan_problem_t *prob;
+    plan_state_pool_t *pool;
+    corpus_t corpus;
+    const char *name = baseName(fn);
+    char kname[128];
+    int i;
+
+    prob = planProblemFromProto(fn, PLAN_PROBLEM_USE_CG);
+    if (prob == NULL){
+        fprintf(stderr, "Error: Could not load file `%s'\n", fn);
+        return -1;
+    }
+
+    corpusInit(&corpus, prob);
+
+    run(&corpus, name, "state-pool-insert", kStatePoolInsert,
+        kStatePoolInsertPrep, kStatePoolInsertClean, &pool);
+    run(&corpus, name, "state-pool-find", kStatePoolFind, NULL, NULL, NULL);
+    run(&corpus, name, "succ-gen-find", kSuccGenFind, NULL, NULL, NULL);
+    run(&corpus, name, "op-apply", kOpApply, NULL, NULL, NULL);
+
+    for (i = 0; i < heurs_size; ++i){
+        if (!heurSelected(heurs[i].name))
+            continue;
+        sprintf(kname, "heur-%s", heurs[i].name);
+        if (opts.kernel != NULL
+                && strncmp(kname, opts.kernel, strlen(opts.kernel)) != 0)
+            continue;
+        if (heurs[i].no_cond_eff && hasCondEff(prob)){
+            fprintf(stderr, "Skipping %s on %s: conditional effects are"
+                            " not supported.\n", kname, name);
+            continue;
+        }
+
+        heurs[i].heur = heurNew(heurs[i].name, prob);
+        if (heurs[i].heur == NULL){
+            fprintf(stderr, "Error: Cannot create heuristic `%s'\n",
+                    heurs[i].name);
+            continue;
+        }
+        run(&corpus, name, kname, kHeur, NULL, NULL, heurs + i);
+        planHeurDel(heurs[i].heur);
+        heurs[i].heur = NULL;
+    }
+
+    run(&corpus, name, "list-tiebreaking", kList, NULL, NULL, NULL);
+    for (i = 0; i < lazy_lists_size; ++i){
+        run(&corpus, name, lazy_lists[i].name, kListLazy, NULL, NULL,
+            lazy_lists + i);
+    }
+
+    corpusFree(&corpus);
+    planProblemDel(prob);
+    return 0;
+}
+
+static char **protoFilesInDir(const char *dirname, int *size)
+{
+    DIR *dir;
+    struct dirent *ent;
+    char **files = NULL;
+    int len;
+
+    *size = 0;
+    dir = opendir(dirname);
+    if (dir == NULL){
+        fprintf(stderr, "Error: Could not open directory `%s'\n", dirname);
+        return NULL;
+    }
+
+    while ((ent = readdir(dir)) != NULL){
+        len = strlen(ent->d_name);
+        if (len < 7 || strcmp(ent->d_name + len - 6, ".proto") != 0)
+            continue;
+        files = BOR_REALLOC_ARR(files, char *, *size + 1);
+        files[*size] = BOR_ALLOC_ARR(char, strlen(dirname) + len + 2);
+        sprintf(files[*size], "%s/%s", dirname, ent->d_name);
+        ++*size;
+    }
+    closedir(dir);
+
+    qsort(files, *size, sizeof(char *), cmpStr);
+    return files;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [OPTIONS] [problem.proto ...]\n", prog);
+    fprintf(stderr, "  If no problem is given, all problems from %s/ are"
+                    " used.\n", DEFAULT_PROTO_DIR);
+    fprintf(stderr, "  OPTIONS:\n");
+    fprintf(stderr, "    -r int   Measured repetitions (default: 5)\n");
+    fprintf(stderr, "    -w int   Warmup repetitions (default: 1)\n");
+    fprintf(stderr, "    -n int   Number of sampled states (default: 1000)\n");
+    fprintf(stderr, "    -s int   Seed of the sampling (default: 1)\n");
+    fprintf(stderr, "    -f csv|json  Output format (default: csv)\n");
+    fprintf(stderr, "    -H str   Comma-separated list of heuristics\n");
+    fprintf(stderr, "    -k str   Run only kernels with the given prefix\n");
+}
+
+int main(int argc, char *argv[])
+{
+    char **files = NULL;
+    int i, c, files_size = 0, ret = 0;
+
+    opts.reps = 5;
+    opts.warmup = 1;
+    opts.num_states = 1000;
+    opts.seed = 1;
+    opts.json = 0;
+    opts.heur = NULL;
+    opts.kernel = NULL;
+
+    while ((c = getopt(argc, argv, "r:w:n:s:f:H:k:h")) != -1){
+        if (c == 'r'){
+            opts.reps = atoi(optarg);
+        }else if (c == 'w'){
+            opts.warmup = atoi(optarg);
+        }else if (c == 'n'){
+            opts.num_states = atoi(optarg);
+        }else if (c == 's'){
+            opts.seed = strtoul(optarg, NULL, 10);
+        }else if (c == 'f' && strcmp(optarg, "json") == 0){
+            opts.json = 1;
+        }else if (c == 'f' && strcmp(optarg, "csv") == 0){
+            opts.json = 0;
+        }else if (c == 'H'){
+            opts.heur = optarg;
+        }else if (c == 'k'){
+            opts.kernel = optarg;
+        }else{
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    if (opts.reps < 1 || opts.warmup < 0 || opts.num_states < 1){
+        usage(argv[0]);
+        return -1;
+    }
+    // xorshift must not be seeded with zero
+    if (opts.seed == 0)
+        opts.seed = 1;
+
+    if (optind < argc){
+        for (i = optind; i < argc; ++i)
+            ret |= benchProblem(argv[i]);
+    }else{
+        files = protoFilesInDir(DEFAULT_PROTO_DIR, &files_size);
+        if (files == NULL)
+            return -1;
+        for (i = 0; i < files_size; ++i){
+            ret |= benchProblem(files[i]);
+            BOR_FREE(files[i]);
+        }
+        BOR_FREE(files);
+    }
+
+    return ret;
+}
@@ -1,7 +1,7 @@
 #include <cu/cu.h>
 #include <plan/fa_mutex.h>
 
-void faMutex(const char *fn, unsigned flags)
+void faMutex(const char *fn, unsigned flags, int native_threads)
 {
     plan_problem_t *prob;
     plan_mutex_group_set_t ms;
@@ -16,7 +16,11 @@ void faMutex(const char *fn, unsigned flags)
     //    printf("var[%d]: %d\n", i, prob->var[i].range);
 
     planMutexGroupSetInit(&ms);
-    planFAMutexFind(prob, &state, &ms, flags);
+    if (native_threads > 0){
+        planFAMutexFindNative(prob, &state, &ms, flags, native_threads);
+    }else{
+        planFAMutexFind(prob, &state, &ms, flags);
+    }
     planMutexGroupSetSort(&ms);
     for (i = 0; i < ms.group_size; ++i){
         printf("fa-mutex[%d]: is-goal: %d", i, ms.group[i].is_goal);
@@ -30,17 +34,17 @@ void faMutex(const char *fn, unsigned flags)
 
 TEST(testFAMutex)
 {
-    faMutex("proto/simple.proto", 0);
-    faMutex("proto/depot-pfile1.proto", 0);
-    faMutex("proto/depot-pfile2.proto", 0);
-    faMutex("proto/depot-pfile5.proto", 0);
-    faMutex("proto/driverlog-pfile1.proto", 0);
-    faMutex("proto/driverlog-pfile3.proto", 0);
-    faMutex("proto/openstacks-p03.proto", 0);
-    faMutex("proto/rovers-p01.proto", 0);
-    faMutex("proto/rovers-p02.proto", 0);
-    faMutex("proto/rovers-p03.proto", 0);
-    faMutex("proto/rovers-p15.proto", 0);
+    faMutex("proto/simple.proto", 0, 0);
+    faMutex("proto/depot-pfile1.proto", 0, 0);
+    faMutex("proto/depot-pfile2.proto", 0, 0);
+    faMutex("proto/depot-pfile5.proto", 0, 0);
+    faMutex("proto/driverlog-pfile1.proto", 0, 0);
+    faMutex("proto/driverlog-pfile3.proto", 0, 0);
+    faMutex("proto/openstacks-p03.proto", 0, 0);
+    faMutex("proto/rovers-p01.proto", 0, 0);
+    faMutex("proto/rovers-p02.proto", 0, 0);
+    faMutex("proto/rovers-p03.proto", 0, 0);
+    faMutex("proto/rovers-p15.proto", 0, 0);
 }
 
 TEST(testFAMutexGoal)
@@ -49,15 +53,49 @@ TEST(testFAMutexGoal)
 
     flags = PLAN_FA_MUTEX_ONLY_GOAL;
 
-    faMutex("proto/simple.proto", flags);
-    faMutex("proto/depot-pfile1.proto", flags);
-    faMutex("proto/depot-pfile2.proto", flags);
-    faMutex("proto/depot-pfile5.proto", flags);
-    faMutex("proto/driverlog-pfile1.proto", flags);
-    faMutex("proto/driverlog-pfile3.proto", flags);
-    faMutex("proto/openstacks-p03.proto", flags);
-    faMutex("proto/rovers-p01.proto", flags);
-    faMutex("proto/rovers-p02.proto", flags);
-    faMutex("proto/rovers-p03.proto", flags);
-    faMutex("proto/rovers-p15.proto", flags);
+    faMutex("proto/simple.proto", flags, 0);
+    faMutex("proto/depot-pfile1.proto", flags, 0);
+    faMutex("proto/depot-pfile2.proto", flags, 0);
+    faMutex("proto/depot-pfile5.proto", flags, 0);
+    faMutex("proto/driverlog-pfile1.proto", flags, 0);
+    faMutex("proto/driverlog-pfile3.proto", flags, 0);
+    faMutex("proto/openstacks-p03.proto", flags, 0);
+    faMutex("proto/rovers-p01.proto", flags, 0);
+    faMutex("proto/rovers-p02.proto", flags, 0);
+    faMutex("proto/rovers-p03.proto", flags, 0);
+    faMutex("proto/rovers-p15.proto", flags, 0);
+}
+
+TEST(testFAMutexNative)
+{
+    faMutex("proto/simple.proto", 0, 4);
+    faMutex("proto/depot-pfile1.proto", 0, 4);
+    faMutex("proto/depot-pfile2.proto", 0, 4);
+    faMutex("proto/depot-pfile5.proto", 0, 4);
+    faMutex("proto/driverlog-pfile1.proto", 0, 4);
+    faMutex("proto/driverlog-pfile3.proto", 0, 4);
+    faMutex("proto/openstacks-p03.proto", 0, 4);
+    faMutex("proto/rovers-p01.proto", 0, 4);
+    faMutex("proto/rovers-p02.proto", 0, 4);
+    faMutex("proto/rovers-p03.proto", 0, 4);
+    faMutex("proto/rovers-p15.proto", 0, 4);
+}
+
+TEST(testFAMutexNativeGoal)
+{
+    unsigned flags;
+
+    flags = PLAN_FA_MUTEX_ONLY_GOAL;
+
+    faMutex("proto/simple.proto", flags, 4);
+    faMutex("proto/depot-pfile1.proto", flags, 4);
+    faMutex("proto/depot-pfile2.proto", flags, 4);
+    faMutex("proto/depot-pfile5.proto", flags, 4);
+    faMutex("proto/driverlog-pfile1.proto", flags, 4);
+    faMutex("proto/driverlog-pfile3.proto", flags, 4);
+    faMutex("proto/openstacks-p03.proto", flags, 4);
+    faMutex("proto/rovers-p01.proto", flags, 4);
+    faMutex("proto/rovers-p02.proto", flags, 4);
+    faMutex("proto/rovers-p03.proto", flags, 4);
+    faMutex("proto/rovers-p15.proto", flags, 4);
 }
@@ -3,9 +3,13 @@
 
 TEST(testFAMutex);
 TEST(testFAMutexGoal);
+TEST(testFAMutexNative);
+TEST(testFAMutexNativeGoal);
 TEST_SUITE(TSFAMutex) {
     TEST_ADD(testFAMutex),
     TEST_ADD(testFAMutexGoal),
+    TEST_ADD(testFAMutexNative),
+    TEST_ADD(testFAMutexNativeGoal),
     TEST_ADD(protobufTearDown),
     TEST_SUITE_CLOSURE
 };
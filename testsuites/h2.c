@@ -0,0 +1,224 @@
+#include <cu/cu.h>
+#include <boruvka/alloc.h>
+#include "plan/problem.h"
+#include "plan/h2.h"
+#include "plan/search.h"
+#include "state_pool.h"
+
+static void h2Mutex(const char *proto, const char *states)
+{
+    plan_problem_t *p;
+    plan_h2_t h2;
+    state_pool_t state_pool;
+    plan_state_t *state;
+    int v1, v2, val1, val2, mutex, unreachable, bad;
+
+    printf("---- %s ----\n", proto);
+    p = planProblemFromProto(proto, PLAN_PROBLEM_USE_CG);
+    state = planStateNew(p->state_pool->num_vars);
+    planStatePoolGetState(p->state_pool, p->initial_state, state);
+
+    planH2Init(&h2, p);
+    planH2Mutex(&h2, state);
+
+    mutex = unreachable = 0;
+    for (v1 = 0; v1 < p->var_size; ++v1){
+        for (val1 = 0; val1 < p->var[v1].range; ++val1){
+            if (!planH2IsReachable(&h2, v1, val1))
+                ++unreachable;
+
+            for (v2 = v1 + 1; v2 < p->var_size; ++v2){
+                for (val2 = 0; val2 < p->var[v2].range; ++val2){
+                    if (planH2IsMutex(&h2, v1, val1, v2, val2))
+                        ++mutex;
+                }
+            }
+        }
+    }
+    printf("Unreachable facts: %d\n", unreachable);
+    printf("Mutex pairs: %d\n", mutex);
+
+    // No pair of facts from a reachable state can be mutex
+    bad = 0;
+    statePoolInit(&state_pool, states);
+    while (statePoolNext(&state_pool, state) == 0){
+        for (v1 = 0; v1 < p->var_size; ++v1){
+            val1 = planStateGet(state, v1);
+            if (!planH2IsReachable(&h2, v1, val1))
+                ++bad;
+            for (v2 = v1 + 1; v2 < p->var_size; ++v2){
+                val2 = planStateGet(state, v2);
+                if (planH2IsMutex(&h2, v1, val1, v2, val2))
+                    ++bad;
+            }
+        }
+    }
+    statePoolFree(&state_pool);
+    assertEquals(bad, 0);
+
+    // The goal is reachable and the value does not change if computed
+    // again
+    planStatePoolGetState(p->state_pool, p->initial_state, state);
+    printf("h^2: %d\n", planH2(&h2, state, p->goal));
+    assertEquals(planH2(&h2, state, p->goal), planH2(&h2, state, p->goal));
+
+    planH2Free(&h2);
+    planStateDel(state);
+    planProblemDel(p);
+}
+
+TEST(testH2Mutex)
+{
+    h2Mutex("proto/simple.proto", "states/simple.txt");
+    h2Mutex("proto/depot-pfile1.proto", "states/depot-pfile1.txt");
+    h2Mutex("proto/depot-pfile5.proto", "states/depot-pfile5.txt");
+    h2Mutex("proto/rovers-p03.proto", "states/rovers-p03.txt");
+    h2Mutex("proto/rovers-p15.proto", "states/rovers-p15.txt");
+}
+
+static plan_cost_t h2PruneSearch(plan_problem_t *p)
+{
+    plan_search_astar_params_t params;
+    plan_search_t *search;
+    plan_path_t path;
+    plan_cost_t cost = -1;
+
+    planSearchAStarParamsInit(&params);
+    params.search.prob = p;
+    params.search.heur = planHeurRelaxLMCutNew(p, 0);
+    params.search.heur_del = 1;
+    search = planSearchAStarNew(&params);
+
+    planPathInit(&path);
+    if (planSearchRun(search, &path) == PLAN_SEARCH_FOUND)
+        cost = planPathCost(&path);
+    planPathFree(&path);
+    planSearchDel(search);
+    return cost;
+}
+
+static void h2Prune(const char *proto)
+{
+    plan_problem_t *p, *pruned;
+    plan_cost_t cost, pruned_cost;
+    int facts, pruned_facts, i;
+
+    printf("---- %s ----\n", proto);
+    p = planProblemFromProto(proto, PLAN_PROBLEM_USE_CG);
+    pruned = planProblemFromProto(proto, PLAN_PROBLEM_USE_CG
+                                            | PLAN_PROBLEM_PRUNE_H2);
+
+    for (facts = 0, i = 0; i < p->var_size; ++i)
+        facts += p->var[i].range;
+    for (pruned_facts = 0, i = 0; i < pruned->var_size; ++i)
+        pruned_facts += pruned->var[i].range;
+    printf("Ops: %d -> %d (removed: %d)\n", p->op_size, pruned->op_size,
+           pruned->h2_ops_removed);
+    printf("Facts: %d -> %d (removed: %d)\n", facts, pruned_facts,
+           pruned->h2_facts_removed);
+    printf("Vars: %d -> %d (removed: %d)\n", p->var_size, pruned->var_size,
+           pruned->h2_vars_removed);
+    printf("Bytes per state: %d -> %d\n",
+           planStatePackerBufSize(p->state_pool->packer),
+           planStatePackerBufSize(pruned->state_pool->packer));
+    assertEquals(p->op_size - pruned->h2_ops_removed, pruned->op_size);
+    assertEquals(facts - pruned->h2_facts_removed, pruned_facts);
+    assertTrue(pruned_facts <= facts);
+
+    // Optimal cost must be preserved
+    cost = h2PruneSearch(p);
+    pruned_cost = h2PruneSearch(pruned);
+    printf("Cost: %d -> %d\n", cost, pruned_cost);
+    assertEquals(cost, pruned_cost);
+
+    planProblemDel(p);
+    planProblemDel(pruned);
+}
+
+TEST(testH2Prune)
+{
+    h2Prune("proto/simple.proto");
+    h2Prune("proto/depot-pfile1.proto");
+    h2Prune("proto/depot-pfile2.proto");
+    h2Prune("proto/driverlog-pfile3.proto");
+    h2Prune("proto/rovers-p03.proto");
+    h2Prune("proto/sokoban-p01.proto");
+    h2Prune("proto/openstacks-p03.proto");
+}
+
+TEST(testH2PruneVars)
+{
+    plan_problem_t p;
+    plan_state_t *state;
+    int i;
+
+    // Variables a, b, c, d with ranges 2, 3, 2, 2; all set to 0 in the
+    // initial state; the goal is b = 1 and d = 0.
+    planProblemInit(&p);
+    p.var_size = 4;
+    p.var = BOR_ALLOC_ARR(plan_var_t, p.var_size);
+    planVarInit(p.var + 0, "a", 2);
+    planVarInit(p.var + 1, "b", 3);
+    planVarInit(p.var + 2, "c", 2);
+    planVarInit(p.var + 3, "d", 2);
+    p.state_pool = planStatePoolNew(p.var, p.var_size);
+    state = planStateNew(p.var_size);
+    for (i = 0; i < p.var_size; ++i)
+        planStateSet(state, i, 0);
+    p.initial_state = planStatePoolInsert(p.state_pool, state);
+    p.goal = planPartStateNew(p.var_size);
+    planPartStateSet(p.goal, 1, 1);
+    planPartStateSet(p.goal, 3, 0);
+
+    p.op_size = 4;
+    p.op = BOR_ALLOC_ARR(plan_op_t, p.op_size);
+    for (i = 0; i < p.op_size; ++i){
+        planOpInit(p.op + i, p.var_size);
+        p.op[i].global_id = i;
+        p.op[i].cost = 1;
+    }
+    // a: 0 -> 1
+    planOpSetName(p.op + 0, "a01");
+    planOpSetPre(p.op + 0, 0, 0);
+    planOpSetEff(p.op + 0, 0, 1);
+    // b: 0 -> 1 if a = 1
+    planOpSetName(p.op + 1, "b01");
+    planOpSetPre(p.op + 1, 0, 1);
+    planOpSetPre(p.op + 1, 1, 0);
+    planOpSetEff(p.op + 1, 1, 1);
+    // b: -> 2 if c = 1 which is unreachable
+    planOpSetName(p.op + 2, "b2");
+    planOpSetPre(p.op + 2, 2, 1);
+    planOpSetEff(p.op + 2, 1, 2);
+    // d: -> 1 which is a dead-end because of the goal
+    planOpSetName(p.op + 3, "d1");
+    planOpSetEff(p.op + 3, 3, 1);
+
+    planProblemPruneH2(&p, NULL);
+    assertEquals(p.h2_ops_removed, 2);
+    assertEquals(p.h2_facts_removed, 3);
+    assertEquals(p.h2_vars_removed, 2);
+    assertEquals(p.op_size, 2);
+    assertEquals(p.var_size, 2);
+    assertEquals(strcmp(p.var[0].name, "a"), 0);
+    assertEquals(strcmp(p.var[1].name, "b"), 0);
+    assertEquals(p.var[1].range, 2);
+    assertEquals(strcmp(p.op[0].name, "a01"), 0);
+    assertEquals(strcmp(p.op[1].name, "b01"), 0);
+    assertEquals(p.op[1].global_id, 1);
+    assertEquals(planPartStateGet(p.op[1].pre, 0), 1);
+    assertEquals(planPartStateGet(p.op[1].pre, 1), 0);
+    assertEquals(planPartStateGet(p.op[1].eff, 1), 1);
+    assertEquals(p.goal->vals_size, 1);
+    assertEquals(planPartStateGet(p.goal, 1), 1);
+
+    planStateDel(state);
+    state = planStateNew(p.var_size);
+    planStatePoolGetState(p.state_pool, p.initial_state, state);
+    assertEquals(planStateGet(state, 0), 0);
+    assertEquals(planStateGet(state, 1), 0);
+    planStateDel(state);
+
+    planProblemPack(&p);
+    planProblemFree(&p);
+}
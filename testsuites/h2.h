@@ -0,0 +1,15 @@
+#ifndef TEST_H2
+#define TEST_H2
+
+TEST(testH2Mutex);
+TEST(testH2Prune);
+TEST(testH2PruneVars);
+TEST_SUITE(TSH2) {
+    TEST_ADD(testH2Mutex),
+    TEST_ADD(testH2Prune),
+    TEST_ADD(testH2PruneVars),
+    TEST_ADD(protobufTearDown),
+    TEST_SUITE_CLOSURE
+};
+
+#endif /* TEST_H2 */
@@ -12,10 +12,21 @@
 TEST(protobufTearDown);
 
 TEST_TS_HEUR(Relax);
-TEST_TS_HEUR(GoalCount);
+
+TEST(testHeurGoalCount);
+TEST(testHeurGoalCountPacked);
+TEST_SUITE(TSHeurGoalCount) {
+    TEST_ADD(testHeurGoalCount),
+    TEST_ADD(testHeurGoalCountPacked),
+    TEST_ADD(protobufTearDown),
+    TEST_SUITE_CLOSURE
+};
+
 TEST_TS_HEUR(RelaxAdd);
 TEST_TS_HEUR(RelaxMax);
 TEST_TS_HEUR(RelaxFF);
+TEST_TS_HEUR(AddMaxFF);
+TEST_TS_HEUR(Cache);
 TEST_TS_HEUR(LMCut);
 TEST_TS_HEUR(DTG);
 
@@ -44,15 +55,19 @@ TEST_SUITE(TSHeurFlow) {
 };
 
 TEST(testHeurPotential);
+TEST(testHeurPotentialEnsemble);
 TEST_SUITE(TSHeurPotential) {
     TEST_ADD(testHeurPotential),
+    TEST_ADD(testHeurPotentialEnsemble),
     TEST_ADD(protobufTearDown),
     TEST_SUITE_CLOSURE
 };
 
 TEST(testHeurH2Max);
+TEST(testHeurH2Max2);
 TEST_SUITE(TSHeurH2) {
     TEST_ADD(testHeurH2Max),
+    TEST_ADD(testHeurH2Max2),
     TEST_ADD(protobufTearDown),
     TEST_SUITE_CLOSURE
 };
@@ -70,6 +85,8 @@ TEST_SUITE(TSHeurH2LMCut) {
     TEST_SUITE_ADD(TSHeurRelaxAdd), \
     TEST_SUITE_ADD(TSHeurRelaxMax), \
     TEST_SUITE_ADD(TSHeurRelaxFF), \
+    TEST_SUITE_ADD(TSHeurAddMaxFF), \
+    TEST_SUITE_ADD(TSHeurCache), \
     TEST_SUITE_ADD(TSHeurLMCut), \
     TEST_SUITE_ADD(TSHeurLMCutInc), \
     TEST_SUITE_ADD(TSHeurDTG), \
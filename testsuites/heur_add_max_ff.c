@@ -0,0 +1,74 @@
+#include <cu/cu.h>
+#include <boruvka/alloc.h>
+#include "plan/heur.h"
+#include "state_pool.h"
+#include "heur_common.h"
+
+static plan_heur_t *addMaxFFNew(plan_problem_t *p)
+{
+    return planHeurAddMaxFFNew(p, 0);
+}
+
+static plan_heur_t *addMaxFF1New(plan_problem_t *p)
+{
+    return planHeurAddMaxFFNew(p, PLAN_HEUR_OP_UNIT_COST);
+}
+
+/** Compares .heur_add and .heur_max with the standalone heuristics */
+static void cmpAddMax(const char *proto, const char *states, unsigned flags)
+{
+    plan_problem_t *p;
+    state_pool_t state_pool;
+    plan_state_t *state;
+    plan_heur_t *heur, *hadd, *hmax;
+    plan_heur_res_t res, res_add, res_max;
+    int add_diff = 0, max_diff = 0;
+
+    p = planProblemFromProto(proto, PLAN_PROBLEM_USE_CG);
+    state = planStateNew(p->state_pool->num_vars);
+    statePoolInit(&state_pool, states);
+    heur = planHeurAddMaxFFNew(p, flags);
+    hadd = planHeurAddNew(p, flags);
+    hmax = planHeurMaxNew(p, flags);
+
+    while (statePoolNext(&state_pool, state) == 0){
+        planHeurResInit(&res);
+        planHeurResInit(&res_add);
+        planHeurResInit(&res_max);
+        planHeurState(heur, state, &res);
+        planHeurState(hadd, state, &res_add);
+        planHeurState(hmax, state, &res_max);
+        add_diff += (res.heur_add != res_add.heur);
+        max_diff += (res.heur_max != res_max.heur);
+    }
+    assertEquals(add_diff, 0);
+    assertEquals(max_diff, 0);
+
+    planHeurDel(heur);
+    planHeurDel(hadd);
+    planHeurDel(hmax);
+    statePoolFree(&state_pool);
+    planStateDel(state);
+    planProblemDel(p);
+}
+
+TEST(testHeurAddMaxFF)
+{
+    cmpAddMax("proto/depot-pfile1.proto", "states/depot-pfile1.txt", 0);
+    cmpAddMax("proto/depot-pfile5.proto", "states/depot-pfile5.txt", 0);
+    cmpAddMax("proto/rovers-p03.proto", "states/rovers-p03.txt", 0);
+    cmpAddMax("proto/rovers-p15.proto", "states/rovers-p15.txt", 0);
+    cmpAddMax("proto/CityCar-p3-2-2-0-1.proto",
+              "states/citycar-p3-2-2-0-1.txt", 0);
+    cmpAddMax("proto/rovers-p15.proto", "states/rovers-p15.txt",
+              PLAN_HEUR_OP_UNIT_COST);
+
+    runHeurTest("add-max-ff", "proto/depot-pfile1.proto",
+            "states/depot-pfile1.txt", addMaxFFNew, 1, 0);
+    runHeurTest("add-max-ff", "proto/rovers-p03.proto",
+            "states/rovers-p03.txt", addMaxFFNew, 0, 0);
+    runHeurTest("add-max-ff", "proto/CityCar-p3-2-2-0-1.proto",
+            "states/citycar-p3-2-2-0-1.txt", addMaxFFNew, 0, 0);
+    runHeurTest("add-max-ff-1", "proto/rovers-p15.proto",
+            "states/rovers-p15.txt", addMaxFF1New, 0, 0);
+}
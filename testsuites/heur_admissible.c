@@ -32,6 +32,13 @@ static plan_heur_t *heurPotential(const plan_problem_t *p)
     return planHeurPotentialNew(p, &init_state, 0);
 }
 
+static plan_heur_t *heurPotentialEnsemble(const plan_problem_t *p)
+{
+    PLAN_STATE_STACK(init_state, p->state_pool->num_vars);
+    planStatePoolGetState(p->state_pool, p->initial_state, &init_state);
+    return planHeurPotentialEnsembleNew(p, &init_state, 16, 4, 0);
+}
+
 static void checkOptimalCost(new_heur_fn new_heur, const char *proto)
 {
     plan_search_astar_params_t params;
@@ -207,3 +214,23 @@ TEST(testHeurAdmissiblePotential)
                       "states/rovers-p03.txt",
                       "states/rovers-p03.cost.txt");
 }
+
+TEST(testHeurAdmissiblePotentialEnsemble)
+{
+    checkOptimalCost(heurPotentialEnsemble, "proto/depot-pfile1.proto");
+    checkOptimalCost(heurPotentialEnsemble, "proto/depot-pfile2.proto");
+    checkOptimalCost(heurPotentialEnsemble, "proto/rovers-p03.proto");
+
+    checkOptimalCost2(heurPotentialEnsemble,
+                      "proto/depot-pfile1.proto",
+                      "states/depot-pfile1.txt",
+                      "states/depot-pfile1.cost.txt");
+    checkOptimalCost2(heurPotentialEnsemble,
+                      "proto/driverlog-pfile1.proto",
+                      "states/driverlog-pfile1.txt",
+                      "states/driverlog-pfile1.cost.txt");
+    checkOptimalCost2(heurPotentialEnsemble,
+                      "proto/rovers-p03.proto",
+                      "states/rovers-p03.txt",
+                      "states/rovers-p03.cost.txt");
+}
@@ -6,6 +6,7 @@ TEST(testHeurAdmissibleMax);
 TEST(testHeurAdmissibleFlow);
 TEST(testHeurAdmissibleFlowLandmarks);
 TEST(testHeurAdmissiblePotential);
+TEST(testHeurAdmissiblePotentialEnsemble);
 TEST(protobufTearDown);
 
 TEST_SUITE(TSHeurAdmissible){
@@ -14,6 +15,7 @@ TEST_SUITE(TSHeurAdmissible){
     TEST_ADD(testHeurAdmissibleFlow),
     TEST_ADD(testHeurAdmissibleFlowLandmarks),
     TEST_ADD(testHeurAdmissiblePotential),
+    TEST_ADD(testHeurAdmissiblePotentialEnsemble),
     TEST_ADD(protobufTearDown),
     TEST_SUITE_CLOSURE
 };
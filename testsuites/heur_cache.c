@@ -0,0 +1,105 @@
+#include <cu/cu.h>
+#include <boruvka/alloc.h>
+#include "plan/heur.h"
+#include "plan/succ_gen.h"
+
+static int cmpOpPtr(const void *a, const void *b)
+{
+    const plan_op_t *o1 = *(const plan_op_t **)a;
+    const plan_op_t *o2 = *(const plan_op_t **)b;
+    return o1 - o2;
+}
+
+static void evalState(plan_heur_t *heur, const plan_state_t *state,
+                      plan_heur_res_t *res, plan_op_t **pref_op,
+                      const plan_problem_t *p)
+{
+    int i;
+
+    for (i = 0; i < p->op_size; ++i)
+        pref_op[i] = p->op + i;
+    planHeurResInit(res);
+    res->pref_op = pref_op;
+    res->pref_op_size = p->op_size;
+    planHeurState(heur, state, res);
+    qsort(res->pref_op, res->pref_size, sizeof(plan_op_t *), cmpOpPtr);
+}
+
+/** Simple deterministic pseudo-random generator */
+static unsigned rnd(unsigned *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return (*seed >> 16u) & 0x7fffu;
+}
+
+static void runCache(const char *proto, int num_states, int capacity)
+{
+    plan_problem_t *p;
+    plan_state_t *state;
+    plan_state_id_t cur;
+    plan_heur_t *heur, *cache;
+    plan_heur_res_t res, res_cache;
+    plan_op_t **pref_op, **pref_op_cache, **app_op;
+    int i, si, num_ops, diff = 0;
+    unsigned seed = 1;
+    long hits, misses;
+
+    // Unimportant variables are kept in the problem on purpose so that
+    // the cache has something to abstract from
+    p = planProblemFromProto(proto, 0);
+    state = planStateNew(p->state_pool->num_vars);
+    pref_op = BOR_ALLOC_ARR(plan_op_t *, p->op_size);
+    pref_op_cache = BOR_ALLOC_ARR(plan_op_t *, p->op_size);
+    app_op = BOR_ALLOC_ARR(plan_op_t *, p->op_size);
+
+    heur = planHeurRelaxFFNew(p, 0);
+    cache = planHeurCacheNew(planHeurRelaxFFNew(p, 0), p, capacity);
+
+    // States are generated by a random walk from the initial state
+    cur = p->initial_state;
+    for (si = 0; si < num_states; ++si){
+        planStatePoolGetState(p->state_pool, cur, state);
+        evalState(heur, state, &res, pref_op, p);
+        for (i = 0; i < 2; ++i){
+            evalState(cache, state, &res_cache, pref_op_cache, p);
+            if (res.heur != res_cache.heur
+                    || res.pref_size != res_cache.pref_size
+                    || memcmp(res.pref_op, res_cache.pref_op,
+                              sizeof(plan_op_t *) * res.pref_size) != 0){
+                ++diff;
+            }
+        }
+
+        num_ops = planSuccGenFind(p->succ_gen, state, app_op, p->op_size);
+        if (num_ops == 0 || si % 50 == 49){
+            cur = p->initial_state;
+        }else{
+            cur = planOpApply(app_op[rnd(&seed) % num_ops],
+                              p->state_pool, cur);
+        }
+    }
+    assertEquals(diff, 0);
+
+    planHeurCacheStat(cache, &hits, &misses);
+    assertTrue(hits > num_states);
+    printf("%s: capacity: %d, hits: %ld, misses: %ld\n",
+           proto, capacity, hits, misses);
+
+    planHeurDel(heur);
+    planHeurDel(cache);
+    BOR_FREE(pref_op);
+    BOR_FREE(pref_op_cache);
+    BOR_FREE(app_op);
+    planStateDel(state);
+    planProblemDel(p);
+}
+
+TEST(testHeurCache)
+{
+    runCache("proto/depot-pfile1.proto", 500, 1000);
+    runCache("proto/driverlog-pfile3.proto", 500, 1000);
+    runCache("proto/rovers-p03.proto", 500, 1000);
+    runCache("proto/rovers-p15.proto", 500, 1000);
+    runCache("proto/rovers-p15.proto", 500, 10);
+    runCache("proto/CityCar-p3-2-2-0-1.proto", 500, 1000);
+}
@@ -7,6 +7,11 @@ static plan_heur_t *dtgNew(plan_problem_t *p)
     return planHeurDTGNew(p, 0);
 }
 
+static plan_heur_t *dtgAllPairsNew(plan_problem_t *p)
+{
+    return planHeurDTGNew(p, PLAN_HEUR_DTG_ALL_PAIRS);
+}
+
 TEST(testHeurDTG)
 {
     runHeurTest("DTG", "proto/depot-pfile1.proto",
@@ -19,4 +24,11 @@ TEST(testHeurDTG)
             "states/rovers-p15.txt", dtgNew, 0, 0);
     runHeurTest("DTG", "proto/CityCar-p3-2-2-0-1.proto",
             "states/citycar-p3-2-2-0-1.txt", dtgNew, 0, 0);
+
+    runHeurTest("DTG-all-pairs", "proto/depot-pfile5.proto",
+            "states/depot-pfile5.txt", dtgAllPairsNew, 1, 0);
+    runHeurTest("DTG-all-pairs", "proto/rovers-p15.proto",
+            "states/rovers-p15.txt", dtgAllPairsNew, 0, 0);
+    runHeurTest("DTG-all-pairs", "proto/CityCar-p3-2-2-0-1.proto",
+            "states/citycar-p3-2-2-0-1.txt", dtgAllPairsNew, 0, 0);
 }
@@ -1,5 +1,6 @@
 #include <cu/cu.h>
 #include "plan/heur.h"
+#include "plan/search.h"
 #include "heur_common.h"
 
 static plan_heur_t *goalCountNew(plan_problem_t *p)
@@ -22,3 +23,59 @@ TEST(testHeurGoalCount)
                 "states/citycar-p3-2-2-0-1.txt", goalCountNew, 0, 0);
 }
 
+
+static void goalCountPacked(const char *proto)
+{
+    plan_search_lazy_params_t params;
+    plan_search_t *search;
+    plan_heur_t *heur;
+    plan_heur_res_t res, res2;
+    plan_path_t path;
+    plan_state_t *state;
+    plan_state_id_t sid;
+    int num_states, ok;
+
+    planSearchLazyParamsInit(&params);
+    params.search.prob = planProblemFromProto(proto, PLAN_PROBLEM_USE_CG);
+    params.search.heur = planHeurGoalCountNew(params.search.prob->goal);
+    params.list = planListLazyHeapNew();
+    search = planSearchLazyNew(&params);
+
+    planPathInit(&path);
+    assertEquals(planSearchRun(search, &path), PLAN_SEARCH_FOUND);
+
+    // Goal counts computed (incrementally) on packed states during the
+    // search must be the same as the ones computed on unpacked states
+    heur = planHeurGoalCountNew(params.search.prob->goal);
+    state = planStateNew(search->state_pool->num_vars);
+    num_states = planStatePoolSize(search->state_pool);
+    ok = 1;
+    for (sid = 0; sid < num_states; ++sid){
+        planHeurResInit(&res);
+        planHeurNode(params.search.heur, sid, search, &res);
+        planHeurResInit(&res2);
+        planStatePoolGetState(search->state_pool, sid, state);
+        planHeurState(heur, state, &res2);
+        if (res.heur != res2.heur)
+            ok = 0;
+    }
+    assertTrue(ok);
+    printf("%s: states: %d, plan cost: %d\n", proto, num_states,
+           (int)planPathCost(&path));
+
+    planStateDel(state);
+    planHeurDel(heur);
+    planPathFree(&path);
+    planListLazyDel(params.list);
+    planHeurDel(params.search.heur);
+    planSearchDel(search);
+    planProblemDel(params.search.prob);
+}
+
+TEST(testHeurGoalCountPacked)
+{
+    goalCountPacked("proto/depot-pfile2.proto");
+    goalCountPacked("proto/driverlog-pfile3.proto");
+    goalCountPacked("proto/rovers-p03.proto");
+    goalCountPacked("proto/sokoban-p01.proto");
+}
@@ -10,6 +10,11 @@ static plan_heur_t *h2New(plan_problem_t *p)
     return planHeurH2MaxNew(p, 0);
 }
 
+static plan_heur_t *max2New(plan_problem_t *p)
+{
+    return planHeurMax2New(p, 0);
+}
+
 TEST(testHeurH2Max)
 {
     runHeurTest("h2", "proto/simple.proto",
@@ -23,3 +28,44 @@ TEST(testHeurH2Max)
     runHeurTest("h2", "proto/rovers-p15.proto",
             "states/rovers-p15.txt", h2New, 0, 0);
 }
+
+/** Compares the bit-parallel h^2 with the reference h^2 on all states */
+static void cmpH2Max2(const char *proto, const char *states)
+{
+    plan_problem_t *p;
+    state_pool_t state_pool;
+    plan_state_t *state;
+    plan_heur_t *h2, *max2;
+    plan_heur_res_t res_h2, res_max2;
+    int diff = 0;
+
+    p = planProblemFromProto(proto, PLAN_PROBLEM_USE_CG);
+    state = planStateNew(p->state_pool->num_vars);
+    statePoolInit(&state_pool, states);
+    h2 = h2New(p);
+    max2 = max2New(p);
+
+    while (statePoolNext(&state_pool, state) == 0){
+        planHeurResInit(&res_h2);
+        planHeurResInit(&res_max2);
+        planHeurState(h2, state, &res_h2);
+        planHeurState(max2, state, &res_max2);
+        diff += (res_h2.heur != res_max2.heur);
+    }
+    assertEquals(diff, 0);
+
+    planHeurDel(h2);
+    planHeurDel(max2);
+    statePoolFree(&state_pool);
+    planStateDel(state);
+    planProblemDel(p);
+}
+
+TEST(testHeurH2Max2)
+{
+    cmpH2Max2("proto/simple.proto", "states/simple.txt");
+    cmpH2Max2("proto/depot-pfile1.proto", "states/depot-pfile1.txt");
+    cmpH2Max2("proto/depot-pfile5.proto", "states/depot-pfile5.txt");
+    cmpH2Max2("proto/rovers-p03.proto", "states/rovers-p03.txt");
+    cmpH2Max2("proto/rovers-p15.proto", "states/rovers-p15.txt");
+}
@@ -11,6 +11,16 @@ plan_heur_t *maHeurMax(const plan_problem_t *prob)
     return planHeurMARelaxMaxNew(prob, 0);
 }
 
+plan_heur_t *maHeurDTG(const plan_problem_t *prob)
+{
+    return planHeurMADTGNew(prob, 0);
+}
+
+plan_heur_t *maHeurDTGAllPairs(const plan_problem_t *prob)
+{
+    return planHeurMADTGNew(prob, PLAN_HEUR_DTG_ALL_PAIRS);
+}
+
 plan_heur_t *seqHeurMaxNew(const plan_problem_t *prob)
 {
     return planHeurRelaxMaxNew(prob, 0);
@@ -245,13 +255,17 @@ TEST(testHeurMALMCut)
 TEST(testHeurMADTG)
 {
     runTestHeurMA("ma-dtg", "proto/simple.proto",
-                  "states/simple.txt", NULL, planHeurMADTGNew, -1, NULL);
+                  "states/simple.txt", NULL, maHeurDTG, -1, NULL);
     runTestHeurMA("ma-dtg", "proto/depot-pfile1.proto",
-                  "states/depot-pfile1.txt", NULL, planHeurMADTGNew, -1, NULL);
+                  "states/depot-pfile1.txt", NULL, maHeurDTG, -1, NULL);
     runTestHeurMA("ma-dtg", "proto/depot-pfile5.proto",
-                  "states/depot-pfile5.txt", NULL, planHeurMADTGNew, 200, NULL);
+                  "states/depot-pfile5.txt", NULL, maHeurDTG, 200, NULL);
     runTestHeurMA("ma-dtg", "proto/rovers-p03.proto",
-                  "states/rovers-p03.txt", NULL, planHeurMADTGNew, -1, NULL);
+                  "states/rovers-p03.txt", NULL, maHeurDTG, -1, NULL);
     runTestHeurMA("ma-dtg", "proto/rovers-p15.proto",
-                  "states/rovers-p15.txt", NULL, planHeurMADTGNew, -1, NULL);
+                  "states/rovers-p15.txt", NULL, maHeurDTG, -1, NULL);
+    runTestHeurMA("ma-dtg-all-pairs", "proto/depot-pfile1.proto",
+                  "states/depot-pfile1.txt", NULL, maHeurDTGAllPairs, -1, NULL);
+    runTestHeurMA("ma-dtg-all-pairs", "proto/rovers-p03.proto",
+                  "states/rovers-p03.txt", NULL, maHeurDTGAllPairs, -1, NULL);
 }
@@ -4,8 +4,9 @@
 #include "plan/search.h"
 #include "state_pool.h"
 
-static void runAStar(const char *proto, unsigned flags,
-                     int expected_cost)
+static void _runAStar(const char *proto, unsigned flags,
+                      int ensemble_size, int num_threads,
+                      int expected_cost)
 {
     plan_search_astar_params_t params;
     plan_search_t *search;
@@ -19,7 +20,8 @@ static void runAStar(const char *proto, unsigned flags,
     planStatePoolGetState(p->state_pool, p->initial_state, state);
 
     planSearchAStarParamsInit(&params);
-    params.search.heur = planHeurPotentialNew(p, state, flags);
+    params.search.heur = planHeurPotentialEnsembleNew(p, state, ensemble_size,
+                                                      num_threads, flags);
     //params.search.heur = planHeurLMCutNew(p->var, p->var_size, p->goal,
     //                                      p->op, p->op_size, flags);
     planStateDel(state);
@@ -43,6 +45,50 @@ static void runAStar(const char *proto, unsigned flags,
     assertEquals(cost, expected_cost);
 }
 
+static void runAStar(const char *proto, unsigned flags,
+                     int expected_cost)
+{
+    _runAStar(proto, flags, 1, 1, expected_cost);
+}
+
+/** Checks that the ensemble dominates the single potential function and
+ *  that the values do not depend on the number of threads */
+static void checkEnsemble(const char *proto, const char *states,
+                          int ensemble_size)
+{
+    plan_problem_t *p;
+    plan_state_t *state;
+    state_pool_t state_pool;
+    plan_heur_t *heur, *ens, *ens_par;
+    plan_heur_res_t res, res_ens, res_ens_par;
+
+    p = planProblemFromProto(proto, PLAN_PROBLEM_USE_CG);
+    state = planStateNew(p->state_pool->num_vars);
+    planStatePoolGetState(p->state_pool, p->initial_state, state);
+    heur = planHeurPotentialNew(p, state, 0);
+    ens = planHeurPotentialEnsembleNew(p, state, ensemble_size, 1, 0);
+    ens_par = planHeurPotentialEnsembleNew(p, state, ensemble_size, 4, 0);
+
+    statePoolInit(&state_pool, states);
+    while (statePoolNext(&state_pool, state) == 0){
+        planHeurResInit(&res);
+        planHeurState(heur, state, &res);
+        planHeurResInit(&res_ens);
+        planHeurState(ens, state, &res_ens);
+        planHeurResInit(&res_ens_par);
+        planHeurState(ens_par, state, &res_ens_par);
+        assertTrue(res.heur <= res_ens.heur);
+        assertEquals(res_ens.heur, res_ens_par.heur);
+    }
+
+    statePoolFree(&state_pool);
+    planHeurDel(heur);
+    planHeurDel(ens);
+    planHeurDel(ens_par);
+    planStateDel(state);
+    planProblemDel(p);
+}
+
 TEST(testHeurPotential)
 {
     runAStar("proto/simple.proto", 0, 10);
@@ -55,3 +101,16 @@ TEST(testHeurPotential)
     runAStar("proto/rovers-p03.proto", 0, 11);
     runAStar("proto/sokoban-p01.proto", 0, 9);
 }
+
+TEST(testHeurPotentialEnsemble)
+{
+    _runAStar("proto/depot-pfile1.proto", 0, 16, 4, 10);
+    _runAStar("proto/depot-pfile2.proto", 0, 16, 4, 15);
+    _runAStar("proto/driverlog-pfile3.proto", 0, 16, 4, 12);
+    _runAStar("proto/rovers-p03.proto", 0, 16, 4, 11);
+    _runAStar("proto/sokoban-p01.proto", 0, 16, 4, 9);
+
+    checkEnsemble("proto/depot-pfile1.proto", "states/depot-pfile1.txt", 16);
+    checkEnsemble("proto/rovers-p03.proto", "states/rovers-p03.txt", 16);
+    checkEnsemble("proto/rovers-p15.proto", "states/rovers-p15.txt", 10);
+}
@@ -82,3 +82,181 @@ TEST(testLandmarkCache)
 
     planLandmarkCacheDel(ldmc);
 }
+
+TEST(testLandmarkCachePrune)
+{
+    plan_landmark_cache_t *ldmc;
+    plan_landmark_set_t ldms;
+    size_t empty_mem, mem, alloc_mem;
+    int i, ldm[1];
+
+    ldmc = planLandmarkCacheNew(0);
+    empty_mem = planLandmarkCacheMemUsage(ldmc);
+
+    for (i = 0; i < 4; ++i){
+        planLandmarkSetInit(&ldms);
+        planLandmarkSetAdd(&ldms, 4, ldm0);
+        planLandmarkSetAdd(&ldms, 3, ldm3);
+        ldm[0] = 100 + i;
+        planLandmarkSetAdd(&ldms, 1, ldm);
+        assertEquals(planLandmarkCacheAdd(ldmc, i, &ldms), 0);
+    }
+
+    // Nothing was used yet
+    assertEquals(planLandmarkPrune(ldmc), 0);
+
+    assertNotEquals(planLandmarkCacheGet(ldmc, 0), NULL);
+    assertNotEquals(planLandmarkCacheGet(ldmc, 1), NULL);
+    assertNotEquals(planLandmarkCacheGet(ldmc, 2), NULL);
+    mem = ldmc->mem;
+    alloc_mem = planLandmarkCacheMemUsage(ldmc);
+
+    // The last used landmark set is kept, the freed memory stays in the
+    // cache for the next sets (only the table of free lists may grow)
+    assertEquals(planLandmarkPrune(ldmc), 2);
+    assertTrue(ldmc->mem < mem);
+    assertTrue(planLandmarkCacheMemUsage(ldmc) >= alloc_mem);
+    assertTrue(planLandmarkCacheMemUsage(ldmc) < alloc_mem + 1024);
+    assertEquals(planLandmarkCacheGet(ldmc, 0), NULL);
+    assertEquals(planLandmarkCacheGet(ldmc, 1), NULL);
+    assertNotEquals(planLandmarkCacheGet(ldmc, 2), NULL);
+    assertNotEquals(planLandmarkCacheGet(ldmc, 3), NULL);
+
+    planLandmarkCacheClear(ldmc);
+    assertEquals(planLandmarkCacheGet(ldmc, 2), NULL);
+    assertEquals(planLandmarkCacheGet(ldmc, 3), NULL);
+    assertEquals(planLandmarkCacheMemUsage(ldmc) - ldmc->ldms_alloc
+                    * sizeof(plan_landmark_t), empty_mem);
+
+    // The cache is still usable after clearing
+    planLandmarkSetInit(&ldms);
+    planLandmarkSetAdd(&ldms, 4, ldm0);
+    assertEquals(planLandmarkCacheAdd(ldmc, 2, &ldms), 0);
+    assertNotEquals(planLandmarkCacheGet(ldmc, 2), NULL);
+
+    planLandmarkCacheDel(ldmc);
+}
+
+static void addSet(plan_landmark_cache_t *ldmc, int id)
+{
+    plan_landmark_set_t ldms;
+    int ldm[2];
+
+    planLandmarkSetInit(&ldms);
+    planLandmarkSetAdd(&ldms, 4, ldm0);
+    ldm[0] = id;
+    ldm[1] = id + 1;
+    planLandmarkSetAdd(&ldms, 2, ldm);
+    assertEquals(planLandmarkCacheAdd(ldmc, id, &ldms), 0);
+}
+
+TEST(testLandmarkCacheMaxMem)
+{
+    plan_landmark_cache_t *ldmc;
+    const plan_landmark_set_t *l;
+    size_t mem;
+    int i, found;
+
+    ldmc = planLandmarkCacheNew(0);
+    for (i = 0; i < 10000; ++i)
+        addSet(ldmc, i);
+    for (i = 0; i < 10000; ++i){
+        l = planLandmarkCacheGet(ldmc, i);
+        assertNotEquals(l, NULL);
+        if (l != NULL){
+            assertEquals(l->size, 2);
+            assertEquals(l->landmark[1].op_id[0], i);
+        }
+    }
+    assertEquals(planLandmarkCacheGet(ldmc, 10000), NULL);
+
+    // Refresh the first sets so they are not the least recently used
+    for (i = 0; i < 10; ++i)
+        planLandmarkCacheGet(ldmc, i);
+
+    // Keep roughly a tenth of the cache
+    mem = ldmc->mem;
+    planLandmarkCacheSetMaxMem(ldmc, mem / 10);
+    assertTrue(ldmc->mem <= mem / 10);
+    for (i = 0; i < 10; ++i)
+        assertNotEquals(planLandmarkCacheGet(ldmc, i), NULL);
+    for (i = 10; i < 100; ++i)
+        assertEquals(planLandmarkCacheGet(ldmc, i), NULL);
+    assertNotEquals(planLandmarkCacheGet(ldmc, 9999), NULL);
+
+    // New sets evict the old ones
+    for (i = 10000; i < 20000; ++i){
+        addSet(ldmc, i);
+        assertTrue(ldmc->mem <= mem / 10);
+    }
+    assertNotEquals(planLandmarkCacheGet(ldmc, 19999), NULL);
+    assertEquals(planLandmarkCacheGet(ldmc, 9999), NULL);
+
+    found = 0;
+    for (i = 0; i < 20000; ++i){
+        l = planLandmarkCacheGet(ldmc, i);
+        if (l != NULL){
+            assertEquals(l->landmark[1].op_id[0], i);
+            ++found;
+        }
+    }
+    assertTrue(found > 0);
+    assertTrue(found < 2000);
+
+    // The shared landmark is freed only with the last set
+    planLandmarkCacheClear(ldmc);
+    assertEquals(ldmc->mem, 0);
+    addSet(ldmc, 1);
+    l = planLandmarkCacheGet(ldmc, 1);
+    assertEquals(l->landmark[0].size, 4);
+
+    planLandmarkCacheDel(ldmc);
+}
+
+static void addSetSize(plan_landmark_cache_t *ldmc, int id, int size)
+{
+    plan_landmark_set_t ldms;
+    int i, ldm[size];
+
+    for (i = 0; i < size; ++i)
+        ldm[i] = id * size + i;
+    planLandmarkSetInit(&ldms);
+    planLandmarkSetAdd(&ldms, size, ldm);
+    assertEquals(planLandmarkCacheAdd(ldmc, id, &ldms), 0);
+}
+
+TEST(testLandmarkCacheReuse)
+{
+    plan_landmark_cache_t *ldmc;
+    const plan_landmark_set_t *l;
+    size_t mem;
+    int i;
+
+    ldmc = planLandmarkCacheNew(0);
+    for (i = 0; i < 1000; ++i)
+        addSetSize(ldmc, i, 60);
+    mem = planLandmarkCacheMemUsage(ldmc);
+
+    // Evict everything, the memory stays in the cache
+    planLandmarkCacheSetMaxMem(ldmc, 1);
+    assertEquals(ldmc->mem, 0);
+    assertTrue(planLandmarkCacheMemUsage(ldmc) >= mem);
+    assertTrue(planLandmarkCacheMemUsage(ldmc) < mem + 1024);
+    planLandmarkCacheSetMaxMem(ldmc, 0);
+
+    // Smaller records are carved from the freed larger ones, no new block
+    // is allocated
+    for (i = 0; i < 1000; ++i)
+        addSetSize(ldmc, i, 20);
+    assertTrue(planLandmarkCacheMemUsage(ldmc) < mem + 1024);
+    for (i = 0; i < 1000; ++i){
+        l = planLandmarkCacheGet(ldmc, i);
+        assertNotEquals(l, NULL);
+        if (l != NULL){
+            assertEquals(l->landmark[0].size, 20);
+            assertEquals(l->landmark[0].op_id[19], i * 20 + 19);
+        }
+    }
+
+    planLandmarkCacheDel(ldmc);
+}
@@ -1,10 +1,16 @@
 #ifndef TEST_LANDMARK
 
 TEST(testLandmarkCache);
+TEST(testLandmarkCachePrune);
+TEST(testLandmarkCacheMaxMem);
+TEST(testLandmarkCacheReuse);
 TEST(protobufTearDown);
 
 TEST_SUITE(TSLandmark) {
     TEST_ADD(testLandmarkCache),
+    TEST_ADD(testLandmarkCachePrune),
+    TEST_ADD(testLandmarkCacheMaxMem),
+    TEST_ADD(testLandmarkCacheReuse),
     TEST_ADD(protobufTearDown),
     TEST_SUITE_CLOSURE
 };
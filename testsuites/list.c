@@ -38,14 +38,19 @@ TEST(testListTieBreaking)
     plan_list_t *list;
     plan_cost_t cost[3];
     plan_state_id_t state_id;
+    size_t mem_empty;
     int i;
 
     list = planListTieBreaking(3);
+    mem_empty = planListMemUsage(list);
+    assertTrue(mem_empty > 0);
 
     for (i = 0; i < data3_size; ++i)
         planListPush(list, data3[i].cost, data3[i].state_id);
+    assertTrue(planListMemUsage(list) > mem_empty);
     for (i = 0; planListPop(list, &state_id, cost) == 0; ++i);
     assertEquals(i, data3_size);
+    assertEquals(planListMemUsage(list), mem_empty);
 
     for (i = 0; i < data3_size; ++i)
         planListPush(list, data3[i].cost, data3[i].state_id);
@@ -0,0 +1,192 @@
+#include <math.h>
+#include <cu/cu.h>
+#include "plan/config.h"
+#include "plan/lp.h"
+
+#define EPS 1E-6
+
+#ifdef PLAN_LP
+/** Simple deterministic pseudo-random generator */
+static unsigned rnd(unsigned *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return (*seed >> 16u) & 0x7fffu;
+}
+#endif /* PLAN_LP */
+
+TEST(testLP)
+{
+#ifdef PLAN_LP
+    plan_lp_t *lp;
+    double val, x[3];
+
+    // max 3x + 2y  s.t.  x + y <= 4, x + 3y <= 6, x <= 3
+    lp = planLPNew(3, 2, PLAN_LP_MAX);
+    planLPSetObj(lp, 0, 3.);
+    planLPSetObj(lp, 1, 2.);
+    planLPSetCoef(lp, 0, 0, 1.);
+    planLPSetCoef(lp, 0, 1, 1.);
+    planLPSetRHS(lp, 0, 4., 'L');
+    planLPSetCoef(lp, 1, 0, 1.);
+    planLPSetCoef(lp, 1, 1, 3.);
+    planLPSetRHS(lp, 1, 6., 'L');
+    planLPSetCoef(lp, 2, 0, 1.);
+    planLPSetRHS(lp, 2, 3., 'L');
+    assertEquals(planLPSolve(lp, &val, x), 0);
+    assertTrue(fabs(val - 11.) < EPS);
+    assertTrue(fabs(x[0] - 3.) < EPS);
+    assertTrue(fabs(x[1] - 1.) < EPS);
+
+    // Free variable and equality: min x + y  s.t.  x - y = -2, y <= 5
+    planLPDel(lp);
+    lp = planLPNew(2, 2, PLAN_LP_MIN);
+    planLPSetVarFree(lp, 0);
+    planLPSetObj(lp, 0, 1.);
+    planLPSetObj(lp, 1, 1.);
+    planLPSetCoef(lp, 0, 0, 1.);
+    planLPSetCoef(lp, 0, 1, -1.);
+    planLPSetRHS(lp, 0, -2., 'E');
+    planLPSetCoef(lp, 1, 1, 1.);
+    planLPSetRHS(lp, 1, 5., 'L');
+    assertEquals(planLPSolve(lp, &val, x), 0);
+    assertTrue(fabs(val + 2.) < EPS);
+    assertTrue(fabs(x[0] + 2.) < EPS);
+    assertTrue(fabs(x[1]) < EPS);
+
+    // Infeasible: y >= 6
+    planLPSetRHS(lp, 1, 6., 'G');
+    planLPSetRHS(lp, 0, 0., 'L');
+    planLPSetVarRange(lp, 1, 0., 5.);
+    assertEquals(planLPSolve(lp, &val, x), -1);
+    assertTrue(val == 0.);
+    planLPDel(lp);
+#endif /* PLAN_LP */
+}
+
+TEST(testLPRows)
+{
+#ifdef PLAN_LP
+    plan_lp_t *lp;
+    double val, x[2];
+    char sense[2] = { 'L', 'L' };
+    double rhs[2] = { 2., 3. };
+
+    // max x + y  s.t.  x + 2y <= 4, 2x + y <= 5
+    lp = planLPNew(2, 2, PLAN_LP_MAX);
+    planLPSetObj(lp, 0, 1.);
+    planLPSetObj(lp, 1, 1.);
+    planLPSetCoef(lp, 0, 0, 1.);
+    planLPSetCoef(lp, 0, 1, 2.);
+    planLPSetRHS(lp, 0, 4., 'L');
+    planLPSetCoef(lp, 1, 0, 2.);
+    planLPSetCoef(lp, 1, 1, 1.);
+    planLPSetRHS(lp, 1, 5., 'L');
+    assertEquals(planLPSolve(lp, &val, x), 0);
+    assertTrue(fabs(val - 3.) < EPS);
+
+    // Add x <= 2, y <= 3
+    planLPAddRows(lp, 2, rhs, sense);
+    assertEquals(planLPNumRows(lp), 4);
+    planLPSetCoef(lp, 2, 0, 1.);
+    planLPSetCoef(lp, 3, 1, 1.);
+    planLPSetRHS(lp, 2, 1., 'L');
+    assertEquals(planLPSolve(lp, &val, x), 0);
+    assertTrue(fabs(val - 2.5) < EPS);
+    assertTrue(fabs(x[0] - 1.) < EPS);
+    assertTrue(fabs(x[1] - 1.5) < EPS);
+
+    // Delete the first two rows, only x <= 1, y <= 3 remain
+    planLPDelRows(lp, 0, 1);
+    assertEquals(planLPNumRows(lp), 2);
+    assertEquals(planLPSolve(lp, &val, x), 0);
+    assertTrue(fabs(val - 4.) < EPS);
+
+    // Remove the coeficient of y, the problem is unbounded
+    planLPSetCoef(lp, 1, 1, 0.);
+    assertEquals(planLPSolve(lp, &val, x), -1);
+    planLPDel(lp);
+#endif /* PLAN_LP */
+}
+
+TEST(testLPWarmStart)
+{
+#ifdef PLAN_LP
+    plan_lp_t *lp, *lp2;
+    double val, val2;
+    unsigned seed = 7u;
+    int rows = 30, cols = 20, i, j, k, c;
+
+    // Re-solving a modified problem must give the same result as
+    // solving it from scratch
+    lp = planLPNew(rows, cols, PLAN_LP_MAX);
+    lp2 = NULL;
+    for (k = 0; k < 20; ++k){
+        lp2 = planLPNew(rows, cols, PLAN_LP_MAX);
+        for (j = 0; j < cols; ++j){
+            c = rnd(&seed) % 10;
+            planLPSetObj(lp, j, c);
+            planLPSetObj(lp2, j, c);
+            planLPSetVarRange(lp, j, 0., 10.);
+            planLPSetVarRange(lp2, j, 0., 10.);
+        }
+        for (i = 0; i < rows; ++i){
+            for (j = 0; j < cols; ++j){
+                c = (rnd(&seed) % 4 == 0 ? (int)(rnd(&seed) % 7) - 2 : 0);
+                planLPSetCoef(lp, i, j, c);
+                planLPSetCoef(lp2, i, j, c);
+            }
+            c = rnd(&seed) % 20;
+            planLPSetRHS(lp, i, c, 'L');
+            planLPSetRHS(lp2, i, c, 'L');
+        }
+
+        assertEquals(planLPSolve(lp, &val, NULL), 0);
+        assertEquals(planLPSolve(lp2, &val2, NULL), 0);
+        assertTrue(fabs(val - val2) < EPS);
+        planLPDel(lp2);
+    }
+    planLPDel(lp);
+#endif /* PLAN_LP */
+}
+
+TEST(testMIP)
+{
+#ifdef PLAN_LP
+    static const int weight[] = { 12, 7, 11, 8, 9 };
+    static const int value[] = { 24, 13, 23, 15, 16 };
+    plan_lp_t *lp;
+    double val, x[5];
+    int i;
+
+    // 0-1 knapsack with capacity 26, the optimum is items 1, 2, 3
+    lp = planLPNew(1, 5, PLAN_LP_MAX);
+    for (i = 0; i < 5; ++i){
+        planLPSetVarBinary(lp, i);
+        planLPSetObj(lp, i, value[i]);
+        planLPSetCoef(lp, 0, i, weight[i]);
+    }
+    planLPSetRHS(lp, 0, 26., 'L');
+    assertEquals(planLPSolve(lp, &val, x), 0);
+    assertTrue(fabs(val - 51.) < EPS);
+    assertTrue(fabs(x[0]) < EPS);
+    assertTrue(fabs(x[1] - 1.) < EPS);
+    assertTrue(fabs(x[2] - 1.) < EPS);
+    assertTrue(fabs(x[3] - 1.) < EPS);
+    assertTrue(fabs(x[4]) < EPS);
+
+    // General integer variables: max x + y  s.t.  2x + 2y <= 7
+    planLPDel(lp);
+    lp = planLPNew(1, 2, PLAN_LP_MAX);
+    planLPSetVarInt(lp, 0);
+    planLPSetVarInt(lp, 1);
+    planLPSetObj(lp, 0, 1.);
+    planLPSetObj(lp, 1, 1.);
+    planLPSetCoef(lp, 0, 0, 2.);
+    planLPSetCoef(lp, 0, 1, 2.);
+    planLPSetRHS(lp, 0, 7., 'L');
+    assertEquals(planLPSolve(lp, &val, x), 0);
+    assertTrue(fabs(val - 3.) < EPS);
+    assertTrue(fabs(x[0] - floor(x[0] + .5)) < EPS);
+    planLPDel(lp);
+#endif /* PLAN_LP */
+}
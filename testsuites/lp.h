@@ -0,0 +1,16 @@
+#ifndef TEST_LP
+#define TEST_LP
+
+TEST(testLP);
+TEST(testLPRows);
+TEST(testLPWarmStart);
+TEST(testMIP);
+TEST_SUITE(TSLP) {
+    TEST_ADD(testLP),
+    TEST_ADD(testLPRows),
+    TEST_ADD(testLPWarmStart),
+    TEST_ADD(testMIP),
+    TEST_SUITE_CLOSURE
+};
+
+#endif /* TEST_LP */
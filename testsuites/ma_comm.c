@@ -58,6 +58,11 @@ TEST(testMACommPingPong)
     pthread_join(th[0], NULL);
     pthread_join(th[1], NULL);
 
+    assertEquals(comm[0]->sent_msgs, 5);
+    assertEquals(comm[0]->recv_msgs, 5);
+    assertEquals(comm[1]->sent_msgs, 5);
+    assertEquals(comm[1]->recv_msgs, 5);
+
     planMACommDel(comm[0]);
     planMACommDel(comm[1]);
     planMACommInprocPoolDel(inproc_pool);
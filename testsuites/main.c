@@ -4,9 +4,10 @@
 #include "state.h"
 #include "succ_gen.h"
 #include "state_space.h"
-//#include "search_ehc.h"
+#include "search_ehc.h"
 //#include "search_lazy.h"
 #include "search_astar.h"
+#include "search_bfs.h"
 #include "heur.h"
 #include "heur_ma.h"
 #include "heur_ma_pot.h"
@@ -21,6 +22,10 @@
 #include "landmark.h"
 #include "msg_schema.h"
 #include "fa_mutex.h"
+#include "h2.h"
+#include "symmetry.h"
+#include "trace.h"
+#include "lp.h"
 
 TEST(protobufTearDown)
 {
@@ -32,9 +37,10 @@ TEST_SUITES {
     TEST_SUITE_ADD(TSState),
     TEST_SUITE_ADD(TSSuccGen),
     TEST_SUITE_ADD(TSStateSpace),
-    //TEST_SUITE_ADD(TSSearchEHC),
+    TEST_SUITE_ADD(TSSearchEHC),
     //TEST_SUITE_ADD(TSSearchLazy),
     TEST_SUITE_ADD(TSSearchAStar),
+    TEST_SUITE_ADD(TSSearchBFS),
     TEST_SUITE_ADD_HEUR,
     TEST_SUITE_ADD(TSHeurMA),
     TEST_SUITE_ADD(TSHeurMAPot),
@@ -49,6 +55,10 @@ TEST_SUITES {
     TEST_SUITE_ADD(TSLandmark),
     TEST_SUITE_ADD(TSMsgSchema),
     TEST_SUITE_ADD(TSFAMutex),
+    TEST_SUITE_ADD(TSH2),
+    TEST_SUITE_ADD(TSSymmetry),
+    TEST_SUITE_ADD(TSTrace),
+    TEST_SUITE_ADD(TSLP),
     TEST_SUITES_CLOSURE
 };
 
@@ -1,4 +1,5 @@
 #include <cu/cu.h>
+#include <boruvka/alloc.h>
 #include <plan/search.h>
 
 TEST(testSearchAStar)
@@ -45,3 +46,267 @@ TEST(testSearchAStar)
     planSearchDel(search);
     planProblemDel(p);
 }
+
+static void astarStubborn(const char *proto, plan_cost_t cost)
+{
+    plan_search_astar_params_t params;
+    plan_search_t *search;
+    plan_path_t path;
+    plan_problem_t *p;
+    long expanded[2];
+    int stubborn;
+
+    printf("%s\n", proto);
+    for (stubborn = 0; stubborn < 2; ++stubborn){
+        planSearchAStarParamsInit(&params);
+        p = planProblemFromProto(proto, PLAN_PROBLEM_USE_CG);
+        params.search.prob = p;
+        params.search.heur = planHeurRelaxLMCutNew(p, 0);
+        params.search.heur_del = 1;
+        params.search.stubborn = stubborn;
+        search = planSearchAStarNew(&params);
+
+        planPathInit(&path);
+        assertEquals(planSearchRun(search, &path), PLAN_SEARCH_FOUND);
+        assertEquals(planPathCost(&path), cost);
+        expanded[stubborn] = search->stat.expanded_states;
+        printf("  stubborn: %d, expanded: %ld, generated: %ld\n",
+               stubborn, search->stat.expanded_states,
+               search->stat.generated_states);
+
+        planPathFree(&path);
+        planSearchDel(search);
+        planProblemDel(p);
+    }
+
+    assertTrue(expanded[1] <= expanded[0]);
+}
+
+TEST(testSearchAStarStubborn)
+{
+    astarStubborn("proto/driverlog-pfile3.proto", 12);
+    astarStubborn("proto/depot-pfile2.proto", 15);
+    astarStubborn("proto/rovers-p03.proto", 11);
+}
+
+static void astarDeadEnd(const char *proto, plan_cost_t cost)
+{
+    plan_search_astar_params_t params;
+    plan_search_t *search;
+    plan_path_t path;
+    plan_problem_t *p;
+    long evaluated[2];
+    int dead_end;
+
+    printf("%s\n", proto);
+    for (dead_end = 0; dead_end < 2; ++dead_end){
+        planSearchAStarParamsInit(&params);
+        p = planProblemFromProto(proto, PLAN_PROBLEM_USE_CG);
+        params.search.prob = p;
+        params.search.heur = planHeurRelaxLMCutNew(p, 0);
+        params.search.heur_del = 1;
+        params.search.dead_end = dead_end;
+        search = planSearchAStarNew(&params);
+
+        planPathInit(&path);
+        assertEquals(planSearchRun(search, &path), PLAN_SEARCH_FOUND);
+        assertEquals(planPathCost(&path), cost);
+        evaluated[dead_end] = search->stat.evaluated_states;
+        printf("  dead-end: %d, evaluated: %ld, expanded: %ld,"
+               " conflicts: %ld, pruned: %ld\n",
+               dead_end, search->stat.evaluated_states,
+               search->stat.expanded_states,
+               planSearchDeadEndConflicts(search),
+               planSearchDeadEndPruned(search));
+
+        planPathFree(&path);
+        planSearchDel(search);
+        planProblemDel(p);
+    }
+
+    assertTrue(evaluated[1] <= evaluated[0]);
+}
+
+TEST(testSearchAStarDeadEnd)
+{
+    astarDeadEnd("proto/sokoban-p01.proto", 9);
+    astarDeadEnd("proto/rovers-p03.proto", 11);
+}
+
+static void rwastarImproved(plan_search_t *search, const plan_path_t *path,
+                            plan_cost_t cost, void *ud)
+{
+    plan_cost_t *last_cost = ud;
+
+    assertEquals(planPathCost(path), cost);
+    assertTrue(cost < *last_cost);
+    *last_cost = cost;
+}
+
+TEST(testSearchRWAStar)
+{
+    plan_search_rwastar_params_t params;
+    plan_search_t *search;
+    plan_path_t path;
+    plan_problem_t *p;
+    plan_cost_t last_cost = PLAN_COST_MAX;
+    long evaluated;
+    int weight[] = { 10, 1 };
+
+    planSearchRWAStarParamsInit(&params);
+    p = planProblemFromProto("proto/driverlog-pfile3.proto",
+                             PLAN_PROBLEM_USE_CG);
+    params.search.prob = p;
+    params.search.heur = planHeurRelaxLMCutNew(p, 0);
+    params.search.heur_del = 1;
+    params.improved_fn = rwastarImproved;
+    params.improved_data = &last_cost;
+    search = planSearchRWAStarNew(&params);
+
+    planPathInit(&path);
+    assertEquals(planSearchRun(search, &path), PLAN_SEARCH_FOUND);
+    assertEquals(planPathCost(&path), 12);
+    assertEquals(last_cost, 12);
+
+    planPathFree(&path);
+    planSearchDel(search);
+    planProblemDel(p);
+
+    // Heuristic must be evaluated at most once per state
+    last_cost = PLAN_COST_MAX;
+    planSearchRWAStarParamsInit(&params);
+    p = planProblemFromProto("proto/depot-pfile2.proto",
+                             PLAN_PROBLEM_USE_CG);
+    params.search.prob = p;
+    params.search.heur = planHeurRelaxLMCutNew(p, 0);
+    params.search.heur_del = 1;
+    params.weight = weight;
+    params.weight_size = 2;
+    params.improved_fn = rwastarImproved;
+    params.improved_data = &last_cost;
+    search = planSearchRWAStarNew(&params);
+
+    planPathInit(&path);
+    assertEquals(planSearchRun(search, &path), PLAN_SEARCH_FOUND);
+    assertEquals(planPathCost(&path), 15);
+    assertEquals(last_cost, 15);
+    evaluated = search->stat.evaluated_states;
+    assertTrue(evaluated <= (long)p->state_pool->num_states);
+
+    planPathFree(&path);
+    planSearchDel(search);
+    planProblemDel(p);
+}
+
+TEST(testSearchSMAStar)
+{
+    plan_search_smastar_params_t params;
+    plan_search_t *search;
+    plan_path_t path;
+    plan_problem_t *p;
+
+    planSearchSMAStarParamsInit(&params);
+    p = planProblemFromProto("proto/depot-pfile2.proto",
+                             PLAN_PROBLEM_USE_CG);
+    params.search.prob = p;
+    params.search.heur = planHeurRelaxLMCutNew(p, 0);
+    params.search.heur_del = 1;
+    params.max_states = 100;
+    search = planSearchSMAStarNew(&params);
+
+    planPathInit(&path);
+    assertEquals(planSearchRun(search, &path), PLAN_SEARCH_FOUND);
+    assertEquals(planPathCost(&path), 15);
+    assertTrue(planSearchSMAStarEvicted(search) > 0);
+    assertTrue(planStatePoolSize(p->state_pool) <= 100 + p->op_size);
+
+    planPathFree(&path);
+    planSearchDel(search);
+    planProblemDel(p);
+}
+
+/** LM-Cut that checks that the state loaded by the search corresponds
+ *  to the state stored in the state pool under the same ID */
+struct _check_heur_t {
+    plan_heur_t heur;
+    plan_heur_t *lm_cut;
+    plan_state_t *state;
+    int mismatch;
+};
+typedef struct _check_heur_t check_heur_t;
+
+static void checkHeurDel(plan_heur_t *_h)
+{
+    check_heur_t *h = bor_container_of(_h, check_heur_t, heur);
+    planHeurDel(h->lm_cut);
+    planStateDel(h->state);
+    _planHeurFree(&h->heur);
+    BOR_FREE(h);
+}
+
+static void checkHeurNode(plan_heur_t *_h, plan_state_id_t state_id,
+                          plan_search_t *search, plan_heur_res_t *res)
+{
+    check_heur_t *h = bor_container_of(_h, check_heur_t, heur);
+    const plan_state_t *state;
+
+    state = planSearchLoadState(search, state_id);
+    planStatePoolGetState(search->state_pool, state_id, h->state);
+    if (memcmp(state->val, h->state->val,
+               sizeof(plan_val_t) * state->size) != 0)
+        ++h->mismatch;
+    planHeurState(h->lm_cut, h->state, res);
+}
+
+static check_heur_t *checkHeurNew(plan_problem_t *p)
+{
+    check_heur_t *h;
+
+    h = BOR_ALLOC(check_heur_t);
+    _planHeurInit(&h->heur, checkHeurDel, NULL, checkHeurNode);
+    h->lm_cut = planHeurRelaxLMCutNew(p, 0);
+    h->state = planStateNew(p->state_pool->num_vars);
+    h->mismatch = 0;
+    return h;
+}
+
+static void smastarReuse(const char *proto, int max_states, int dead_end,
+                         plan_cost_t cost)
+{
+    plan_search_smastar_params_t params;
+    plan_search_t *search;
+    plan_path_t path;
+    plan_problem_t *p;
+    check_heur_t *heur;
+
+    planSearchSMAStarParamsInit(&params);
+    p = planProblemFromProto(proto, PLAN_PROBLEM_USE_CG);
+    heur = checkHeurNew(p);
+    params.search.prob = p;
+    params.search.heur = &heur->heur;
+    params.search.heur_del = 1;
+    params.search.dead_end = dead_end;
+    params.max_states = max_states;
+    search = planSearchSMAStarNew(&params);
+
+    planPathInit(&path);
+    assertEquals(planSearchRun(search, &path), PLAN_SEARCH_FOUND);
+    assertEquals(planPathCost(&path), cost);
+    assertTrue(planSearchSMAStarEvicted(search) > 0);
+    // More states were generated than there were IDs
+    assertTrue(search->stat.generated_states
+                > (long)planStatePoolSize(p->state_pool));
+    assertEquals(heur->mismatch, 0);
+
+    planPathFree(&path);
+    planSearchDel(search);
+    planProblemDel(p);
+}
+
+TEST(testSearchSMAStarReuseID)
+{
+    smastarReuse("proto/sokoban-p01.proto", 300, 0, 9);
+    smastarReuse("proto/sokoban-p01.proto", 300, 1, 9);
+    smastarReuse("proto/rovers-p03.proto", 30, 1, 11);
+    smastarReuse("proto/depot-pfile2.proto", 100, 0, 15);
+}
@@ -2,10 +2,20 @@
 #define TEST_SEARCH_ASTAR_H
 
 TEST(testSearchAStar);
+TEST(testSearchAStarStubborn);
+TEST(testSearchAStarDeadEnd);
+TEST(testSearchRWAStar);
+TEST(testSearchSMAStar);
+TEST(testSearchSMAStarReuseID);
 TEST(protobufTearDown);
 
 TEST_SUITE(TSSearchAStar) {
     TEST_ADD(testSearchAStar),
+    TEST_ADD(testSearchAStarStubborn),
+    TEST_ADD(testSearchAStarDeadEnd),
+    TEST_ADD(testSearchRWAStar),
+    TEST_ADD(testSearchSMAStar),
+    TEST_ADD(testSearchSMAStarReuseID),
     TEST_ADD(protobufTearDown),
     TEST_SUITE_CLOSURE
 };
@@ -0,0 +1,87 @@
+#include <cu/cu.h>
+#include "plan/search.h"
+
+static void checkPath(const plan_problem_t *p, plan_path_t *path)
+{
+    plan_state_t *state;
+    plan_path_op_t *path_op;
+    plan_state_id_t state_id;
+    int i;
+
+    state = planStateNew(p->var_size);
+    state_id = p->initial_state;
+    BOR_LIST_FOR_EACH_ENTRY(path, plan_path_op_t, path_op, path){
+        assertEquals(path_op->from_state, state_id);
+        for (i = 0; i < p->op_size; ++i){
+            if (strcmp(p->op[i].name, path_op->name) == 0)
+                break;
+        }
+        assertTrue(i < p->op_size);
+        if (i == p->op_size)
+            break;
+
+        planStatePoolGetState(p->state_pool, state_id, state);
+        assertTrue(planPartStateIsSubsetState(p->op[i].pre, state));
+        state_id = planOpApply(p->op + i, p->state_pool, state_id);
+        assertEquals(path_op->to_state, state_id);
+    }
+    assertTrue(planStatePoolPartStateIsSubset(p->state_pool, p->goal,
+                                              state_id));
+    planStateDel(state);
+}
+
+static void runBFS(const char *proto, int count_reachable, int num_threads,
+                   int plan_len, long reachable)
+{
+    plan_search_bfs_params_t params;
+    plan_search_t *search;
+    plan_path_t path;
+    plan_problem_t *p;
+
+    planSearchBFSParamsInit(&params);
+    p = planProblemFromProto(proto, PLAN_PROBLEM_USE_CG);
+    params.search.prob = p;
+    params.count_reachable = count_reachable;
+    params.num_threads = num_threads;
+    search = planSearchBFSNew(&params);
+
+    planPathInit(&path);
+    assertEquals(planSearchRun(search, &path), PLAN_SEARCH_FOUND);
+    assertEquals(planPathLen(&path), plan_len);
+    checkPath(p, &path);
+    if (reachable >= 0){
+        assertEquals(planSearchBFSReachable(search), reachable);
+    }
+
+    printf("%s [count: %d, threads: %d]: len: %d, reachable: %ld,"
+           " layers: %d, expanded: %ld, generated: %ld\n",
+           proto, count_reachable, num_threads, planPathLen(&path),
+           planSearchBFSReachable(search), planSearchBFSLayers(search),
+           search->stat.expanded_states, search->stat.generated_states);
+
+    planPathFree(&path);
+    planSearchDel(search);
+    planProblemDel(p);
+}
+
+TEST(testSearchBFS)
+{
+    runBFS("proto/simple.proto", 0, 1, 10, -1);
+    runBFS("proto/depot-pfile1.proto", 0, 1, 10, -1);
+    runBFS("proto/driverlog-pfile1.proto", 0, 1, 7, -1);
+    runBFS("proto/rovers-p03.proto", 0, 1, 11, -1);
+    runBFS("proto/sokoban-p01.proto", 0, 1, 25, -1);
+    runBFS("proto/depot-pfile1.proto", 0, 3, 10, -1);
+    runBFS("proto/sokoban-p01.proto", 0, 3, 25, -1);
+}
+
+TEST(testSearchBFSCount)
+{
+    runBFS("proto/depot-pfile1.proto", 1, 1, 10, 576);
+    runBFS("proto/driverlog-pfile1.proto", 1, 1, 7, 10575);
+    runBFS("proto/rovers-p03.proto", 1, 1, 11, 19944);
+    runBFS("proto/sokoban-p01.proto", 1, 1, 25, 63868);
+    runBFS("proto/depot-pfile1.proto", 1, 4, 10, 576);
+    runBFS("proto/driverlog-pfile1.proto", 1, 4, 7, 10575);
+    runBFS("proto/rovers-p03.proto", 1, 4, 11, 19944);
+}
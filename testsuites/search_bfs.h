@@ -0,0 +1,15 @@
+#ifndef TEST_SEARCH_BFS_H
+#define TEST_SEARCH_BFS_H
+
+TEST(testSearchBFS);
+TEST(testSearchBFSCount);
+TEST(protobufTearDown);
+
+TEST_SUITE(TSSearchBFS) {
+    TEST_ADD(testSearchBFS),
+    TEST_ADD(testSearchBFSCount),
+    TEST_ADD(protobufTearDown),
+    TEST_SUITE_CLOSURE
+};
+
+#endif /* TEST_SEARCH_BFS_H */
@@ -9,7 +9,8 @@ TEST(testSearchEHC)
 
     planSearchEHCParamsInit(&params);
 
-    params.search.prob = planProblemFromFD("load-from-file.in2.sas");
+    params.search.prob = planProblemFromProto("proto/depot-pfile1.proto",
+                                              PLAN_PROBLEM_USE_CG);
     params.search.heur = planHeurGoalCountNew(params.search.prob->goal);
     params.search.heur_del = 1;
     ehc = planSearchEHCNew(&params);
@@ -17,9 +18,87 @@ TEST(testSearchEHC)
 
     assertEquals(planSearchRun(ehc, &path), PLAN_SEARCH_FOUND);
     planPathPrint(&path, stdout);
-    assertEquals(planPathCost(&path), 38);
+    assertEquals(planPathCost(&path), 12);
 
     planPathFree(&path);
     planSearchDel(ehc);
     planProblemDel(params.search.prob);
 }
+
+static void ehcPar(const char *proto, int num_threads, plan_path_t *path)
+{
+    plan_search_ehc_params_t params;
+    plan_search_t *ehc;
+    plan_problem_t *p;
+    plan_heur_t *thread_heur[BOR_MAX(num_threads, 1)];
+    int i;
+
+    planSearchEHCParamsInit(&params);
+
+    p = planProblemFromProto(proto, PLAN_PROBLEM_USE_CG);
+    params.search.prob = p;
+    params.search.heur = planHeurRelaxFFNew(p, 0);
+    params.search.heur_del = 1;
+    params.use_preferred_ops = PLAN_SEARCH_PREFERRED_PREF;
+    for (i = 0; i < num_threads; ++i){
+        thread_heur[i] = planHeurRelaxFFNew(p, 0);
+    }
+    // Sequential EHC is used without per-thread heuristics
+    if (num_threads > 0){
+        params.thread_heur = thread_heur;
+        params.thread_heur_size = num_threads;
+    }
+    ehc = planSearchEHCNew(&params);
+
+    planPathInit(path);
+    assertEquals(planSearchRun(ehc, path), PLAN_SEARCH_FOUND);
+    printf("%s [threads: %d]: cost: %d, evaluated: %ld, expanded: %ld\n",
+           proto, num_threads, (int)planPathCost(path),
+           ehc->stat.evaluated_states, ehc->stat.expanded_states);
+
+    planSearchDel(ehc);
+    planProblemDel(p);
+}
+
+static void pathCmp(plan_path_t *path1, plan_path_t *path2)
+{
+    plan_path_op_t *op1, *op2;
+    bor_list_t *item1, *item2;
+
+    assertEquals(planPathLen(path1), planPathLen(path2));
+    item2 = borListNext(path2);
+    BOR_LIST_FOR_EACH(path1, item1){
+        if (item2 == path2)
+            break;
+        op1 = BOR_LIST_ENTRY(item1, plan_path_op_t, path);
+        op2 = BOR_LIST_ENTRY(item2, plan_path_op_t, path);
+        assertEquals(strcmp(op1->name, op2->name), 0);
+        item2 = borListNext(item2);
+    }
+}
+
+static void ehcParCmp(const char *proto)
+{
+    plan_path_t path0, path1, path4;
+
+    ehcPar(proto, 0, &path0);
+    ehcPar(proto, 1, &path1);
+    ehcPar(proto, 4, &path4);
+
+    // The layered EHC must find the same plan as the sequential EHC and
+    // the plan must not depend on the number of threads
+    pathCmp(&path0, &path1);
+    pathCmp(&path1, &path4);
+
+    planPathFree(&path0);
+    planPathFree(&path1);
+    planPathFree(&path4);
+}
+
+TEST(testSearchEHCPar)
+{
+    ehcParCmp("proto/depot-pfile2.proto");
+    ehcParCmp("proto/driverlog-pfile3.proto");
+    ehcParCmp("proto/rovers-p15.proto");
+    ehcParCmp("proto/sokoban-p01.proto");
+}
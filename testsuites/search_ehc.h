@@ -2,10 +2,12 @@
 #define TEST_SEARCH_EHC_H
 
 TEST(testSearchEHC);
+TEST(testSearchEHCPar);
 TEST(protobufTearDown);
 
 TEST_SUITE(TSSearchEHC) {
     TEST_ADD(testSearchEHC),
+    TEST_ADD(testSearchEHCPar),
     TEST_ADD(protobufTearDown),
     TEST_SUITE_CLOSURE
 };
@@ -11,7 +11,7 @@ TEST(testSearchLazy)
 
     planSearchLazyParamsInit(&params);
 
-    params.search.prob = planProblemFromFD(DEF_JSON);
+    params.search.prob = planProblemFromFD(DEF_JSON, 0);
 
     params.search.heur = planHeurGoalCountNew(params.search.prob->goal);
     params.list = planListLazyHeapNew();
@@ -108,6 +108,66 @@ TEST(testStateBasic)
     planVarFree(vars + 3);
 }
 
+TEST(testStatePoolRemove)
+{
+    plan_var_t vars[2];
+    plan_state_pool_t *pool;
+    plan_state_t *state;
+    plan_state_id_t ins[3], id;
+    int data_id, init = 7, *data;
+
+    planVarInit(vars + 0, "a", 6);
+    planVarInit(vars + 1, "b", 3);
+
+    pool = planStatePoolNew(vars, 2);
+    data_id = planStatePoolDataReserve(pool, sizeof(int), NULL, &init);
+    state = planStateNew(pool->num_vars);
+
+    planStateZeroize(state);
+    ins[0] = planStatePoolInsert(pool, state);
+    planStateSet(state, 0, 3);
+    ins[1] = planStatePoolInsert(pool, state);
+    planStateSet(state, 1, 2);
+    ins[2] = planStatePoolInsert(pool, state);
+    assertEquals(planStatePoolSize(pool), 3);
+
+    data = planStatePoolData(pool, data_id, ins[1]);
+    *data = 11;
+
+    assertEquals(planStatePoolRemove(pool, ins[1]), 0);
+    assertEquals(planStatePoolRemove(pool, ins[1]), -1);
+    assertEquals(planStatePoolSize(pool), 2);
+    assertEquals(pool->num_states, 3);
+
+    planStateZeroize(state);
+    planStateSet(state, 0, 3);
+    assertEquals(planStatePoolFind(pool, state), PLAN_NO_STATE);
+
+    // Existing states are still found and the removed ID is reused
+    planStateZeroize(state);
+    assertEquals(planStatePoolInsert(pool, state), ins[0]);
+    planStateSet(state, 0, 5);
+    id = planStatePoolInsert(pool, state);
+    assertEquals(id, ins[1]);
+    assertEquals(planStatePoolSize(pool), 3);
+    assertEquals(pool->num_states, 3);
+    assertEquals(*(int *)planStatePoolData(pool, data_id, id), 7);
+
+    planStatePoolGetState(pool, id, state);
+    assertEquals(planStateGet(state, 0), 5);
+    assertEquals(planStateGet(state, 1), 0);
+
+    planStateSet(state, 0, 4);
+    assertEquals(planStatePoolInsert(pool, state), 3);
+    assertEquals(planStatePoolSize(pool), 4);
+
+    planStateDel(state);
+    planStatePoolDel(pool);
+
+    planVarFree(vars + 0);
+    planVarFree(vars + 1);
+}
+
 TEST(testStatePreEff)
 {
     plan_var_t vars[4];
@@ -2,6 +2,7 @@
 #define TEST_STATE_H
 
 TEST(testStateBasic);
+TEST(testStatePoolRemove);
 TEST(testStatePreEff);
 TEST(testPartStateUnset);
 TEST(testPackerPubPart);
@@ -9,6 +10,7 @@ TEST(protobufTearDown);
 
 TEST_SUITE(TSState) {
     TEST_ADD(testStateBasic),
+    TEST_ADD(testStatePoolRemove),
     TEST_ADD(testStatePreEff),
     TEST_ADD(testPartStateUnset),
     TEST_ADD(testPackerPubPart),
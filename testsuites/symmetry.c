@@ -0,0 +1,155 @@
+#include <cu/cu.h>
+#include <plan/symmetry.h>
+#include <plan/search.h>
+
+static void mapPartState(const plan_symmetry_gen_t *gen,
+                         const plan_part_state_t *src,
+                         plan_part_state_t *dst)
+{
+    plan_var_id_t var;
+    int i;
+
+    for (i = 0; i < src->vals_size; ++i){
+        var = src->vals[i].var;
+        planPartStateSet(dst, gen->var[var], gen->val[var][src->vals[i].val]);
+    }
+}
+
+static void checkGen(const plan_problem_t *p, const plan_symmetry_gen_t *gen)
+{
+    plan_part_state_t *ps;
+    const plan_op_t *op, *img;
+    int i;
+
+    ps = planPartStateNew(p->var_size);
+    mapPartState(gen, p->goal, ps);
+    assertTrue(planPartStateEq(ps, p->goal));
+    planPartStateDel(ps);
+
+    for (i = 0; i < p->op_size; ++i){
+        op = p->op + i;
+        img = p->op + gen->op[i];
+        assertEquals(op->cost, img->cost);
+
+        ps = planPartStateNew(p->var_size);
+        mapPartState(gen, op->pre, ps);
+        assertTrue(planPartStateEq(ps, img->pre));
+        planPartStateDel(ps);
+
+        ps = planPartStateNew(p->var_size);
+        mapPartState(gen, op->eff, ps);
+        assertTrue(planPartStateEq(ps, img->eff));
+        planPartStateDel(ps);
+    }
+}
+
+static void genTest(const char *proto)
+{
+    plan_problem_t *p;
+    plan_symmetry_t sym;
+    plan_symmetry_gen_t perm;
+    plan_state_t *s1, *s2, *c;
+    int i;
+
+    p = planProblemFromProto(proto, PLAN_PROBLEM_USE_CG);
+    assertEquals(planSymmetryInit(&sym, p), 0);
+    printf("%s: generators: %d\n", proto, sym.gen_size);
+    for (i = 0; i < sym.gen_size; ++i)
+        checkGen(p, sym.gen + i);
+
+    // Undoing the canonicalization must give back the original state
+    s1 = planStateNew(p->var_size);
+    s2 = planStateNew(p->var_size);
+    c = planStateNew(p->var_size);
+    planSymmetryGenInit(&perm, &sym);
+    planStatePoolGetState(p->state_pool, p->initial_state, s1);
+    for (i = 0; i < sym.gen_size; ++i){
+        planSymmetryGenApply(sym.gen + i, p->var_size, s1, s2);
+        planStateCopy(c, s2);
+        planSymmetryCanonState(&sym, c);
+        planSymmetryGenUncanon(&perm, &sym);
+        planSymmetryGenApply(&perm, p->var_size, c, s1);
+        assertTrue(memcmp(s1->val, s2->val,
+                          sizeof(plan_val_t) * p->var_size) == 0);
+        planSymmetryGenFree(&perm, &sym);
+        planSymmetryGenInit(&perm, &sym);
+    }
+    planSymmetryGenFree(&perm, &sym);
+    planStateDel(s1);
+    planStateDel(s2);
+    planStateDel(c);
+
+    planSymmetryFree(&sym);
+    planProblemDel(p);
+}
+
+TEST(testSymmetryGen)
+{
+    genTest("proto/simple.proto");
+    genTest("proto/depot-pfile1.proto");
+    genTest("proto/depot-pfile2.proto");
+    genTest("proto/driverlog-pfile3.proto");
+    genTest("proto/rovers-p15.proto");
+    genTest("proto/sokoban-p01.proto");
+}
+
+static void checkPath(const plan_problem_t *p, plan_path_t *path)
+{
+    plan_state_t *state;
+    plan_path_op_t *path_op;
+    int i, found;
+
+    state = planStateNew(p->var_size);
+    planStatePoolGetState(p->state_pool, p->initial_state, state);
+    BOR_LIST_FOR_EACH_ENTRY(path, plan_path_op_t, path_op, path){
+        for (i = 0, found = 0; i < p->op_size && !found; ++i){
+            if (strcmp(p->op[i].name, path_op->name) != 0)
+                continue;
+            found = 1;
+            assertTrue(planPartStateIsSubsetState(p->op[i].pre, state));
+            planPartStateUpdateState(p->op[i].eff, state);
+        }
+        assertTrue(found);
+    }
+    assertTrue(planPartStateIsSubsetState(p->goal, state));
+    planStateDel(state);
+}
+
+static void searchTest(const char *proto, plan_cost_t cost)
+{
+    plan_search_astar_params_t params;
+    plan_search_t *search;
+    plan_path_t path;
+    plan_problem_t *p;
+    int symmetry;
+
+    printf("%s\n", proto);
+    for (symmetry = 0; symmetry < 2; ++symmetry){
+        planSearchAStarParamsInit(&params);
+        p = planProblemFromProto(proto, PLAN_PROBLEM_USE_CG);
+        params.search.prob = p;
+        params.search.heur = planHeurRelaxLMCutNew(p, 0);
+        params.search.heur_del = 1;
+        params.search.symmetry = symmetry;
+        search = planSearchAStarNew(&params);
+
+        planPathInit(&path);
+        assertEquals(planSearchRun(search, &path), PLAN_SEARCH_FOUND);
+        assertEquals(planPathCost(&path), cost);
+        checkPath(p, &path);
+        printf("  symmetry: %d, expanded: %ld, generated: %ld\n",
+               symmetry, search->stat.expanded_states,
+               search->stat.generated_states);
+
+        planPathFree(&path);
+        planSearchDel(search);
+        planProblemDel(p);
+    }
+}
+
+TEST(testSymmetrySearch)
+{
+    searchTest("proto/driverlog-pfile3.proto", 12);
+    searchTest("proto/depot-pfile2.proto", 15);
+    searchTest("proto/sokoban-p01.proto", 9);
+}
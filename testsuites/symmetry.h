@@ -0,0 +1,15 @@
+#ifndef TEST_SYMMETRY_H
+#define TEST_SYMMETRY_H
+
+TEST(testSymmetryGen);
+TEST(testSymmetrySearch);
+TEST(protobufTearDown);
+
+TEST_SUITE(TSSymmetry) {
+    TEST_ADD(testSymmetryGen),
+    TEST_ADD(testSymmetrySearch),
+    TEST_ADD(protobufTearDown),
+    TEST_SUITE_CLOSURE
+};
+
+#endif
@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <cu/cu.h>
+#include <plan/trace.h>
+
+#define TRACE_FN "regressions/tmp.TSTrace.json"
+
+static char *readFile(const char *fn)
+{
+    FILE *fin;
+    char *buf;
+    long size;
+
+    fin = fopen(fn, "r");
+    if (fin == NULL)
+        return NULL;
+    fseek(fin, 0L, SEEK_END);
+    size = ftell(fin);
+    fseek(fin, 0L, SEEK_SET);
+    buf = malloc(size + 1);
+    if (fread(buf, 1, size, fin) != (size_t)size)
+        size = 0;
+    buf[size] = 0x0;
+    fclose(fin);
+    return buf;
+}
+
+static int countStr(const char *s, const char *needle)
+{
+    int cnt = 0;
+    while ((s = strstr(s, needle)) != NULL){
+        ++cnt;
+        s += strlen(needle);
+    }
+    return cnt;
+}
+
+TEST(testTrace)
+{
+    char *buf;
+
+    // Nothing is recorded if tracing is not started
+    planTraceBegin("test", "none");
+    planTraceEnd("test", "none");
+    assertFalse(plan_trace_enabled);
+
+    assertEquals(planTraceStart(TRACE_FN), 0);
+    assertTrue(plan_trace_enabled);
+    assertEquals(planTraceStart(TRACE_FN), -1);
+
+    planTraceThreadName("main \"thread\"");
+    planTraceBegin("test", "outer");
+    planTraceBeginArgs("test", "inner", "a", 1, "b", -2);
+    planTraceEnd("test", "inner");
+    planTraceInstant("test", "inst", "x", 10, NULL, 0, NULL, 0, "y", 11);
+    planTraceEnd("test", "outer");
+    planTraceStop();
+    assertFalse(plan_trace_enabled);
+
+    buf = readFile(TRACE_FN);
+    assertNotEquals(buf, NULL);
+    if (buf == NULL)
+        return;
+
+    assertEquals(strncmp(buf, "{\"traceEvents\":[", 16), 0);
+    assertEquals(countStr(buf, "\"ph\":\"B\""), 2);
+    assertEquals(countStr(buf, "\"ph\":\"E\""), 2);
+    assertEquals(countStr(buf, "\"ph\":\"i\""), 1);
+    assertEquals(countStr(buf, "\"ph\":\"M\""), 1);
+    assertEquals(countStr(buf, "\"name\":\"none\""), 0);
+    assertEquals(countStr(buf, "main \\\"thread\\\""), 1);
+    assertEquals(countStr(buf, "\"args\":{\"a\":1,\"b\":-2}"), 1);
+    assertEquals(countStr(buf, "\"args\":{\"x\":10,\"y\":11}"), 1);
+    assertEquals(countStr(buf, "\"dropped_events\":0"), 1);
+    free(buf);
+    unlink(TRACE_FN);
+}
+
+static void *thEvents(void *arg)
+{
+    long i, id = (long)arg;
+    char name[32];
+
+    sprintf(name, "th %ld", id);
+    planTraceThreadName(name);
+    for (i = 0; i < 1000; ++i){
+        planTraceBeginArgs("test", "ev", "i", i, NULL, 0);
+        planTraceEnd("test", "ev");
+    }
+    return NULL;
+}
+
+TEST(testTraceThreads)
+{
+    pthread_t th[4];
+    char *buf;
+    long i;
+    int run;
+
+    // The second run must not reuse buffers freed by the first one
+    for (run = 0; run < 2; ++run){
+        assertEquals(planTraceStart(TRACE_FN), 0);
+        thEvents((void *)-1L);
+        for (i = 0; i < 4; ++i)
+            pthread_create(th + i, NULL, thEvents, (void *)i);
+        for (i = 0; i < 4; ++i)
+            pthread_join(th[i], NULL);
+        planTraceStop();
+
+        buf = readFile(TRACE_FN);
+        assertNotEquals(buf, NULL);
+        if (buf == NULL)
+            return;
+        assertEquals(countStr(buf, "\"ph\":\"B\""), 5000);
+        assertEquals(countStr(buf, "\"ph\":\"E\""), 5000);
+        assertEquals(countStr(buf, "\"ph\":\"M\""), 5);
+        for (i = 0; i < 5; ++i){
+            char tid[16];
+            sprintf(tid, "\"tid\":%ld,", i);
+            assertEquals(countStr(buf, tid), 2001);
+        }
+        free(buf);
+    }
+    unlink(TRACE_FN);
+}
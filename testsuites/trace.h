@@ -0,0 +1,13 @@
+#ifndef TEST_TRACE_H
+#define TEST_TRACE_H
+
+TEST(testTrace);
+TEST(testTraceThreads);
+
+TEST_SUITE(TSTrace) {
+    TEST_ADD(testTrace),
+    TEST_ADD(testTraceThreads),
+    TEST_SUITE_CLOSURE
+};
+
+#endif